@@ -0,0 +1,326 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "Campaign.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <yarp/os/Bottle.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::Campaign;
+using iCub::interactionForces::CampaignRun;
+using iCub::interactionForces::ExperimentConfig;
+using iCub::interactionForces::ExperimentParameters;
+
+using yarp::os::Bottle;
+
+
+/** Allowance for the press and raise motions of a pinch, in seconds. */
+static const double MOTION_TIME = 2.0;
+
+
+Campaign::Campaign() {
+    busy = false;
+    stopping = false;
+    running = false;
+    runsTotal = 0;
+    runsDone = 0;
+    pinchesTotal = 0;
+    pinchesDone = 0;
+    started = 0.0;
+    nominalLeft = 0.0;
+    nominalDone = 0.0;
+    measuredDone = 0.0;
+
+    dbgTag = "Campaign: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Campaign file                                                    ********************************************** */
+int Campaign::load(const string &i_file, const ExperimentParameters &i_params, const vector<double> &i_home, const string &i_hand,
+        const double &i_now) {
+    std::ifstream in(i_file.c_str());
+    if (!in.is_open()) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return -1;
+    }
+
+    // The campaign is named after the file unless named in it
+    string name = i_file.substr(i_file.find_last_of('/') + 1);
+    name = name.substr(0, name.find('.'));
+
+    // Campaigns queued behind a running one start from the same parameters
+    mutex.lock();
+    CampaignRun defaults = base;
+    bool queued = busy;
+    mutex.unlock();
+    if (!queued) {
+        defaults.params = i_params;
+        defaults.home = i_home;
+    }
+
+    // Parse the whole file before queueing anything
+    std::deque<CampaignRun> runs;
+    int skipped = 0;
+    string line;
+    for (int lineNo = 1; std::getline(in, line); ++lineNo) {
+        Bottle words(line.c_str());
+        if ((words.size() == 0) || (line.find_first_not_of(" \t") == string::npos) || (line[line.find_first_not_of(" \t")] == '#')) {
+            continue;
+        }
+
+        string keyword = words.get(0).asString().c_str();
+        if (keyword == "name") {
+            name = words.get(1).asString().c_str();
+            continue;
+        }
+        bool isRun = (keyword == "run");
+        if (!isRun && (keyword != "defaults")) {
+            cerr << dbgTag << i_file << ":" << lineNo << ": expected name, defaults or run. \n";
+            return -1;
+        }
+
+        CampaignRun run = defaults;
+        int first = 1;
+        if (isRun) {
+            run.name = words.get(1).asString().c_str();
+            if (run.name.empty()) {
+                cerr << dbgTag << i_file << ":" << lineNo << ": missing run name. \n";
+                return -1;
+            }
+            first = 2;
+        }
+        int repeat = 1;
+        string hand = i_hand;
+        for (int i = first; i < words.size(); ++i) {
+            Bottle *setting = words.get(i).asList();
+            if ((setting == NULL) || (setting->size() < 2)) {
+                cerr << dbgTag << i_file << ":" << lineNo << ": expected (name value), got " << words.get(i).toString().c_str() << ". \n";
+                return -1;
+            }
+            string key = setting->get(0).asString().c_str();
+            Bottle value;
+            for (int j = 1; j < setting->size(); ++j) {
+                value.add(setting->get(j));
+            }
+
+            bool ok = true;
+            if (key == "repeat") {
+                repeat = value.get(0).asInt();
+                ok = isRun && (repeat > 0);
+            } else if (key == "hand") {
+                hand = value.get(0).asString().c_str();
+                ok = (hand == "left") || (hand == "right");
+            } else if ((key == "home.arm") || (key == "home.hand")) {
+                Bottle *pos = value.get(0).asList();
+                size_t offset = (key == "home.arm") ? 0 : 7;
+                size_t n = (key == "home.arm") ? 7 : 9;
+                ok = (pos != NULL) && ((size_t) pos->size() == n);
+                for (size_t j = 0; ok && (j < n); ++j) {
+                    run.home[offset + j] = pos->get(j).asDouble();
+                }
+            } else {
+                ok = ExperimentConfig::assign(run.params, key, value);
+            }
+            if (!ok) {
+                cerr << dbgTag << i_file << ":" << lineNo << ": invalid setting " << setting->toString().c_str() << ". \n";
+                return -1;
+            }
+        }
+        if (!ExperimentConfig::validate(run.params)) {
+            cerr << dbgTag << i_file << ":" << lineNo << ": invalid experiment parameters. \n";
+            return -1;
+        }
+
+        if (!isRun) {
+            defaults = run;
+        } else if (hand != i_hand) {
+            // A module instance drives a single arm
+            cout << dbgTag << "Skipping run " << run.name << " for the " << hand << " hand. \n";
+            skipped++;
+        } else {
+            string runName = run.name;
+            for (int k = 0; k < repeat; ++k) {
+                if (repeat > 1) {
+                    stringstream ss;
+                    ss << runName << "_" << k + 1;
+                    run.name = ss.str();
+                }
+                runs.push_back(run);
+            }
+        }
+    }
+    for (size_t i = 0; i < runs.size(); ++i) {
+        runs[i].campaign = name;
+    }
+
+    mutex.lock();
+    if (!busy && !runs.empty()) {
+        // First campaign of the queue
+        base.params = i_params;
+        base.home = i_home;
+        busy = true;
+        stopping = false;
+        runsTotal = 0;
+        runsDone = 0;
+        pinchesTotal = 0;
+        pinchesDone = 0;
+        started = i_now;
+        nominalLeft = 0.0;
+        nominalDone = 0.0;
+        measuredDone = 0.0;
+    }
+    for (size_t i = 0; i < runs.size(); ++i) {
+        queue.push_back(runs[i]);
+        runsTotal++;
+        pinchesTotal += runs[i].params.nPinches;
+        nominalLeft += runs[i].params.nPinches * getNominal(runs[i].params);
+    }
+    mutex.unlock();
+
+    cout << dbgTag << "Queued " << runs.size() << " runs of campaign " << name;
+    if (skipped > 0) {
+        cout << ", skipped " << skipped << " runs for the other hand";
+    }
+    cout << ". \n";
+
+    return (int) runs.size();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Run queue                                                        ********************************************** */
+bool Campaign::next(CampaignRun &o_run) {
+    mutex.lock();
+    bool ok = !stopping && !queue.empty();
+    if (ok) {
+        current = queue.front();
+        queue.pop_front();
+        running = true;
+        o_run = current;
+    }
+    mutex.unlock();
+
+    return ok;
+}
+
+void Campaign::pinchDone(const double &i_duration) {
+    mutex.lock();
+    if (running) {
+        double nominal = getNominal(current.params);
+        pinchesDone++;
+        nominalLeft = std::max(nominalLeft - nominal, 0.0);
+        nominalDone += nominal;
+        measuredDone += i_duration;
+    }
+    mutex.unlock();
+}
+
+void Campaign::runDone(void) {
+    mutex.lock();
+    if (running) {
+        runsDone++;
+        running = false;
+    }
+    mutex.unlock();
+}
+
+bool Campaign::finish(CampaignRun &o_base) {
+    mutex.lock();
+    bool done = busy && !running && (stopping || queue.empty());
+    if (done) {
+        queue.clear();
+        busy = false;
+        stopping = false;
+        o_base = base;
+        o_base.campaign = current.campaign;
+    }
+    mutex.unlock();
+
+    return done;
+}
+
+void Campaign::stop(void) {
+    mutex.lock();
+    if (busy) {
+        stopping = true;
+        queue.clear();
+    }
+    mutex.unlock();
+}
+
+bool Campaign::isStopping(void) {
+    mutex.lock();
+    bool result = stopping;
+    mutex.unlock();
+
+    return result;
+}
+
+bool Campaign::isBusy(void) {
+    mutex.lock();
+    bool result = busy;
+    mutex.unlock();
+
+    return result;
+}
+
+string Campaign::getReport(const double &i_now) {
+    stringstream ss;
+    ss << std::fixed << std::setprecision(0);
+
+    mutex.lock();
+    if (!busy) {
+        ss << "idle \n";
+    } else {
+        // Scale the nominal time left by the measured to nominal ratio of the completed pinches
+        double ratio = (nominalDone > 0.0) ? measuredDone / nominalDone : 1.0;
+        if (running) {
+            ss << "campaign " << current.campaign << ", run " << current.name << " (" << runsDone + 1 << "/" << runsTotal << ")";
+        } else {
+            ss << "between runs (" << runsDone << "/" << runsTotal << ")";
+        }
+        ss << ", pinch " << pinchesDone << "/" << pinchesTotal << ", elapsed " << i_now - started << " s, left " << nominalLeft * ratio
+            << " s" << std::setprecision(2) << " (x" << ratio << " nominal)";
+        if (stopping) {
+            ss << ", stopping";
+        }
+        ss << " \n";
+    }
+    mutex.unlock();
+
+    return ss.str();
+}
+
+double Campaign::getNominal(const ExperimentParameters &i_params) {
+    return i_params.pinchDuration + i_params.pinchDelay + MOTION_TIME;
+}
+/* *********************************************************************************************************************** */
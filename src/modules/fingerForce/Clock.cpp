@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "Clock.h"
+
+#include <yarp/os/Time.h>
+#include <yarp/os/Thread.h>
+
+using std::string;
+
+using iCub::interactionForces::Clock;
+using iCub::interactionForces::RealClock;
+using iCub::interactionForces::SimulatedClock;
+
+using yarp::os::Semaphore;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Clock factory                                                    ********************************************** */
+Clock* Clock::create(const string &i_type) {
+    if (i_type == "real") {
+        return new RealClock();
+    } else if (i_type == "sim") {
+        return new SimulatedClock();
+    }
+
+    return NULL;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Real clock                                                       ********************************************** */
+double RealClock::now() {
+    return yarp::os::Time::now();
+}
+
+void RealClock::delay(const double &i_seconds) {
+    yarp::os::Time::delay(i_seconds);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Simulated clock                                                  ********************************************** */
+SimulatedClock::SimulatedClock(const double &i_startTime)
+    : simTime(i_startTime), transients(0) {}
+
+double SimulatedClock::now() {
+    mutex.lock();
+    double t = simTime;
+    mutex.unlock();
+
+    return t;
+}
+
+void SimulatedClock::delay(const double &i_seconds) {
+    if (i_seconds <= 0.0) {
+        return;
+    }
+
+    Semaphore sem(0);
+
+    mutex.lock();
+    bool registered = (participants.find(yarp::os::Thread::getKeyOfCaller()) != participants.end());
+    if (!registered) {
+        transients++;
+    }
+    Sleeper s;
+    s.wakeTime = simTime + i_seconds;
+    s.sem = &sem;
+    sleepers.push_back(s);
+    advance();
+    mutex.unlock();
+
+    sem.wait();
+
+    if (!registered) {
+        mutex.lock();
+        transients--;
+        // The participants may all have gone to sleep while this thread was counted
+        advance();
+        mutex.unlock();
+    }
+}
+
+void SimulatedClock::registerThread() {
+    mutex.lock();
+    participants[yarp::os::Thread::getKeyOfCaller()]++;
+    mutex.unlock();
+}
+
+void SimulatedClock::unregisterThread() {
+    mutex.lock();
+    std::map<long int, int>::iterator it = participants.find(yarp::os::Thread::getKeyOfCaller());
+    if (it != participants.end()) {
+        if (--(it->second) <= 0) {
+            participants.erase(it);
+            // The remaining participants may all be waiting already
+            advance();
+        }
+    }
+    mutex.unlock();
+}
+
+void SimulatedClock::advance() {
+    if (sleepers.empty() || (sleepers.size() < participants.size() + transients)) {
+        return;
+    }
+
+    // Jump to the earliest wake up time
+    double next = sleepers[0].wakeTime;
+    for (size_t i = 1; i < sleepers.size(); ++i) {
+        if (sleepers[i].wakeTime < next) {
+            next = sleepers[i].wakeTime;
+        }
+    }
+    if (next > simTime) {
+        simTime = next;
+    }
+
+    // Wake up all due threads
+    size_t k = 0;
+    for (size_t i = 0; i < sleepers.size(); ++i) {
+        if (sleepers[i].wakeTime <= simTime) {
+            sleepers[i].sem->post();
+        } else {
+            sleepers[k++] = sleepers[i];
+        }
+    }
+    sleepers.resize(k);
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "ClockedRateThread.h"
+
+using iCub::interactionForces::ClockedRateThread;
+using iCub::interactionForces::ClockParticipant;
+
+
+ClockedRateThread::ClockedRateThread(const int aPeriod, Clock *aClock)
+    : runner(*this), periodMs(aPeriod), clock(aClock) {
+        iterations = 0;
+        estPeriod = 0.0;
+        estUsed = 0.0;
+        lastStart = 0.0;
+}
+
+ClockedRateThread::~ClockedRateThread() {
+    if (runner.isRunning()) {
+        runner.stop();
+    }
+}
+
+bool ClockedRateThread::start() {
+    return runner.start();
+}
+
+void ClockedRateThread::stop() {
+    runner.stop();
+}
+
+bool ClockedRateThread::isRunning() {
+    return runner.isRunning();
+}
+
+bool ClockedRateThread::setRate(const int aPeriod) {
+    if (aPeriod <= 0) {
+        return false;
+    }
+
+    statMutex.lock();
+    periodMs = aPeriod;
+    statMutex.unlock();
+
+    return true;
+}
+
+double ClockedRateThread::getRate() {
+    statMutex.lock();
+    double p = periodMs;
+    statMutex.unlock();
+
+    return p;
+}
+
+double ClockedRateThread::getEstPeriod() {
+    statMutex.lock();
+    double p = estPeriod;
+    statMutex.unlock();
+
+    return p;
+}
+
+double ClockedRateThread::getEstUsed() {
+    statMutex.lock();
+    double u = estUsed;
+    statMutex.unlock();
+
+    return u;
+}
+
+unsigned int ClockedRateThread::getIterations() {
+    statMutex.lock();
+    unsigned int n = iterations;
+    statMutex.unlock();
+
+    return n;
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Periodic loop                                                    ********************************************** */
+void ClockedRateThread::loop() {
+    // The loop thread takes part in the simulated time
+    ClockParticipant participant(clock);
+
+    while (!runner.isStopping()) {
+        double start = clock->now();
+
+        run();
+
+        double end = clock->now();
+
+        statMutex.lock();
+        if (iterations > 0) {
+            estPeriod = 1000.0 * (start - lastStart);
+        }
+        estUsed = 1000.0 * (end - start);
+        lastStart = start;
+        iterations++;
+        double wait = 0.001 * periodMs - (end - start);
+        statMutex.unlock();
+
+        clock->delay(wait);
+    }
+}
+/* *********************************************************************************************************************** */
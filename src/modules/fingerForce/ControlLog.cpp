@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "ControlLog.h"
+
+#include <cstdio>
+#include <cstdarg>
+#include <iostream>
+
+#include <yarp/os/Time.h>
+
+using std::cout;
+
+using iCub::interactionForces::ControlLog;
+
+using yarp::os::Time;
+
+
+/** Idle period of the background thread in seconds. */
+static const double DRAIN_PERIOD = 0.005;
+
+
+ControlLog::ControlLog()
+    : lines(NULL), capacity(0), writePos(0), readPos(0), dropped(0), drainer(*this), deferred(false) {
+        dbgTag = "ControlLog: ";
+}
+
+ControlLog::~ControlLog() {
+    stop();
+    delete[] lines;
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Start and stop the deferred printing                             ********************************************** */
+bool ControlLog::start(const int i_capacity) {
+    if (deferred) {
+        return true;
+    }
+
+    capacity = 2;
+    while ((int) capacity < i_capacity) {
+        capacity *= 2;
+    }
+    delete[] lines;
+    lines = new Line[capacity];
+    for (unsigned int i = 0; i < capacity; ++i) {
+        lines[i].sequence = i;
+    }
+    writePos = 0;
+    readPos = 0;
+    __sync_synchronize();
+
+    if (!drainer.start()) {
+        cout << dbgTag << "Could not start the log thread. \n";
+        return false;
+    }
+    deferred = true;
+
+    return true;
+}
+
+void ControlLog::stop(void) {
+    if (!deferred) {
+        return;
+    }
+    drainer.stop();
+    deferred = false;
+    drain();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Lines                                                            ********************************************** */
+void ControlLog::print(const char *i_format, ...) {
+    va_list args;
+    va_start(args, i_format);
+
+    if (!deferred) {
+        // The console output of the other threads goes through cout
+        char text[LINE_SIZE];
+        vsnprintf(text, LINE_SIZE, i_format, args);
+        va_end(args);
+        cout << text;
+        return;
+    }
+
+    // Claim a free slot, any number of threads may print at once
+    unsigned int pos = writePos;
+    Line *line = NULL;
+    while (line == NULL) {
+        Line *slot = &lines[pos & (capacity - 1)];
+        int diff = (int) (slot->sequence - pos);
+        if (diff == 0) {
+            if (__sync_bool_compare_and_swap(&writePos, pos, pos + 1)) {
+                line = slot;
+            } else {
+                pos = writePos;
+            }
+        } else if (diff < 0) {
+            // The ring is full
+            __sync_fetch_and_add(&dropped, 1);
+            va_end(args);
+            return;
+        } else {
+            pos = writePos;
+        }
+    }
+
+    vsnprintf(line->text, LINE_SIZE, i_format, args);
+    va_end(args);
+
+    // Publish the line
+    __sync_synchronize();
+    line->sequence = pos + 1;
+}
+
+void ControlLog::printLines(const std::string &i_text) {
+    size_t start = 0;
+    while (start < i_text.size()) {
+        size_t end = i_text.find('\n', start);
+        if (end == std::string::npos) {
+            end = i_text.size();
+        }
+        print("%.*s\n", (int) (end - start), i_text.c_str() + start);
+        start = end + 1;
+    }
+}
+
+int ControlLog::drain(void) {
+    int count = 0;
+    while (lines != NULL) {
+        Line *line = &lines[readPos & (capacity - 1)];
+        if ((int) (line->sequence - (readPos + 1)) != 0) {
+            break;
+        }
+        __sync_synchronize();
+        cout << line->text;
+        count++;
+
+        // Free the slot for the next round of the ring
+        __sync_synchronize();
+        line->sequence = readPos + capacity;
+        readPos++;
+    }
+    if (count > 0) {
+        cout.flush();
+    }
+
+    return count;
+}
+
+unsigned int ControlLog::getDropped(void) {
+    return __sync_fetch_and_add(&dropped, 0);
+}
+
+void ControlLog::Drainer::run() {
+    while (!isStopping()) {
+        if (owner.drain() == 0) {
+            Time::delay(DRAIN_PERIOD);
+        }
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "DepthProfile.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::DepthProfile;
+using iCub::interactionForces::StaircaseProfile;
+using iCub::interactionForces::SineProfile;
+using iCub::interactionForces::ChirpProfile;
+using iCub::interactionForces::PrbsProfile;
+using iCub::interactionForces::TableProfile;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Profile factory                                                  ********************************************** */
+DepthProfile* DepthProfile::create(const string &i_type, const Bottle &i_group) {
+    string dbgTag = "DepthProfile: ";
+
+    double amplitude = i_group.check("amplitude", Value(5.0), "Profile amplitude in degrees.").asDouble();
+    double duration = i_group.check("duration", Value(60.0), "Profile duration in seconds.").asDouble();
+
+    if (i_type == "staircase") {
+        double stepSize = i_group.check("stepSize", Value(1.0), "Staircase step size in degrees.").asDouble();
+        double stepDuration = i_group.check("stepDuration", Value(5.0), "Staircase step duration in seconds.").asDouble();
+        int nSteps = i_group.check("nSteps", Value(10), "Number of staircase steps up.").asInt();
+        if ((stepDuration <= 0.0) || (nSteps <= 0)) {
+            cerr << dbgTag << "Invalid staircase parameters. \n";
+            return NULL;
+        }
+        return new StaircaseProfile(stepSize, stepDuration, nSteps);
+    } else if (i_type == "sine") {
+        double frequency = i_group.check("frequency", Value(0.5), "Sinusoid frequency in Hz.").asDouble();
+        if ((frequency <= 0.0) || (duration <= 0.0)) {
+            cerr << dbgTag << "Invalid sinusoid parameters. \n";
+            return NULL;
+        }
+        return new SineProfile(amplitude, frequency, duration);
+    } else if (i_type == "chirp") {
+        double f0 = i_group.check("f0", Value(0.1), "Chirp start frequency in Hz.").asDouble();
+        double f1 = i_group.check("f1", Value(2.0), "Chirp end frequency in Hz.").asDouble();
+        if ((f0 < 0.0) || (f1 < 0.0) || (duration <= 0.0)) {
+            cerr << dbgTag << "Invalid chirp parameters. \n";
+            return NULL;
+        }
+        return new ChirpProfile(amplitude, f0, f1, duration);
+    } else if (i_type == "prbs") {
+        double bitDuration = i_group.check("bitDuration", Value(0.5), "PRBS bit duration in seconds.").asDouble();
+        int seed = i_group.check("seed", Value(1), "PRBS register seed.").asInt();
+        if (bitDuration <= 0.0) {
+            cerr << dbgTag << "Invalid PRBS parameters. \n";
+            return NULL;
+        }
+        int nBits = (int) ceil(duration / bitDuration);
+        return new PrbsProfile(amplitude, bitDuration, nBits, seed);
+    } else if (i_type == "table") {
+        Bottle *table = i_group.find("table").asList();
+        if ((table == NULL) || (table->size() < 2)) {
+            cerr << dbgTag << "Cannot find a table of at least two (time depth) points in parameter group [profile]. \n";
+            return NULL;
+        }
+        vector<double> times, depths;
+        for (int i = 0; i < table->size(); ++i) {
+            Bottle *point = table->get(i).asList();
+            if ((point == NULL) || (point->size() != 2)) {
+                cerr << dbgTag << "Invalid table point " << i << ". Expecting (time depth). \n";
+                return NULL;
+            }
+            double t = point->get(0).asDouble();
+            if (!times.empty() && (t <= times.back())) {
+                cerr << dbgTag << "Table times must be strictly increasing. \n";
+                return NULL;
+            }
+            times.push_back(t);
+            depths.push_back(point->get(1).asDouble());
+        }
+        return new TableProfile(times, depths);
+    }
+
+    cerr << dbgTag << "Unknown profile type: " << i_type << ". \n";
+
+    return NULL;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Staircase                                                        ********************************************** */
+StaircaseProfile::StaircaseProfile(const double &aStepSize, const double &aStepDuration, const int &aNSteps)
+    : stepSize(aStepSize), stepDuration(aStepDuration), nSteps(aNSteps) {}
+
+double StaircaseProfile::sample(const double &i_t) const {
+    if (i_t < 0.0) {
+        return 0.0;
+    }
+
+    int step = (int) floor(i_t / stepDuration);
+    if (step <= nSteps) {
+        return step * stepSize;
+    } else if (step <= 2 * nSteps) {
+        return (2 * nSteps - step) * stepSize;
+    }
+
+    return 0.0;
+}
+
+double StaircaseProfile::getDuration() const {
+    return (2 * nSteps + 1) * stepDuration;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sinusoid                                                         ********************************************** */
+SineProfile::SineProfile(const double &aAmplitude, const double &aFrequency, const double &aDuration)
+    : amplitude(aAmplitude), frequency(aFrequency), duration(aDuration) {}
+
+double SineProfile::sample(const double &i_t) const {
+    if ((i_t < 0.0) || (i_t > duration)) {
+        return 0.0;
+    }
+
+    return 0.5 * amplitude * (1.0 - cos(2.0 * M_PI * frequency * i_t));
+}
+
+double SineProfile::getDuration() const {
+    return duration;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Chirp                                                            ********************************************** */
+ChirpProfile::ChirpProfile(const double &aAmplitude, const double &aF0, const double &aF1, const double &aDuration)
+    : amplitude(aAmplitude), f0(aF0), f1(aF1), duration(aDuration) {}
+
+double ChirpProfile::sample(const double &i_t) const {
+    if ((i_t < 0.0) || (i_t > duration)) {
+        return 0.0;
+    }
+
+    // Instantaneous frequency f0 + (f1 - f0) t / T
+    double phase = 2.0 * M_PI * (f0 * i_t + 0.5 * (f1 - f0) * i_t * i_t / duration);
+
+    return 0.5 * amplitude * (1.0 - cos(phase));
+}
+
+double ChirpProfile::getDuration() const {
+    return duration;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pseudo-random binary sequence                                    ********************************************** */
+PrbsProfile::PrbsProfile(const double &aAmplitude, const double &aBitDuration, const int &aNBits, const int &aSeed)
+    : amplitude(aAmplitude), bitDuration(aBitDuration) {
+        // 7 bit Fibonacci LFSR, taps 7 and 6 (x^7 + x^6 + 1), period 127
+        unsigned int reg = (unsigned int) aSeed & 0x7F;
+        if (reg == 0) {
+            reg = 1;
+        }
+
+        bits.resize(aNBits > 0 ? aNBits : 0);
+        for (size_t i = 0; i < bits.size(); ++i) {
+            unsigned int fb = ((reg >> 6) ^ (reg >> 5)) & 1;
+            reg = ((reg << 1) | fb) & 0x7F;
+            bits[i] = (fb != 0);
+        }
+}
+
+double PrbsProfile::sample(const double &i_t) const {
+    if (i_t < 0.0) {
+        return 0.0;
+    }
+
+    size_t bit = (size_t) floor(i_t / bitDuration);
+    if (bit >= bits.size()) {
+        return 0.0;
+    }
+
+    return bits[bit] ? amplitude : 0.0;
+}
+
+double PrbsProfile::getDuration() const {
+    return bits.size() * bitDuration;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* User table                                                       ********************************************** */
+TableProfile::TableProfile(const vector<double> &aTimes, const vector<double> &aDepths)
+    : times(aTimes), depths(aDepths) {}
+
+double TableProfile::sample(const double &i_t) const {
+    if (i_t <= times.front()) {
+        return depths.front();
+    } else if (i_t >= times.back()) {
+        return depths.back();
+    }
+
+    // Binary search for the enclosing segment
+    size_t k = std::upper_bound(times.begin(), times.end(), i_t) - times.begin();
+    double a = (i_t - times[k - 1]) / (times[k] - times[k - 1]);
+
+    return depths[k - 1] + a * (depths[k] - depths[k - 1]);
+}
+
+double TableProfile::getDuration() const {
+    return times.back();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,265 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "ExperimentConfig.h"
+
+#include <iostream>
+#include <sstream>
+
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::ExperimentConfig;
+using iCub::interactionForces::ExperimentParameters;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+/** The parameter names, in display order. */
+static const char *PARAM_NAMES[] = {"nPinches", "pinchIncrement", "pinchDuration", "pinchDelay", "progressiveDepth", "useThumb",
+    "finger.joint", "finger.startPos", "finger.pinchPos", "finger.fingertips"};
+static const int N_PARAMS = sizeof(PARAM_NAMES) / sizeof(PARAM_NAMES[0]);
+
+
+ExperimentConfig::ExperimentConfig() {
+    Bottle empty;
+    read(empty, empty, staged);
+    pending = false;
+
+    dbgTag = "ExperimentConfig: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Read and check the parameters                                    ********************************************** */
+bool ExperimentConfig::read(const Bottle &i_experiment, const Bottle &i_finger, ExperimentParameters &o_params) {
+    o_params.nPinches = i_experiment.check("nPinches", Value(10), "Number of pinchings per sequence.").asInt();
+    o_params.pinchIncrement = i_experiment.check("pinchIncrement", Value(1), "Position increment for each pinch.").asInt();
+    o_params.pinchDuration = i_experiment.check("pinchDuration", Value(5), "Duration of a single pinch.").asInt();
+    o_params.pinchDelay = i_experiment.check("pinchDelay", Value(5), "Delay between pinches.").asInt();
+    o_params.progressiveDepth = i_experiment.check("progressiveDepth", Value(false), "Set to true to progressively increase pinching depth.").asBool();
+    o_params.useThumb = i_experiment.check("useThumb", Value(false), "Set to true to use the thumb when pinching.").asBool();
+
+    o_params.finger.joint = i_finger.check("joint", Value(11)).asInt();
+    o_params.finger.startPos = i_finger.check("startPos", Value(0.0)).asDouble();
+    o_params.finger.pinchPos = i_finger.check("pinchPos", Value(20.0)).asDouble();
+    o_params.finger.fingertips.clear();
+    Bottle *tips = i_finger.find("fingertips").asList();
+    if (tips != NULL) {
+        for (int i = 0; i < tips->size(); ++i) {
+            o_params.finger.fingertips.push_back(tips->get(i).asInt());
+        }
+    } else {
+        for (int i = 0; i < 5; ++i) {
+            o_params.finger.fingertips.push_back(i);
+        }
+    }
+
+    return validate(o_params);
+}
+
+bool ExperimentConfig::validate(const ExperimentParameters &i_params) {
+    if (i_params.nPinches <= 0) {
+        cerr << "ExperimentConfig: " << "Invalid number of pinches " << i_params.nPinches << ". \n";
+        return false;
+    }
+    if ((i_params.pinchDuration < 0) || (i_params.pinchDelay < 0)) {
+        cerr << "ExperimentConfig: " << "Invalid pinch duration or delay. \n";
+        return false;
+    }
+    if ((i_params.finger.joint < 7) || (i_params.finger.joint > 15)) {
+        cerr << "ExperimentConfig: " << "Invalid finger joint " << i_params.finger.joint << ". Expecting a hand joint (7-15). \n";
+        return false;
+    }
+    for (size_t i = 0; i < i_params.finger.fingertips.size(); ++i) {
+        if ((i_params.finger.fingertips[i] < 0) || (i_params.finger.fingertips[i] > 4)) {
+            cerr << "ExperimentConfig: " << "Invalid fingertip index " << i_params.finger.fingertips[i] << ". \n";
+            return false;
+        }
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Staged parameters                                                ********************************************** */
+void ExperimentConfig::stage(const ExperimentParameters &i_params) {
+    mutex.lock();
+    staged = i_params;
+    pending = true;
+    mutex.unlock();
+}
+
+bool ExperimentConfig::set(const string &i_name, const Bottle &i_value) {
+    if (i_value.size() == 0) {
+        cerr << dbgTag << "Missing value for " << i_name << ". \n";
+        return false;
+    }
+
+    // Edit a copy so that an invalid value leaves the staged parameters untouched
+    mutex.lock();
+    ExperimentParameters params = staged;
+    bool ok = assign(params, i_name, i_value);
+    if (ok && validate(params)) {
+        staged = params;
+        pending = true;
+    } else {
+        ok = false;
+    }
+    mutex.unlock();
+
+    return ok;
+}
+
+bool ExperimentConfig::assign(ExperimentParameters &io_params, const string &i_name, const Bottle &i_value) {
+    if (i_value.size() == 0) {
+        cerr << "ExperimentConfig: " << "Missing value for " << i_name << ". \n";
+        return false;
+    }
+    const Value &value = i_value.get(0);
+    ExperimentParameters &params = io_params;
+
+    bool ok = true;
+    if (i_name == "nPinches") {
+        params.nPinches = value.asInt();
+    } else if (i_name == "pinchIncrement") {
+        params.pinchIncrement = value.asInt();
+    } else if (i_name == "pinchDuration") {
+        params.pinchDuration = value.asInt();
+    } else if (i_name == "pinchDelay") {
+        params.pinchDelay = value.asInt();
+    } else if (i_name == "progressiveDepth") {
+        params.progressiveDepth = value.asBool();
+    } else if (i_name == "useThumb") {
+        params.useThumb = value.asBool();
+    } else if (i_name == "finger.joint") {
+        params.finger.joint = value.asInt();
+    } else if (i_name == "finger.startPos") {
+        params.finger.startPos = value.asDouble();
+    } else if (i_name == "finger.pinchPos") {
+        params.finger.pinchPos = value.asDouble();
+    } else if (i_name == "finger.fingertips") {
+        // Accept both "(1 4)" and "1 4"
+        const Bottle *tips = value.isList() ? value.asList() : &i_value;
+        params.finger.fingertips.clear();
+        for (int i = 0; i < tips->size(); ++i) {
+            params.finger.fingertips.push_back(tips->get(i).asInt());
+        }
+    } else {
+        cerr << "ExperimentConfig: " << "Unknown parameter " << i_name << ". \n";
+        ok = false;
+    }
+
+    return ok;
+}
+
+ExperimentParameters ExperimentConfig::getStaged(void) {
+    mutex.lock();
+    ExperimentParameters params = staged;
+    mutex.unlock();
+
+    return params;
+}
+
+string ExperimentConfig::get(const string &i_name) {
+    mutex.lock();
+    string value = format(staged, i_name);
+    mutex.unlock();
+
+    return value;
+}
+
+string ExperimentConfig::toString(void) {
+    stringstream ss;
+
+    mutex.lock();
+    for (int i = 0; i < N_PARAMS; ++i) {
+        ss << PARAM_NAMES[i] << " " << format(staged, PARAM_NAMES[i]) << "\n";
+    }
+    if (pending) {
+        ss << "(pending, applied before the next pinch)\n";
+    }
+    mutex.unlock();
+
+    return ss.str();
+}
+
+string ExperimentConfig::snapshot(const ExperimentParameters &i_params) {
+    stringstream ss;
+    for (int i = 0; i < N_PARAMS; ++i) {
+        ss << (i > 0 ? " " : "") << "(" << PARAM_NAMES[i] << " " << format(i_params, PARAM_NAMES[i]) << ")";
+    }
+
+    return ss.str();
+}
+
+string ExperimentConfig::format(const ExperimentParameters &i_params, const string &i_name) {
+    stringstream ss;
+    ss << std::boolalpha;
+
+    if (i_name == "nPinches") {
+        ss << i_params.nPinches;
+    } else if (i_name == "pinchIncrement") {
+        ss << i_params.pinchIncrement;
+    } else if (i_name == "pinchDuration") {
+        ss << i_params.pinchDuration;
+    } else if (i_name == "pinchDelay") {
+        ss << i_params.pinchDelay;
+    } else if (i_name == "progressiveDepth") {
+        ss << i_params.progressiveDepth;
+    } else if (i_name == "useThumb") {
+        ss << i_params.useThumb;
+    } else if (i_name == "finger.joint") {
+        ss << i_params.finger.joint;
+    } else if (i_name == "finger.startPos") {
+        ss << i_params.finger.startPos;
+    } else if (i_name == "finger.pinchPos") {
+        ss << i_params.finger.pinchPos;
+    } else if (i_name == "finger.fingertips") {
+        ss << "(";
+        for (size_t i = 0; i < i_params.finger.fingertips.size(); ++i) {
+            ss << (i > 0 ? " " : "") << i_params.finger.fingertips[i];
+        }
+        ss << ")";
+    }
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Swap in the staged parameters                                    ********************************************** */
+bool ExperimentConfig::fetch(ExperimentParameters &o_params) {
+    mutex.lock();
+    bool changed = pending;
+    if (pending) {
+        o_params = staged;
+        pending = false;
+    }
+    mutex.unlock();
+
+    return changed;
+}
+/* *********************************************************************************************************************** */
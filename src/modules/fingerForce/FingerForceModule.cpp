@@ -21,9 +21,13 @@
 #include "FingerForceModule.h"
 
 #include <iostream>
+#include <fstream>
 #include <sstream>
+#include <iomanip>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include <ctime>
 
 #include <yarp/os/Network.h>
 #include <yarp/os/Property.h>
@@ -32,6 +36,48 @@
 
 
 using iCub::interactionForces::FingerForceModule;
+using iCub::interactionForces::Clock;
+using iCub::interactionForces::ClockParticipant;
+using iCub::interactionForces::SimulatedHand;
+using iCub::interactionForces::PoseService;
+using iCub::interactionForces::DepthProfile;
+using iCub::interactionForces::SensorHub;
+using iCub::interactionForces::JointCache;
+using iCub::interactionForces::RealTime;
+using iCub::interactionForces::RealTimeScope;
+using iCub::interactionForces::ControlLoop;
+using iCub::interactionForces::SlipDetector;
+using iCub::interactionForces::PinchMonitor;
+using iCub::interactionForces::PinchMetrics;
+using iCub::interactionForces::PinchSegment;
+using iCub::interactionForces::PinchPipeline;
+using iCub::interactionForces::PinchSummaryJob;
+using iCub::interactionForces::SegmentJob;
+using iCub::interactionForces::IndexCloseJob;
+using iCub::interactionForces::ResultFlushJob;
+using iCub::interactionForces::OnsetReportJob;
+using iCub::interactionForces::ResultWriter;
+using iCub::interactionForces::ResultStore;
+using iCub::interactionForces::PinchResult;
+using iCub::interactionForces::OnsetDetector;
+using iCub::interactionForces::ContactOnset;
+using iCub::interactionForces::ContactSource;
+using iCub::interactionForces::StallDetector;
+using iCub::interactionForces::LagMonitor;
+using iCub::interactionForces::LagJob;
+using iCub::interactionForces::SkinForceEstimator;
+using iCub::interactionForces::SkinCompensator;
+using iCub::interactionForces::SegmentIndex;
+using iCub::interactionForces::StreamWatchdog;
+using iCub::interactionForces::VisualFeed;
+using iCub::interactionForces::ExperimentConfig;
+using iCub::interactionForces::Campaign;
+using iCub::interactionForces::CampaignRun;
+using iCub::interactionForces::PinchPhase;
+using iCub::interactionForces::PHASE_PRESS;
+using iCub::interactionForces::PHASE_HOLD;
+using iCub::interactionForces::PHASE_RAISE;
+using iCub::interactionForces::PHASE_REST;
 
 using std::stringstream;
 using std::string;
@@ -55,9 +101,44 @@ FingerForceModule::FingerForceModule()
     dbgTag = "FingerForceModule: ";
 
     closing = false;
+    useRealTime = false;
+    rtPriority = 0;
+    rtCpu = -1;
+    clock = NULL;
+    thGaze = NULL;
+    poseService = NULL;
+    sensorHub = NULL;
+    jointCache = NULL;
+    pinchMonitor = NULL;
+    segmentIndex = NULL;
+    pipeline = NULL;
+    resultWriter = NULL;
+    watchdog = NULL;
+    visualFeed = NULL;
+    slipDetector = NULL;
+    onsetDetector = NULL;
+    stallDetector = NULL;
+    nPinchOnsets = 0;
+    lagMonitor = NULL;
+    skinForce = NULL;
+    skinCompensator = NULL;
+    simHand = NULL;
+    iPos = NULL;
+    iEncs = NULL;
+    iCtrl = NULL;
+    iImp = NULL;
     
     // Experiment parameters
     pinchCounter = 0;
+    pinchNumber = 0;
+
+    contactHold = false;
+    holdCount = 0;
+    holdErrorSum = 0.0;
+    holdErrorMax = 0.0;
+    loadedCount = 0;
+    loadedSum = 0.0;
+    loadedSumSq = 0.0;
 }
 /* *********************************************************************************************************************** */
 
@@ -76,7 +157,28 @@ double FingerForceModule::getPeriod() { return period; }
 
 /* *********************************************************************************************************************** */
 /* ******* Update    module                                                 ********************************************** */   
-bool FingerForceModule::updateModule() { return true; }
+bool FingerForceModule::updateModule() {
+    // Campaign runs are executed back to back
+    CampaignRun run;
+    while (!closing && campaign.next(run)) {
+        executeRun(run);
+    }
+
+    if (campaign.finish(run)) {
+        // Restore the parameters and the pose in use before the campaign
+        ClockParticipant participant(clock);
+        motionMutex.lock();
+        if (!setupRun(run)) {
+            cerr << dbgTag << "Could not restore the pose in use before the campaign. \n";
+        }
+        switchIndex("after_" + run.campaign);
+        resultSession = baseSession;
+        motionMutex.unlock();
+        cout << dbgTag << "Campaign queue complete. \n";
+    }
+
+    return true;
+}
 /* *********************************************************************************************************************** */
 
 
@@ -84,7 +186,6 @@ bool FingerForceModule::updateModule() { return true; }
 /* ******* Configure module                                                 ********************************************** */   
 bool FingerForceModule::configure(ResourceFinder &rf) {
     using std::vector;
-    using yarp::os::Time;
 
     cout << dbgTag << "Starting. \n";
 
@@ -95,8 +196,17 @@ bool FingerForceModule::configure(ResourceFinder &rf) {
     period = rf.check("period", 1.0, "The module period").asDouble();
     robotName = rf.check("robot", Value("icub"), "The robot name.").asString().c_str();
     whichArm = rf.check("whichArm", Value("right"), "The arm to use.").asString().c_str();
+    useGaze = rf.check("useGaze", Value(true), "Set to true to track the hand with the gaze.").asBool();
     string portNameRoot = "/" + moduleName + "/";
 
+    // Module clock
+    string clockType = rf.check("clock", Value("real"), "The clock type (real|sim).").asString().c_str();
+    clock = Clock::create(clockType);
+    if (clock == NULL) {
+        cerr << dbgTag << "Unknown clock type: " << clockType << ". Expecting real or sim. \n";
+        return false;
+    }
+
     // Robot home position
     Bottle parGroup = rf.findGroup("home");
     homePos.resize(16, 0.0);
@@ -137,6 +247,25 @@ bool FingerForceModule::configure(ResourceFinder &rf) {
         return false;
     }
 
+    // Homing only moves the joints away from the home position
+    homeTolerance.resize(homePos.size(), 1.0);
+    Value tolerance = parGroup.check("tolerance", Value(1.0), "Home position tolerance in degrees, one value or one per joint.");
+    if (tolerance.isList()) {
+        Bottle *tolerances = tolerance.asList();
+        if ((size_t) tolerances->size() != homePos.size()) {
+            cerr << dbgTag << "Invalid home tolerance size. Expecting a list of size " << homePos.size() << ". \n";
+            return false;
+        }
+        for (int i = 0; i < tolerances->size(); ++i) {
+            homeTolerance[i] = tolerances->get(i).asDouble();
+        }
+    } else {
+        homeTolerance.assign(homePos.size(), tolerance.asDouble());
+    }
+    homeMaxAge = parGroup.check("maxAge", Value(0.1), "Maximum age of the cached joint positions in seconds.").asDouble();
+    homePoll = parGroup.check("poll", Value(0.01), "Homing motion polling period in seconds.").asDouble();
+    homeTimeout = parGroup.check("timeout", Value(10.0), "Homing motion timeout in seconds.").asDouble();
+
 #ifndef NODEBUG
     cout << "\n";
     cout << "DEBUG: " << dbgTag << "Experiment home position for the arm is: ";
@@ -148,58 +277,52 @@ bool FingerForceModule::configure(ResourceFinder &rf) {
 
 
     // Experiment configuration
+    configFile = rf.findFile("from").c_str();
     parGroup = rf.findGroup("experiment");
-    if (!parGroup.isNull()) {
-        nPinches = parGroup.check("nPinches", 10, "Number of pinchings per sequence.").asInt();
-        pinchIncrement = parGroup.check("pinchIncrement", 1, "Position increment for each pinch.").asInt();
-        pinchDuration = parGroup.check("pinchDuration", 5, "Duration of a single pinch.").asInt();
-        pinchDelay = parGroup.check("pinchDelay", 5, "Delay between pinches.").asInt();
-        progressiveDepth = parGroup.check("progressiveDepth", false, "Set to true to progressively increase pinching depth.").asBool();
-        useThumb = parGroup.check("useThumb", false, "Set to true to use the thumb when pinching.").asBool();
-    } else {
-        nPinches = 10;
-        pinchIncrement = 1;
-        pinchDuration = 5;
-        pinchDelay = 5;
-        progressiveDepth = false;
-        useThumb = false;
+    profileType = parGroup.check("profile", Value("none"), "The continuous depth profile type.").asString().c_str();
+    if (!ExperimentConfig::read(parGroup, rf.findGroup("finger"), params)) {
+        cerr << dbgTag << "Invalid experiment parameters. \n";
+        return false;
+    }
+    // Seed the staged copy edited over RPC
+    experimentConfig.stage(params);
+    experimentConfig.fetch(params);
+
+    // Continuous depth profile
+    profileGroup = rf.findGroup("profile");
+    if (profileType != "none") {
+        DepthProfile *profile = DepthProfile::create(profileType, profileGroup);
+        if (profile == NULL) {
+            cerr << dbgTag << "Invalid depth profile configuration. \n";
+            return false;
+        }
+        delete profile;
     }
 
 #ifndef NODEBUG
     cout << "\n";
     cout << "DEBUG: " << dbgTag << "Experiment parameters are: \n";
-    cout << "DEBUG: " << dbgTag << "\t" << "nPinches: " << nPinches << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "pinchIncrement " << pinchIncrement << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "pinchDuration " << pinchDuration << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "pinchDelay " << pinchDelay << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "progressiveDepth "  << std::boolalpha << progressiveDepth << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "useThumb " << useThumb << std::noboolalpha << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "nPinches: " << params.nPinches << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "pinchIncrement " << params.pinchIncrement << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "pinchDuration " << params.pinchDuration << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "pinchDelay " << params.pinchDelay << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "progressiveDepth "  << std::boolalpha << params.progressiveDepth << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "useThumb " << params.useThumb << std::noboolalpha << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "profile " << profileType << "\n";
     cout << "\n";
 #endif
     
 
-    // Pinching parameters
-    parGroup = rf.findGroup("finger");
-    if (!parGroup.isNull()) {
-        finger.joint = parGroup.check("joint", 11).asInt();
-        finger.startPos = parGroup.check("startPos", 0.0).asDouble();
-        finger.pinchPos = parGroup.check("pinchPos", 20.0).asDouble();
-    } else {
-        finger.joint = 11;
-        finger.startPos = 0;
-        finger.pinchPos = 20;
-    }
-
     // Initialise previous depth
     previousDepth.resize(2, 0.0);
     previousDepth[0] = homePos[9];
-    previousDepth[1] = finger.startPos;
+    previousDepth[1] = params.finger.startPos;
 
 #ifndef NODEBUG
     cout << "DEBUG: " << dbgTag << "Pinching parameters are: \n";
-    cout << "DEBUG: " << dbgTag << "\t" << "finger.joint: " << finger.joint << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "finger.startPos " << finger.startPos << "\n";
-    cout << "DEBUG: " << dbgTag << "\t" << "finger.pinchPos " << finger.pinchPos << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "finger.joint: " << params.finger.joint << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "finger.startPos " << params.finger.startPos << "\n";
+    cout << "DEBUG: " << dbgTag << "\t" << "finger.pinchPos " << params.finger.pinchPos << "\n";
     cout << "\n";
 #endif
 
@@ -212,20 +335,49 @@ bool FingerForceModule::configure(ResourceFinder &rf) {
     
         
     /* ****** Position control stuff for hand                       ****** */
-    Property options;
-    options.put("device", "remote_controlboard");
-    options.put("local", (portNameRoot + "position_client/" + whichArm + "_arm").c_str());               
-    options.put("remote", ("/" + robotName + "/" + whichArm + "_arm").c_str());
-    if (!clientPos.open(options)) {
-        return false;
-    }
-    // Open the views
-    clientPos.view(iPos);
-    if (iPos == 0) {
-        return false;
+    parGroup = rf.findGroup("plant");
+    string plantType = parGroup.check("type", Value("real"), "The plant type (real|sim).").asString().c_str();
+    if (plantType == "sim") {
+        // In-process simulated hand
+        cout << dbgTag << "Using the simulated hand plant. \n";
+        simHand = new SimulatedHand(clock);
+        if (!simHand->configure(parGroup, homePos)) {
+            return false;
+        }
+        iPos = simHand;
+        iEncs = simHand;
+        iCtrl = simHand;
+        iImp = simHand;
+    } else {
+        Property options;
+        options.put("device", "remote_controlboard");
+        options.put("local", (portNameRoot + "position_client/" + whichArm + "_arm").c_str());               
+        options.put("remote", ("/" + robotName + "/" + whichArm + "_arm").c_str());
+        if (!clientPos.open(options)) {
+            return false;
+        }
+        // Open the views
+        clientPos.view(iPos);
+        if (iPos == 0) {
+            return false;
+        }
+        clientPos.view(iEncs);
+        if (iEncs == 0) {
+            return false;
+        }
+        // The compliant interfaces are optional
+        clientPos.view(iCtrl);
+        clientPos.view(iImp);
     }
-    clientPos.view(iEncs);
-    if (iEncs == 0) {
+
+    // Compliant pinching
+    parGroup = rf.findGroup("impedance");
+    compliantPinch = parGroup.check("enable", Value(false), "Set to true to press and hold in impedance mode.").asBool();
+    fingerStiffness = parGroup.check("fingerStiffness", Value(0.3), "Finger joint stiffness.").asDouble();
+    fingerDamping = parGroup.check("fingerDamping", Value(0.01), "Finger joint damping.").asDouble();
+    thumbStiffness = parGroup.check("thumbStiffness", Value(0.3), "Thumb joint stiffness.").asDouble();
+    thumbDamping = parGroup.check("thumbDamping", Value(0.01), "Thumb joint damping.").asDouble();
+    if (compliantPinch && !setupCompliance()) {
         return false;
     }
     int jnts = 0;
@@ -250,20 +402,279 @@ bool FingerForceModule::configure(ResourceFinder &rf) {
 #ifndef NODEBUG
         cout << "DEBUG: " << dbgTag << "Encoder data is not available yet. \n";
 #endif
-        Time::delay(0.1);
+        clock->delay(0.1);
+    }
+
+    // Control path buffers, allocated once
+    controlPosition.resize(jnts);
+    controlTarget.resize(jnts);
+    controlState.resize(jnts);
+    movingJoints.reserve(jnts);
+
+    // Real-time execution of the control path
+    parGroup = rf.findGroup("realtime");
+    useRealTime = parGroup.check("enable", Value(false), "Set to true to run the control path in real-time mode.").asBool();
+    rtPriority = parGroup.check("priority", Value(0), "SCHED_FIFO priority of the control path, 0 for the default scheduling.").asInt();
+    rtCpu = parGroup.check("cpu", Value(-1), "CPU of the control path, -1 for any.").asInt();
+    if (useRealTime) {
+        if (parGroup.check("lockMemory", Value(true), "Set to true to lock the module memory.").asBool()) {
+            RealTime::lockMemory();
+        }
+        if (!controlLog.start(parGroup.check("logSize", Value(256), "Number of queued log lines of the control path.").asInt())) {
+            return false;
+        }
     }
 
     // Put arm in position
-    reachArm();
+    if (!reachArm()) {
+        return false;
+    }
+
+
+    /* ******* Stream transport.                                    ******* */
+    parGroup = rf.findGroup("transport");
+    string carrier = parGroup.check("carrier", Value("udp"), "Network carrier of the input streams.").asString().c_str();
+    bool useShmem = parGroup.check("shmem", Value(true), "Set to true to read the co-located producers over shared memory.").asBool();
+
+
+    /* ******* Hand pose cache.                                     ******* */
+    poseService = new PoseService(clock, rf.findGroup("gaze").check("velocityFilter", Value(0.3), "Hand velocity filter coefficient.").asDouble());
+    if (!poseService->open(portNameRoot + "pose:i", "/" + robotName + "/cartesianController/" + whichArm + "_arm/state:o", carrier,
+                useShmem)) {
+        cout << dbgTag << "Could not open the hand pose port. \n";
+        return false;
+    }
+
+
+    /* ******* Sensor streams.                                      ******* */
+    sensorHub = new SensorHub(clock);
+
+    // Arm joint positions
+    jointCache = new JointCache(clock);
+    sensorHub->addListener(jointCache);
+
+    // Skin drift compensation
+    parGroup = rf.findGroup("compensation");
+    if (parGroup.check("enable", Value(false), "Set to true to compensate the raw skin within the module.").asBool()) {
+        skinCompensator = new SkinCompensator(sensorHub);
+        if (!skinCompensator->configure(parGroup, portNameRoot + "skinComp:o")) {
+            cout << dbgTag << "Could not configure the skin compensator. \n";
+            return false;
+        }
+        sensorHub->addListener(skinCompensator);
+    }
+
+    // Per-pinch metrics
+    pinchMonitor = new PinchMonitor(params.finger.joint, params.finger.fingertips);
+    sensorHub->addListener(pinchMonitor);
+
+    // Pinch segment index
+    parGroup = rf.findGroup("index");
+    if (parGroup.check("enable", Value(false), "Set to true to write the pinch segment index.").asBool()) {
+        std::vector<string> streamNames;
+        std::vector<string> streamPaths;
+        Bottle *streams = parGroup.find("streams").asList();
+        if (streams != NULL) {
+            for (int i = 0; i < streams->size(); ++i) {
+                Bottle *stream = streams->get(i).asList();
+                if ((stream == NULL) || (stream->size() != 2)) {
+                    cerr << dbgTag << "Invalid index stream, expected (name path). \n";
+                    return false;
+                }
+                streamNames.push_back(stream->get(0).asString().c_str());
+                streamPaths.push_back(stream->get(1).asString().c_str());
+            }
+        }
+        segmentIndex = new SegmentIndex();
+        indexFile = parGroup.check("file", Value("pinchIndex.log"), "The pinch index file.").asString().c_str();
+        indexStreams = streamNames;
+        indexPaths = streamPaths;
+        if (!segmentIndex->create(indexFile, streamNames, streamPaths, clock)) {
+            return false;
+        }
+    }
+
+    // Bookkeeping pipeline
+    parGroup = rf.findGroup("pipeline");
+    usePipeline = parGroup.check("enable", Value(true), "Set to true to run the per-pinch bookkeeping on a worker thread.").asBool();
+    int queueSize = parGroup.check("queueSize", Value(8), "Maximum number of queued bookkeeping jobs.").asInt();
+    pipeline = new PinchPipeline(queueSize);
+    // Enough jobs of each type for a full queue, the job being executed and the one being filled
+    summaryJobs.fill<PinchSummaryJob>(queueSize + 2);
+    segmentJobs.fill<SegmentJob>(queueSize + 2);
+    lagJobs.fill<LagJob>(queueSize + 2);
+    onsetJobs.fill<OnsetReportJob>(queueSize + 2);
+    // At most one flush and one index close per sequence or campaign run
+    flushJobs.fill<ResultFlushJob>(2);
+    closeJobs.fill<IndexCloseJob>(2);
+
+    // Results store
+    parGroup = rf.findGroup("results");
+    if (parGroup.check("enable", Value(false), "Set to true to append the pinch results to the results store.").asBool()) {
+        resultSession = parGroup.check("session", Value(""), "The session label, default module, arm and start time.").asString().c_str();
+        if (resultSession.empty()) {
+            time_t now = time(NULL);
+            struct tm date;
+            localtime_r(&now, &date);
+            char stamp[32];
+            strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &date);
+            resultSession = moduleName + "_" + whichArm + "_" + stamp;
+        }
+        baseSession = resultSession;
+        resultWriter = new ResultWriter();
+        if (!resultWriter->open(parGroup.check("dir", Value("/var/usr/fg/data/results"), "The results store directory.").asString().c_str(),
+                    moduleName, parGroup.check("blockRows", Value(1000), "Maximum number of buffered results.").asInt())) {
+            return false;
+        }
+    }
+
+    // Slip detection
+    parGroup = rf.findGroup("slip");
+    useSlip = parGroup.check("enable", Value(false), "Set to true to monitor slip while holding a pinch.").asBool();
+    slipCorrection = parGroup.check("correction", Value(0.0), "Finger depth correction for each slip event.").asDouble();
+    maxSlipCorrection = parGroup.check("maxCorrection", Value(5.0), "Maximum finger depth correction per pinch.").asDouble();
+    if (useSlip) {
+        slipDetector = new SlipDetector();
+        if (!slipDetector->configure(parGroup, portNameRoot + "slip:o")) {
+            cout << dbgTag << "Could not configure the slip detector. \n";
+            return false;
+        }
+        sensorHub->addListener(slipDetector);
+    }
+
+    // Contact onsets
+    parGroup = rf.findGroup("onset");
+    if (parGroup.check("enable", Value(false), "Set to true to estimate the contact onsets.").asBool()) {
+        onsetDetector = new OnsetDetector();
+        if (!onsetDetector->configure(parGroup, portNameRoot + "onset:o")) {
+            cout << dbgTag << "Could not configure the onset detector. \n";
+            return false;
+        }
+        sensorHub->addListener(onsetDetector);
+        contactSources.push_back(onsetDetector);
+    }
+
+    // Encoder stalls
+    parGroup = rf.findGroup("stall");
+    if (parGroup.check("enable", Value(false), "Set to true to detect the contacts from the stalls of the pinching joints.").asBool()) {
+        stallDetector = new StallDetector();
+        if (!stallDetector->configure(parGroup, portNameRoot + "stall:o", params.finger.joint)) {
+            cout << dbgTag << "Could not configure the stall detector. \n";
+            return false;
+        }
+        sensorHub->addListener(stallDetector);
+        contactSources.push_back(stallDetector);
+    }
+
+    // Hold timing
+    parGroup = rf.findGroup("hold");
+    string holdAnchor = parGroup.check("anchor", Value("motion"), "Start of the hold: motion (end of the press motion) or contact.").asString().c_str();
+    if ((holdAnchor != "motion") && (holdAnchor != "contact")) {
+        cerr << dbgTag << "Unknown hold anchor " << holdAnchor << ", expected motion or contact. \n";
+        return false;
+    }
+    contactHold = (holdAnchor == "contact");
+    contactTimeout = parGroup.check("contactTimeout", Value(5.0), "Maximum time from the start of the press to the contact.").asDouble();
+    contactPoll = parGroup.check("poll", Value(0.001), "Contact polling period in seconds.").asDouble();
+    if (contactHold && contactSources.empty()) {
+        cerr << dbgTag << "The contact anchored hold needs a contact detector, enable [onset] or [stall]. \n";
+        return false;
+    }
+
+    // Skin lag
+    parGroup = rf.findGroup("lag");
+    if (parGroup.check("enable", Value(false), "Set to true to estimate the skin to nano17 lag of each pinch.").asBool()) {
+        lagMonitor = new LagMonitor();
+        if (!lagMonitor->configure(parGroup, portNameRoot + "lag:o", params.finger.fingertips)) {
+            cout << dbgTag << "Could not configure the lag monitor. \n";
+            return false;
+        }
+        sensorHub->addListener(lagMonitor);
+    }
+
+    // Skin force calibration
+    parGroup = rf.findGroup("calibration");
+    string calibrationFile = parGroup.check("file", Value(""), "The skin to force models written by calibrationFit.").asString().c_str();
+    if (!calibrationFile.empty()) {
+        skinForce = new SkinForceEstimator();
+        if (!skinForce->configure(rf.findFile(calibrationFile.c_str()).c_str(), portNameRoot + "skinForce:o")) {
+            cout << dbgTag << "Could not load the skin force calibration. \n";
+            return false;
+        }
+        sensorHub->addListener(skinForce);
+    }
+
+    // Synchronised pinching
+    parGroup = rf.findGroup("sync");
+    useSync = parGroup.check("enable", Value(false), "Set to true to synchronise the arrival of the pinching joints.").asBool();
+    syncSpeed = parGroup.check("speed", Value(50.0), "Reference speed of the longest pinching move in deg/s.").asDouble();
+    syncMinSpeed = parGroup.check("minSpeed", Value(1.0), "Minimum reference speed of a pinching joint in deg/s.").asDouble();
+    syncPoll = parGroup.check("poll", Value(0.01), "Arrival polling period in seconds.").asDouble();
+    syncTimeout = parGroup.check("timeout", Value(10.0), "Synchronised move timeout in seconds.").asDouble();
+    syncTolerance = parGroup.check("tolerance", Value(0.5), "Arrival tolerance in degrees.").asDouble();
+    resetSyncStats();
+
+    // Stream health watchdog
+    parGroup = rf.findGroup("watchdog");
+    pauseOnFault = parGroup.check("pauseOnFault", Value(false), "Set to true to pause pinching while a stream is faulty.").asBool();
+    if (parGroup.check("enable", Value(true), "Set to true to monitor the sensor streams.").asBool()) {
+        watchdog = new StreamWatchdog(parGroup.check("period", Value(250), "Health check period in ms.").asInt(), clock);
+        if (!watchdog->configure(parGroup, portNameRoot + "health:o")) {
+            return false;
+        }
+        sensorHub->addListener(watchdog);
+    }
+
+    // Decimated feed for the port scopes
+    parGroup = rf.findGroup("scope");
+    if (parGroup.check("enable", Value(false), "Set to true to publish the decimated feed for the port scopes.").asBool()) {
+        visualFeed = new VisualFeed(parGroup.check("period", Value(50), "Display period in ms.").asInt(), clock);
+        if (!visualFeed->configure(parGroup, portNameRoot + "scope:o")) {
+            return false;
+        }
+        sensorHub->addListener(visualFeed);
+    }
+
+    if (simHand) {
+        int samplePeriod = rf.findGroup("plant").check("samplePeriod", Value(10), "Simulated sensor sampling period in ms.").asInt();
+        if (!sensorHub->openSimulated(simHand, samplePeriod)) {
+            return false;
+        }
+    } else {
+        if (!sensorHub->open(portNameRoot, robotName, whichArm, carrier, useShmem)) {
+            cout << dbgTag << "Could not open the sensor ports. \n";
+            return false;
+        }
+    }
 
 
     /* ******* Start threads.                                       ******* */
-    // Gaze thread
-    thGaze = new GazeThread(100, rf);
-    if (!thGaze->start()) {
-        cout << dbgTag << "Could not start the gaze thread. \n";
+    // Bookkeeping thread
+    if (usePipeline && !pipeline->start()) {
+        cout << dbgTag << "Could not start the bookkeeping thread. \n";
         return false;
     }
+
+    // Watchdog thread
+    if (watchdog && !watchdog->start()) {
+        cout << dbgTag << "Could not start the watchdog thread. \n";
+        return false;
+    }
+
+    // Port scope feed thread
+    if (visualFeed && !visualFeed->start()) {
+        cout << dbgTag << "Could not start the port scope feed thread. \n";
+        return false;
+    }
+
+    // Gaze thread
+    if (useGaze) {
+        thGaze = new GazeThread(100, rf, clock, poseService);
+        if (!thGaze->start()) {
+            cout << dbgTag << "Could not start the gaze thread. \n";
+            return false;
+        }
+    }
     
     cout << dbgTag << "Started correctly. \n";
 
@@ -284,7 +695,85 @@ bool FingerForceModule::close() {
     RPCFingertipsCmd.close();
 
     // Stop threads
-    thGaze->stop();
+    if (thGaze) {
+        thGaze->stop();
+        delete thGaze;
+        thGaze = NULL;
+    }
+    if (poseService) {
+        poseService->close();
+        delete poseService;
+        poseService = NULL;
+    }
+    if (sensorHub) {
+        sensorHub->close();
+        delete sensorHub;
+        sensorHub = NULL;
+    }
+    delete jointCache;
+    jointCache = NULL;
+    if (watchdog) {
+        watchdog->stop();
+        watchdog->close();
+        delete watchdog;
+        watchdog = NULL;
+    }
+    if (visualFeed) {
+        visualFeed->stop();
+        visualFeed->close();
+        delete visualFeed;
+        visualFeed = NULL;
+    }
+    if (pipeline) {
+        // Flush the pending bookkeeping before closing the index
+        pipeline->stop();
+        delete pipeline;
+        pipeline = NULL;
+    }
+    if (resultWriter) {
+        resultWriter->close();
+        delete resultWriter;
+        resultWriter = NULL;
+    }
+    controlLog.stop();
+    delete pinchMonitor;
+    pinchMonitor = NULL;
+    if (segmentIndex) {
+        segmentIndex->close();
+        delete segmentIndex;
+        segmentIndex = NULL;
+    }
+    if (slipDetector) {
+        slipDetector->close();
+        delete slipDetector;
+        slipDetector = NULL;
+    }
+    if (onsetDetector) {
+        onsetDetector->close();
+        delete onsetDetector;
+        onsetDetector = NULL;
+    }
+    if (stallDetector) {
+        stallDetector->close();
+        delete stallDetector;
+        stallDetector = NULL;
+    }
+    contactSources.clear();
+    if (lagMonitor) {
+        lagMonitor->close();
+        delete lagMonitor;
+        lagMonitor = NULL;
+    }
+    if (skinForce) {
+        skinForce->close();
+        delete skinForce;
+        skinForce = NULL;
+    }
+    if (skinCompensator) {
+        skinCompensator->close();
+        delete skinCompensator;
+        skinCompensator = NULL;
+    }
     
     // Restore initial robot position
     if (iPos) {
@@ -295,6 +784,13 @@ bool FingerForceModule::close() {
 
     // Cartesian controller
     clientPos.close();
+    delete simHand;
+    simHand = NULL;
+
+    delete clock;
+    clock = NULL;
+    iPos = NULL;
+    iEncs = NULL;
 
     cout << dbgTag << "Closed. \n";
 
@@ -313,6 +809,37 @@ bool FingerForceModule::interruptModule() {
     skinManagerHandL.interrupt();
     skinManagerHandR.interrupt();
     RPCFingertipsCmd.interrupt();
+    campaign.stop();
+    if (poseService) {
+        poseService->interrupt();
+    }
+    if (sensorHub) {
+        sensorHub->interrupt();
+    }
+    if (watchdog) {
+        watchdog->interrupt();
+    }
+    if (visualFeed) {
+        visualFeed->interrupt();
+    }
+    if (slipDetector) {
+        slipDetector->interrupt();
+    }
+    if (onsetDetector) {
+        onsetDetector->interrupt();
+    }
+    if (stallDetector) {
+        stallDetector->interrupt();
+    }
+    if (lagMonitor) {
+        lagMonitor->interrupt();
+    }
+    if (skinForce) {
+        skinForce->interrupt();
+    }
+    if (skinCompensator) {
+        skinCompensator->interrupt();
+    }
 
     cout << dbgTag << "Interrupted. \n";
 
@@ -324,18 +851,31 @@ bool FingerForceModule::interruptModule() {
 /* *********************************************************************************************************************** */
 /* ******* Place arm in grasping position                                   ********************************************** */ 
 bool FingerForceModule::reachArm(void) {
+    ClockParticipant participant(clock);
+
     cout << dbgTag << "Reaching for pinch ... \n";
-    
-    iPos->stop();
 
-    // Set the arm in the starting position
-    // Arm
-    iPos->positionMove(&homePos[0]);
-    // Hand
-    open();
+    // Set the arm in the starting position, with the pinching finger open
+    Vector &target = controlTarget;
+    for (size_t i = 0; i < homePos.size(); ++i) {
+        target[i] = homePos[i];
+    }
+    target[params.finger.joint] = params.finger.startPos;
+    if (!selectJoints(target, 0, homePos.size())) {
+        cerr << dbgTag << "Could not reach for pinch, the arm pose is unknown. \n";
+        return false;
+    }
+    if (movingJoints.empty()) {
+        // Do not interrupt a motion in progress when already in place
+        cout << dbgTag << "Already in place. \n";
+        return true;
+    }
 
-    // Check motion done
-    waitMoveDone(10, 1);
+    iPos->stop();
+    if (!commandJoints(target)) {
+        cerr << dbgTag << "Could not reach for pinch. \n";
+        return false;
+    }
     cout << dbgTag << "Done. \n";
 
     return true;
@@ -346,43 +886,28 @@ bool FingerForceModule::reachArm(void) {
 /* *********************************************************************************************************************** */
 /* ******* Open the hand.                                                   ********************************************** */
 bool FingerForceModule::open(void) {
-    
-    // Create position vector
-    int joints;
-    iPos->getAxes(&joints);
-    Vector position(joints);
-    iEncs->getEncoders(position.data());
-
-#ifndef NODEBUG
-    cout << "DEBUG: " << dbgTag << "Hand joint position is: \t";
-    for (size_t i = 0; i < position.size(); ++i) {
-        cout << position[i] << " ";
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
     }
-    cout << "\n";
-#endif
 
-    // Open hand
-    for (size_t i = 7; i < homePos.size(); ++i) {
-        if ((int) i == finger.joint) {
-            position[i] = finger.startPos;
-        } else {
-            position[i] = homePos[i];
-        }
-    }
-    iPos->positionMove(position.data());
-    // Check motion done
-    waitMoveDone(10, 1);
+    ClockParticipant participant(clock);
+    motionMutex.lock();
+    bool ok = openHand();
+    motionMutex.unlock();
 
-#ifndef NODEBUG
-    iEncs->getEncoders(position.data());
-    cout << "DEBUG: " << dbgTag << "Hand joint position reached: \t";
-    for (size_t i = 0; i < position.size(); ++i) {
-        cout << position[i] << " ";
+    return ok;
+}
+
+bool FingerForceModule::openHand(void) {
+    // Open hand
+    Vector &target = controlTarget;
+    for (size_t i = 0; i < homePos.size(); ++i) {
+        target[i] = homePos[i];
     }
-    cout << "\n";
-#endif
+    target[params.finger.joint] = params.finger.startPos;
 
-    return true;
+    return moveJoints(target, 7, homePos.size());
 }
 /* *********************************************************************************************************************** */
 
@@ -390,73 +915,201 @@ bool FingerForceModule::open(void) {
 /* *********************************************************************************************************************** */
 /* ******* Execute a pinching.                                               ********************************************** */
 bool FingerForceModule::pinch(void) {
-    using yarp::os::Time;
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    ClockParticipant participant(clock);
+    RealTimeScope realTime(useRealTime, rtPriority, rtCpu);
+    motionMutex.lock();
+    bool ok = pinchOnce();
+    motionMutex.unlock();
+
+    return ok;
+}
+
+bool FingerForceModule::pinchOnce(void) {
+    ClockParticipant participant(clock);
+
+    // Parameter changes are only applied between pinches
+    applyParams();
+
+    // Do not pinch on faulty sensor streams
+    if (!waitHealthy()) {
+        return false;
+    }
 
     // Get current limb position
-    int njoints;
-    iPos->getAxes(&njoints);
-    Vector position(njoints);
+    Vector &position = controlPosition;
     iEncs->getEncoders(position.data());
+    int index = pinchNumber++;
 
 #if !defined(NODEBUG) || (FINGER_FORCE_DEBUG)
-    cout << "DEBUG: " << dbgTag << "Starting limb position: " << position[finger.joint] << ", "
-        << "Previous depth: ";
-    cout << "Thumb (" << previousDepth[0] << ")\t Finger: (" << previousDepth[1] << ") \n";
+    controlLog.print("DEBUG: %sStarting limb position: %g, Previous depth: Thumb (%g)\t Finger: (%g) \n", dbgTag.c_str(),
+            position[params.finger.joint], previousDepth[0], previousDepth[1]);
 #endif
 
     // Check for progressive pinching depth
-    if (progressiveDepth) {
+    if (params.progressiveDepth) {
 #if !defined(NODEBUG) || (FINGER_FORCE_DEBUG)
-        cout << "DEBUG: " << dbgTag << "Performing pinch number: " << pinchCounter << "\n";
+        controlLog.print("DEBUG: %sPerforming pinch number: %d\n", dbgTag.c_str(), pinchCounter);
 #endif
-        if ((pinchCounter >= 0) && (pinchCounter < nPinches/2)) {
+        if ((pinchCounter >= 0) && (pinchCounter < params.nPinches/2)) {
             // First half of pinching sequence 
-            position[finger.joint] = previousDepth[1] + pinchIncrement;    // Increment depth wrt previous depth
-            previousDepth[1] = position[finger.joint];                  // Store previous depth
+            position[params.finger.joint] = previousDepth[1] + params.pinchIncrement;    // Increment depth wrt previous depth
+            previousDepth[1] = position[params.finger.joint];                  // Store previous depth
             checkUseThumb(true, position);
-        } else if (pinchCounter == nPinches/2) {
+        } else if (pinchCounter == params.nPinches/2) {
             // Midpoint of sequence
-            position[finger.joint] = previousDepth[1];
-        } else if ((pinchCounter >= nPinches/2) && (pinchCounter < nPinches)) {
+            position[params.finger.joint] = previousDepth[1];
+        } else if ((pinchCounter >= params.nPinches/2) && (pinchCounter < params.nPinches)) {
             // Second half of pinching sequence
-            position[finger.joint] = previousDepth[1] - pinchIncrement;    // Decrement depth wrt previous depth
-            previousDepth[1] = position[finger.joint];                  // Store previous depth
+            position[params.finger.joint] = previousDepth[1] - params.pinchIncrement;    // Decrement depth wrt previous depth
+            previousDepth[1] = position[params.finger.joint];                  // Store previous depth
             checkUseThumb(true, position);
         }
 
         pinchCounter++;       // Increment pinchcounter
     } else {
-        position[finger.joint] = finger.startPos + pinchIncrement;      // Increment depth wrt previous depth
+        position[params.finger.joint] = params.finger.startPos + params.pinchIncrement;      // Increment depth wrt previous depth
     }
 
     
-    cout << dbgTag << "Pinching depth is: " << position[finger.joint] << "\n";
+    controlLog.print("%sPinching depth is: %g\n", dbgTag.c_str(), position[params.finger.joint]);
 
     // Pinch
-    cout << dbgTag << "Pinching ...... ";
-    iPos->positionMove(position.data());
-    // Check motion done
-    waitMoveDone(10, 1);
+    pinchMonitor->begin(index, clock->now());
+    for (size_t i = 0; i < contactSources.size(); ++i) {
+        contactSources[i]->arm(index);
+    }
+    if (lagMonitor) {
+        lagMonitor->begin();
+    }
+    controlLog.print("%sPinching ...... ", dbgTag.c_str());
+    if (compliantPinch) {
+        switchPinchMode(true);
+    }
+    double depth = position[params.finger.joint];
+    double thumbDepth = position[9];
+    double pressStart = clock->now();
+    markPhase(index, PHASE_PRESS, depth, thumbDepth, pressStart);
+    if (stallDetector) {
+        stallDetector->command(params.finger.joint, depth, clock->now());
+        if (params.useThumb) {
+            stallDetector->command(9, thumbDepth, clock->now());
+        }
+    }
+    if (useSync) {
+        syncMove(position, PHASE_PRESS);
+    } else {
+        iPos->positionMove(position.data());
+        // Check motion done, unless the hold starts at the contact
+        if (!contactHold) {
+            waitMoveDone(10, 1);
+        }
+    }
+
+    // The hold starts at the end of the press motion, or at the contact
+    double contact = 0.0;
+    bool touched = false;
+    if (contactHold) {
+        touched = waitContact(pressStart + contactTimeout, contact);
+        if (!touched) {
+            controlLog.print("%sNo contact detected, the hold starts at the end of the press motion. \n", dbgTag.c_str());
+            if (!useSync) {
+                waitMoveDone(10, 1);
+            }
+        }
+    }
+    double holdStart = touched ? contact : clock->now();
     iEncs->getEncoders(position.data());
-    cout << "Limb position reached: " << position[finger.joint] << "\n";
+    controlLog.print("Limb position reached: %g\n", position[params.finger.joint]);
     
     // dt pinch
-    Time::delay(pinchDuration);
+    markPhase(index, PHASE_HOLD, depth, thumbDepth, holdStart);
+    hold(holdStart, holdStart + params.pinchDuration, depth);
+    double holdEnd = clock->now();
+
+    // Contact onsets of the press and hold, reported once the finger is raised
+    if (!contactSources.empty()) {
+        for (size_t i = 0; i < contactSources.size(); ++i) {
+            contactSources[i]->disarm();
+        }
+        collectOnsets();
+        if (!touched) {
+            touched = getContactTime(pinchOnsets, nPinchOnsets, contact);
+        }
+    }
+
+    // Measured hold and loading durations
+    double holdTime = holdEnd - holdStart;
+    double holdError = fabs(holdTime - params.pinchDuration);
+    holdCount++;
+    holdErrorSum += holdError;
+    holdErrorMax = std::max(holdErrorMax, holdError);
+    if (touched) {
+        double loadedTime = holdEnd - contact;
+        loadedCount++;
+        loadedSum += loadedTime;
+        loadedSumSq += loadedTime * loadedTime;
+        controlLog.print("%sHold %.4f s, contact %.4f s into the press, loaded %.4f s. \n", dbgTag.c_str(), holdTime,
+                contact - pressStart, loadedTime);
+    } else {
+        controlLog.print("%sHold %.4f s. \n", dbgTag.c_str(), holdTime);
+    }
 
     // Raise -- move back to pre-pinching position
-    cout << dbgTag << "Raising ...... ";
-    position[finger.joint] = finger.startPos;       // Move finger
-    if (useThumb) {
+    controlLog.print("%sRaising ...... ", dbgTag.c_str());
+    if (compliantPinch) {
+        switchPinchMode(false);
+    }
+    position[params.finger.joint] = params.finger.startPos;       // Move finger
+    if (params.useThumb) {
         position[9] = homePos[9];
     }
 
     // Move
-    iPos->positionMove(position.data());
-    // Check motion done
-    waitMoveDone(10, 1);
+    markPhase(index, PHASE_RAISE, position[params.finger.joint], position[9]);
+    if (useSync) {
+        syncMove(position, PHASE_RAISE);
+    } else {
+        iPos->positionMove(position.data());
+        // Check motion done
+        waitMoveDone(10, 1);
+    }
+    endPhase();
 
     iEncs->getEncoders(position.data());
-    cout << "Limb position reached: " << position[finger.joint] << "\n";
+    controlLog.print("Limb position reached: %g\n", position[params.finger.joint]);
+    if (!contactSources.empty()) {
+        OnsetReportJob *onsetJob = onsetJobs.take<OnsetReportJob>();
+        onsetJob->setup(&onsetReport, pinchOnsets, nPinchOnsets);
+        pipeline->push(onsetJob);
+    }
+
+    // Pinch summary, finished off the control path
+    PinchSummaryJob *summaryJob = summaryJobs.take<PinchSummaryJob>();
+    summaryJob->setup(clock->now(), resultWriter);
+    if (resultWriter) {
+        PinchResult &result = summaryJob->getResult();
+        summaryJob->setContext(resultSession, whichArm, params);
+        result.value[iCub::interactionForces::RESULT_DEPTH] = depth;
+        result.value[iCub::interactionForces::RESULT_HOLD] = holdTime;
+        if (touched) {
+            result.value[iCub::interactionForces::RESULT_CONTACT] = contact - pressStart;
+            result.value[iCub::interactionForces::RESULT_LOADED] = holdEnd - contact;
+        }
+        result.setStamp(yarp::os::Time::now());
+    }
+    pinchMonitor->end(summaryJob->getMetrics());
+    pipeline->push(summaryJob);
+    if (lagMonitor) {
+        LagJob *lagJob = lagJobs.take<LagJob>();
+        lagJob->setup(lagMonitor, index);
+        lagMonitor->end(lagJob->getSignals());
+        pipeline->push(lagJob);
+    }
    
     return true;
 }
@@ -466,24 +1119,82 @@ bool FingerForceModule::pinch(void) {
 /* *********************************************************************************************************************** */
 /* ******* Execute a pinching.                                               ********************************************** */
 bool FingerForceModule::pinchseq() {
-    using yarp::os::Time;
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    ClockParticipant participant(clock);
+    RealTimeScope realTime(useRealTime, rtPriority, rtCpu);
+    motionMutex.lock();
+    bool ok = runSequence(false);
+    motionMutex.unlock();
+
+    return ok;
+}
+
+bool FingerForceModule::runSequence(const bool i_campaign) {
+    ClockParticipant participant(clock);
+
+    applyParams();
 
     // Sequence of pinchings
-    cout << dbgTag << "Executing a series of " << nPinches << " pinchings. \n";
+    cout << dbgTag << "Executing a series of " << params.nPinches << " pinchings. \n";
  
     connectDataDumper();
 
     // Reset pinchcounter
     pinchCounter = 0;
-    for (int i = 0; i < nPinches; ++i) {
+    resetSyncStats();
+    holdCount = 0;
+    holdErrorSum = 0.0;
+    holdErrorMax = 0.0;
+    loadedCount = 0;
+    loadedSum = 0.0;
+    loadedSumSq = 0.0;
+    for (int i = 0; (i < params.nPinches) && !closing; ++i) {
+        if (i_campaign && campaign.isStopping()) {
+            cout << dbgTag << "Campaign stopped after " << i << " pinches. \n";
+            break;
+        }
+        double start = clock->now();
+
         // Execute pinch
-        pinch();
+        if (!pinchOnce()) {
+            break;
+        }
         
         // Wait between taps
-        Time::delay(pinchDelay);
+        markPhase(pinchNumber - 1, PHASE_REST, params.finger.startPos, homePos[9]);
+        clock->delay(params.pinchDelay);
+        endPhase();
+
+        if (i_campaign) {
+            campaign.pinchDone(clock->now() - start);
+        }
+    }
+    if (resultWriter) {
+        ResultFlushJob *flushJob = flushJobs.take<ResultFlushJob>();
+        flushJob->setWriter(resultWriter);
+        pipeline->push(flushJob);
     }
 
     cout << dbgTag << "Pinching sequence complete. \n";
+    cout << dbgTag << "Bookkeeping pipeline: " << pipeline->getReport();
+    if (stallDetector) {
+        cout << dbgTag << "Encoder contact detection: " << stallDetector->getReport();
+    }
+    reportSyncStats();
+    if (holdCount > 0) {
+        cout << dbgTag << "Hold timing error over " << holdCount << " pinches: mean " << 1000.0 * holdErrorSum / holdCount
+            << " ms, max " << 1000.0 * holdErrorMax << " ms. \n";
+    }
+    if (loadedCount > 0) {
+        double mean = loadedSum / loadedCount;
+        double var = (loadedCount > 1) ? std::max(loadedSumSq - loadedCount * mean * mean, 0.0) / (loadedCount - 1) : 0.0;
+        cout << dbgTag << "Loaded duration over " << loadedCount << " contacts: mean " << mean << " s, std " << 1000.0 * sqrt(var)
+            << " ms. \n";
+    }
 
     disconnectDataDumper();
 
@@ -493,27 +1204,359 @@ bool FingerForceModule::pinchseq() {
 
 
 /* *********************************************************************************************************************** */
-/* ******* Reset the pinch counter.                                         ********************************************** */
-bool FingerForceModule::resetC(void) {
-    cout << dbgTag << "Resetting the pinch counter. \n";
-    pinchCounter = 0;
-    
+/* ******* Select the continuous depth profile.                             ********************************************** */
+bool FingerForceModule::setProfile(const string &type) {
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    if (type != "none") {
+        // Check that the profile can be built from the configuration
+        DepthProfile *profile = DepthProfile::create(type, profileGroup);
+        if (profile == NULL) {
+            return false;
+        }
+        delete profile;
+    }
+
+    cout << dbgTag << "Depth profile set to: " << type << "\n";
+    profileType = type;
+
     return true;
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* RPC Quit module                                                  ********************************************** */
-bool FingerForceModule::quit(void) {
-        return closing = true;
+/* ******* Get the continuous depth profile.                                ********************************************** */
+string FingerForceModule::getProfile(void) {
+    return profileType;
 }
 /* *********************************************************************************************************************** */
 
 
 /* *********************************************************************************************************************** */
-/* ******* Attach RPC port.                                                 ********************************************** */
-bool FingerForceModule::attach(yarp::os::RpcServer &source) {
+/* ******* Run the continuous depth profile.                                ********************************************** */
+bool FingerForceModule::runProfile(void) {
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    ClockParticipant participant(clock);
+    RealTimeScope realTime(useRealTime, rtPriority, rtCpu);
+    motionMutex.lock();
+
+    applyParams();
+
+    if (profileType == "none") {
+        cerr << dbgTag << "No depth profile selected. \n";
+        motionMutex.unlock();
+        return false;
+    }
+
+    DepthProfile *profile = DepthProfile::create(profileType, profileGroup);
+    if (profile == NULL) {
+        motionMutex.unlock();
+        return false;
+    }
+    double profilePeriod = profileGroup.check("period", Value(0.01), "Profile control period in seconds.").asDouble();
+    double thumbScale = profileGroup.check("thumbScale", Value(1.0), "Thumb depth relative to the finger depth.").asDouble();
+    double duration = profile->getDuration();
+    int nSamples = (int) floor(duration / profilePeriod) + 1;
+
+    cout << dbgTag << "Running " << profileType << " depth profile for " << duration << " s. \n";
+
+    connectDataDumper();
+
+    // The profile is indexed as a pinch, so that the skin compensation holds its baseline during the contact
+    int index = pinchNumber++;
+
+    // Stream the depth setpoints at the control rate
+    if (compliantPinch) {
+        switchPinchMode(true);
+    }
+    double start = clock->now();
+    markPhase(index, PHASE_PRESS, params.finger.startPos, homePos[9], start);
+    for (int k = 0; (k < nSamples) && !closing; ++k) {
+        double depth = profile->sample(k * profilePeriod);
+        iPos->positionMove(params.finger.joint, params.finger.startPos + depth);
+        if (params.useThumb) {
+            iPos->positionMove(9, homePos[9] + thumbScale * depth);
+        }
+
+        double tick = start + (k + 1) * profilePeriod;
+        clock->delay(tick - clock->now());
+        tickLatency.add(iCub::interactionForces::LOOP_PROFILE, tick, clock->now());
+    }
+
+    // Raise -- move back to pre-pinching position
+    markPhase(index, PHASE_RAISE, params.finger.startPos, homePos[9]);
+    if (compliantPinch) {
+        switchPinchMode(false);
+    }
+    iPos->positionMove(params.finger.joint, params.finger.startPos);
+    if (params.useThumb) {
+        iPos->positionMove(9, homePos[9]);
+    }
+    waitMoveDone(10, 1);
+    markPhase(index, PHASE_REST, params.finger.startPos, homePos[9]);
+    endPhase();
+
+    disconnectDataDumper();
+
+    cout << dbgTag << "Depth profile complete. \n";
+
+    delete profile;
+    motionMutex.unlock();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Enable or disable compliant pinching.                            ********************************************** */
+bool FingerForceModule::setCompliant(const bool enable) {
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    // Do not switch the mode between the press and the raise of a pinch
+    motionMutex.lock();
+    if (enable && !setupCompliance()) {
+        motionMutex.unlock();
+        return false;
+    }
+
+    cout << dbgTag << "Compliant pinching " << (enable ? "enabled" : "disabled") << ". \n";
+    compliantPinch = enable;
+    motionMutex.unlock();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the sensor stream health.                                    ********************************************** */
+string FingerForceModule::getStreamHealth(void) {
+    if (!watchdog) {
+        return "disabled";
+    }
+
+    return watchdog->getReport();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Check the sensor stream health.                                  ********************************************** */
+bool FingerForceModule::isStreamHealthy(void) {
+    return (!watchdog || watchdog->isHealthy());
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the input stream transports.                                 ********************************************** */
+string FingerForceModule::getTransports(void) {
+    stringstream ss;
+    ss << sensorHub->getTransports();
+    ss << "pose: " << poseService->getTransport() << "\n";
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the layout of the port scope feed.                           ********************************************** */
+string FingerForceModule::getScope(void) {
+    if (!visualFeed) {
+        return "disabled";
+    }
+
+    return visualFeed->getLayout();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the bookkeeping pipeline statistics.                         ********************************************** */
+string FingerForceModule::getPipelineStats(void) {
+    return pipeline->getReport();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the control path latency.                                    ********************************************** */
+string FingerForceModule::getLatency(void) {
+    stringstream ss;
+    ss << tickLatency.getReport();
+    ss << "log: " << (controlLog.isDeferred() ? "deferred" : "direct") << ", " << controlLog.getDropped() << " dropped lines\n";
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the contact onsets of the last pinch.                        ********************************************** */
+string FingerForceModule::getContactOnsets(void) {
+    if (contactSources.empty()) {
+        return "disabled";
+    }
+
+    return onsetReport.get();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the skin lag of the last analysed pinch.                     ********************************************** */
+string FingerForceModule::getSkinLag(void) {
+    if (!lagMonitor) {
+        return "disabled";
+    }
+
+    return lagMonitor->getReport();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get an experiment parameter.                                     ********************************************** */
+string FingerForceModule::getParam(const string &name) {
+    return experimentConfig.get(name);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set an experiment parameter.                                     ********************************************** */
+bool FingerForceModule::setParam(const string &name, const string &value) {
+    // The runs of a campaign use their own parameters
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+    if (!experimentConfig.set(name, Bottle(value.c_str()))) {
+        return false;
+    }
+
+    cout << dbgTag << "Parameter " << name << " set to " << experimentConfig.get(name) << ", applied before the next pinch. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get all experiment parameters.                                   ********************************************** */
+string FingerForceModule::getParams(void) {
+    return experimentConfig.toString();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reload the experiment parameters.                                ********************************************** */
+bool FingerForceModule::reloadParams(void) {
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    Property config;
+    if (configFile.empty() || !config.fromConfigFile(configFile.c_str())) {
+        cerr << dbgTag << "Could not read the configuration file " << configFile << ". \n";
+        return false;
+    }
+
+    iCub::interactionForces::ExperimentParameters reloaded;
+    if (!ExperimentConfig::read(config.findGroup("experiment"), config.findGroup("finger"), reloaded)) {
+        cerr << dbgTag << "Invalid experiment parameters in " << configFile << ". \n";
+        return false;
+    }
+    experimentConfig.stage(reloaded);
+
+    cout << dbgTag << "Experiment parameters reloaded from " << configFile << ", applied before the next pinch. \n";
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Queue a campaign.                                                ********************************************** */
+bool FingerForceModule::runCampaign(const string &file) {
+    // Relative campaign files are also searched next to the configuration file
+    string path = file;
+    if (!std::ifstream(path.c_str()).good() && (file[0] != '/') && (configFile.find('/') != string::npos)) {
+        path = configFile.substr(0, configFile.find_last_of('/') + 1) + file;
+    }
+
+    return campaign.load(path, experimentConfig.getStaged(), homePos, whichArm, clock->now()) > 0;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Get the campaign progress.                                       ********************************************** */
+string FingerForceModule::getCampaign(void) {
+    return campaign.getReport(clock->now());
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Stop the campaign.                                               ********************************************** */
+bool FingerForceModule::stopCampaign(void) {
+    if (!campaign.isBusy()) {
+        return false;
+    }
+
+    cout << dbgTag << "Stopping the campaign after the current pinch. \n";
+    campaign.stop();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reset the pinch counter.                                         ********************************************** */
+bool FingerForceModule::resetC(void) {
+    if (campaign.isBusy()) {
+        cerr << dbgTag << "A campaign is running, stop it first. \n";
+        return false;
+    }
+
+    cout << dbgTag << "Resetting the pinch counter. \n";
+    motionMutex.lock();
+    pinchCounter = 0;
+    motionMutex.unlock();
+    
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* RPC Quit module                                                  ********************************************** */
+bool FingerForceModule::quit(void) {
+        return closing = true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Attach RPC port.                                                 ********************************************** */
+bool FingerForceModule::attach(yarp::os::RpcServer &source) {
         return this->yarp().attachAsServer(source);
 }
 /* *********************************************************************************************************************** */
@@ -522,19 +1565,17 @@ bool FingerForceModule::attach(yarp::os::RpcServer &source) {
 /* *********************************************************************************************************************** */
 /* ******* Wait for motion to be completed.                                 ********************************************** */
 bool FingerForceModule::waitMoveDone(const double &i_timeout, const double &i_delay) {
-    using yarp::os::Time;
-    
     bool ok = false;
     
-    double start = Time::now();
-    while (!ok && (start - Time::now() <= i_timeout)) {
+    double start = clock->now();
+    while (!ok && (clock->now() - start <= i_timeout)) {
         iPos->checkMotionDone(&ok);
-        Time::delay(i_delay);
+        clock->delay(i_delay);
     }
 
 #ifndef NODEBUG
     if (!ok) {
-        cout << dbgTag << "Timeout expired while waiting for motion to complete. \n";
+        controlLog.print("%sTimeout expired while waiting for motion to complete. \n", dbgTag.c_str());
     }
 #endif
 
@@ -543,15 +1584,96 @@ bool FingerForceModule::waitMoveDone(const double &i_timeout, const double &i_de
 /* *********************************************************************************************************************** */
 
 
+/* *********************************************************************************************************************** */
+/* ******* Incremental joint moves.                                         ********************************************** */
+bool FingerForceModule::readJoints(Vector &o_joints) {
+    // The joint stream is preferred to a round trip to the encoders
+    if (jointCache && jointCache->getJoints(homeMaxAge, o_joints) && (o_joints.size() >= homePos.size())) {
+        return true;
+    }
+
+    o_joints.resize(controlPosition.size());
+
+    return iEncs->getEncoders(o_joints.data());
+}
+
+bool FingerForceModule::moveJoints(const Vector &i_target, const int i_first, const int i_last) {
+    if (!selectJoints(i_target, i_first, i_last)) {
+        return false;
+    }
+
+    return commandJoints(i_target);
+}
+
+bool FingerForceModule::selectJoints(const Vector &i_target, const int i_first, const int i_last) {
+    Vector &position = controlState;
+    std::vector<int> &moving = movingJoints;
+    moving.clear();
+    if (!readJoints(position)) {
+        controlLog.print("%sCould not read the joint positions. \n", dbgTag.c_str());
+        return false;
+    }
+
+    // Only the joints outside the tolerance are commanded
+    for (int i = i_first; (i < i_last) && (i < (int) position.size()); ++i) {
+        if (fabs(position[i] - i_target[i]) > homeTolerance[i]) {
+            moving.push_back(i);
+        }
+    }
+
+#ifndef NODEBUG
+    controlLog.print("DEBUG: %sMoving %d of joints %d-%d. \n", dbgTag.c_str(), (int) moving.size(), i_first, i_last - 1);
+    for (size_t k = 0; k < moving.size(); ++k) {
+        controlLog.print("DEBUG: %s\tjoint %d: %g -> %g\n", dbgTag.c_str(), moving[k], position[moving[k]], i_target[moving[k]]);
+    }
+#endif
+
+    return true;
+}
+
+bool FingerForceModule::commandJoints(const Vector &i_target) {
+    const std::vector<int> &moving = movingJoints;
+    if (moving.empty()) {
+        return true;
+    }
+
+    for (size_t k = 0; k < moving.size(); ++k) {
+        iPos->positionMove(moving[k], i_target[moving[k]]);
+    }
+
+    return waitJointsDone(moving, homeTimeout, homePoll);
+}
+
+bool FingerForceModule::waitJointsDone(const std::vector<int> &i_joints, const double &i_timeout, const double &i_poll) {
+    bool done = false;
+
+    double start = clock->now();
+    while (!done && (clock->now() - start <= i_timeout)) {
+        controlDelay(iCub::interactionForces::LOOP_POLL, i_poll);
+        done = true;
+        for (size_t k = 0; done && (k < i_joints.size()); ++k) {
+            iPos->checkMotionDone(i_joints[k], &done);
+        }
+    }
+
+    if (!done) {
+        controlLog.print("%sTimeout expired while waiting for the joints to reach the home position. \n", dbgTag.c_str());
+    }
+
+    return done;
+}
+/* *********************************************************************************************************************** */
+
+
 /* *********************************************************************************************************************** */
 /* ******* Check if the thumb is to be used for the pinching motion.        ********************************************** */
 void FingerForceModule::checkUseThumb(const bool increment, yarp::sig::Vector &o_positions) {
     // Check for thumb
-    if (useThumb) {
+    if (params.useThumb) {
         if (increment) {
-            o_positions[9] = previousDepth[0] + pinchIncrement;
+            o_positions[9] = previousDepth[0] + params.pinchIncrement;
         } else {
-            o_positions[9] = previousDepth[0] - pinchIncrement;
+            o_positions[9] = previousDepth[0] - params.pinchIncrement;
         }
 
         // Store previous depth
@@ -571,6 +1693,9 @@ bool FingerForceModule::connectDataDumper(void) {
     ok &= Network::connect("/NIDAQmxReader/data/real:o", "/dump_" + whichArm + "_nano17");
     ok &= Network::connect("/" + robotName + "/skin/" + whichArm + "_hand", "/dump_" + whichArm + "_skin_raw");
     ok &= Network::connect("/" + robotName + "/skin/" + whichArm + "_hand_comp", "/dump_" + whichArm + "_skin_comp");
+    if (skinCompensator) {
+        ok &= Network::connect("/" + moduleName + "/skinComp:o", "/dump_" + whichArm + "_skin_phasecomp");
+    }
 
     return ok;
 }
@@ -587,7 +1712,450 @@ bool FingerForceModule::disconnectDataDumper(void) {
     ok &= Network::disconnect("/NIDAQmxReader/data/real:o", "/dump_" + whichArm + "_nano17");
     ok &= Network::disconnect("/" + robotName + "/skin/" + whichArm + "_hand", "/dump_" + whichArm + "_skin_raw");
     ok &= Network::disconnect("/" + robotName + "/skin/" + whichArm + "_hand_comp", "/dump_" + whichArm + "_skin_comp");
+    if (skinCompensator) {
+        ok &= Network::disconnect("/" + moduleName + "/skinComp:o", "/dump_" + whichArm + "_skin_phasecomp");
+    }
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Set up the compliant interfaces.                                 ********************************************** */
+bool FingerForceModule::setupCompliance(void) {
+    if ((iCtrl == NULL) || (iImp == NULL)) {
+        controlLog.print("%sThe control board does not provide the control mode and impedance interfaces. \n", dbgTag.c_str());
+        return false;
+    }
+
+    // Preset the impedance so that switching mode is a single call
+    bool ok = iImp->setImpedance(params.finger.joint, fingerStiffness, fingerDamping);
+    ok &= iImp->setImpedance(9, thumbStiffness, thumbDamping);
+    if (!ok) {
+        controlLog.print("%sCould not set the joint impedance. \n", dbgTag.c_str());
+    }
+
+#ifndef NODEBUG
+    controlLog.print("DEBUG: %sImpedance parameters are: \n", dbgTag.c_str());
+    controlLog.print("DEBUG: %s\tfinger (%g, %g) \n", dbgTag.c_str(), fingerStiffness, fingerDamping);
+    controlLog.print("DEBUG: %s\tthumb (%g, %g) \n", dbgTag.c_str(), thumbStiffness, thumbDamping);
+#endif
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Switch the pinching joints control mode.                         ********************************************** */
+bool FingerForceModule::switchPinchMode(const bool i_compliant) {
+    int mode = i_compliant ? VOCAB_CM_IMPEDANCE_POS : VOCAB_CM_POSITION;
+    int joints[2] = {params.finger.joint, 9};
+    int modes[2] = {mode, mode};
+    int n = params.useThumb ? 2 : 1;
+
+    // Switch all pinching joints with a single request
+#ifndef NODEBUG
+    double start = clock->now();
+#endif
+    bool ok = iCtrl->setControlModes(n, joints, modes);
+
+#ifndef NODEBUG
+    controlLog.print("DEBUG: %sSwitched to %s mode in %g ms. \n", dbgTag.c_str(), i_compliant ? "impedance" : "position",
+            1000.0 * (clock->now() - start));
+#endif
+    if (!ok) {
+        controlLog.print("%sCould not switch the control mode. \n", dbgTag.c_str());
+    }
 
     return ok;
 }
 /* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Wait for healthy sensor streams.                                 ********************************************** */
+bool FingerForceModule::waitHealthy(void) {
+    if (!watchdog || !pauseOnFault) {
+        return true;
+    }
+
+    bool paused = false;
+    bool healthy = watchdog->isHealthy();
+    while (!healthy && !closing && !campaign.isStopping()) {
+        if (!paused) {
+            controlLog.print("%sSensor stream fault, pausing. \n", dbgTag.c_str());
+            controlLog.printLines(watchdog->getReport());
+            paused = true;
+        }
+        clock->delay(0.1);
+        healthy = watchdog->isHealthy();
+    }
+    if (closing) {
+        return false;
+    }
+    if (!healthy) {
+        controlLog.print("%sCampaign stopped while paused on a sensor stream fault. \n", dbgTag.c_str());
+        return false;
+    }
+    if (paused) {
+        controlLog.print("%sSensor streams recovered, resuming. \n", dbgTag.c_str());
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Apply the staged experiment parameters.                          ********************************************** */
+void FingerForceModule::applyParams(void) {
+    iCub::interactionForces::ExperimentParameters previous = params;
+    if (!experimentConfig.fetch(params)) {
+        return;
+    }
+
+    controlLog.print("%sApplying the new experiment parameters. \n", dbgTag.c_str());
+#ifndef NODEBUG
+    controlLog.printLines(experimentConfig.toString());
+#endif
+
+    bool fingerMoved = (params.finger.joint != previous.finger.joint) || (params.finger.startPos != previous.finger.startPos);
+    if (fingerMoved || (params.finger.fingertips != previous.finger.fingertips)) {
+        pinchMonitor->setup(params.finger.joint, params.finger.fingertips);
+        if (stallDetector) {
+            stallDetector->setup(params.finger.joint);
+        }
+    }
+    if (fingerMoved) {
+        if (compliantPinch && (params.finger.joint != previous.finger.joint)) {
+            setupCompliance();
+        }
+
+        // Restart the progressive depth from the new start position
+        previousDepth[1] = params.finger.startPos;
+        openHand();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Campaign runs.                                                   ********************************************** */
+bool FingerForceModule::setupRun(const CampaignRun &i_run) {
+    homePos = i_run.home;
+    previousDepth[0] = homePos[9];
+    experimentConfig.stage(i_run.params);
+    applyParams();
+    // Each run starts its progressive depth afresh
+    previousDepth[1] = params.finger.startPos;
+
+    // Only the joints away from the home position move
+    return reachArm();
+}
+
+void FingerForceModule::executeRun(const CampaignRun &i_run) {
+    ClockParticipant participant(clock);
+    RealTimeScope realTime(useRealTime, rtPriority, rtCpu);
+    motionMutex.lock();
+
+    cout << dbgTag << "Campaign " << i_run.campaign << ": starting run " << i_run.name << ". \n";
+    if (!setupRun(i_run)) {
+        // Never pinch from an unknown pose
+        cerr << dbgTag << "Campaign " << i_run.campaign << ": skipping run " << i_run.name << ", the arm is not in place. \n";
+        campaign.runDone();
+        motionMutex.unlock();
+        return;
+    }
+
+    // Each run has its own segment index and results session
+    switchIndex(i_run.campaign + "_" + i_run.name);
+    if (resultWriter) {
+        resultSession = baseSession + "_" + i_run.campaign + "_" + i_run.name;
+    }
+    runSequence(true);
+    campaign.runDone();
+
+    motionMutex.unlock();
+}
+
+void FingerForceModule::switchIndex(const string &i_label) {
+    if (indexFile.empty()) {
+        return;
+    }
+    endPhase();
+
+    // The old index is closed by the pipeline once its queued rows are written
+    if (segmentIndex) {
+        IndexCloseJob *closeJob = closeJobs.take<IndexCloseJob>();
+        closeJob->setIndex(segmentIndex);
+        pipeline->push(closeJob);
+        segmentIndex = NULL;
+    }
+
+    size_t dot = indexFile.find_last_of('.');
+    if ((dot == string::npos) || (dot < indexFile.find_last_of('/') + 1)) {
+        dot = indexFile.size();
+    }
+    string file = indexFile.substr(0, dot) + "_" + i_label + indexFile.substr(dot);
+    SegmentIndex *index = new SegmentIndex();
+    if (!index->create(file, indexStreams, indexPaths, clock)) {
+        cerr << dbgTag << "The pinch segments are no longer indexed. \n";
+        delete index;
+        return;
+    }
+    segmentIndex = index;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pinch segment index.                                             ********************************************** */
+void FingerForceModule::markPhase(const int &i_pinch, const PinchPhase i_phase, const double &i_fingerDepth, const double &i_thumbDepth,
+        const double i_time) {
+    double time = (i_time < 0.0) ? clock->now() : i_time;
+    if (skinCompensator) {
+        skinCompensator->setPhase(i_phase, time);
+    }
+    if (segmentIndex) {
+        endPhase(time);
+        segmentIndex->begin(i_pinch, i_phase, time, i_fingerDepth, i_thumbDepth);
+    }
+}
+
+void FingerForceModule::endPhase(const double i_time) {
+    // The phase boundary is taken here, the row is written by the pipeline
+    if (!segmentIndex) {
+        return;
+    }
+    SegmentJob *segmentJob = segmentJobs.take<SegmentJob>();
+    if (segmentIndex->take((i_time < 0.0) ? clock->now() : i_time, segmentJob->getSegment())) {
+        segmentJob->setIndex(segmentIndex);
+        pipeline->push(segmentJob);
+    } else {
+        segmentJob->release();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Synchronised move of the pinching joints.                        ********************************************** */
+double FingerForceModule::syncMove(const Vector &i_position, const PinchPhase i_phase) {
+    int joints[2] = {params.finger.joint, 9};
+    int n = params.useThumb ? 2 : 1;
+    int stats = (i_phase == PHASE_PRESS) ? 0 : 1;
+
+    Vector &current = controlState;
+    current.resize(i_position.size());
+    iEncs->getEncoders(current.data());
+
+    // Time of the longest move at the nominal speed
+    double distance[2] = {0.0, 0.0};
+    double targets[2] = {0.0, 0.0};
+    double longest = 0.0;
+    for (int k = 0; k < n; ++k) {
+        targets[k] = i_position[joints[k]];
+        distance[k] = fabs(targets[k] - current[joints[k]]);
+        longest = std::max(longest, distance[k]);
+    }
+    double duration = longest / syncSpeed;
+
+    // Scale the speeds so that all joints take the same time
+    double nominal[2] = {syncSpeed, syncSpeed};
+    for (int k = 0; k < n; ++k) {
+        iPos->getRefSpeed(joints[k], &nominal[k]);
+        double speed = (duration > 0.0) ? std::max(distance[k] / duration, syncMinSpeed) : syncSpeed;
+        iPos->setRefSpeed(joints[k], speed);
+    }
+
+    // Time the arrivals on the joint stream
+    jointCache->watch(joints, targets, n, syncTolerance);
+    double start = clock->now();
+    iPos->positionMove(i_position.data());
+
+    // Wait for the moving joints
+    double arrival[2] = {0.0, 0.0};
+    bool moving[2] = {false, false};
+    bool polled = false;
+    int pending = 0;
+    for (int k = 0; k < n; ++k) {
+        moving[k] = (distance[k] > 0.0);
+        pending += moving[k] ? 1 : 0;
+    }
+    int nMoving = pending;
+    while ((pending > 0) && (clock->now() - start <= syncTimeout) && !closing) {
+        controlDelay(iCub::interactionForces::LOOP_POLL, syncPoll);
+        for (int k = 0; k < n; ++k) {
+            bool done = false;
+            if (moving[k] && iPos->checkMotionDone(joints[k], &done) && done) {
+                double stamp = 0.0;
+                if (jointCache->getArrival(k, stamp)) {
+                    arrival[k] = stamp - start;
+                } else {
+                    // No stream sample within the tolerance: fall back to the polling time
+                    arrival[k] = clock->now() - start;
+                    polled = true;
+                }
+                moving[k] = false;
+                pending--;
+            }
+        }
+    }
+
+    // Restore the nominal speeds used by the other movements
+    for (int k = 0; k < n; ++k) {
+        iPos->setRefSpeed(joints[k], nominal[k]);
+    }
+
+    if (pending > 0) {
+        controlLog.print("%sTimeout expired while waiting for the synchronised move to complete. \n", dbgTag.c_str());
+        return -1.0;
+    }
+    if (nMoving < 2) {
+        // A single moving joint is synchronised by definition
+        return 0.0;
+    }
+
+    double error = fabs(arrival[0] - arrival[1]);
+    syncCount[stats]++;
+    syncErrorSum[stats] += error;
+    syncErrorMax[stats] = std::max(syncErrorMax[stats], error);
+    syncPolled[stats] += polled ? 1 : 0;
+    controlLog.print("%sSynchronised move: planned %g s, finger %g s, thumb %g s, error %g ms%s. \n", dbgTag.c_str(), duration,
+            arrival[0], arrival[1], 1000.0 * error, polled ? " (polled)" : "");
+
+    return error;
+}
+
+void FingerForceModule::resetSyncStats(void) {
+    for (int i = 0; i < 2; ++i) {
+        syncCount[i] = 0;
+        syncErrorSum[i] = 0.0;
+        syncErrorMax[i] = 0.0;
+        syncPolled[i] = 0;
+    }
+}
+
+void FingerForceModule::reportSyncStats(void) {
+    const char *moves[2] = {"press", "raise"};
+    for (int i = 0; i < 2; ++i) {
+        if (syncCount[i] == 0) {
+            continue;
+        }
+        cout << dbgTag << "Synchronisation error over " << syncCount[i] << " " << moves[i] << " moves: mean "
+            << 1000.0 * syncErrorSum[i] / syncCount[i] << " ms, max " << 1000.0 * syncErrorMax[i] << " ms";
+        if (syncPolled[i] > 0) {
+            cout << ", " << syncPolled[i] << " moves timed by polling with a resolution of " << 1000.0 * syncPoll << " ms";
+        } else {
+            cout << ", timed on the joint stream sampled every " << 1000.0 * jointCache->getPeriod() << " ms";
+        }
+        cout << ". \n";
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Hold a pinch.                                                    ********************************************** */
+bool FingerForceModule::hold(const double &i_start, const double &i_end, const double &i_depth) {
+    if (!useSlip) {
+        delayUntil(i_end);
+        return true;
+    }
+
+    // Discard the events received while pressing
+    slipDetector->takeEvents();
+    slipDetector->setArmed(true);
+
+    double correction = 0.0;
+    double remaining = i_end - clock->now();
+    while (remaining > 0.0) {
+        if (remaining > 0.01) {
+            controlDelay(iCub::interactionForces::LOOP_HOLD, 0.01);
+        } else {
+            delayUntil(i_end);
+        }
+        remaining = i_end - clock->now();
+
+        int events = slipDetector->takeEvents();
+        if (events > 0) {
+            controlLog.print("%sSlip detected at %g s into the hold. \n", dbgTag.c_str(), clock->now() - i_start);
+
+            // Press deeper to recover the grip
+            if ((slipCorrection > 0.0) && (correction < maxSlipCorrection)) {
+                correction = std::min(correction + events * slipCorrection, maxSlipCorrection);
+                iPos->positionMove(params.finger.joint, i_depth + correction);
+#ifndef NODEBUG
+                controlLog.print("DEBUG: %sFinger depth corrected to: %g\n", dbgTag.c_str(), i_depth + correction);
+#endif
+            }
+        }
+    }
+
+    slipDetector->setArmed(false);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Contact anchored hold timing.                                    ********************************************** */
+bool FingerForceModule::waitContact(const double &i_deadline, double &o_time) {
+    while (!closing) {
+        if (getContactTime(pinchOnsets, collectOnsets(), o_time)) {
+            return true;
+        }
+        if (clock->now() >= i_deadline) {
+            break;
+        }
+        controlDelay(iCub::interactionForces::LOOP_POLL, contactPoll);
+    }
+
+    return false;
+}
+
+int FingerForceModule::collectOnsets(void) {
+    nPinchOnsets = 0;
+    for (size_t i = 0; i < contactSources.size(); ++i) {
+        nPinchOnsets += contactSources[i]->getOnsets(pinchOnsets + nPinchOnsets,
+                iCub::interactionForces::MAX_CONTACT_ONSETS - nPinchOnsets);
+    }
+
+    return nPinchOnsets;
+}
+
+bool FingerForceModule::getContactTime(const ContactOnset *i_onsets, const int &i_count, double &o_time) {
+    // The detection delay is measured in the time base of the source and moved to the module clock
+    bool found = false;
+    for (int i = 0; i < i_count; ++i) {
+        double time = i_onsets[i].received - (i_onsets[i].detected - i_onsets[i].time);
+        if (!found || (time < o_time)) {
+            o_time = time;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void FingerForceModule::delayUntil(const double &i_time) {
+    // A single delay overshoots by the scheduling latency, the last millisecond is waited in short steps
+    double remaining = i_time - clock->now();
+    if (remaining > 0.001) {
+        clock->delay(remaining - 0.001);
+    }
+    while ((remaining = i_time - clock->now()) > 0.0) {
+        clock->delay(std::min(remaining, 0.0001));
+    }
+    tickLatency.add(iCub::interactionForces::LOOP_HOLD, i_time, clock->now());
+}
+
+void FingerForceModule::controlDelay(const ControlLoop i_loop, const double &i_delay) {
+    double tick = clock->now() + i_delay;
+    clock->delay(i_delay);
+    tickLatency.add(i_loop, tick, clock->now());
+}
+/* *********************************************************************************************************************** */
@@ -19,7 +19,6 @@
 
 
 #include <iostream>
-#include <sstream>
 
 #include "GazeThread.h"
 
@@ -31,15 +30,15 @@ using std::string;
 
 using iCub::interactionForces::GazeThread;
 
-using yarp::os::RateThread;
 using yarp::os::Value;
-using yarp::dev::ICartesianControl;
 using yarp::dev::IGazeControl;
 
-GazeThread::GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf)
-    : RateThread(aPeriod) {
+GazeThread::GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, iCub::interactionForces::Clock *aClock, iCub::interactionForces::PoseService *aPoseService)
+    : ClockedRateThread(aPeriod, aClock) {
         period = aPeriod;
         rf = aRf;
+        poseService = aPoseService;
+        iGaze = NULL;
 
         dbgTag = "GazeThread: ";
 }
@@ -47,35 +46,29 @@ GazeThread::GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf)
 bool GazeThread::threadInit() {
     using yarp::os::Property;
     using yarp::os::Bottle;
-    using std::stringstream;
 
     cout << dbgTag << "Starting thread. \n";
 
     /* ******* Extract configuration files          ******* */
-    string robotName = rf.check("robot", Value("icub"), "The robot name.").asString().c_str();
-    string whichHand = rf.check("whichHand", Value("right"), "The hand to be used for the grasping.").asString().c_str();
-    
-    
-    /* ****** Cartesian controller stuff                      ****** */
-    Property optCart;
-    optCart.put("device", "cartesiancontrollerclient");
-    optCart.put("remote", ("/" + robotName + "/cartesianController/" + whichHand + "_arm").c_str());
-    optCart.put("local", ("/cartesian_client/" + whichHand + "_arm").c_str());
-    
-    if (!clientCart.open(optCart))
-        return false;
-    // open the view
-    clientCart.view(iCart);
-    // latch the controller context in order to preserve it after closing the module
-    iCart->storeContext(&startup_context_id_cart);
-    // print out some info about the controller
-    Bottle info;
-    if (!iCart->getInfo(info)) {
-        cout << dbgTag << "------------------------------------ \n";
+    Bottle &parGroup = rf.findGroup("gaze");
+    lookAhead = parGroup.check("lookAhead", Value(0.1), "Fixation point prediction horizon in seconds.").asDouble();
+    fixationOffset.resize(3, 0.0);
+    fixationOffset[0] = -0.1;
+    Bottle *offset = parGroup.find("offset").asList();
+    if (offset != NULL) {
+        if (offset->size() == 3) {
+            for (int i = 0; i < 3; ++i) {
+                fixationOffset[i] = offset->get(i).asDouble();
+            }
+        } else {
+            cout << dbgTag << "Invalid gaze offset parameter size. Expecting a list of size 3. \n";
+            return false;
+        }
     }
-    stringstream ss;
-    ss << "Cartesian controller info = " << info.toString().c_str() << "\n";
-    cout << dbgTag << ss;
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Gaze look ahead is " << lookAhead << " s, offset is " << fixationOffset.toString() << "\n";
+#endif
 
     /* ****** Gaze controller stuff                               ****** */
     Property optGaze;
@@ -90,11 +83,9 @@ bool GazeThread::threadInit() {
     // latch the controller context in order to preserve it after closing the module
     iGaze->storeContext(&startup_context_id_gaze);
     // print out some info about the controller
-    info.clear();
+    Bottle info;
     iGaze->getInfo(info);
-    ss.str(std::string());
-    ss << "Gaze controller info = " << info.toString().c_str() << "\n";
-    cout << dbgTag << ss;
+    cout << dbgTag << "Gaze controller info = " << info.toString().c_str() << "\n";
 
     // Store initial gaze
     iGaze->getFixationPoint(startGaze);
@@ -111,19 +102,13 @@ void GazeThread::threadRelease() {
 	// Restore initial gaze
     iGaze->lookAtFixationPoint(startGaze);
 
-    // Stop cartesian and gaze controller
-    if (iCart) {
-        iCart->stopControl();
-        // restore the controller context as it was before opening the module
-        iCart->restoreContext(startup_context_id_cart);
-    }
+    // Stop gaze controller
     if (iGaze) {
         iGaze->stopControl();
         // restore the controller context as it was before opening the module
         iGaze->restoreContext(startup_context_id_gaze);
     }
 
-    clientCart.close();
     clientGaze.close();
 
     cout << dbgTag << "Done. \n";
@@ -138,15 +123,18 @@ void GazeThread::run() {
 bool GazeThread::lookAtObject() {
     using yarp::sig::Vector;
 
-    Vector position(3), orientation(4);
+    Vector position(3);
     
-    // Get pose
-    iCart->getPose(position, orientation);
+    // Get the hand position predicted ahead of the gaze motion
+    if (!poseService->predictPosition(lookAhead, position)) {
+        return false;
+    }
      
-    // Look at object
-    position[0] -= 0.1;
-    iGaze->lookAtFixationPoint(position);                 // move the gaze to the desired fixation point
-    bool ok = iGaze->waitMotionDone();                        // wait until the operation is done
+    // Look at object -- the gaze controller tracks the streamed fixation point, hence do not wait for motion done
+    for (int i = 0; i < 3; ++i) {
+        position[i] += fixationOffset[i];
+    }
+    bool ok = iGaze->lookAtFixationPoint(position);                 // move the gaze to the desired fixation point
 
     return ok;
 }
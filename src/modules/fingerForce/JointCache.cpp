@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "JointCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+using iCub::interactionForces::JointCache;
+using iCub::interactionForces::SensorStream;
+using iCub::interactionForces::SensorSample;
+
+using yarp::sig::Vector;
+
+
+const int JointCache::MAX_WATCHED;
+
+JointCache::JointCache(Clock *aClock)
+    : clock(aClock) {
+        stamp = -1.0;
+        period = 0.0;
+        for (int k = 0; k < MAX_WATCHED; ++k) {
+            watched[k] = 0;
+            targets[k] = 0.0;
+            arrivals[k] = -1.0;
+        }
+        nWatched = 0;
+        tolerance = 0.0;
+        watchStart = 0.0;
+}
+
+bool JointCache::getJoints(const double &i_maxAge, Vector &o_joints) {
+    mutex.lock();
+    bool fresh = (stamp >= 0.0) && (clock->now() - stamp <= i_maxAge);
+    if (fresh) {
+        o_joints = joints;
+    }
+    mutex.unlock();
+
+    return fresh;
+}
+
+double JointCache::getPeriod(void) {
+    mutex.lock();
+    double result = period;
+    mutex.unlock();
+
+    return result;
+}
+
+void JointCache::watch(const int *i_joints, const double *i_targets, const int &i_n, const double &i_tolerance) {
+    mutex.lock();
+    nWatched = std::min(i_n, MAX_WATCHED);
+    for (int k = 0; k < nWatched; ++k) {
+        watched[k] = i_joints[k];
+        targets[k] = i_targets[k];
+        arrivals[k] = -1.0;
+    }
+    tolerance = i_tolerance;
+    watchStart = clock->now();
+    mutex.unlock();
+}
+
+bool JointCache::getArrival(const int &i_k, double &o_time) {
+    mutex.lock();
+    bool arrived = (i_k < nWatched) && (arrivals[i_k] >= 0.0);
+    if (arrived) {
+        o_time = arrivals[i_k];
+    }
+    mutex.unlock();
+
+    return arrived;
+}
+
+void JointCache::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    if (i_stream != iCub::interactionForces::STREAM_JOINTS) {
+        return;
+    }
+
+    mutex.lock();
+    double dt = i_sample.rxTime - stamp;
+    if ((stamp >= 0.0) && (dt > 0.0)) {
+        period = (period > 0.0) ? period + 0.05 * (dt - period) : dt;
+    }
+
+    // Interpolate the tolerance crossing between the previous and the current sample
+    for (int k = 0; k < nWatched; ++k) {
+        size_t j = (size_t) watched[k];
+        if ((arrivals[k] >= 0.0) || (j >= i_sample.size)) {
+            continue;
+        }
+        double error = fabs(i_sample.data[j] - targets[k]);
+        if (error > tolerance) {
+            continue;
+        }
+        double arrival = i_sample.rxTime;
+        if ((stamp >= watchStart) && (j < joints.size()) && (dt > 0.0)) {
+            double prevError = fabs(joints[j] - targets[k]);
+            if (prevError > tolerance) {
+                arrival = stamp + dt * (prevError - tolerance) / (prevError - error);
+            }
+        }
+        arrivals[k] = std::max(arrival, watchStart);
+    }
+
+    joints.resize(i_sample.size);
+    for (size_t i = 0; i < i_sample.size; ++i) {
+        joints[i] = i_sample.data[i];
+    }
+    stamp = i_sample.rxTime;
+    mutex.unlock();
+}
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "LagEstimator.h"
+
+#include <cmath>
+#include <algorithm>
+
+using std::vector;
+
+using iCub::interactionForces::LagEstimator;
+using iCub::interactionForces::LagEstimate;
+using iCub::interactionForces::LagSignals;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+
+/** Number of samples of a full buffer older than the given span. */
+static size_t expired(const vector<double> &i_time, const double &i_span) {
+    double cutoff = i_time.back() - i_span;
+    size_t n = 0;
+    while ((n < i_time.size()) && (i_time[n] < cutoff)) {
+        n++;
+    }
+
+    return n;
+}
+
+/** Drop the given number of oldest samples, or every other sample up to the latest one if zero. */
+static void shrink(vector<double> &io_values, const size_t &i_expired) {
+    if (i_expired > 0) {
+        io_values.erase(io_values.begin(), io_values.begin() + i_expired);
+        return;
+    }
+    size_t n = 0;
+    for (size_t i = (io_values.size() + 1) % 2; i < io_values.size(); i += 2) {
+        io_values[n++] = io_values[i];
+    }
+    io_values.resize(n);
+}
+
+
+/* *********************************************************************************************************************** */
+/* ******* Signals                                                          ********************************************** */
+void LagSignals::bound(const double &i_span, const size_t &i_nForce, const size_t &i_nSkin, const size_t &i_nFingertips) {
+    span = i_span;
+    forceTime.reserve(i_nForce);
+    force.reserve(i_nForce);
+    skinTime.reserve(i_nSkin);
+    skin.resize(i_nFingertips);
+    for (size_t k = 0; k < skin.size(); ++k) {
+        skin[k].reserve(i_nSkin);
+    }
+}
+
+void LagSignals::clear(void) {
+    forceTime.clear();
+    force.clear();
+    skinTime.clear();
+    for (size_t k = 0; k < skin.size(); ++k) {
+        skin[k].clear();
+    }
+}
+
+void LagSignals::addWrench(const double &i_time, const double *i_values, const size_t &i_size) {
+    if (i_size < 3) {
+        return;
+    }
+    if ((span > 0.0) && !forceTime.empty() && (forceTime.size() == forceTime.capacity())) {
+        size_t n = expired(forceTime, span);
+        shrink(forceTime, n);
+        shrink(force, n);
+    }
+    forceTime.push_back(i_time);
+    force.push_back(sqrt(i_values[0] * i_values[0] + i_values[1] * i_values[1] + i_values[2] * i_values[2]));
+}
+
+void LagSignals::addSkin(const double &i_time, const double *i_values, const size_t &i_size, const vector<int> &i_fingertips) {
+    if (i_size < SKIN_TAXELS) {
+        return;
+    }
+    skin.resize(i_fingertips.size());
+    if ((span > 0.0) && !skinTime.empty() && (skinTime.size() == skinTime.capacity())) {
+        size_t n = expired(skinTime, span);
+        shrink(skinTime, n);
+        for (size_t k = 0; k < skin.size(); ++k) {
+            shrink(skin[k], n);
+        }
+    }
+    skinTime.push_back(i_time);
+    for (size_t k = 0; k < i_fingertips.size(); ++k) {
+        const double *x = i_values + i_fingertips[k] * FINGERTIP_TAXELS;
+        double sum = 0.0;
+        for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+            sum += x[i];
+        }
+        skin[k].push_back(sum);
+    }
+}
+
+void LagSignals::append(const LagSignals &i_other) {
+    forceTime.insert(forceTime.end(), i_other.forceTime.begin(), i_other.forceTime.end());
+    force.insert(force.end(), i_other.force.begin(), i_other.force.end());
+    skinTime.insert(skinTime.end(), i_other.skinTime.begin(), i_other.skinTime.end());
+    skin.resize(std::max(skin.size(), i_other.skin.size()));
+    for (size_t k = 0; k < i_other.skin.size(); ++k) {
+        skin[k].insert(skin[k].end(), i_other.skin[k].begin(), i_other.skin[k].end());
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Plan                                                             ********************************************** */
+LagEstimator::LagEstimator() {
+    resolution = 0.001;
+    window = 0.0;
+    maxLag = 0.0;
+    span = 1;
+    nGrid = 0;
+    nFft = 0;
+}
+
+bool LagEstimator::setup(const double &i_window, const double &i_resolution, const double &i_maxLag, const double &i_smoothing) {
+    if ((i_window <= 0.0) || (i_resolution <= 0.0) || (i_maxLag <= 0.0) || (i_window < 2.0 * i_resolution)) {
+        return false;
+    }
+    window = i_window;
+    resolution = i_resolution;
+    maxLag = i_maxLag;
+    span = std::max(1, (int) floor(i_smoothing / resolution + 0.5));
+
+    // Zero padding to twice the grid avoids the circular wrap of the correlation
+    nGrid = (size_t) ceil(window / resolution) + 1;
+    nFft = 1;
+    int bits = 0;
+    while (nFft < 2 * nGrid) {
+        nFft <<= 1;
+        bits++;
+    }
+
+    bitReverse.resize(nFft);
+    for (size_t i = 0; i < nFft; ++i) {
+        size_t r = 0;
+        for (int b = 0; b < bits; ++b) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        bitReverse[i] = r;
+    }
+    cosTable.resize(nFft / 2);
+    sinTable.resize(nFft / 2);
+    for (size_t k = 0; k < nFft / 2; ++k) {
+        cosTable[k] = cos(2.0 * M_PI * k / nFft);
+        sinTable[k] = sin(2.0 * M_PI * k / nFft);
+    }
+
+    aRe.assign(nFft, 0.0);
+    aIm.assign(nFft, 0.0);
+    bRe.assign(nFft, 0.0);
+    bIm.assign(nFft, 0.0);
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Estimate                                                         ********************************************** */
+bool LagEstimator::estimate(const vector<double> &i_timeA, const vector<double> &i_a, const vector<double> &i_timeB,
+        const vector<double> &i_b, LagEstimate &o_estimate) {
+    o_estimate.lag = 0.0;
+    o_estimate.confidence = 0.0;
+    o_estimate.valid = false;
+    if ((nFft == 0) || (i_timeA.size() < 2) || (i_timeB.size() < 2)) {
+        return false;
+    }
+
+    // The last window of the overlap of the two signals
+    double start = std::max(i_timeA.front(), i_timeB.front());
+    double end = std::min(i_timeA.back(), i_timeB.back());
+    if (end - start < 2.0 * resolution) {
+        return false;
+    }
+    start = std::max(start, end - (nGrid - 1) * resolution);
+    size_t n = std::min(nGrid, (size_t) floor((end - start) / resolution) + 1);
+
+    double energyA = resample(i_timeA, i_a, start, n, aRe);
+    double energyB = resample(i_timeB, i_b, start, n, bRe);
+    if ((energyA <= 0.0) || (energyB <= 0.0)) {
+        return false;
+    }
+    std::fill(aIm.begin(), aIm.end(), 0.0);
+    std::fill(bIm.begin(), bIm.end(), 0.0);
+
+    // r[k] = sum a[i] b[i + k] = IFFT(conj(A) B)
+    transform(aRe, aIm, false);
+    transform(bRe, bIm, false);
+    for (size_t i = 0; i < nFft; ++i) {
+        double re = aRe[i] * bRe[i] + aIm[i] * bIm[i];
+        double im = aRe[i] * bIm[i] - aIm[i] * bRe[i];
+        aRe[i] = re;
+        aIm[i] = im;
+    }
+    transform(aRe, aIm, true);
+
+    // Peak within the maximum lag
+    long maxBins = std::min((long) floor(maxLag / resolution), (long) n - 1);
+    long best = 0;
+    double peak = aRe[0];
+    for (long k = -maxBins; k <= maxBins; ++k) {
+        double r = aRe[(k >= 0) ? k : nFft + k];
+        if (r > peak) {
+            peak = r;
+            best = k;
+        }
+    }
+
+    // Parabolic refinement
+    double delta = 0.0;
+    if ((best > -maxBins) && (best < maxBins)) {
+        double left = aRe[(best - 1 >= 0) ? best - 1 : nFft + best - 1];
+        double right = aRe[(best + 1 >= 0) ? best + 1 : nFft + best + 1];
+        double den = left - 2.0 * peak + right;
+        if (den < 0.0) {
+            delta = 0.5 * (left - right) / den;
+        }
+    }
+
+    o_estimate.lag = (best + delta) * resolution;
+    o_estimate.confidence = peak / sqrt(energyA * energyB);
+    o_estimate.valid = true;
+
+    return true;
+}
+
+double LagEstimator::resample(const vector<double> &i_time, const vector<double> &i_values, const double &i_start,
+        const size_t &i_n, vector<double> &o_grid) {
+    // Linear interpolation, the times are increasing
+    size_t j = 0;
+    double mean = 0.0;
+    for (size_t i = 0; i < i_n; ++i) {
+        double t = i_start + i * resolution;
+        while ((j + 2 < i_time.size()) && (i_time[j + 1] < t)) {
+            ++j;
+        }
+        double dt = i_time[j + 1] - i_time[j];
+        double w = (dt > 0.0) ? (t - i_time[j]) / dt : 0.0;
+        w = std::max(0.0, std::min(1.0, w));
+        // Exact on flat stretches, so that a constant signal has no energy
+        o_grid[i] = i_values[j] + w * (i_values[j + 1] - i_values[j]);
+    }
+
+    // Difference over the smoothing span: the derivative filtered by a moving average
+    size_t m = std::min((size_t) span, i_n - 1);
+    mean = 0.0;
+    for (size_t i = 0; i + m < i_n; ++i) {
+        o_grid[i] = o_grid[i + m] - o_grid[i];
+        mean += o_grid[i];
+    }
+    mean /= (i_n - m);
+    for (size_t i = 0; i + m < i_n; ++i) {
+        o_grid[i] -= mean;
+    }
+    for (size_t i = i_n - m; i < i_n; ++i) {
+        o_grid[i] = 0.0;
+    }
+    std::fill(o_grid.begin() + i_n, o_grid.end(), 0.0);
+
+    double energy = 0.0;
+    for (size_t i = 0; i < i_n; ++i) {
+        energy += o_grid[i] * o_grid[i];
+    }
+
+    return energy;
+}
+
+void LagEstimator::transform(vector<double> &io_re, vector<double> &io_im, const bool &i_inverse) {
+    for (size_t i = 0; i < nFft; ++i) {
+        size_t j = bitReverse[i];
+        if (i < j) {
+            std::swap(io_re[i], io_re[j]);
+            std::swap(io_im[i], io_im[j]);
+        }
+    }
+
+    const double sign = i_inverse ? 1.0 : -1.0;
+    for (size_t len = 2; len <= nFft; len <<= 1) {
+        size_t half = len / 2;
+        size_t step = nFft / len;
+        for (size_t i = 0; i < nFft; i += len) {
+            for (size_t k = 0; k < half; ++k) {
+                double wr = cosTable[k * step];
+                double wi = sign * sinTable[k * step];
+                size_t p = i + k;
+                size_t q = p + half;
+                double tr = wr * io_re[q] - wi * io_im[q];
+                double ti = wr * io_im[q] + wi * io_re[q];
+                io_re[q] = io_re[p] - tr;
+                io_im[q] = io_im[p] - ti;
+                io_re[p] += tr;
+                io_im[p] += ti;
+            }
+        }
+    }
+
+    if (i_inverse) {
+        for (size_t i = 0; i < nFft; ++i) {
+            io_re[i] /= nFft;
+            io_im[i] /= nFft;
+        }
+    }
+}
+/* *********************************************************************************************************************** */
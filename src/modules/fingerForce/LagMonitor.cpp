@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "LagMonitor.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::LagMonitor;
+using iCub::interactionForces::LagSignals;
+using iCub::interactionForces::LagEstimate;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+LagMonitor::LagMonitor() {
+    active = false;
+    minConfidence = 0.5;
+    expectedLag = 0.0;
+    tolerance = 0.0;
+
+    dbgTag = "LagMonitor: ";
+}
+
+LagMonitor::~LagMonitor() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the monitor                                            ********************************************** */
+bool LagMonitor::configure(const Bottle &i_group, const string &i_portName, const vector<int> &i_fingertips) {
+    double window = i_group.check("window", Value(10.0), "Maximum analysed duration of a pinch in seconds.").asDouble();
+    double resolution = i_group.check("resolution", Value(0.001), "Correlation grid period in seconds.").asDouble();
+    double maxLag = i_group.check("maxLag", Value(0.2), "Maximum absolute lag in seconds.").asDouble();
+    double smoothing = i_group.check("smoothing", Value(0.05), "Span of the signal differences in seconds.").asDouble();
+    minConfidence = i_group.check("minConfidence", Value(0.5), "Minimum peak correlation of a reliable estimate.").asDouble();
+    expectedLag = i_group.check("expectedLag", Value(0.0), "Expected skin lag in seconds.").asDouble();
+    tolerance = i_group.check("tolerance", Value(0.0), "Warn when the lag differs from the expected one by more than this, 0 to disable.").asDouble();
+    if (!estimator.setup(window, resolution, maxLag, smoothing)) {
+        cerr << dbgTag << "Invalid lag estimator window, resolution or maximum lag. \n";
+        return false;
+    }
+
+    fingertips = i_fingertips;
+    Bottle *tips = i_group.find("fingertips").asList();
+    if (tips != NULL) {
+        fingertips.clear();
+        for (int i = 0; i < tips->size(); ++i) {
+            fingertips.push_back(tips->get(i).asInt());
+        }
+    }
+    for (size_t i = 0; i < fingertips.size(); ++i) {
+        if ((fingertips[i] < 0) || (fingertips[i] > 4)) {
+            cerr << dbgTag << "Invalid fingertip index " << fingertips[i] << ". \n";
+            return false;
+        }
+    }
+
+    // Only the last window is analysed: keep it, with the maximum lag, in twice the room of 1 kHz force and
+    // 100 Hz skin samples, so that a long pinch trims the buffers instead of growing them on the sensor thread
+    double span = window + maxLag;
+    signals.bound(span, (size_t) (2.0 * span * 1000.0), (size_t) (2.0 * span * 100.0), fingertips.size());
+
+    if (!lagPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Cross-correlating " << fingertips.size() << " fingertips with a transform size of "
+        << estimator.getTransformSize() << ". \n";
+#endif
+
+    return true;
+}
+
+void LagMonitor::interrupt() {
+    lagPort.interrupt();
+}
+
+void LagMonitor::close() {
+    lagPort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Recording                                                        ********************************************** */
+void LagMonitor::begin(void) {
+    mutex.lock();
+    signals.clear();
+    active = true;
+    mutex.unlock();
+}
+
+void LagMonitor::end(LagSignals &o_signals) {
+    mutex.lock();
+    active = false;
+    o_signals = signals;
+    mutex.unlock();
+}
+
+void LagMonitor::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    double stamp = (i_sample.envTime > 0.0) ? i_sample.envTime : i_sample.rxTime;
+
+    mutex.lock();
+    if (active) {
+        if (i_stream == STREAM_WRENCH) {
+            signals.addWrench(stamp, i_sample.data, i_sample.size);
+        } else if (i_stream == STREAM_SKIN_COMP) {
+            signals.addSkin(stamp, i_sample.data, i_sample.size, fingertips);
+        }
+    }
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Analysis                                                         ********************************************** */
+void LagMonitor::analyse(const int &i_pinch, const LagSignals &i_signals) {
+    stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    for (size_t k = 0; (k < fingertips.size()) && (k < i_signals.skin.size()); ++k) {
+        LagEstimate estimate;
+        if (!estimator.estimate(i_signals.forceTime, i_signals.force, i_signals.skinTime, i_signals.skin[k], estimate)) {
+            ss << dbgTag << "Pinch " << i_pinch << " fingertip " << fingertips[k] << ": no estimate. \n";
+            continue;
+        }
+
+        ss << dbgTag << "Pinch " << i_pinch << " fingertip " << fingertips[k] << ": skin lag " << 1000.0 * estimate.lag
+            << " ms, confidence " << estimate.confidence;
+        if (estimate.confidence < minConfidence) {
+            ss << " (unreliable)";
+        } else if ((tolerance > 0.0) && (fabs(estimate.lag - expectedLag) > tolerance)) {
+            ss << " (regression: expected " << 1000.0 * expectedLag << " ms)";
+        }
+        ss << ". \n";
+
+        Bottle &out = lagPort.prepare();
+        out.clear();
+        out.addString("lag");
+        out.addInt(i_pinch);
+        out.addInt(fingertips[k]);
+        out.addDouble(estimate.lag);
+        out.addDouble(estimate.confidence);
+        lagPort.write();
+    }
+
+    cout << ss.str();
+
+    reportMutex.lock();
+    report = ss.str();
+    reportMutex.unlock();
+}
+
+string LagMonitor::getReport(void) {
+    reportMutex.lock();
+    string current = report;
+    reportMutex.unlock();
+
+    return current;
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,329 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "OnsetDetector.h"
+
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::OnsetDetector;
+using iCub::interactionForces::ContactOnset;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+
+const int OnsetDetector::SOURCE_FT;
+
+OnsetDetector::OnsetDetector() {
+    method = METHOD_CUSUM;
+    threshold = 5.0;
+    drift = 0.5;
+    baselineRate = 0.02;
+    fitWindow = 8;
+    ftAxis = 2;
+    ftSignValue = 1.0;
+
+    armed = false;
+    pinch = -1;
+    generation = 0;
+    // The onsets are recorded by the sensor threads without allocating
+    onsets.reserve(MAX_CONTACT_ONSETS);
+
+    dbgTag = "OnsetDetector: ";
+}
+
+OnsetDetector::~OnsetDetector() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the detector                                           ********************************************** */
+bool OnsetDetector::configure(const Bottle &i_group, const string &i_portName) {
+    string methodName = i_group.check("method", Value("cusum"), "The detection method (cusum|threshold).").asString().c_str();
+    if (methodName == "cusum") {
+        method = METHOD_CUSUM;
+    } else if (methodName == "threshold") {
+        method = METHOD_THRESHOLD;
+    } else {
+        cerr << dbgTag << "Unknown detection method " << methodName << ". Expecting cusum or threshold. \n";
+        return false;
+    }
+    threshold = i_group.check("threshold", Value(5.0), "Detection threshold in baseline standard deviations.").asDouble();
+    drift = i_group.check("drift", Value(0.5), "CUSUM drift in baseline standard deviations.").asDouble();
+    baselineRate = i_group.check("baselineRate", Value(0.02), "Baseline adaptation rate while disarmed.").asDouble();
+    fitWindow = i_group.check("fitWindow", Value(8), "Maximum number of rising samples used to interpolate the onset.").asInt();
+    ftAxis = i_group.check("ftAxis", Value(2), "The nano17 normal force axis.").asInt();
+    double ftSign = i_group.check("ftSign", Value(1.0), "Sign of the normal force when pressing.").asDouble();
+    double minSkin = i_group.check("minSkin", Value(2.0), "Minimum taxel sum deviation for an onset.").asDouble();
+    double minForce = i_group.check("minForce", Value(0.01), "Minimum normal force deviation for an onset.").asDouble();
+    if ((fitWindow < 2) || (ftAxis < 0) || (ftAxis > 5)) {
+        cerr << dbgTag << "Invalid fit window or force axis. \n";
+        return false;
+    }
+
+    fingertips.clear();
+    Bottle *tips = i_group.find("fingertips").asList();
+    if (tips != NULL) {
+        for (int i = 0; i < tips->size(); ++i) {
+            int f = tips->get(i).asInt();
+            if ((f < 0) || (f > 4)) {
+                cerr << dbgTag << "Invalid fingertip index " << f << ". \n";
+                return false;
+            }
+            fingertips.push_back(f);
+        }
+    } else {
+        for (int f = 0; f < 5; ++f) {
+            fingertips.push_back(f);
+        }
+    }
+
+    // Preallocate all buffers
+    skinChannels.resize(fingertips.size());
+    for (size_t i = 0; i < skinChannels.size(); ++i) {
+        setupChannel(skinChannels[i], fingertips[i], minSkin);
+    }
+    setupChannel(ftChannel, SOURCE_FT, minForce);
+    ftSignValue = (ftSign < 0.0) ? -1.0 : 1.0;
+
+    if (!eventPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Detecting the onsets of " << fingertips.size() << " fingertips and the nano17 with "
+        << getMethodName(method) << ". \n";
+#endif
+
+    return true;
+}
+
+void OnsetDetector::setupChannel(OnsetChannel &o_channel, const int &i_source, const double &i_minDelta) {
+    o_channel.source = i_source;
+    o_channel.minDelta = i_minDelta;
+    o_channel.mean = 0.0;
+    o_channel.var = 0.0;
+    o_channel.nBaseline = 0;
+    o_channel.cusum = 0.0;
+    o_channel.times.assign(fitWindow + 1, 0.0);
+    o_channel.values.assign(fitWindow + 1, 0.0);
+    o_channel.head = 0;
+    o_channel.count = 0;
+    o_channel.generation = 0;
+    o_channel.found = false;
+}
+
+void OnsetDetector::interrupt() {
+    eventPort.interrupt();
+}
+
+void OnsetDetector::close() {
+    eventPort.close();
+}
+
+const char* OnsetDetector::getMethodName(const Method i_method) {
+    return (i_method == METHOD_CUSUM) ? "cusum" : "threshold";
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Arming                                                           ********************************************** */
+void OnsetDetector::arm(const int &i_pinch) {
+    mutex.lock();
+    armed = true;
+    pinch = i_pinch;
+    // The channels reset themselves in their own thread on the next sample
+    generation++;
+    onsets.clear();
+    mutex.unlock();
+}
+
+void OnsetDetector::disarm() {
+    mutex.lock();
+    armed = false;
+    mutex.unlock();
+}
+
+int OnsetDetector::getOnsets(ContactOnset *o_onsets, const int &i_size) {
+    mutex.lock();
+    int n = std::min((int) onsets.size(), i_size);
+    std::copy(onsets.begin(), onsets.begin() + n, o_onsets);
+    mutex.unlock();
+
+    return n;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sample processing                                                ********************************************** */
+void OnsetDetector::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    bool envelope = (i_sample.envTime > 0.0);
+    double stamp = envelope ? i_sample.envTime : i_sample.rxTime;
+
+    if ((i_stream == STREAM_SKIN_COMP) && (i_sample.size >= SKIN_TAXELS)) {
+        for (size_t k = 0; k < fingertips.size(); ++k) {
+            const double *x = i_sample.data + fingertips[k] * FINGERTIP_TAXELS;
+            double sum = 0.0;
+            for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+                sum += x[i];
+            }
+            process(skinChannels[k], stamp, i_sample.rxTime, sum, envelope);
+        }
+    } else if ((i_stream == STREAM_WRENCH) && (i_sample.size > (size_t) ftAxis)) {
+        process(ftChannel, stamp, i_sample.rxTime, ftSignValue * i_sample.data[ftAxis], envelope);
+    }
+}
+
+void OnsetDetector::process(OnsetChannel &io_channel, const double &i_time, const double &i_received, const double &i_value,
+        const bool &i_envelope) {
+    mutex.lock();
+    bool isArmed = armed;
+    int current = pinch;
+    unsigned int currentGeneration = generation;
+    mutex.unlock();
+
+    if (io_channel.generation != currentGeneration) {
+        io_channel.generation = currentGeneration;
+        io_channel.cusum = 0.0;
+        io_channel.found = false;
+    }
+
+    // Latest samples, used by the interpolation
+    io_channel.times[io_channel.head] = i_time;
+    io_channel.values[io_channel.head] = i_value;
+    io_channel.head = (io_channel.head + 1) % io_channel.times.size();
+    if (io_channel.count < io_channel.times.size()) {
+        io_channel.count++;
+    }
+
+    if (!isArmed) {
+        // Exponentially weighted baseline mean and variance
+        if (io_channel.nBaseline == 0) {
+            io_channel.mean = i_value;
+            io_channel.var = 0.0;
+        } else {
+            double d = i_value - io_channel.mean;
+            io_channel.mean += baselineRate * d;
+            io_channel.var = (1.0 - baselineRate) * (io_channel.var + baselineRate * d * d);
+        }
+        io_channel.nBaseline++;
+        return;
+    }
+    if (io_channel.found || (io_channel.nBaseline < 2)) {
+        return;
+    }
+
+    double sigma = std::max(sqrt(io_channel.var), 1e-9);
+    double deviation = i_value - io_channel.mean;
+    bool alarm = false;
+    if (method == METHOD_CUSUM) {
+        io_channel.cusum = std::max(0.0, io_channel.cusum + deviation / sigma - drift);
+        alarm = (io_channel.cusum > threshold);
+    } else {
+        alarm = (deviation > threshold * sigma);
+    }
+    if (!alarm || (deviation < io_channel.minDelta)) {
+        return;
+    }
+
+    io_channel.found = true;
+
+    ContactOnset onset;
+    onset.source = io_channel.source;
+    onset.pinch = current;
+    onset.time = refine(io_channel, sigma);
+    onset.detected = i_time;
+    onset.amplitude = deviation;
+    onset.envelope = i_envelope;
+    onset.received = i_received;
+    emit(onset);
+}
+
+double OnsetDetector::refine(const OnsetChannel &i_channel, const double &i_sigma) const {
+    const size_t size = i_channel.times.size();
+    const size_t newest = (i_channel.head + size - 1) % size;
+    const double t0 = i_channel.times[newest];
+
+    // Least squares line through the rising samples, times relative to the detection
+    double st = 0.0, sx = 0.0, stt = 0.0, stx = 0.0;
+    int n = 0;
+    double earliest = 0.0;
+    for (size_t k = 0; k < i_channel.count; ++k) {
+        size_t i = (newest + size - k) % size;
+        double t = i_channel.times[i] - t0;
+        double x = i_channel.values[i];
+        earliest = t;
+        if (x - i_channel.mean <= i_sigma) {
+            // Last sample at the baseline level
+            break;
+        }
+        st += t;
+        sx += x;
+        stt += t * t;
+        stx += t * x;
+        n++;
+    }
+
+    double onset = earliest;
+    if (n >= 2) {
+        double den = n * stt - st * st;
+        double slope = (den > 0.0) ? (n * stx - st * sx) / den : 0.0;
+        if (slope > 0.0) {
+            // Intersection of the line with the baseline
+            onset = (st + (i_channel.mean * n - sx) / slope) / n;
+        }
+    }
+
+    // The onset lies between the last quiet sample, or the oldest sample kept, and the detection
+    onset = std::max(earliest, std::min(onset, 0.0));
+
+    return t0 + onset;
+}
+
+void OnsetDetector::emit(const ContactOnset &i_onset) {
+    mutex.lock();
+    onsets.push_back(i_onset);
+    mutex.unlock();
+
+    portMutex.lock();
+    Bottle &out = eventPort.prepare();
+    out.clear();
+    out.addString("onset");
+    out.addInt(i_onset.pinch);
+    out.addInt(i_onset.source);
+    out.addDouble(i_onset.time);
+    out.addDouble(i_onset.detected);
+    out.addDouble(i_onset.amplitude);
+    eventPort.write();
+    portMutex.unlock();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "OnsetReport.h"
+#include "OnsetDetector.h"
+#include "StallDetector.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+using std::cout;
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::OnsetReport;
+using iCub::interactionForces::OnsetReportJob;
+using iCub::interactionForces::ContactOnset;
+using iCub::interactionForces::OnsetDetector;
+using iCub::interactionForces::StallDetector;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Onset report                                                     ********************************************** */
+OnsetReport::OnsetReport() {
+    dbgTag = "OnsetReport: ";
+}
+
+void OnsetReport::build(const ContactOnset *i_onsets, const int &i_count) {
+    stringstream ss;
+    ss << std::fixed;
+
+    const ContactOnset *ft = NULL;
+    for (int i = 0; i < i_count; ++i) {
+        if (i_onsets[i].source == OnsetDetector::SOURCE_FT) {
+            ft = &i_onsets[i];
+        }
+    }
+
+    if (i_count == 0) {
+        ss << dbgTag << "No contact onset detected. \n";
+    }
+    for (int i = 0; i < i_count; ++i) {
+        const ContactOnset &onset = i_onsets[i];
+        ss << dbgTag << "Contact onset of ";
+        if (onset.source == OnsetDetector::SOURCE_FT) {
+            ss << "nano17";
+        } else if (onset.source == StallDetector::SOURCE_FINGER_JOINT) {
+            ss << "finger joint stall";
+        } else if (onset.source == StallDetector::SOURCE_THUMB_JOINT) {
+            ss << "thumb joint stall";
+        } else {
+            ss << "fingertip " << onset.source;
+        }
+        ss << std::setprecision(4) << " at " << onset.time << " s (detected " << 1000.0 * (onset.detected - onset.time) << " ms later)";
+        if (ft && (&onset != ft)) {
+            ss << ", lag to nano17 " << 1000.0 * (onset.time - ft->time) << " ms";
+        }
+        ss << (onset.envelope ? "" : ", receive time") << ". \n";
+    }
+    cout << ss.str();
+
+    mutex.lock();
+    report = ss.str();
+    mutex.unlock();
+}
+
+string OnsetReport::get(void) {
+    mutex.lock();
+    string current = report;
+    mutex.unlock();
+
+    return current;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pipeline job                                                     ********************************************** */
+void OnsetReportJob::setup(OnsetReport *i_report, const ContactOnset *i_onsets, const int &i_count) {
+    report = i_report;
+    count = std::min(i_count, MAX_CONTACT_ONSETS);
+    std::copy(i_onsets, i_onsets + count, onsets);
+}
+/* *********************************************************************************************************************** */
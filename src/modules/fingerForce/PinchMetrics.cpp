@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "PinchMetrics.h"
+
+#include <cmath>
+#include <algorithm>
+#include <iomanip>
+
+using std::vector;
+using std::ostream;
+
+using iCub::interactionForces::PinchMetrics;
+using iCub::interactionForces::PinchSummary;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+
+PinchMetrics::PinchMetrics() {
+    joint = 11;
+    reset(0, 0.0);
+}
+
+void PinchMetrics::setup(const int &i_joint, const vector<int> &i_fingertips) {
+    joint = i_joint;
+    fingertips.clear();
+    for (size_t i = 0; i < i_fingertips.size(); ++i) {
+        if ((i_fingertips[i] >= 0) && (i_fingertips[i] < 5)) {
+            fingertips.push_back(i_fingertips[i]);
+        }
+    }
+}
+
+void PinchMetrics::reset(const int &i_index, const double &i_start) {
+    summary.index = i_index;
+    summary.start = i_start;
+    summary.end = i_start;
+    summary.depth = -HUGE_VAL;
+    summary.peakForce = 0.0;
+    summary.meanForce = 0.0;
+    summary.peakSkin = 0.0;
+    summary.meanSkin = 0.0;
+    summary.nJoints = 0;
+    summary.nForce = 0;
+    summary.nSkin = 0;
+
+    forceSum = 0.0;
+    skinSum = 0.0;
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Samples                                                          ********************************************** */
+void PinchMetrics::addJoints(const double *i_joints, const size_t &i_size) {
+    if ((joint >= 0) && ((size_t) joint < i_size)) {
+        addDepth(i_joints[joint]);
+    }
+}
+
+void PinchMetrics::addDepth(const double &i_position) {
+    summary.depth = std::max(summary.depth, i_position);
+    summary.nJoints++;
+}
+
+void PinchMetrics::addWrench(const double *i_wrench, const size_t &i_size) {
+    if (i_size >= 3) {
+        // Norm of the force
+        double f = sqrt(i_wrench[0]*i_wrench[0] + i_wrench[1]*i_wrench[1] + i_wrench[2]*i_wrench[2]);
+        summary.peakForce = std::max(summary.peakForce, f);
+        forceSum += f;
+        summary.nForce++;
+    }
+}
+
+void PinchMetrics::addSkin(const double *i_skin, const size_t &i_size) {
+    if (i_size >= SKIN_TAXELS) {
+        // Sum of the compensated taxels of the fingertips in contact
+        double s = 0.0;
+        for (size_t k = 0; k < fingertips.size(); ++k) {
+            const double *tip = i_skin + fingertips[k] * FINGERTIP_TAXELS;
+            for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+                s += tip[i];
+            }
+        }
+        summary.peakSkin = std::max(summary.peakSkin, s);
+        skinSum += s;
+        summary.nSkin++;
+    }
+}
+
+void PinchMetrics::merge(const PinchMetrics &i_other) {
+    summary.start = std::min(summary.start, i_other.summary.start);
+    summary.end = std::max(summary.end, i_other.summary.end);
+    summary.depth = std::max(summary.depth, i_other.summary.depth);
+    summary.peakForce = std::max(summary.peakForce, i_other.summary.peakForce);
+    summary.peakSkin = std::max(summary.peakSkin, i_other.summary.peakSkin);
+    summary.nJoints += i_other.summary.nJoints;
+    summary.nForce += i_other.summary.nForce;
+    summary.nSkin += i_other.summary.nSkin;
+
+    forceSum += i_other.forceSum;
+    skinSum += i_other.skinSum;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Summary                                                          ********************************************** */
+const PinchSummary& PinchMetrics::finish(const double &i_end) {
+    summary.end = i_end;
+    summary.meanForce = (summary.nForce > 0) ? forceSum / summary.nForce : 0.0;
+    summary.meanSkin = (summary.nSkin > 0) ? skinSum / summary.nSkin : 0.0;
+    if (summary.nJoints == 0) {
+        summary.depth = 0.0;
+    }
+
+    return summary;
+}
+
+const PinchSummary& PinchMetrics::getSummary(void) const {
+    return summary;
+}
+
+void PinchMetrics::writeHeader(ostream &o_stream) {
+    o_stream << "index\tstart\tend\tduration\tdepth\tpeakForce\tmeanForce\tpeakSkin\tmeanSkin\tnJoints\tnForce\tnSkin\n";
+}
+
+void PinchMetrics::write(ostream &o_stream, const PinchSummary &i_summary) {
+    o_stream << i_summary.index << "\t"
+        << std::fixed
+        << i_summary.start << "\t" << i_summary.end << "\t" << i_summary.end - i_summary.start << "\t"
+        << i_summary.depth << "\t"
+        << i_summary.peakForce << "\t" << i_summary.meanForce << "\t"
+        << i_summary.peakSkin << "\t" << i_summary.meanSkin << "\t"
+        << std::resetiosflags(std::ios::floatfield)
+        << i_summary.nJoints << "\t" << i_summary.nForce << "\t" << i_summary.nSkin << "\n";
+}
+/* *********************************************************************************************************************** */
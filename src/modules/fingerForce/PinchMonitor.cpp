@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "PinchMonitor.h"
+
+using std::vector;
+
+using iCub::interactionForces::PinchMonitor;
+using iCub::interactionForces::PinchMetrics;
+
+
+PinchMonitor::PinchMonitor(const int &i_joint, const vector<int> &i_fingertips) {
+    metrics.setup(i_joint, i_fingertips);
+    active = false;
+}
+
+void PinchMonitor::setup(const int &i_joint, const vector<int> &i_fingertips) {
+    mutex.lock();
+    metrics.setup(i_joint, i_fingertips);
+    mutex.unlock();
+}
+
+void PinchMonitor::begin(const int &i_index, const double &i_time) {
+    mutex.lock();
+    metrics.reset(i_index, i_time);
+    active = true;
+    mutex.unlock();
+}
+
+void PinchMonitor::end(PinchMetrics &o_metrics) {
+    mutex.lock();
+    active = false;
+    o_metrics = metrics;
+    mutex.unlock();
+}
+
+void PinchMonitor::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    mutex.lock();
+    if (active) {
+        switch (i_stream) {
+            case STREAM_JOINTS:
+                metrics.addJoints(i_sample.data, i_sample.size);
+                break;
+            case STREAM_WRENCH:
+                metrics.addWrench(i_sample.data, i_sample.size);
+                break;
+            case STREAM_SKIN_COMP:
+                metrics.addSkin(i_sample.data, i_sample.size);
+                break;
+            default:
+                break;
+        }
+    }
+    mutex.unlock();
+}
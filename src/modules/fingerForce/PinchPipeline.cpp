@@ -0,0 +1,292 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "PinchPipeline.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <yarp/os/Time.h>
+
+using std::cout;
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::PinchPipeline;
+using iCub::interactionForces::PinchSummaryJob;
+using iCub::interactionForces::SegmentJob;
+using iCub::interactionForces::IndexCloseJob;
+using iCub::interactionForces::ResultFlushJob;
+using iCub::interactionForces::PipelineJob;
+using iCub::interactionForces::JobPool;
+using iCub::interactionForces::PipelineStats;
+using iCub::interactionForces::PinchMetrics;
+using iCub::interactionForces::PinchSummary;
+using iCub::interactionForces::ExperimentParameters;
+using iCub::interactionForces::ExperimentConfig;
+using iCub::interactionForces::ResultStore;
+using iCub::interactionForces::ResultWriter;
+
+using yarp::os::Time;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Job pool                                                         ********************************************** */
+void PipelineJob::release(void) {
+    if (pool != NULL) {
+        pool->give(this);
+    } else {
+        delete this;
+    }
+}
+
+JobPool::JobPool() {
+    misses = 0;
+}
+
+JobPool::~JobPool() {
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        delete jobs[i];
+    }
+}
+
+void JobPool::add(PipelineJob *i_job) {
+    i_job->pool = this;
+
+    mutex.lock();
+    jobs.push_back(i_job);
+    free.push_back(i_job);
+    mutex.unlock();
+}
+
+PipelineJob* JobPool::takeFree(void) {
+    PipelineJob *job = NULL;
+
+    mutex.lock();
+    if (!free.empty()) {
+        job = free.back();
+        free.pop_back();
+    } else {
+        misses++;
+    }
+    mutex.unlock();
+
+    return job;
+}
+
+void JobPool::give(PipelineJob *i_job) {
+    mutex.lock();
+    free.push_back(i_job);
+    mutex.unlock();
+}
+
+unsigned int JobPool::getMisses(void) {
+    mutex.lock();
+    unsigned int current = misses;
+    mutex.unlock();
+
+    return current;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Bookkeeping jobs                                                 ********************************************** */
+void PinchSummaryJob::setup(const double &i_end, ResultWriter *i_writer) {
+    end = i_end;
+    writer = i_writer;
+    result.clear();
+}
+
+void PinchSummaryJob::setContext(const string &i_session, const string &i_hand, const ExperimentParameters &i_params) {
+    session = i_session;
+    hand = i_hand;
+    params = i_params;
+}
+
+void PinchSummaryJob::execute(void) {
+    PinchSummary summary = metrics.finish(end);
+
+    stringstream ss;
+    ss << "PinchPipeline: " << "Pinch summary: \n";
+    PinchMetrics::writeHeader(ss);
+    PinchMetrics::write(ss, summary);
+    cout << ss.str();
+
+    if (writer != NULL) {
+        result.text[iCub::interactionForces::RESULT_SESSION] = session;
+        result.text[iCub::interactionForces::RESULT_HAND] = hand;
+        result.text[iCub::interactionForces::RESULT_FINGER] = ResultStore::getFingerName(params.finger.joint);
+        result.text[iCub::interactionForces::RESULT_CONFIG] = ExperimentConfig::snapshot(params);
+        result.setSummary(summary);
+        writer->append(result);
+    }
+}
+
+void ResultFlushJob::execute(void) {
+    writer->flush();
+}
+
+void SegmentJob::execute(void) {
+    index->write(segment);
+}
+
+void IndexCloseJob::execute(void) {
+    index->close();
+    delete index;
+    index = NULL;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pipeline                                                         ********************************************** */
+PinchPipeline::PinchPipeline(const int aCapacity)
+    : queue(std::max(aCapacity, 1)), items(0), slots(std::max(aCapacity, 1)) {
+        head = 0;
+        count = 0;
+        stats.jobs = 0;
+        stats.pending = 0;
+        stats.maxPending = 0;
+        stats.stalls = 0;
+        stats.stallTime = 0.0;
+        stats.meanJobTime = 0.0;
+        stats.maxJobTime = 0.0;
+        stats.maxLatency = 0.0;
+        jobTimeSum = 0.0;
+
+        dbgTag = "PinchPipeline: ";
+}
+
+PinchPipeline::~PinchPipeline() {}
+
+void PinchPipeline::push(PipelineJob *i_job) {
+    Entry entry;
+    entry.job = i_job;
+    entry.pushed = Time::now();
+
+    if (!isRunning()) {
+        execute(entry);
+        return;
+    }
+
+    // Only wait on bookkeeping when the worker is a full queue behind
+    if (!slots.check()) {
+        slots.wait();
+        double stall = Time::now() - entry.pushed;
+
+        mutex.lock();
+        stats.stalls++;
+        stats.stallTime += stall;
+        mutex.unlock();
+#ifndef NODEBUG
+        cout << "DEBUG: " << dbgTag << "Stalled for " << 1000.0 * stall << " ms waiting for a free slot. \n";
+#endif
+    }
+
+    mutex.lock();
+    queue[(head + count) % queue.size()] = entry;
+    count++;
+    stats.pending = count;
+    stats.maxPending = std::max(stats.maxPending, stats.pending);
+    mutex.unlock();
+    items.post();
+}
+
+void PinchPipeline::run(void) {
+    while (!isStopping()) {
+        items.wait();
+
+        mutex.lock();
+        if (count == 0) {
+            // Woken up to stop
+            mutex.unlock();
+            continue;
+        }
+        Entry entry = queue[head];
+        head = (head + 1) % queue.size();
+        count--;
+        stats.pending = count;
+        mutex.unlock();
+
+        execute(entry);
+        slots.post();
+    }
+}
+
+void PinchPipeline::onStop(void) {
+    items.post();
+}
+
+void PinchPipeline::threadRelease(void) {
+    // Drain the queue so that no bookkeeping is lost on close
+    mutex.lock();
+    std::vector<Entry> remaining;
+    for (; count > 0; count--) {
+        remaining.push_back(queue[head]);
+        head = (head + 1) % queue.size();
+    }
+    stats.pending = 0;
+    mutex.unlock();
+
+    for (size_t i = 0; i < remaining.size(); ++i) {
+        execute(remaining[i]);
+        slots.post();
+    }
+}
+
+void PinchPipeline::execute(const Entry &i_entry) {
+    double start = Time::now();
+    i_entry.job->execute();
+    i_entry.job->release();
+    double done = Time::now();
+
+    mutex.lock();
+    stats.jobs++;
+    jobTimeSum += done - start;
+    stats.meanJobTime = jobTimeSum / stats.jobs;
+    stats.maxJobTime = std::max(stats.maxJobTime, done - start);
+    stats.maxLatency = std::max(stats.maxLatency, done - i_entry.pushed);
+    mutex.unlock();
+}
+
+PipelineStats PinchPipeline::getStats(void) {
+    mutex.lock();
+    PipelineStats current = stats;
+    mutex.unlock();
+
+    return current;
+}
+
+string PinchPipeline::getReport(void) {
+    PipelineStats current = getStats();
+
+    stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+    ss << "jobs " << current.jobs << " pending " << current.pending << " maxPending " << current.maxPending
+        << " stalls " << current.stalls << " stallTime " << current.stallTime
+        << " meanJobMs " << 1000.0 * current.meanJobTime << " maxJobMs " << 1000.0 * current.maxJobTime
+        << " maxLatencyMs " << 1000.0 * current.maxLatency << "\n";
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "PoseService.h"
+#include "Transport.h"
+
+#include <iostream>
+
+#include <yarp/os/Stamp.h>
+
+using std::cout;
+using std::string;
+
+using iCub::interactionForces::PoseService;
+
+using yarp::sig::Vector;
+
+
+/** Number of stream periods without a pose after which the velocity is no longer extrapolated. */
+static const double STALE_PERIODS = 3.0;
+
+
+PoseService::PoseService(Clock *aClock, const double &aVelocityFilter)
+    : clock(aClock), velocityFilter(aVelocityFilter) {
+        position.resize(3, 0.0);
+        orientation.resize(4, 0.0);
+        velocity.resize(3, 0.0);
+        stamp = 0.0;
+        sourceStamp = 0.0;
+        sourceEnvelope = false;
+        period = 0.0;
+        count = 0;
+
+        dbgTag = "PoseService: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Open the pose port                                               ********************************************** */
+bool PoseService::open(const string &i_localName, const string &i_remoteName, const string &i_carrier, const bool i_shmem) {
+    if (!yarp::os::BufferedPort<Vector>::open(i_localName.c_str())) {
+        return false;
+    }
+    useCallback();
+
+    transport = iCub::interactionForces::Transport::connect(i_remoteName, i_localName, i_carrier, i_shmem);
+    if (transport.empty()) {
+        cout << dbgTag << "Could not connect to " << i_remoteName << ". Waiting for an external connection. \n";
+        transport = "external";
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pose callback                                                    ********************************************** */
+void PoseService::onRead(Vector &i_pose) {
+    if (i_pose.size() < 7) {
+        return;
+    }
+
+    double now = clock->now();
+
+    // Time the pose at the source when the controller stamps it, so that network jitter does not
+    // show up in the velocity; the receive time is only used when there is no envelope
+    yarp::os::Stamp envelope;
+    bool hasEnvelope = getEnvelope(envelope) && envelope.isValid() && (envelope.getTime() > 0.0);
+    double source = hasEnvelope ? envelope.getTime() : now;
+
+    mutex.lock();
+    if ((count > 0) && (hasEnvelope == sourceEnvelope)) {
+        double dt = source - sourceStamp;
+        if (dt > 1e-6) {
+            for (int i = 0; i < 3; ++i) {
+                double v = (i_pose[i] - position[i]) / dt;
+                velocity[i] += velocityFilter * (v - velocity[i]);
+            }
+            period = (count > 1) ? period + velocityFilter * (dt - period) : dt;
+        }
+    }
+    for (int i = 0; i < 3; ++i) {
+        position[i] = i_pose[i];
+    }
+    for (int i = 0; i < 4; ++i) {
+        orientation[i] = i_pose[i + 3];
+    }
+    stamp = now;
+    sourceStamp = source;
+    sourceEnvelope = hasEnvelope;
+    count++;
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pose accessors                                                   ********************************************** */
+bool PoseService::getPose(Vector &o_position, Vector &o_orientation, double *o_stamp) {
+    mutex.lock();
+    bool ok = (count > 0);
+    o_position = position;
+    o_orientation = orientation;
+    if (o_stamp != NULL) {
+        *o_stamp = stamp;
+    }
+    mutex.unlock();
+
+    return ok;
+}
+
+bool PoseService::getVelocity(Vector &o_velocity) {
+    mutex.lock();
+    bool ok = (count > 1);
+    o_velocity = velocity;
+    mutex.unlock();
+
+    return ok;
+}
+
+bool PoseService::predictPosition(const double &i_lookAhead, Vector &o_position) {
+    double now = clock->now();
+
+    mutex.lock();
+    bool ok = (count > 0);
+    double age = now - stamp;
+    double horizon = i_lookAhead + age;
+    o_position = position;
+    if ((count > 1) && (age > STALE_PERIODS * period)) {
+        // Stalled stream: do not chase the last velocity
+        ok = false;
+    } else if (count > 1) {
+        for (int i = 0; i < 3; ++i) {
+            o_position[i] += velocity[i] * horizon;
+        }
+    }
+    mutex.unlock();
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "RealTime.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/mman.h>
+
+using std::cerr;
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::RealTime;
+using iCub::interactionForces::RealTimeScope;
+using iCub::interactionForces::TickLatency;
+using iCub::interactionForces::ControlLoop;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Process and thread setup                                         ********************************************** */
+bool RealTime::lockMemory(void) {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        cerr << "RealTime: " << "Could not lock the memory: " << strerror(errno) << ". \n";
+        return false;
+    }
+
+    return true;
+}
+
+bool RealTime::setScheduling(const int i_priority, const int i_cpu) {
+    bool ok = true;
+
+    if (i_priority > 0) {
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = std::min(i_priority, sched_get_priority_max(SCHED_FIFO));
+        int error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (error != 0) {
+            cerr << "RealTime: " << "Could not set the real-time scheduling: " << strerror(error) << ". \n";
+            ok = false;
+        }
+    }
+
+    if (i_cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(i_cpu, &cpus);
+        int error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (error != 0) {
+            cerr << "RealTime: " << "Could not set the CPU affinity: " << strerror(error) << ". \n";
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+RealTimeScope::RealTimeScope(const bool i_enable, const int i_priority, const int i_cpu) {
+    active = i_enable && ((i_priority > 0) || (i_cpu >= 0));
+    if (active) {
+        pthread_getschedparam(pthread_self(), &policy, &param);
+        pthread_getaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        RealTime::setScheduling(i_priority, i_cpu);
+    }
+}
+
+RealTimeScope::~RealTimeScope() {
+    if (active) {
+        pthread_setschedparam(pthread_self(), policy, &param);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Tick latency                                                     ********************************************** */
+TickLatency::TickLatency() {
+    reset();
+}
+
+void TickLatency::add(const ControlLoop i_loop, const double &i_scheduled, const double &i_actual) {
+    double latency = std::max(i_actual - i_scheduled, 0.0);
+
+    mutex.lock();
+    count[i_loop]++;
+    sum[i_loop] += latency;
+    max[i_loop] = std::max(max[i_loop], latency);
+    mutex.unlock();
+}
+
+void TickLatency::reset(void) {
+    mutex.lock();
+    for (int i = 0; i < iCub::interactionForces::N_CONTROL_LOOPS; ++i) {
+        count[i] = 0;
+        sum[i] = 0.0;
+        max[i] = 0.0;
+    }
+    mutex.unlock();
+}
+
+string TickLatency::getReport(void) {
+    stringstream ss;
+    ss << std::fixed << std::setprecision(3);
+
+    mutex.lock();
+    for (int i = 0; i < iCub::interactionForces::N_CONTROL_LOOPS; ++i) {
+        ss << getLoopName((ControlLoop) i) << ": " << count[i] << " ticks";
+        if (count[i] > 0) {
+            ss << ", mean " << 1000.0 * sum[i] / count[i] << " ms, max " << 1000.0 * max[i] << " ms";
+        }
+        ss << "\n";
+    }
+    mutex.unlock();
+
+    return ss.str();
+}
+
+const char* TickLatency::getLoopName(const ControlLoop i_loop) {
+    switch (i_loop) {
+        case iCub::interactionForces::LOOP_PROFILE:
+            return "profile";
+        case iCub::interactionForces::LOOP_HOLD:
+            return "hold";
+        case iCub::interactionForces::LOOP_POLL:
+            return "poll";
+        default:
+            return "unknown";
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,972 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "ResultStore.h"
+
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <map>
+#include <limits>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+using std::cerr;
+using std::string;
+using std::vector;
+using std::map;
+using std::stringstream;
+
+using iCub::interactionForces::PinchResult;
+using iCub::interactionForces::PinchSummary;
+using iCub::interactionForces::ResultFilter;
+using iCub::interactionForces::ResultSegment;
+using iCub::interactionForces::ResultWriter;
+using iCub::interactionForces::ResultHandler;
+using iCub::interactionForces::ResultStore;
+
+
+/** File signature and format version. */
+static const char MAGIC[4] = {'F', 'R', 'S', 'T'};
+#define VERSION 2
+
+/** The columns of the version 1 segments, in file order. */
+#define V1_COLUMNS 14
+static const int V1_LAYOUT[V1_COLUMNS] = {
+    iCub::interactionForces::RESULT_SESSION, iCub::interactionForces::RESULT_HAND, iCub::interactionForces::RESULT_FINGER,
+    iCub::interactionForces::RESULT_CONFIG, iCub::interactionForces::RESULT_STAMP, iCub::interactionForces::RESULT_DAY,
+    iCub::interactionForces::RESULT_PINCH, iCub::interactionForces::RESULT_DEPTH, iCub::interactionForces::RESULT_REACHED,
+    iCub::interactionForces::RESULT_DURATION, iCub::interactionForces::RESULT_PEAKFORCE, iCub::interactionForces::RESULT_MEANFORCE,
+    iCub::interactionForces::RESULT_PEAKSKIN, iCub::interactionForces::RESULT_MEANSKIN
+};
+
+/** Size of the file header and of a column entry. */
+#define HEADER_SIZE 16
+#define ENTRY_SIZE 64
+
+/** The segment file extension. */
+static const string EXTENSION = ".frs";
+
+static const char* COLUMN_NAMES[iCub::interactionForces::N_RESULT_COLUMNS] = {
+    "session", "hand", "finger", "config", "stamp", "day", "pinch", "depth", "reached", "duration",
+    "contact", "loaded", "hold", "peakForce", "meanForce", "peakSkin", "meanSkin"
+};
+
+
+/* *********************************************************************************************************************** */
+/* ******* Little endian serialisation                                      ********************************************** */
+static void putU32(vector<unsigned char> &o_buf, const uint32_t i_value) {
+    for (int i = 0; i < 4; ++i) {
+        o_buf.push_back((unsigned char) (i_value >> (8 * i)));
+    }
+}
+
+static void putU64(vector<unsigned char> &o_buf, const uint64_t i_value) {
+    for (int i = 0; i < 8; ++i) {
+        o_buf.push_back((unsigned char) (i_value >> (8 * i)));
+    }
+}
+
+static void putF64(vector<unsigned char> &o_buf, const double i_value) {
+    uint64_t bits;
+    memcpy(&bits, &i_value, sizeof(bits));
+    putU64(o_buf, bits);
+}
+
+static uint32_t getU32(const unsigned char *i_buf) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= ((uint32_t) i_buf[i]) << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t getU64(const unsigned char *i_buf) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= ((uint64_t) i_buf[i]) << (8 * i);
+    }
+    return value;
+}
+
+static double getF64(const unsigned char *i_buf) {
+    uint64_t bits = getU64(i_buf);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Indexes                                                          ********************************************** */
+/** The columns indexed by posting lists. */
+static bool isPosting(const int &i_column) {
+    return (i_column == iCub::interactionForces::RESULT_HAND) || (i_column == iCub::interactionForces::RESULT_FINGER);
+}
+
+/** The columns indexed by sorted rows. */
+static bool isSorted(const int &i_column) {
+    return (i_column == iCub::interactionForces::RESULT_DEPTH) || (i_column == iCub::interactionForces::RESULT_STAMP);
+}
+
+static bool isNaN(const double &i_value) {
+    return i_value != i_value;
+}
+
+/** Order of the values with NaN last, as in the sorted indexes. */
+static bool lessValue(const double &i_a, const double &i_b) {
+    return (i_a < i_b) || (!isNaN(i_a) && isNaN(i_b));
+}
+
+/** Order of the rows of a column by value. */
+struct LessRow {
+    const vector<double> &values;
+
+    LessRow(const vector<double> &aValues) : values(aValues) {}
+
+    bool operator()(const uint32_t &i_a, const uint32_t &i_b) const {
+        return lessValue(values[i_a], values[i_b]);
+    }
+};
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Rows and filters                                                 ********************************************** */
+PinchResult::PinchResult() {
+    clear();
+}
+
+void PinchResult::clear(void) {
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        value[i] = std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+void PinchResult::setStamp(const double &i_stamp) {
+    value[RESULT_STAMP] = i_stamp;
+
+    time_t seconds = (time_t) i_stamp;
+    struct tm date;
+    localtime_r(&seconds, &date);
+    value[RESULT_DAY] = (date.tm_year + 1900) * 10000 + (date.tm_mon + 1) * 100 + date.tm_mday;
+}
+
+void PinchResult::setSummary(const PinchSummary &i_summary) {
+    value[RESULT_PINCH] = i_summary.index;
+    value[RESULT_REACHED] = i_summary.depth;
+    value[RESULT_DURATION] = i_summary.end - i_summary.start;
+    value[RESULT_PEAKFORCE] = i_summary.peakForce;
+    value[RESULT_MEANFORCE] = i_summary.meanForce;
+    value[RESULT_PEAKSKIN] = i_summary.peakSkin;
+    value[RESULT_MEANSKIN] = i_summary.meanSkin;
+}
+
+ResultFilter::ResultFilter() {
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        min[i] = -HUGE_VAL;
+        max[i] = HUGE_VAL;
+    }
+}
+
+bool ResultFilter::isRange(const int &i_column) const {
+    return (i_column >= N_RESULT_TEXT) && ((min[i_column] > -HUGE_VAL) || (max[i_column] < HUGE_VAL));
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Segment reader                                                   ********************************************** */
+ResultSegment::ResultSegment() {
+    file = NULL;
+    nRows = 0;
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        loaded[i] = false;
+        present[i] = false;
+    }
+    for (int i = 0; i < N_RESULT_TEXT; ++i) {
+        hasDictionary[i] = false;
+    }
+    dbgTag = "ResultSegment: ";
+}
+
+ResultSegment::~ResultSegment() {
+    close();
+}
+
+bool ResultSegment::open(const string &i_file) {
+    close();
+
+    file = fopen(i_file.c_str(), "rb");
+    if (file == NULL) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return false;
+    }
+    fileName = i_file;
+
+    // The layout maps the columns of the file to the current columns, NULL if they are the same
+    const int *layout = NULL;
+    uint32_t nColumns = 0;
+    if (read(0, HEADER_SIZE) && (memcmp(&buffer[0], MAGIC, 4) == 0)) {
+        uint32_t version = getU32(&buffer[4]);
+        nColumns = getU32(&buffer[12]);
+        if ((version == 1) && (nColumns == V1_COLUMNS)) {
+            layout = V1_LAYOUT;
+        } else if ((version != VERSION) || (nColumns != N_RESULT_COLUMNS)) {
+            nColumns = 0;
+        }
+    }
+    if ((nColumns == 0) || !read(0, HEADER_SIZE + ENTRY_SIZE * nColumns)) {
+        cerr << dbgTag << i_file << " is not a results segment of a supported version. \n";
+        close();
+        return false;
+    }
+    nRows = getU32(&buffer[8]);
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        present[i] = false;
+        zoneMin[i] = std::numeric_limits<double>::quiet_NaN();
+        zoneMax[i] = std::numeric_limits<double>::quiet_NaN();
+        columnSection[i].offset = columnSection[i].size = 0;
+        indexSection[i].offset = indexSection[i].size = 0;
+        dictionarySection[i].offset = dictionarySection[i].size = 0;
+    }
+    for (uint32_t k = 0; k < nColumns; ++k) {
+        const unsigned char *entry = &buffer[HEADER_SIZE + ENTRY_SIZE * k];
+        int i = (layout != NULL) ? layout[k] : (int) k;
+        present[i] = true;
+        zoneMin[i] = getF64(entry);
+        zoneMax[i] = getF64(entry + 8);
+        columnSection[i].offset = getU64(entry + 16);
+        columnSection[i].size = getU64(entry + 24);
+        indexSection[i].offset = getU64(entry + 32);
+        indexSection[i].size = getU64(entry + 40);
+        dictionarySection[i].offset = getU64(entry + 48);
+        dictionarySection[i].size = getU64(entry + 56);
+    }
+
+    return true;
+}
+
+void ResultSegment::close(void) {
+    if (file != NULL) {
+        fclose(file);
+        file = NULL;
+    }
+    nRows = 0;
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        loaded[i] = false;
+        values[i].clear();
+    }
+    for (int i = 0; i < N_RESULT_TEXT; ++i) {
+        hasDictionary[i] = false;
+        dictionary[i].clear();
+        codes[i].clear();
+    }
+}
+
+bool ResultSegment::read(const uint64_t &i_offset, const uint64_t &i_size) {
+    buffer.resize((size_t) i_size);
+    if (i_size == 0) {
+        return true;
+    }
+    if ((file == NULL) || (fseeko(file, (off_t) i_offset, SEEK_SET) != 0) || (fread(&buffer[0], 1, (size_t) i_size, file) != i_size)) {
+        cerr << dbgTag << "Could not read " << fileName << ". \n";
+        return false;
+    }
+
+    return true;
+}
+
+bool ResultSegment::loadDictionary(const int &i_column) {
+    if (hasDictionary[i_column]) {
+        return true;
+    }
+    const Section &section = dictionarySection[i_column];
+    if ((section.size < 4) || !read(section.offset, section.size)) {
+        return false;
+    }
+    uint32_t nValues = getU32(&buffer[0]);
+    size_t k = 4;
+    dictionary[i_column].resize(nValues);
+    for (uint32_t i = 0; i < nValues; ++i) {
+        if (k + 4 > buffer.size()) {
+            return false;
+        }
+        uint32_t length = getU32(&buffer[k]);
+        k += 4;
+        if (k + length > buffer.size()) {
+            return false;
+        }
+        dictionary[i_column][i].assign((const char *) &buffer[k], length);
+        k += length;
+    }
+    hasDictionary[i_column] = true;
+
+    return true;
+}
+
+bool ResultSegment::load(const int &i_column) {
+    if ((i_column < 0) || (i_column >= N_RESULT_COLUMNS)) {
+        return false;
+    }
+    if (loaded[i_column]) {
+        return true;
+    }
+
+    const Section &section = columnSection[i_column];
+    if (i_column < N_RESULT_TEXT) {
+        if (!loadDictionary(i_column) || (section.size != 4 * (uint64_t) nRows) || !read(section.offset, section.size)) {
+            return false;
+        }
+        vector<uint32_t> &column = codes[i_column];
+        column.resize(nRows);
+        for (uint32_t i = 0; i < nRows; ++i) {
+            column[i] = getU32(&buffer[4 * i]);
+            if (column[i] >= dictionary[i_column].size()) {
+                cerr << dbgTag << "Invalid code in " << fileName << ". \n";
+                return false;
+            }
+        }
+    } else if (!present[i_column]) {
+        // A column the segment predates
+        values[i_column].assign(nRows, std::numeric_limits<double>::quiet_NaN());
+    } else {
+        if ((section.size != 8 * (uint64_t) nRows) || !read(section.offset, section.size)) {
+            return false;
+        }
+        vector<double> &column = values[i_column];
+        column.resize(nRows);
+        for (uint32_t i = 0; i < nRows; ++i) {
+            column[i] = getF64(&buffer[8 * i]);
+        }
+    }
+    loaded[i_column] = true;
+
+    return true;
+}
+
+bool ResultSegment::getRow(const uint32_t &i_row, PinchResult &o_result) {
+    if (i_row >= nRows) {
+        return false;
+    }
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        if (!load(i)) {
+            return false;
+        }
+        if (i < N_RESULT_TEXT) {
+            o_result.text[i] = dictionary[i][codes[i][i_row]];
+        } else {
+            o_result.value[i] = values[i][i_row];
+        }
+    }
+
+    return true;
+}
+
+bool ResultSegment::findCodes(const int &i_column, const vector<string> &i_values, vector<uint32_t> &o_codes) {
+    o_codes.clear();
+    if (!loadDictionary(i_column)) {
+        return false;
+    }
+    const vector<string> &names = dictionary[i_column];
+    for (uint32_t i = 0; i < names.size(); ++i) {
+        if (std::find(i_values.begin(), i_values.end(), names[i]) != i_values.end()) {
+            o_codes.push_back(i);
+        }
+    }
+
+    return true;
+}
+
+bool ResultSegment::readPostings(const int &i_column, const vector<uint32_t> &i_codes, vector<uint32_t> *o_rows, uint32_t &o_count) {
+    // nValues, the start of each list and the rows, grouped by value
+    const Section &section = indexSection[i_column];
+    if ((section.size < 4) || !read(section.offset, 4)) {
+        return false;
+    }
+    uint32_t nValues = getU32(&buffer[0]);
+    if ((section.size != 4 * (uint64_t) (nValues + 2 + nRows)) || !read(section.offset + 4, 4 * (uint64_t) (nValues + 1))) {
+        return false;
+    }
+    vector<uint32_t> starts(nValues + 1);
+    for (uint32_t i = 0; i <= nValues; ++i) {
+        starts[i] = getU32(&buffer[4 * i]);
+    }
+
+    o_count = 0;
+    if (o_rows != NULL) {
+        o_rows->clear();
+    }
+    uint64_t rowsOffset = section.offset + 4 * (uint64_t) (nValues + 2);
+    for (size_t c = 0; c < i_codes.size(); ++c) {
+        if ((i_codes[c] >= nValues) || (starts[i_codes[c]] > starts[i_codes[c] + 1]) || (starts[i_codes[c] + 1] > nRows)) {
+            return false;
+        }
+        uint32_t count = starts[i_codes[c] + 1] - starts[i_codes[c]];
+        o_count += count;
+        if ((o_rows == NULL) || (count == 0)) {
+            continue;
+        }
+        if (!read(rowsOffset + 4 * (uint64_t) starts[i_codes[c]], 4 * (uint64_t) count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; ++i) {
+            o_rows->push_back(getU32(&buffer[4 * i]));
+        }
+    }
+    if ((o_rows != NULL) && (i_codes.size() > 1)) {
+        std::sort(o_rows->begin(), o_rows->end());
+    }
+
+    return true;
+}
+
+bool ResultSegment::readRange(const int &i_column, const double &i_min, const double &i_max, vector<uint32_t> *o_rows, uint32_t &o_count) {
+    // The sorted values followed by their rows
+    const Section &section = indexSection[i_column];
+    if (section.size != 12 * (uint64_t) nRows) {
+        return false;
+    }
+
+    // First value not below the minimum, first value above the maximum
+    uint32_t bounds[2];
+    for (int b = 0; b < 2; ++b) {
+        uint32_t low = 0;
+        uint32_t high = nRows;
+        while (low < high) {
+            uint32_t middle = low + (high - low) / 2;
+            if (!read(section.offset + 8 * (uint64_t) middle, 8)) {
+                return false;
+            }
+            double value = getF64(&buffer[0]);
+            bool before = (b == 0) ? lessValue(value, i_min) : !lessValue(i_max, value);
+            if (before) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        bounds[b] = low;
+    }
+
+    o_count = (bounds[1] > bounds[0]) ? bounds[1] - bounds[0] : 0;
+    if ((o_rows == NULL) || (o_count == 0)) {
+        if (o_rows != NULL) {
+            o_rows->clear();
+        }
+        return true;
+    }
+    if (!read(section.offset + 8 * (uint64_t) nRows + 4 * (uint64_t) bounds[0], 4 * (uint64_t) o_count)) {
+        return false;
+    }
+    o_rows->resize(o_count);
+    for (uint32_t i = 0; i < o_count; ++i) {
+        (*o_rows)[i] = getU32(&buffer[4 * i]);
+    }
+    std::sort(o_rows->begin(), o_rows->end());
+
+    return true;
+}
+
+bool ResultSegment::select(const ResultFilter &i_filter, vector<uint32_t> &o_rows) {
+    o_rows.clear();
+
+    // Zone maps
+    for (int c = N_RESULT_TEXT; c < N_RESULT_COLUMNS; ++c) {
+        if (i_filter.isRange(c) && ((zoneMax[c] < i_filter.min[c]) || (zoneMin[c] > i_filter.max[c]))) {
+            return true;
+        }
+    }
+
+    // Codes of the accepted text values
+    vector<uint32_t> accepted[N_RESULT_TEXT];
+    for (int c = 0; c < N_RESULT_TEXT; ++c) {
+        if (i_filter.values[c].empty()) {
+            continue;
+        }
+        if (!findCodes(c, i_filter.values[c], accepted[c])) {
+            return false;
+        }
+        if (accepted[c].empty()) {
+            return true;
+        }
+    }
+
+    // The most selective index provides the candidate rows
+    int best = -1;
+    uint32_t bestCount = nRows;
+    for (int c = 0; c < N_RESULT_COLUMNS; ++c) {
+        uint32_t count = nRows;
+        if (isPosting(c) && !accepted[c].empty()) {
+            if (!readPostings(c, accepted[c], NULL, count)) {
+                return false;
+            }
+        } else if (isSorted(c) && i_filter.isRange(c)) {
+            if (!readRange(c, i_filter.min[c], i_filter.max[c], NULL, count)) {
+                return false;
+            }
+        } else {
+            continue;
+        }
+        if (count == 0) {
+            return true;
+        }
+        if ((best < 0) || (count < bestCount)) {
+            best = c;
+            bestCount = count;
+        }
+    }
+
+    uint32_t dummy;
+    if (best < 0) {
+        o_rows.resize(nRows);
+        for (uint32_t i = 0; i < nRows; ++i) {
+            o_rows[i] = i;
+        }
+    } else if (isPosting(best)) {
+        if (!readPostings(best, accepted[best], &o_rows, dummy)) {
+            return false;
+        }
+    } else {
+        if (!readRange(best, i_filter.min[best], i_filter.max[best], &o_rows, dummy)) {
+            return false;
+        }
+    }
+
+    // The remaining conditions are checked on the columns
+    for (int c = 0; (c < N_RESULT_COLUMNS) && !o_rows.empty(); ++c) {
+        if (c == best) {
+            continue;
+        }
+        if (c < N_RESULT_TEXT) {
+            if (accepted[c].empty()) {
+                continue;
+            }
+            if (!load(c)) {
+                return false;
+            }
+            vector<char> keep(dictionary[c].size(), 0);
+            for (size_t i = 0; i < accepted[c].size(); ++i) {
+                keep[accepted[c][i]] = 1;
+            }
+            const vector<uint32_t> &column = codes[c];
+            size_t n = 0;
+            for (size_t i = 0; i < o_rows.size(); ++i) {
+                if (keep[column[o_rows[i]]]) {
+                    o_rows[n++] = o_rows[i];
+                }
+            }
+            o_rows.resize(n);
+        } else if (i_filter.isRange(c)) {
+            if (!load(c)) {
+                return false;
+            }
+            const vector<double> &column = values[c];
+            double min = i_filter.min[c];
+            double max = i_filter.max[c];
+            size_t n = 0;
+            for (size_t i = 0; i < o_rows.size(); ++i) {
+                double value = column[o_rows[i]];
+                if ((value >= min) && (value <= max)) {
+                    o_rows[n++] = o_rows[i];
+                }
+            }
+            o_rows.resize(n);
+        }
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Segment writer                                                   ********************************************** */
+bool ResultSegment::write(const string &i_file, const vector<PinchResult> &i_rows) {
+    uint32_t n = (uint32_t) i_rows.size();
+    vector<unsigned char> sections;
+    vector<unsigned char> header;
+    uint64_t base = HEADER_SIZE + ENTRY_SIZE * N_RESULT_COLUMNS;
+
+    header.insert(header.end(), MAGIC, MAGIC + 4);
+    putU32(header, VERSION);
+    putU32(header, n);
+    putU32(header, N_RESULT_COLUMNS);
+
+    for (int c = 0; c < N_RESULT_COLUMNS; ++c) {
+        double zoneMin = HUGE_VAL;
+        double zoneMax = -HUGE_VAL;
+        uint64_t columnOffset = base + sections.size();
+        uint64_t indexOffset = 0;
+        uint64_t indexSize = 0;
+        uint64_t dictionaryOffset = 0;
+        uint64_t dictionarySize = 0;
+
+        if (c < N_RESULT_TEXT) {
+            // Codes in order of first appearance
+            map<string, uint32_t> lookup;
+            vector<const string*> names;
+            vector<uint32_t> codes(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                map<string, uint32_t>::iterator it = lookup.find(i_rows[i].text[c]);
+                if (it == lookup.end()) {
+                    it = lookup.insert(std::make_pair(i_rows[i].text[c], (uint32_t) names.size())).first;
+                    names.push_back(&i_rows[i].text[c]);
+                }
+                codes[i] = it->second;
+                putU32(sections, codes[i]);
+            }
+
+            dictionaryOffset = base + sections.size();
+            putU32(sections, (uint32_t) names.size());
+            for (size_t i = 0; i < names.size(); ++i) {
+                putU32(sections, (uint32_t) names[i]->size());
+                sections.insert(sections.end(), names[i]->begin(), names[i]->end());
+            }
+            dictionarySize = base + sections.size() - dictionaryOffset;
+
+            if (isPosting(c)) {
+                // Counting sort of the rows by code
+                uint32_t nValues = (uint32_t) names.size();
+                vector<uint32_t> starts(nValues + 1, 0);
+                for (uint32_t i = 0; i < n; ++i) {
+                    ++starts[codes[i] + 1];
+                }
+                for (uint32_t v = 0; v < nValues; ++v) {
+                    starts[v + 1] += starts[v];
+                }
+                vector<uint32_t> rows(n);
+                vector<uint32_t> next(starts.begin(), starts.end() - 1);
+                for (uint32_t i = 0; i < n; ++i) {
+                    rows[next[codes[i]]++] = i;
+                }
+
+                indexOffset = base + sections.size();
+                putU32(sections, nValues);
+                for (uint32_t v = 0; v <= nValues; ++v) {
+                    putU32(sections, starts[v]);
+                }
+                for (uint32_t i = 0; i < n; ++i) {
+                    putU32(sections, rows[i]);
+                }
+                indexSize = base + sections.size() - indexOffset;
+            }
+        } else {
+            vector<double> column(n);
+            for (uint32_t i = 0; i < n; ++i) {
+                column[i] = i_rows[i].value[c];
+                putF64(sections, column[i]);
+                if (!isNaN(column[i])) {
+                    zoneMin = std::min(zoneMin, column[i]);
+                    zoneMax = std::max(zoneMax, column[i]);
+                }
+            }
+
+            if (isSorted(c)) {
+                vector<uint32_t> rows(n);
+                for (uint32_t i = 0; i < n; ++i) {
+                    rows[i] = i;
+                }
+                std::stable_sort(rows.begin(), rows.end(), LessRow(column));
+
+                indexOffset = base + sections.size();
+                for (uint32_t i = 0; i < n; ++i) {
+                    putF64(sections, column[rows[i]]);
+                }
+                for (uint32_t i = 0; i < n; ++i) {
+                    putU32(sections, rows[i]);
+                }
+                indexSize = base + sections.size() - indexOffset;
+            }
+        }
+
+        putF64(header, zoneMin);
+        putF64(header, zoneMax);
+        putU64(header, columnOffset);
+        putU64(header, (uint64_t) ((c < N_RESULT_TEXT) ? 4 : 8) * n);
+        putU64(header, indexOffset);
+        putU64(header, indexSize);
+        putU64(header, dictionaryOffset);
+        putU64(header, dictionarySize);
+    }
+
+    // Readers only list complete segments
+    string temporary = i_file + ".tmp";
+    FILE *file = fopen(temporary.c_str(), "wb");
+    if (file == NULL) {
+        cerr << "ResultSegment: " << "Could not create " << temporary << ". \n";
+        return false;
+    }
+    bool ok = (fwrite(&header[0], 1, header.size(), file) == header.size());
+    ok = ok && (sections.empty() || (fwrite(&sections[0], 1, sections.size(), file) == sections.size()));
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || (rename(temporary.c_str(), i_file.c_str()) != 0)) {
+        cerr << "ResultSegment: " << "Could not write " << i_file << ". \n";
+        unlink(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Store writer                                                     ********************************************** */
+/** Name a new segment after its writer. */
+static string segmentName(const string &i_directory, const string &i_prefix, const time_t &i_start, const unsigned int &i_sequence) {
+    struct tm date;
+    localtime_r(&i_start, &date);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &date);
+
+    stringstream ss;
+    ss << i_directory << "/" << i_prefix << "_" << stamp << "_" << getpid() << "_" << std::setw(6) << std::setfill('0') << i_sequence
+        << EXTENSION;
+    return ss.str();
+}
+
+ResultWriter::ResultWriter() {
+    blockRows = 1000;
+    start = 0;
+    sequence = 0;
+    dbgTag = "ResultWriter: ";
+}
+
+ResultWriter::~ResultWriter() {
+    close();
+}
+
+bool ResultWriter::open(const string &i_directory, const string &i_prefix, const unsigned int &i_blockRows) {
+    close();
+
+    // Create the directory and its parents
+    for (size_t k = 1; k <= i_directory.size(); ++k) {
+        if ((k == i_directory.size()) || (i_directory[k] == '/')) {
+            string path = i_directory.substr(0, k);
+            if ((mkdir(path.c_str(), 0775) != 0) && (errno != EEXIST)) {
+                cerr << dbgTag << "Could not create " << path << ". \n";
+                return false;
+            }
+        }
+    }
+
+    directory = i_directory;
+    prefix = i_prefix;
+    blockRows = std::max(i_blockRows, 1u);
+    start = time(NULL);
+    sequence = 0;
+    rows.clear();
+
+    return true;
+}
+
+void ResultWriter::append(const PinchResult &i_result) {
+    if (directory.empty()) {
+        return;
+    }
+    rows.push_back(i_result);
+    if (rows.size() >= blockRows) {
+        flush();
+    }
+}
+
+bool ResultWriter::flush(void) {
+    if (rows.empty()) {
+        return true;
+    }
+
+    // Never overwrite the segments of a previous writer of the same process
+    string file;
+    struct stat info;
+    do {
+        file = segmentName(directory, prefix, start, sequence++);
+    } while (stat(file.c_str(), &info) == 0);
+    bool ok = ResultSegment::write(file, rows);
+    rows.clear();
+
+    return ok;
+}
+
+bool ResultWriter::close(void) {
+    bool ok = flush();
+    directory.clear();
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Store reader                                                     ********************************************** */
+ResultStore::ResultStore() {
+    dbgTag = "ResultStore: ";
+}
+
+bool ResultStore::open(const string &i_directory) {
+    files.clear();
+    directory = i_directory;
+
+    DIR *dir = opendir(i_directory.c_str());
+    if (dir == NULL) {
+        cerr << dbgTag << "Could not open " << i_directory << ". \n";
+        return false;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        string name = entry->d_name;
+        if ((name.size() > EXTENSION.size()) && (name[0] != '.')
+                && (name.compare(name.size() - EXTENSION.size(), EXTENSION.size(), EXTENSION) == 0)) {
+            files.push_back(i_directory + "/" + name);
+        }
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+
+    return true;
+}
+
+bool ResultStore::select(const ResultFilter &i_filter, ResultHandler *i_handler, uint64_t &o_rows) {
+    o_rows = 0;
+    ResultSegment segment;
+    vector<uint32_t> rows;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!segment.open(files[i])) {
+            // Only a segment removed by a concurrent compaction may be skipped, its rows are in the new one
+            struct stat info;
+            if ((stat(files[i].c_str(), &info) != 0) && (errno == ENOENT)) {
+                continue;
+            }
+            cerr << dbgTag << "Could not read " << files[i] << ", the query is incomplete. \n";
+            return false;
+        }
+        o_rows += segment.getRows();
+        if (!segment.select(i_filter, rows)) {
+            cerr << dbgTag << "Could not query " << files[i] << ". \n";
+            return false;
+        }
+        if (!rows.empty() && !i_handler->onRows(segment, rows)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+bool ResultStore::compact(const unsigned int &i_rows) {
+    ResultWriter writer;
+    if (!writer.open(directory, "compact", i_rows)) {
+        return false;
+    }
+
+    vector<PinchResult> merged;
+    vector<string> sources;
+    ResultSegment segment;
+    for (size_t i = 0; i <= files.size(); ++i) {
+        uint32_t n = 0;
+        if (i < files.size()) {
+            if (!segment.open(files[i])) {
+                return false;
+            }
+            n = segment.getRows();
+            if (n >= i_rows) {
+                continue;
+            }
+        }
+
+        // Write the batch when full or when the segments are over
+        if ((i == files.size()) || (merged.size() + n > i_rows)) {
+            if (sources.size() > 1) {
+                for (size_t k = 0; k < merged.size(); ++k) {
+                    writer.append(merged[k]);
+                }
+                if (!writer.flush()) {
+                    return false;
+                }
+                for (size_t k = 0; k < sources.size(); ++k) {
+                    unlink(sources[k].c_str());
+                }
+            }
+            merged.clear();
+            sources.clear();
+        }
+        if (i == files.size()) {
+            break;
+        }
+
+        size_t first = merged.size();
+        merged.resize(first + n);
+        for (uint32_t r = 0; r < n; ++r) {
+            if (!segment.getRow(r, merged[first + r])) {
+                cerr << dbgTag << "Could not read " << files[i] << ". \n";
+                return false;
+            }
+        }
+        sources.push_back(files[i]);
+    }
+
+    return open(directory);
+}
+
+string ResultStore::getFingerName(const int &i_joint) {
+    switch (i_joint) {
+        case 8:
+        case 9:
+        case 10:
+            return "thumb";
+        case 11:
+        case 12:
+            return "index";
+        case 13:
+        case 14:
+            return "middle";
+        case 15:
+            return "little";
+        default: {
+            stringstream ss;
+            ss << "joint" << i_joint;
+            return ss.str();
+        }
+    }
+}
+
+const char* ResultStore::getColumnName(const int &i_column) {
+    return ((i_column >= 0) && (i_column < N_RESULT_COLUMNS)) ? COLUMN_NAMES[i_column] : "unknown";
+}
+
+int ResultStore::getColumn(const string &i_name) {
+    for (int i = 0; i < N_RESULT_COLUMNS; ++i) {
+        if (i_name == COLUMN_NAMES[i]) {
+            return i;
+        }
+    }
+
+    return N_RESULT_COLUMNS;
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SegmentIndex.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+using std::cerr;
+using std::string;
+using std::vector;
+using std::stringstream;
+
+using iCub::interactionForces::SegmentIndex;
+using iCub::interactionForces::PinchSegment;
+using iCub::interactionForces::PinchPhase;
+
+
+/** Order of the segments by pinch and phase. */
+static bool lessPinchPhase(const PinchSegment &i_a, const PinchSegment &i_b) {
+    return (i_a.pinch < i_b.pinch) || ((i_a.pinch == i_b.pinch) && (i_a.phase < i_b.phase));
+}
+
+/** Order of the segments by start time. */
+static bool lessTime(const double &i_time, const PinchSegment &i_segment) {
+    return i_time < i_segment.start;
+}
+
+/** True if the segment contains the given time. */
+static bool containsTime(const PinchSegment &i_segment, const double &i_time) {
+    return (i_segment.start <= i_time) && (i_time <= i_segment.end);
+}
+
+
+SegmentIndex::SegmentIndex() {
+    writing = false;
+    clock = NULL;
+    pinchOrdered = true;
+    timeOrdered = true;
+    dbgTag = "SegmentIndex: ";
+}
+
+SegmentIndex::~SegmentIndex() {
+    close();
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Writer                                                           ********************************************** */
+bool SegmentIndex::create(const string &i_file, const vector<string> &i_streams, const vector<string> &i_paths,
+        Clock *i_clock) {
+    file.open(i_file.c_str(), std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        cerr << dbgTag << "Could not create " << i_file << ". \n";
+        return false;
+    }
+    streams = i_streams;
+    paths = i_paths;
+    clock = i_clock;
+    segments.clear();
+    samples.clear();
+    pinchOrdered = true;
+    timeOrdered = true;
+
+    file << "# pinch phase start end fingerDepth thumbDepth";
+    for (size_t i = 0; i < streams.size(); ++i) {
+        file << " " << streams[i];
+    }
+    file << "\n";
+    file << std::fixed << std::setprecision(6);
+    file.flush();
+
+    // The first phase starts from the current sizes
+    sample();
+
+    return true;
+}
+
+void SegmentIndex::begin(const int &i_pinch, const PinchPhase i_phase, const double &i_time, const double &i_fingerDepth,
+        const double &i_thumbDepth) {
+    if (!file.is_open()) {
+        return;
+    }
+    end(i_time);
+
+    current.pinch = i_pinch;
+    current.phase = i_phase;
+    current.start = i_time;
+    current.end = i_time;
+    current.fingerDepth = i_fingerDepth;
+    current.thumbDepth = i_thumbDepth;
+    // The offsets are filled in when the phase is written, off the control path
+    writing = true;
+}
+
+void SegmentIndex::end(const double &i_time) {
+    PinchSegment segment;
+    if (take(i_time, segment)) {
+        write(segment);
+    }
+}
+
+bool SegmentIndex::take(const double &i_time, PinchSegment &o_segment) {
+    if (!writing) {
+        return false;
+    }
+    current.end = i_time;
+    writing = false;
+    o_segment = current;
+
+    return true;
+}
+
+void SegmentIndex::write(const PinchSegment &i_segment) {
+    // A phase gets the last sizes sampled before it started
+    segments.push_back(i_segment);
+    checkOrder(segments.size() - 1);
+    PinchSegment &row = segments.back();
+    row.offsets.assign(paths.size(), -1);
+    size_t last = samples.size();
+    for (size_t k = 0; k < samples.size(); ++k) {
+        if (samples[k].time <= row.start) {
+            last = k;
+        }
+    }
+    if (last < samples.size()) {
+        row.offsets = samples[last].sizes;
+        // The phases to come start later, the older samples are no longer needed
+        samples.erase(samples.begin(), samples.begin() + last);
+    }
+
+    file << row.pinch << " " << getPhaseName(row.phase) << " " << row.start << " " << row.end << " "
+        << row.fingerDepth << " " << row.thumbDepth;
+    for (size_t i = 0; i < row.offsets.size(); ++i) {
+        file << " " << (long long) row.offsets[i];
+    }
+    file << "\n";
+    file.flush();
+
+    sample();
+}
+
+void SegmentIndex::sample(void) {
+    if (clock == NULL) {
+        return;
+    }
+
+    // Dated once the files are read, so that all the data of a later phase lies past the sizes
+    SizeSample size;
+    size.sizes.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        struct stat info;
+        size.sizes[i] = (stat(paths[i].c_str(), &info) == 0) ? (int64_t) info.st_size : -1;
+    }
+    size.time = clock->now();
+    samples.push_back(size);
+}
+
+void SegmentIndex::close(void) {
+    if (file.is_open()) {
+        file.close();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reader                                                           ********************************************** */
+bool SegmentIndex::load(const string &i_file) {
+    std::ifstream in(i_file.c_str());
+    if (!in.is_open()) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return false;
+    }
+
+    streams.clear();
+    segments.clear();
+    string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        stringstream ss(line);
+        if (line[0] == '#') {
+            // Header, the stream names follow the six segment columns
+            string word;
+            ss >> word;
+            for (int i = 0; (i < 6) && (ss >> word); ++i) {}
+            while (ss >> word) {
+                streams.push_back(word);
+            }
+            continue;
+        }
+
+        PinchSegment segment;
+        string phase;
+        ss >> segment.pinch >> phase >> segment.start >> segment.end >> segment.fingerDepth >> segment.thumbDepth;
+        if (ss.fail() || (getPhase(phase) == N_PINCH_PHASES)) {
+            cerr << dbgTag << "Invalid line: " << line << "\n";
+            return false;
+        }
+        segment.phase = getPhase(phase);
+        long long offset;
+        while (ss >> offset) {
+            segment.offsets.push_back((int64_t) offset);
+        }
+        segment.offsets.resize(streams.size(), -1);
+        segments.push_back(segment);
+    }
+
+    // The rows are written as the phases close, which a worker thread may not do in order
+    std::stable_sort(segments.begin(), segments.end(), lessPinchPhase);
+    pinchOrdered = true;
+    timeOrdered = true;
+    for (size_t k = 1; k < segments.size(); ++k) {
+        checkOrder(k);
+    }
+    if (!timeOrdered) {
+        cerr << dbgTag << "The phases of " << i_file << " are not in time order, time lookups will be linear. \n";
+    }
+
+    return true;
+}
+
+void SegmentIndex::checkOrder(const size_t &i_k) {
+    if (i_k == 0) {
+        return;
+    }
+    if (lessPinchPhase(segments[i_k], segments[i_k - 1])) {
+        pinchOrdered = false;
+    }
+    if (segments[i_k].start < segments[i_k - 1].start) {
+        timeOrdered = false;
+    }
+}
+
+const PinchSegment* SegmentIndex::find(const int &i_pinch, const PinchPhase i_phase) const {
+    PinchSegment key;
+    key.pinch = i_pinch;
+    key.phase = i_phase;
+    if (!pinchOrdered) {
+        for (size_t k = 0; k < segments.size(); ++k) {
+            if ((segments[k].pinch == i_pinch) && (segments[k].phase == i_phase)) {
+                return &segments[k];
+            }
+        }
+        return NULL;
+    }
+    vector<PinchSegment>::const_iterator it = std::lower_bound(segments.begin(), segments.end(), key, lessPinchPhase);
+    if ((it == segments.end()) || (it->pinch != i_pinch) || (it->phase != i_phase)) {
+        return NULL;
+    }
+
+    return &(*it);
+}
+
+const PinchSegment* SegmentIndex::findTime(const double &i_time) const {
+    if (!timeOrdered) {
+        for (size_t k = 0; k < segments.size(); ++k) {
+            if (containsTime(segments[k], i_time)) {
+                return &segments[k];
+            }
+        }
+        return NULL;
+    }
+    vector<PinchSegment>::const_iterator it = std::upper_bound(segments.begin(), segments.end(), i_time, lessTime);
+    if (it == segments.begin()) {
+        return NULL;
+    }
+    --it;
+
+    return containsTime(*it, i_time) ? &(*it) : NULL;
+}
+
+int SegmentIndex::getStream(const string &i_name) const {
+    for (size_t i = 0; i < streams.size(); ++i) {
+        if (streams[i] == i_name) {
+            return (int) i;
+        }
+    }
+
+    return -1;
+}
+
+const char* SegmentIndex::getPhaseName(const PinchPhase i_phase) {
+    switch (i_phase) {
+        case PHASE_PRESS:
+            return "press";
+        case PHASE_HOLD:
+            return "hold";
+        case PHASE_RAISE:
+            return "raise";
+        case PHASE_REST:
+            return "rest";
+        default:
+            return "unknown";
+    }
+}
+
+PinchPhase SegmentIndex::getPhase(const string &i_name) {
+    for (int i = 0; i < N_PINCH_PHASES; ++i) {
+        if (i_name == getPhaseName((PinchPhase) i)) {
+            return (PinchPhase) i;
+        }
+    }
+
+    return N_PINCH_PHASES;
+}
+/* *********************************************************************************************************************** */
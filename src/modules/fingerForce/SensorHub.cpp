@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "SensorHub.h"
+#include "Transport.h"
+
+#include <iostream>
+#include <sstream>
+
+using std::cout;
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::SensorHub;
+using iCub::interactionForces::SensorStream;
+using iCub::interactionForces::SensorSample;
+using iCub::interactionForces::SensorListener;
+using iCub::interactionForces::SimulatedHand;
+using iCub::interactionForces::Transport;
+
+using yarp::os::Stamp;
+using yarp::sig::Vector;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Stream port callback                                             ********************************************** */
+void SensorHub::StreamPort::onRead(Vector &i_data) {
+    Stamp envelope;
+    getEnvelope(envelope);
+    hub->dispatch(stream, i_data, envelope);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Simulated feed                                                   ********************************************** */
+SensorHub::SimulatedFeed::SimulatedFeed(const int aPeriod, Clock *aClock, SensorHub &aHub, SimulatedHand *aHand)
+    : ClockedRateThread(aPeriod, aClock), hub(aHub), hand(aHand) {
+        int nJoints = 0;
+        hand->getAxes(&nJoints);
+        raw.resize(SimulatedHand::N_TAXELS);
+        comp.resize(SimulatedHand::N_TAXELS);
+        wrench.resize(6);
+        joints.resize(nJoints);
+        seq = 0;
+}
+
+void SensorHub::SimulatedFeed::run() {
+    hand->getSkin(raw, comp);
+    hand->getWrench(wrench);
+    hand->getEncoders(joints.data());
+
+    Stamp envelope(seq++, getClock()->now());
+    hub.dispatch(iCub::interactionForces::STREAM_SKIN_RAW, raw, envelope);
+    hub.dispatch(iCub::interactionForces::STREAM_SKIN_COMP, comp, envelope);
+    hub.dispatch(iCub::interactionForces::STREAM_WRENCH, wrench, envelope);
+    hub.dispatch(iCub::interactionForces::STREAM_JOINTS, joints, envelope);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sensor hub                                                       ********************************************** */
+SensorHub::SensorHub(Clock *aClock)
+    : clock(aClock), feed(NULL) {
+        for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+            ports[i].setup(this, (SensorStream) i);
+            internal[i] = false;
+        }
+
+        dbgTag = "SensorHub: ";
+}
+
+SensorHub::~SensorHub() {
+    close();
+}
+
+void SensorHub::addListener(SensorListener *i_listener) {
+    listeners.push_back(i_listener);
+}
+
+bool SensorHub::open(const string &i_portNameRoot, const string &i_robotName, const string &i_whichArm, const string &i_carrier,
+        const bool i_shmem) {
+    remoteNames[STREAM_SKIN_RAW] = "/" + i_robotName + "/skin/" + i_whichArm + "_hand";
+    remoteNames[STREAM_SKIN_COMP] = "/" + i_robotName + "/skin/" + i_whichArm + "_hand_comp";
+    remoteNames[STREAM_WRENCH] = "/NIDAQmxReader/data/real:o";
+    remoteNames[STREAM_JOINTS] = "/" + i_robotName + "/" + i_whichArm + "_arm/state:o";
+
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        localNames[i] = i_portNameRoot + getStreamName((SensorStream) i) + ":i";
+        if (!ports[i].open(localNames[i].c_str())) {
+            cout << dbgTag << "Could not open port " << localNames[i] << ". \n";
+            return false;
+        }
+        ports[i].useCallback();
+
+        if (internal[i]) {
+            transports[i] = "internal";
+            continue;
+        }
+        transports[i] = Transport::connect(remoteNames[i], localNames[i], i_carrier, i_shmem);
+        if (transports[i].empty()) {
+            cout << dbgTag << "Could not connect to " << remoteNames[i] << ". Waiting for an external connection. \n";
+            transports[i] = "external";
+        }
+    }
+
+    return true;
+}
+
+bool SensorHub::openSimulated(SimulatedHand *i_hand, const int i_period) {
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        transports[i] = "in-process";
+    }
+    feed = new SimulatedFeed(i_period, clock, *this, i_hand);
+    if (!feed->start()) {
+        cout << dbgTag << "Could not start the simulated sensor feed. \n";
+        return false;
+    }
+
+    return true;
+}
+
+void SensorHub::interrupt() {
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        ports[i].interrupt();
+    }
+}
+
+void SensorHub::close() {
+    if (feed) {
+        feed->stop();
+        delete feed;
+        feed = NULL;
+    }
+
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        ports[i].close();
+    }
+}
+
+void SensorHub::dispatch(const SensorStream i_stream, const Vector &i_data, const Stamp &i_envelope) {
+    if (!internal[i_stream]) {
+        inject(i_stream, i_data, i_envelope);
+    }
+}
+
+void SensorHub::setInternal(const SensorStream i_stream) {
+    internal[i_stream] = true;
+}
+
+void SensorHub::inject(const SensorStream i_stream, const Vector &i_data, const Stamp &i_envelope) {
+    SensorSample sample;
+    sample.data = i_data.data();
+    sample.size = i_data.size();
+    sample.seq = i_envelope.isValid() ? i_envelope.getCount() : -1;
+    sample.envTime = i_envelope.isValid() ? i_envelope.getTime() : 0.0;
+    sample.rxTime = clock->now();
+
+    for (size_t i = 0; i < listeners.size(); ++i) {
+        listeners[i]->onSample(i_stream, sample);
+    }
+}
+
+string SensorHub::getTransports(void) {
+    stringstream ss;
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        ss << getStreamName((SensorStream) i) << ": " << (transports[i].empty() ? "closed" : transports[i]);
+        if (!remoteNames[i].empty() && !internal[i]) {
+            ss << " from " << remoteNames[i];
+        }
+        ss << "\n";
+    }
+
+    return ss.str();
+}
+
+const char* SensorHub::getStreamName(const SensorStream i_stream) {
+    switch (i_stream) {
+        case STREAM_SKIN_RAW:
+            return "skin_raw";
+        case STREAM_SKIN_COMP:
+            return "skin_comp";
+        case STREAM_WRENCH:
+            return "nano17";
+        case STREAM_JOINTS:
+            return "joints";
+        default:
+            return "unknown";
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,881 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "SimulatedHand.h"
+
+#include <iostream>
+#include <cmath>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::SimulatedHand;
+using iCub::interactionForces::ContactDigit;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::sig::Vector;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Constructor                                                      ********************************************** */
+SimulatedHand::SimulatedHand(Clock *aClock)
+    : clock(aClock) {
+        nJoints = 0;
+        dt = 0.001;
+        jointStiffness = 1.0;
+        tolerance = 0.5;
+        lastUpdate = 0.0;
+        settled = true;
+
+        objectStiffness = 0.1;
+        taxelGain = 20.0;
+        taxelBaseline = 240.0;
+        tangentialRatio = 0.05;
+
+        encNoise = 0.0;
+        skinNoise = 0.0;
+        ftNoise = 0.0;
+        rngState = 88172645463325252ULL;
+        hasSpareGauss = false;
+        spareGauss = 0.0;
+
+        dbgTag = "SimulatedHand: ";
+}
+
+SimulatedHand::~SimulatedHand() {}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the plant                                              ********************************************** */
+bool SimulatedHand::configure(const Bottle &i_group, const vector<double> &i_initPos) {
+    nJoints = i_group.check("nJoints", Value((int) i_initPos.size()), "Number of simulated joints.").asInt();
+    if ((nJoints <= 0) || (nJoints != (int) i_initPos.size())) {
+        cerr << dbgTag << "Invalid number of joints. Expecting " << i_initPos.size() << ". \n";
+        return false;
+    }
+    dt = i_group.check("dt", Value(0.001), "Integration step in seconds.").asDouble();
+    if (dt <= 0.0) {
+        cerr << dbgTag << "Invalid integration step. \n";
+        return false;
+    }
+
+    // Joint dynamics
+    if (!readJointParam(i_group, "maxSpeed", 100.0, maxSpeed)) {
+        return false;
+    }
+    if (!readJointParam(i_group, "tau", 0.02, tau)) {
+        return false;
+    }
+    jointStiffness = i_group.check("jointStiffness", Value(1.0), "Joint servo stiffness in N/deg.").asDouble();
+    tolerance = i_group.check("tolerance", Value(0.5), "Motion done position tolerance in deg.").asDouble();
+
+    // Contact model
+    objectStiffness = i_group.check("objectStiffness", Value(0.1), "Object stiffness in N/deg.").asDouble();
+    taxelGain = i_group.check("taxelGain", Value(20.0), "Taxel response per N of normal force.").asDouble();
+    taxelBaseline = i_group.check("taxelBaseline", Value(240.0), "Raw taxel value at rest.").asDouble();
+    tangentialRatio = i_group.check("tangentialRatio", Value(0.05), "Tangential to normal force ratio.").asDouble();
+
+    digits.clear();
+    Bottle *cJoints = i_group.find("contactJoints").asList();
+    Bottle *cPos = i_group.find("contactPos").asList();
+    Bottle *cTips = i_group.find("contactFingertips").asList();
+    if ((cJoints != NULL) && (cPos != NULL) && (cTips != NULL)) {
+        if ((cJoints->size() != cPos->size()) || (cJoints->size() != cTips->size())) {
+            cerr << dbgTag << "Parameters contactJoints, contactPos and contactFingertips must have the same size. \n";
+            return false;
+        }
+        for (int i = 0; i < cJoints->size(); ++i) {
+            ContactDigit d;
+            d.joint = cJoints->get(i).asInt();
+            d.contactPos = cPos->get(i).asDouble();
+            d.fingertip = cTips->get(i).asInt();
+            d.force = 0.0;
+            if ((d.joint < 0) || (d.joint >= nJoints) || (d.fingertip < 0) || (d.fingertip > 4)) {
+                cerr << dbgTag << "Invalid contact digit " << i << ". \n";
+                return false;
+            }
+            digits.push_back(d);
+        }
+    }
+
+    // Noise
+    encNoise = i_group.check("encNoise", Value(0.0), "Encoder noise standard deviation in deg.").asDouble();
+    skinNoise = i_group.check("skinNoise", Value(0.0), "Taxel noise standard deviation.").asDouble();
+    ftNoise = i_group.check("ftNoise", Value(0.0), "Wrench noise standard deviation in N.").asDouble();
+    int seed = i_group.check("seed", Value(1), "Noise generator seed.").asInt();
+    rngState = 88172645463325252ULL ^ (unsigned long long) seed;
+    if (rngState == 0) {
+        rngState = 88172645463325252ULL;
+    }
+
+    // Precompute the lag coefficients and the joint to digit map
+    lagAlpha.resize(nJoints);
+    for (int j = 0; j < nJoints; ++j) {
+        lagAlpha[j] = (tau[j] > 0.0) ? (1.0 - exp(-dt / tau[j])) : 1.0;
+    }
+    controlMode.assign(nJoints, VOCAB_CM_POSITION);
+    impStiffness.assign(nJoints, jointStiffness);
+    impDamping.assign(nJoints, 0.0);
+    impOffset.assign(nJoints, 0.0);
+    impAlpha = lagAlpha;
+    jointDigit.assign(nJoints, -1);
+    for (size_t d = 0; d < digits.size(); ++d) {
+        jointDigit[digits[d].joint] = d;
+    }
+
+    // Fingertip spatial response, stronger at the centre of the fingertip
+    taxelWeights.resize(N_FINGERTIP_TAXELS);
+    for (int i = 0; i < N_FINGERTIP_TAXELS; ++i) {
+        double x = (i - 0.5 * (N_FINGERTIP_TAXELS - 1)) / 3.0;
+        taxelWeights[i] = 0.4 + 0.6 * exp(-x * x);
+    }
+
+    // Initial state
+    target = i_initPos;
+    reference = i_initPos;
+    position = i_initPos;
+    velocity.assign(nJoints, 0.0);
+    acceleration.assign(nJoints, 0.0);
+    refSpeed.assign(nJoints, 10.0);
+    refAccel.assign(nJoints, 1e6);
+    lastUpdate = clock->now();
+    settled = true;
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Simulating " << nJoints << " joints with " << digits.size() << " contact digits. \n";
+#endif
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Synthetic sensors                                                ********************************************** */
+void SimulatedHand::getSkin(Vector &o_raw, Vector &o_comp) {
+    mutex.lock();
+    update();
+
+    o_raw.resize(N_TAXELS);
+    o_comp.resize(N_TAXELS);
+    for (int i = 0; i < N_TAXELS; ++i) {
+        o_comp[i] = 0.0;
+    }
+    for (size_t d = 0; d < digits.size(); ++d) {
+        double *tip = o_comp.data() + digits[d].fingertip * N_FINGERTIP_TAXELS;
+        for (int i = 0; i < N_FINGERTIP_TAXELS; ++i) {
+            tip[i] += taxelGain * digits[d].force * taxelWeights[i];
+        }
+    }
+    for (int i = 0; i < N_TAXELS; ++i) {
+        double c = o_comp[i];
+        if (skinNoise > 0.0) {
+            c += skinNoise * gauss();
+        }
+        c = (c < 0.0) ? 0.0 : ((c > 255.0) ? 255.0 : c);
+        o_comp[i] = c;
+        double r = taxelBaseline - c;
+        o_raw[i] = (r < 0.0) ? 0.0 : r;
+    }
+    mutex.unlock();
+}
+
+void SimulatedHand::getWrench(Vector &o_wrench) {
+    mutex.lock();
+    update();
+
+    double normal = 0.0;
+    for (size_t d = 0; d < digits.size(); ++d) {
+        normal += digits[d].force;
+    }
+
+    o_wrench.resize(6);
+    o_wrench[0] = tangentialRatio * normal;
+    o_wrench[1] = 0.0;
+    o_wrench[2] = normal;
+    o_wrench[3] = 0.0;
+    o_wrench[4] = 0.0;
+    o_wrench[5] = 0.0;
+    if (ftNoise > 0.0) {
+        for (int i = 0; i < 6; ++i) {
+            o_wrench[i] += ftNoise * gauss();
+        }
+    }
+    mutex.unlock();
+}
+
+void SimulatedHand::getContactForces(vector<double> &o_forces) {
+    mutex.lock();
+    update();
+
+    o_forces.resize(digits.size());
+    for (size_t d = 0; d < digits.size(); ++d) {
+        o_forces[d] = digits[d].force;
+    }
+    mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Plant integration                                                ********************************************** */
+void SimulatedHand::update() {
+    double now = clock->now();
+
+    if (settled) {
+        lastUpdate = now;
+        return;
+    }
+
+    while ((lastUpdate + dt <= now) && !settled) {
+        step(dt);
+        lastUpdate += dt;
+    }
+
+    if (settled) {
+        lastUpdate = now;
+    }
+}
+
+void SimulatedHand::step(const double &i_dt) {
+    bool done = true;
+
+    for (int j = 0; j < nJoints; ++j) {
+        // Rate limiter
+        double speed = (refSpeed[j] < maxSpeed[j]) ? refSpeed[j] : maxSpeed[j];
+        double maxStep = speed * i_dt;
+        double dr = target[j] - reference[j];
+        if (dr > maxStep) {
+            dr = maxStep;
+        } else if (dr < -maxStep) {
+            dr = -maxStep;
+        }
+        reference[j] += dr;
+
+        // Equilibrium against the object
+        double eq = equilibrium(j, reference[j]);
+
+        // First-order lag
+        double alpha = (controlMode[j] == VOCAB_CM_IMPEDANCE_POS) ? impAlpha[j] : lagAlpha[j];
+        double newPos = position[j] + alpha * (eq - position[j]);
+        double newVel = (newPos - position[j]) / i_dt;
+        acceleration[j] = (newVel - velocity[j]) / i_dt;
+        velocity[j] = newVel;
+        position[j] = newPos;
+
+        if ((reference[j] != target[j]) || (fabs(eq - position[j]) > 1e-6)) {
+            done = false;
+        }
+    }
+
+    // Contact forces
+    for (size_t d = 0; d < digits.size(); ++d) {
+        double pen = position[digits[d].joint] - digits[d].contactPos;
+        digits[d].force = (pen > 0.0) ? objectStiffness * pen : 0.0;
+    }
+
+    if (done) {
+        settled = true;
+        for (int j = 0; j < nJoints; ++j) {
+            velocity[j] = 0.0;
+            acceleration[j] = 0.0;
+        }
+    }
+}
+
+bool SimulatedHand::jointDone(const int &i_joint) const {
+    if (reference[i_joint] != target[i_joint]) {
+        return false;
+    }
+
+    return (fabs(equilibrium(i_joint, reference[i_joint]) - position[i_joint]) <= tolerance);
+}
+
+double SimulatedHand::equilibrium(const int &i_joint, const double &i_reference) const {
+    int d = jointDigit[i_joint];
+    if ((d >= 0) && (i_reference > digits[d].contactPos)) {
+        double k = (controlMode[i_joint] == VOCAB_CM_IMPEDANCE_POS) ? impStiffness[i_joint] : jointStiffness;
+        return (k * i_reference + objectStiffness * digits[d].contactPos) / (k + objectStiffness);
+    }
+
+    return i_reference;
+}
+
+double SimulatedHand::gauss() {
+    if (hasSpareGauss) {
+        hasSpareGauss = false;
+        return spareGauss;
+    }
+
+    // xorshift64* uniform samples in (0, 1]
+    double u[2];
+    for (int i = 0; i < 2; ++i) {
+        rngState ^= rngState >> 12;
+        rngState ^= rngState << 25;
+        rngState ^= rngState >> 27;
+        unsigned long long x = rngState * 2685821657736338717ULL;
+        u[i] = ((x >> 11) + 1) * (1.0 / 9007199254740992.0);
+    }
+
+    // Box-Muller
+    double r = sqrt(-2.0 * log(u[0]));
+    double theta = 2.0 * M_PI * u[1];
+    spareGauss = r * sin(theta);
+    hasSpareGauss = true;
+
+    return r * cos(theta);
+}
+
+bool SimulatedHand::readJointParam(const Bottle &i_group, const string &i_key, const double &i_default, vector<double> &o_values) {
+    o_values.assign(nJoints, i_default);
+
+    Value &v = i_group.find(i_key);
+    if (v.isNull()) {
+        return true;
+    }
+    if (v.isList()) {
+        Bottle *list = v.asList();
+        if (list->size() != nJoints) {
+            cerr << dbgTag << "Invalid " << i_key << " parameter size. Expecting a list of size " << nJoints << ". \n";
+            return false;
+        }
+        for (int i = 0; i < nJoints; ++i) {
+            o_values[i] = list->get(i).asDouble();
+        }
+    } else {
+        o_values.assign(nJoints, v.asDouble());
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IPositionControl                                                 ********************************************** */
+bool SimulatedHand::getAxes(int *ax) {
+    *ax = nJoints;
+    return true;
+}
+
+bool SimulatedHand::setPositionMode() {
+    return true;
+}
+
+bool SimulatedHand::positionMove(int j, double ref) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    target[j] = ref;
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::positionMove(const double *refs) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        target[j] = refs[j];
+    }
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::relativeMove(int j, double delta) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    target[j] += delta;
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::relativeMove(const double *deltas) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        target[j] += deltas[j];
+    }
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::checkMotionDone(int j, bool *flag) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    *flag = jointDone(j);
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::checkMotionDone(bool *flag) {
+    mutex.lock();
+    update();
+    bool done = true;
+    for (int j = 0; (j < nJoints) && done; ++j) {
+        done = jointDone(j);
+    }
+    *flag = done;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setRefSpeed(int j, double sp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    refSpeed[j] = fabs(sp);
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setRefSpeeds(const double *spds) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        refSpeed[j] = fabs(spds[j]);
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setRefAcceleration(int j, double acc) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    refAccel[j] = acc;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setRefAccelerations(const double *accs) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        refAccel[j] = accs[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getRefSpeed(int j, double *ref) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    *ref = refSpeed[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getRefSpeeds(double *spds) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        spds[j] = refSpeed[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getRefAcceleration(int j, double *acc) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    *acc = refAccel[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getRefAccelerations(double *accs) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        accs[j] = refAccel[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::stop(int j) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    target[j] = reference[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::stop() {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        target[j] = reference[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IEncoders                                                        ********************************************** */
+bool SimulatedHand::resetEncoder(int j) {
+    return setEncoder(j, 0.0);
+}
+
+bool SimulatedHand::resetEncoders() {
+    vector<double> zeros(nJoints, 0.0);
+    return setEncoders(&zeros[0]);
+}
+
+bool SimulatedHand::setEncoder(int j, double val) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    target[j] = reference[j] = position[j] = val;
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setEncoders(const double *vals) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        target[j] = reference[j] = position[j] = vals[j];
+    }
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoder(int j, double *v) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    *v = position[j] + ((encNoise > 0.0) ? encNoise * gauss() : 0.0);
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoders(double *encs) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        encs[j] = position[j] + ((encNoise > 0.0) ? encNoise * gauss() : 0.0);
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoderSpeed(int j, double *sp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    *sp = velocity[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoderSpeeds(double *spds) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        spds[j] = velocity[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoderAcceleration(int j, double *spds) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    *spds = acceleration[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getEncoderAccelerations(double *accs) {
+    mutex.lock();
+    update();
+    for (int j = 0; j < nJoints; ++j) {
+        accs[j] = acceleration[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IControlMode2                                                    ********************************************** */
+bool SimulatedHand::applyControlMode(const int &i_joint, const int &i_mode) {
+    if ((i_joint < 0) || (i_joint >= nJoints)) {
+        return false;
+    }
+    if ((i_mode != VOCAB_CM_POSITION) && (i_mode != VOCAB_CM_IMPEDANCE_POS)) {
+        return false;
+    }
+
+    if (controlMode[i_joint] != i_mode) {
+        update();
+        controlMode[i_joint] = i_mode;
+        settled = false;
+    }
+
+    return true;
+}
+
+bool SimulatedHand::setPositionMode(int j) {
+    mutex.lock();
+    bool ok = applyControlMode(j, VOCAB_CM_POSITION);
+    mutex.unlock();
+
+    return ok;
+}
+
+bool SimulatedHand::setVelocityMode(int j) {
+    return false;
+}
+
+bool SimulatedHand::setTorqueMode(int j) {
+    return false;
+}
+
+bool SimulatedHand::setImpedancePositionMode(int j) {
+    mutex.lock();
+    bool ok = applyControlMode(j, VOCAB_CM_IMPEDANCE_POS);
+    mutex.unlock();
+
+    return ok;
+}
+
+bool SimulatedHand::setImpedanceVelocityMode(int j) {
+    return false;
+}
+
+bool SimulatedHand::setOpenLoopMode(int j) {
+    return false;
+}
+
+bool SimulatedHand::getControlMode(int j, int *mode) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    *mode = controlMode[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getControlModes(int *modes) {
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        modes[j] = controlMode[j];
+    }
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getControlModes(const int n_joint, const int *joints, int *modes) {
+    bool ok = true;
+
+    mutex.lock();
+    for (int i = 0; i < n_joint; ++i) {
+        if ((joints[i] >= 0) && (joints[i] < nJoints)) {
+            modes[i] = controlMode[joints[i]];
+        } else {
+            ok = false;
+        }
+    }
+    mutex.unlock();
+
+    return ok;
+}
+
+bool SimulatedHand::setControlMode(const int j, const int mode) {
+    mutex.lock();
+    bool ok = applyControlMode(j, mode);
+    mutex.unlock();
+
+    return ok;
+}
+
+bool SimulatedHand::setControlModes(const int n_joint, const int *joints, int *modes) {
+    bool ok = true;
+
+    mutex.lock();
+    for (int i = 0; i < n_joint; ++i) {
+        ok &= applyControlMode(joints[i], modes[i]);
+    }
+    mutex.unlock();
+
+    return ok;
+}
+
+bool SimulatedHand::setControlModes(int *modes) {
+    bool ok = true;
+
+    mutex.lock();
+    for (int j = 0; j < nJoints; ++j) {
+        ok &= applyControlMode(j, modes[j]);
+    }
+    mutex.unlock();
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* IImpedanceControl                                                ********************************************** */
+bool SimulatedHand::getImpedance(int j, double *stiffness, double *damping) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    *stiffness = impStiffness[j];
+    *damping = impDamping[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setImpedance(int j, double stiffness, double damping) {
+    if ((j < 0) || (j >= nJoints) || (stiffness <= 0.0) || (damping < 0.0)) {
+        return false;
+    }
+
+    mutex.lock();
+    update();
+    impStiffness[j] = stiffness;
+    impDamping[j] = damping;
+    double tauImp = tau[j] + damping / stiffness;
+    impAlpha[j] = (tauImp > 0.0) ? (1.0 - exp(-dt / tauImp)) : 1.0;
+    settled = false;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::setImpedanceOffset(int j, double offset) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    impOffset[j] = offset;
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getImpedanceOffset(int j, double *offset) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    mutex.lock();
+    *offset = impOffset[j];
+    mutex.unlock();
+
+    return true;
+}
+
+bool SimulatedHand::getCurrentImpedanceLimit(int j, double *min_stiff, double *max_stiff, double *min_damp, double *max_damp) {
+    if ((j < 0) || (j >= nJoints)) {
+        return false;
+    }
+
+    *min_stiff = 0.0;
+    *max_stiff = 10.0 * jointStiffness;
+    *min_damp = 0.0;
+    *max_damp = 1.0;
+
+    return true;
+}
+/* *********************************************************************************************************************** */
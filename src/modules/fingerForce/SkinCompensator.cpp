@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SkinCompensator.h"
+
+#include <iostream>
+
+#include <yarp/os/Stamp.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+
+using iCub::interactionForces::SkinCompensator;
+using iCub::interactionForces::SensorHub;
+using iCub::interactionForces::PinchPhase;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Stamp;
+
+
+#define SKIN_TAXELS 192
+
+
+SkinCompensator::SkinCompensator(SensorHub *aHub) {
+    hub = aHub;
+    rate = 0.01;
+    settle = 0.5;
+    replace = false;
+
+    // The fingers are free before the first pinch
+    learning = true;
+    learnFrom = 0.0;
+
+    initialised = false;
+    updates = 0;
+
+    dbgTag = "SkinCompensator: ";
+}
+
+SkinCompensator::~SkinCompensator() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the compensator                                        ********************************************** */
+bool SkinCompensator::configure(const Bottle &i_group, const string &i_portName) {
+    rate = i_group.check("rate", Value(0.01), "Baseline adaptation rate per sample.").asDouble();
+    settle = i_group.check("settle", Value(0.5), "Time after the start of a rest phase before the baseline adapts.").asDouble();
+    replace = i_group.check("replace", Value(false), "Set to true to replace the skinManager compensated stream.").asBool();
+    if ((rate <= 0.0) || (rate > 1.0)) {
+        cerr << dbgTag << "Invalid baseline adaptation rate. \n";
+        return false;
+    }
+
+    // Preallocate all buffers
+    baseline.assign(SKIN_TAXELS, 0.0);
+    comp.resize(SKIN_TAXELS);
+
+    if (!compPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+    if (replace) {
+        hub->setInternal(STREAM_SKIN_COMP);
+    }
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Compensating the raw skin with a rate of " << rate << (replace ? ", replacing" : ", alongside")
+        << " the skinManager stream. \n";
+#endif
+
+    return true;
+}
+
+void SkinCompensator::interrupt() {
+    compPort.interrupt();
+}
+
+void SkinCompensator::close() {
+    compPort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Pinch phases                                                     ********************************************** */
+void SkinCompensator::setPhase(const PinchPhase i_phase, const double &i_time) {
+    mutex.lock();
+    learning = (i_phase == PHASE_REST);
+    learnFrom = i_time + settle;
+    mutex.unlock();
+}
+
+unsigned int SkinCompensator::getUpdates(void) {
+    mutex.lock();
+    unsigned int n = updates;
+    mutex.unlock();
+
+    return n;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sample processing                                                ********************************************** */
+void SkinCompensator::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    if ((i_stream != STREAM_SKIN_RAW) || (i_sample.size < SKIN_TAXELS)) {
+        return;
+    }
+
+    mutex.lock();
+    bool learn = learning && (i_sample.rxTime >= learnFrom);
+    if (learn) {
+        updates++;
+    }
+    mutex.unlock();
+
+    if (!initialised) {
+        // Start from the first sample
+        for (int i = 0; i < SKIN_TAXELS; ++i) {
+            baseline[i] = i_sample.data[i];
+        }
+        initialised = true;
+    }
+    compensate(i_sample.data, &baseline[0], comp.data(), SKIN_TAXELS, rate, learn);
+
+    Stamp envelope(i_sample.seq, i_sample.envTime);
+    yarp::sig::Vector &out = compPort.prepare();
+    out = comp;
+    compPort.setEnvelope(envelope);
+    compPort.write();
+
+    if (replace) {
+        hub->inject(STREAM_SKIN_COMP, comp, envelope);
+    }
+}
+
+void SkinCompensator::compensate(const double *i_raw, double *io_baseline, double *o_comp, const int &i_n, const double &i_rate,
+        const bool &i_learn) {
+    // Local copies, the references could alias the arrays and prevent the vectorisation
+    const int n = i_n;
+    const double r = i_rate;
+    if (i_learn) {
+        for (int i = 0; i < n; ++i) {
+            double b = io_baseline[i] + r * (i_raw[i] - io_baseline[i]);
+            double c = b - i_raw[i];
+            io_baseline[i] = b;
+            o_comp[i] = (c > 0.0) ? c : 0.0;
+        }
+    } else {
+        for (int i = 0; i < n; ++i) {
+            double c = io_baseline[i] - i_raw[i];
+            o_comp[i] = (c > 0.0) ? c : 0.0;
+        }
+    }
+}
+/* *********************************************************************************************************************** */
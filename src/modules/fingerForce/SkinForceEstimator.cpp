@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SkinForceEstimator.h"
+
+#include <iostream>
+#include <vector>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::SkinForceEstimator;
+using iCub::interactionForces::FingertipModel;
+
+using yarp::os::Bottle;
+
+
+SkinForceEstimator::SkinForceEstimator() {
+    dbgTag = "SkinForceEstimator: ";
+}
+
+SkinForceEstimator::~SkinForceEstimator() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the estimator                                          ********************************************** */
+bool SkinForceEstimator::configure(const string &i_file, const string &i_portName) {
+    if (!model.load(i_file)) {
+        return false;
+    }
+
+    if (!forcePort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+#ifndef NODEBUG
+    const vector<FingertipModel> &models = model.getModels();
+    for (size_t k = 0; k < models.size(); ++k) {
+        cout << "DEBUG: " << dbgTag << "Fingertip " << models[k].fingertip << " calibrated on " << models[k].samples
+            << " samples, cross-validated error " << models[k].cvRmse << " N. \n";
+    }
+#endif
+
+    return true;
+}
+
+void SkinForceEstimator::interrupt() {
+    forcePort.interrupt();
+}
+
+void SkinForceEstimator::close() {
+    forcePort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sample processing                                                ********************************************** */
+void SkinForceEstimator::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    if (i_stream != STREAM_SKIN_COMP) {
+        return;
+    }
+
+    const vector<FingertipModel> &models = model.getModels();
+    Bottle &out = forcePort.prepare();
+    out.clear();
+    out.addDouble((i_sample.envTime > 0.0) ? i_sample.envTime : i_sample.rxTime);
+    for (size_t k = 0; k < models.size(); ++k) {
+        double force;
+        if (model.predict(models[k].fingertip, i_sample.data, i_sample.size, force)) {
+            out.addInt(models[k].fingertip);
+            out.addDouble(force);
+        }
+    }
+    forcePort.write();
+}
+/* *********************************************************************************************************************** */
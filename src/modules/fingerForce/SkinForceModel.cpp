@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SkinForceModel.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#include <yarp/os/Property.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Value.h>
+
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::SkinForceModel;
+using iCub::interactionForces::FingertipModel;
+
+using yarp::os::Property;
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+/** The taxel sum scale of the quadratic feature, keeping it in the range of the linear ones. */
+#define SUM_SCALE 0.01
+
+
+const int SkinForceModel::N_FEATURES;
+
+SkinForceModel::SkinForceModel() {
+    dbgTag = "SkinForceModel: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Model file                                                       ********************************************** */
+bool SkinForceModel::load(const string &i_file) {
+    Property file;
+    if (!file.fromConfigFile(i_file.c_str())) {
+        cerr << dbgTag << "Could not read " << i_file << ". \n";
+        return false;
+    }
+
+    models.clear();
+    for (int f = 0; f < 5; ++f) {
+        stringstream name;
+        name << "fingertip_" << f;
+        Bottle &group = file.findGroup(name.str().c_str());
+        if (group.isNull()) {
+            continue;
+        }
+
+        Bottle *weights = group.find("weights").asList();
+        if ((weights == NULL) || (weights->size() != N_FEATURES)) {
+            cerr << dbgTag << "Invalid weights for fingertip " << f << " in " << i_file << ". \n";
+            return false;
+        }
+        FingertipModel model;
+        model.fingertip = f;
+        for (int i = 0; i < weights->size(); ++i) {
+            model.weights.push_back(weights->get(i).asDouble());
+        }
+        model.lambda = group.check("lambda", Value(0.0)).asDouble();
+        model.samples = group.check("samples", Value(0)).asInt();
+        model.rmse = group.check("rmse", Value(0.0)).asDouble();
+        model.cvRmse = group.check("cvRmse", Value(0.0)).asDouble();
+        models.push_back(model);
+    }
+
+    if (models.empty()) {
+        cerr << dbgTag << "No fingertip model in " << i_file << ". \n";
+        return false;
+    }
+
+    return true;
+}
+
+bool SkinForceModel::save(const string &i_file) const {
+    std::ofstream file(i_file.c_str());
+    if (!file.is_open()) {
+        cerr << dbgTag << "Could not create " << i_file << ". \n";
+        return false;
+    }
+
+    file << "# Skin to force models: force = weights . (1 taxel_0 ... taxel_11 (" << SUM_SCALE << " * sum)^2)\n";
+    file << std::setprecision(12);
+    for (size_t k = 0; k < models.size(); ++k) {
+        const FingertipModel &model = models[k];
+        file << "\n[fingertip_" << model.fingertip << "]\n";
+        file << "weights (";
+        for (size_t i = 0; i < model.weights.size(); ++i) {
+            file << (i > 0 ? " " : "") << model.weights[i];
+        }
+        file << ")\n";
+        file << "lambda " << model.lambda << "\n";
+        file << "samples " << model.samples << "\n";
+        file << "rmse " << model.rmse << "\n";
+        file << "cvRmse " << model.cvRmse << "\n";
+    }
+
+    return file.good();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Prediction                                                       ********************************************** */
+const FingertipModel* SkinForceModel::find(const int &i_fingertip) const {
+    for (size_t k = 0; k < models.size(); ++k) {
+        if (models[k].fingertip == i_fingertip) {
+            return &models[k];
+        }
+    }
+
+    return NULL;
+}
+
+bool SkinForceModel::predict(const int &i_fingertip, const double *i_skin, const size_t &i_size, double &o_force) const {
+    const FingertipModel *model = find(i_fingertip);
+    if ((model == NULL) || (i_size < SKIN_TAXELS)) {
+        return false;
+    }
+
+    double x[N_FEATURES];
+    features(i_skin + i_fingertip * FINGERTIP_TAXELS, x);
+    o_force = 0.0;
+    for (int i = 0; i < N_FEATURES; ++i) {
+        o_force += model->weights[i] * x[i];
+    }
+
+    return true;
+}
+
+void SkinForceModel::features(const double *i_taxels, double *o_features) {
+    double sum = 0.0;
+    o_features[0] = 1.0;
+    for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+        o_features[i + 1] = i_taxels[i];
+        sum += i_taxels[i];
+    }
+    o_features[FINGERTIP_TAXELS + 1] = (SUM_SCALE * sum) * (SUM_SCALE * sum);
+}
+/* *********************************************************************************************************************** */
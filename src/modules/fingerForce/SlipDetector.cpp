@@ -0,0 +1,275 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#include "SlipDetector.h"
+
+#include <iostream>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::SlipDetector;
+using iCub::interactionForces::SlipEvent;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+
+const int SlipDetector::SOURCE_FT;
+
+SlipDetector::SlipDetector() {
+    windowSize = 20;
+    skinThreshold = 4.0;
+    ftThreshold = 4.0;
+    skinMinEnergy = 1.0;
+    ftMinEnergy = 1e-4;
+    baselineRate = 0.01;
+    latchedRate = 0.001;
+    refractory = 0.2;
+
+    hasPrevSkin = false;
+    prevFx = 0.0;
+    prevFy = 0.0;
+    hasPrevFt = false;
+
+    armed = false;
+    armings = 0;
+    pendingEvents = 0;
+    totalEvents = 0;
+
+    dbgTag = "SlipDetector: ";
+}
+
+SlipDetector::~SlipDetector() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the detector                                           ********************************************** */
+bool SlipDetector::configure(const Bottle &i_group, const string &i_portName) {
+    windowSize = i_group.check("window", Value(20), "Sliding window length in samples.").asInt();
+    skinThreshold = i_group.check("skinThreshold", Value(4.0), "Skin energy threshold relative to the baseline.").asDouble();
+    ftThreshold = i_group.check("ftThreshold", Value(4.0), "Tangential force energy threshold relative to the baseline.").asDouble();
+    skinMinEnergy = i_group.check("skinMinEnergy", Value(1.0), "Minimum skin window energy for a slip.").asDouble();
+    ftMinEnergy = i_group.check("ftMinEnergy", Value(1e-4), "Minimum tangential force window energy for a slip.").asDouble();
+    baselineRate = i_group.check("baselineRate", Value(0.01), "Baseline energy adaptation rate.").asDouble();
+    latchedRate = i_group.check("latchedRate", Value(0.001), "Baseline energy adaptation rate above threshold.").asDouble();
+    refractory = i_group.check("refractory", Value(0.2), "Minimum time between two events of the same source.").asDouble();
+    if (windowSize <= 0) {
+        cerr << dbgTag << "Invalid window length. \n";
+        return false;
+    }
+    if ((latchedRate < 0.0) || (latchedRate > baselineRate)) {
+        cerr << dbgTag << "Invalid latched adaptation rate, must be within [0, baselineRate]. \n";
+        return false;
+    }
+
+    fingertips.clear();
+    Bottle *tips = i_group.find("fingertips").asList();
+    if (tips != NULL) {
+        for (int i = 0; i < tips->size(); ++i) {
+            int f = tips->get(i).asInt();
+            if ((f < 0) || (f > 4)) {
+                cerr << dbgTag << "Invalid fingertip index " << f << ". \n";
+                return false;
+            }
+            fingertips.push_back(f);
+        }
+    } else {
+        for (int f = 0; f < 5; ++f) {
+            fingertips.push_back(f);
+        }
+    }
+
+    // Preallocate all buffers
+    prevTaxels.assign(SKIN_TAXELS, 0.0);
+    skinChannels.resize(fingertips.size());
+    for (size_t i = 0; i < skinChannels.size(); ++i) {
+        resetChannel(skinChannels[i]);
+    }
+    resetChannel(ftChannel);
+
+    if (!eventPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Monitoring " << fingertips.size() << " fingertips with a window of " << windowSize << " samples. \n";
+#endif
+
+    return true;
+}
+
+void SlipDetector::resetChannel(EnergyChannel &io_channel) {
+    io_channel.window.assign(windowSize, 0.0);
+    io_channel.head = 0;
+    io_channel.count = 0;
+    io_channel.sum = 0.0;
+    io_channel.baseline = 0.0;
+    io_channel.lastEvent = -1e9;
+    io_channel.seeded = 0;
+}
+
+void SlipDetector::interrupt() {
+    eventPort.interrupt();
+}
+
+void SlipDetector::close() {
+    eventPort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Event access                                                     ********************************************** */
+void SlipDetector::setArmed(const bool i_armed) {
+    mutex.lock();
+    if (i_armed && !armed) {
+        armings++;
+    }
+    armed = i_armed;
+    mutex.unlock();
+}
+
+int SlipDetector::takeEvents() {
+    mutex.lock();
+    int n = pendingEvents;
+    pendingEvents = 0;
+    mutex.unlock();
+
+    return n;
+}
+
+bool SlipDetector::getLastEvent(SlipEvent &o_event, unsigned int &o_total) {
+    mutex.lock();
+    o_event = lastSlip;
+    o_total = totalEvents;
+    mutex.unlock();
+
+    return (o_total > 0);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sample processing                                                ********************************************** */
+void SlipDetector::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    double stamp = (i_sample.envTime > 0.0) ? i_sample.envTime : i_sample.rxTime;
+
+    if ((i_stream == STREAM_SKIN_COMP) && (i_sample.size >= SKIN_TAXELS)) {
+        for (size_t k = 0; k < fingertips.size(); ++k) {
+            const int base = fingertips[k] * FINGERTIP_TAXELS;
+            const double *x = i_sample.data + base;
+            double *prev = &prevTaxels[base];
+
+            // Energy of the taxel first difference
+            double energy = 0.0;
+            for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+                double d = x[i] - prev[i];
+                energy += d * d;
+                prev[i] = x[i];
+            }
+
+            if (hasPrevSkin) {
+                processEnergy(skinChannels[k], energy, skinThreshold, skinMinEnergy, fingertips[k], stamp);
+            }
+        }
+        hasPrevSkin = true;
+    } else if ((i_stream == STREAM_WRENCH) && (i_sample.size >= 2)) {
+        double dFx = i_sample.data[0] - prevFx;
+        double dFy = i_sample.data[1] - prevFy;
+        prevFx = i_sample.data[0];
+        prevFy = i_sample.data[1];
+
+        if (hasPrevFt) {
+            processEnergy(ftChannel, dFx * dFx + dFy * dFy, ftThreshold, ftMinEnergy, SOURCE_FT, stamp);
+        }
+        hasPrevFt = true;
+    }
+}
+
+void SlipDetector::processEnergy(EnergyChannel &io_channel, const double &i_energy, const double &i_threshold,
+        const double &i_minEnergy, const int &i_source, const double &i_stamp) {
+    // Sliding window sum
+    io_channel.sum += i_energy - io_channel.window[io_channel.head];
+    if (io_channel.sum < 0.0) {
+        io_channel.sum = 0.0;
+    }
+    io_channel.window[io_channel.head] = i_energy;
+    io_channel.head = (io_channel.head + 1) % io_channel.window.size();
+    if (io_channel.count < io_channel.window.size()) {
+        io_channel.count++;
+        io_channel.baseline = io_channel.sum / io_channel.count;
+        return;
+    }
+
+    mutex.lock();
+    bool isArmed = armed;
+    unsigned int arming = armings;
+    mutex.unlock();
+
+    // Start each armed period from the current contact
+    if (io_channel.seeded != arming) {
+        io_channel.seeded = arming;
+        io_channel.baseline = io_channel.sum / io_channel.window.size();
+    }
+
+    double level = io_channel.baseline * io_channel.window.size();
+    if ((io_channel.sum > i_minEnergy) && (io_channel.sum > i_threshold * level)) {
+        if (isArmed && (i_stamp - io_channel.lastEvent > refractory)) {
+            SlipEvent event;
+            event.source = i_source;
+            event.stamp = i_stamp;
+            event.energy = io_channel.sum;
+            event.baseline = level;
+
+            io_channel.lastEvent = i_stamp;
+            emit(event);
+        }
+        // Follow a lasting change of the contact load, at a lower rate
+        io_channel.baseline += latchedRate * (io_channel.sum / io_channel.window.size() - io_channel.baseline);
+    } else {
+        io_channel.baseline += baselineRate * (io_channel.sum / io_channel.window.size() - io_channel.baseline);
+    }
+}
+
+void SlipDetector::emit(const SlipEvent &i_event) {
+    mutex.lock();
+    pendingEvents++;
+    totalEvents++;
+    lastSlip = i_event;
+    mutex.unlock();
+
+    portMutex.lock();
+    Bottle &out = eventPort.prepare();
+    out.clear();
+    out.addString("slip");
+    out.addInt(i_event.source);
+    out.addDouble(i_event.stamp);
+    out.addDouble(i_event.energy);
+    out.addDouble(i_event.baseline);
+    eventPort.write();
+    portMutex.unlock();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "StallDetector.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::AdaptiveDerivative;
+using iCub::interactionForces::StallDetector;
+using iCub::interactionForces::ContactOnset;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+/* *********************************************************************************************************************** */
+/* ******* Adaptive window differentiator                                   ********************************************** */
+AdaptiveDerivative::AdaptiveDerivative() {
+    maxWindow = 16;
+    noise = 0.1;
+    head = 0;
+    count = 0;
+}
+
+void AdaptiveDerivative::setup(const size_t &i_maxWindow, const double &i_noise) {
+    maxWindow = (i_maxWindow > 0) ? i_maxWindow : 1;
+    noise = i_noise;
+    times.assign(maxWindow + 1, 0.0);
+    values.assign(maxWindow + 1, 0.0);
+    reset();
+}
+
+void AdaptiveDerivative::reset(void) {
+    head = 0;
+    count = 0;
+}
+
+bool AdaptiveDerivative::update(const double &i_time, const double &i_value, double &o_derivative, size_t &o_window) {
+    const size_t size = times.size();
+    if (size == 0) {
+        return false;
+    }
+    times[head] = i_time;
+    values[head] = i_value;
+    size_t last = head;
+    head = (head + 1) % size;
+    if (count < size) {
+        count++;
+    }
+    if (count < 2) {
+        return false;
+    }
+
+    // Longest window whose samples all lie within the noise bound of the end-point line
+    o_window = 0;
+    for (size_t n = 1; n < count; ++n) {
+        size_t first = (last + size - n) % size;
+        double dt = i_time - times[first];
+        if (dt <= 0.0) {
+            break;
+        }
+        double slope = (i_value - values[first]) / dt;
+        bool fits = true;
+        for (size_t j = 1; (j < n) && fits; ++j) {
+            size_t k = (last + size - j) % size;
+            fits = (fabs(values[k] - (i_value - slope * (i_time - times[k]))) <= noise);
+        }
+        if (!fits) {
+            break;
+        }
+        o_derivative = slope;
+        o_window = n;
+    }
+
+    return (o_window > 0);
+}
+/* *********************************************************************************************************************** */
+
+
+const int StallDetector::SOURCE_FINGER_JOINT;
+const int StallDetector::SOURCE_THUMB_JOINT;
+
+StallDetector::StallDetector() {
+    stallVelocity = 2.0;
+    moveVelocity = 5.0;
+    stallTime = 0.05;
+    minError = 1.0;
+    startTimeout = 0.5;
+    maxWindow = 16;
+
+    armed = false;
+    pinch = -1;
+    // The onsets are recorded by the sensor threads without allocating
+    onsets.reserve(MAX_CONTACT_ONSETS);
+
+    nLatency = 0;
+    latencySum = 0.0;
+    latencyMax = 0.0;
+
+    dbgTag = "StallDetector: ";
+}
+
+StallDetector::~StallDetector() {}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the detector                                           ********************************************** */
+bool StallDetector::configure(const Bottle &i_group, const string &i_portName, const int &i_fingerJoint) {
+    maxWindow = i_group.check("maxWindow", Value(16), "Maximum differentiation window in samples.").asInt();
+    double noise = i_group.check("noise", Value(0.05), "Encoder noise bound in degrees.").asDouble();
+    stallVelocity = i_group.check("stallVelocity", Value(2.0), "Speed below which a commanded joint stalls in deg/s.").asDouble();
+    moveVelocity = i_group.check("moveVelocity", Value(5.0), "Speed above which a commanded joint has moved in deg/s.").asDouble();
+    stallTime = i_group.check("stallTime", Value(0.05), "Time a joint must stall for a contact in seconds.").asDouble();
+    minError = i_group.check("minError", Value(1.0), "Distance from the target below which a joint has arrived in degrees.").asDouble();
+    startTimeout = i_group.check("startTimeout", Value(0.5), "Time after a command after which a joint that did not move stalls.").asDouble();
+    if ((maxWindow <= 0) || (noise <= 0.0) || (stallVelocity >= moveVelocity)) {
+        cerr << dbgTag << "Invalid window, noise bound or velocities. \n";
+        return false;
+    }
+
+    // Preallocate all buffers
+    channels.resize(2);
+    setupChannel(channels[0], SOURCE_FINGER_JOINT, i_fingerJoint);
+    setupChannel(channels[1], SOURCE_THUMB_JOINT, 9);
+    for (size_t k = 0; k < channels.size(); ++k) {
+        channels[k].velocityFilter.setup(maxWindow, noise);
+        channels[k].accelerationFilter.setup(maxWindow, stallVelocity);
+    }
+    joints.resize(channels.size());
+    for (size_t k = 0; k < channels.size(); ++k) {
+        joints[k] = channels[k].joint;
+    }
+    commanded.assign(channels.size(), false);
+    targets.assign(channels.size(), 0.0);
+    commandTimes.assign(channels.size(), 0.0);
+    commands.assign(channels.size(), 0);
+
+    if (!eventPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+#ifndef NODEBUG
+    cout << "DEBUG: " << dbgTag << "Monitoring joints " << channels[0].joint << " and " << channels[1].joint << ", stall after "
+        << stallTime << " s below " << stallVelocity << " deg/s. \n";
+#endif
+
+    return true;
+}
+
+void StallDetector::setupChannel(JointChannel &o_channel, const int &i_source, const int &i_joint) {
+    o_channel.source = i_source;
+    o_channel.joint = i_joint;
+    o_channel.velocityFilter.reset();
+    o_channel.accelerationFilter.reset();
+    o_channel.velocity = 0.0;
+    o_channel.acceleration = 0.0;
+    o_channel.command = 0;
+    o_channel.start = 0.0;
+    o_channel.moved = false;
+    o_channel.stalling = false;
+    o_channel.stallStart = 0.0;
+    o_channel.stallStartRx = 0.0;
+    o_channel.impact = -1.0;
+    o_channel.peakDeceleration = 0.0;
+    o_channel.found = false;
+}
+
+void StallDetector::setup(const int &i_fingerJoint) {
+    mutex.lock();
+    if (!joints.empty()) {
+        joints[0] = i_fingerJoint;
+    }
+    mutex.unlock();
+}
+
+void StallDetector::interrupt() {
+    eventPort.interrupt();
+}
+
+void StallDetector::close() {
+    eventPort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Commands and onsets                                              ********************************************** */
+void StallDetector::command(const int &i_joint, const double &i_target, const double &i_time) {
+    mutex.lock();
+    for (size_t k = 0; k < channels.size(); ++k) {
+        if (joints[k] == i_joint) {
+            commanded[k] = true;
+            targets[k] = i_target;
+            commandTimes[k] = i_time;
+            commands[k]++;
+        }
+    }
+    mutex.unlock();
+}
+
+void StallDetector::arm(const int &i_pinch) {
+    mutex.lock();
+    armed = true;
+    pinch = i_pinch;
+    onsets.clear();
+    for (size_t k = 0; k < channels.size(); ++k) {
+        commanded[k] = false;
+        commands[k]++;
+    }
+    mutex.unlock();
+}
+
+void StallDetector::disarm() {
+    mutex.lock();
+    armed = false;
+    for (size_t k = 0; k < channels.size(); ++k) {
+        commanded[k] = false;
+    }
+    mutex.unlock();
+}
+
+int StallDetector::getOnsets(ContactOnset *o_onsets, const int &i_size) {
+    mutex.lock();
+    int n = std::min((int) onsets.size(), i_size);
+    std::copy(onsets.begin(), onsets.begin() + n, o_onsets);
+    mutex.unlock();
+
+    return n;
+}
+
+string StallDetector::getReport(void) {
+    stringstream ss;
+    ss << std::fixed << std::setprecision(1);
+
+    mutex.lock();
+    if (nLatency > 0) {
+        ss << nLatency << " stalls, detection latency mean " << 1000.0 * latencySum / nLatency << " ms, max "
+            << 1000.0 * latencyMax << " ms";
+    } else {
+        ss << "no stall";
+    }
+    mutex.unlock();
+    ss << ". \n";
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Sample processing                                                ********************************************** */
+void StallDetector::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    if (i_stream != STREAM_JOINTS) {
+        return;
+    }
+    bool envelope = (i_sample.envTime > 0.0);
+    double stamp = envelope ? i_sample.envTime : i_sample.rxTime;
+
+    for (size_t k = 0; k < channels.size(); ++k) {
+        mutex.lock();
+        int joint = joints[k];
+        bool isArmed = armed;
+        bool isCommanded = commanded[k];
+        double target = targets[k];
+        double commandTime = commandTimes[k];
+        unsigned int command = commands[k];
+        int currentPinch = pinch;
+        mutex.unlock();
+
+        JointChannel &channel = channels[k];
+        if (channel.joint != joint) {
+            setupChannel(channel, channel.source, joint);
+        }
+        if ((joint < 0) || ((size_t) joint >= i_sample.size)) {
+            continue;
+        }
+        double position = i_sample.data[joint];
+        size_t window;
+        if (!channel.velocityFilter.update(stamp, position, channel.velocity, window)) {
+            continue;
+        }
+        channel.accelerationFilter.update(stamp, channel.velocity, channel.acceleration, window);
+
+        // New command
+        if (channel.command != command) {
+            channel.command = command;
+            channel.start = position;
+            channel.moved = false;
+            channel.stalling = false;
+            channel.impact = -1.0;
+            channel.peakDeceleration = 0.0;
+            channel.found = false;
+        }
+        if (!isArmed || !isCommanded || channel.found) {
+            channel.stalling = false;
+            continue;
+        }
+
+        double error = target - position;
+        if (fabs(error) < minError) {
+            // Arrived
+            channel.stalling = false;
+            continue;
+        }
+        double direction = (error > 0.0) ? 1.0 : -1.0;
+        // Achieved motion, not a noise peak of the velocity
+        if ((channel.velocity * direction > moveVelocity) && ((position - channel.start) * direction >= minError)) {
+            channel.moved = true;
+        }
+
+        // Peak deceleration of the move towards the target
+        if (channel.moved && !channel.stalling && (-channel.acceleration * direction > channel.peakDeceleration)) {
+            channel.peakDeceleration = -channel.acceleration * direction;
+            channel.impact = stamp;
+        }
+
+        bool active = channel.moved || (i_sample.rxTime - commandTime > startTimeout);
+        if (active && (fabs(channel.velocity) < stallVelocity)) {
+            if (!channel.stalling) {
+                channel.stalling = true;
+                channel.stallStart = stamp;
+                channel.stallStartRx = i_sample.rxTime;
+            }
+            if (i_sample.rxTime - channel.stallStartRx >= stallTime) {
+                ContactOnset onset;
+                onset.source = channel.source;
+                onset.pinch = currentPinch;
+                onset.time = ((channel.impact > 0.0) && (channel.impact <= channel.stallStart)) ? channel.impact : channel.stallStart;
+                onset.detected = stamp;
+                onset.amplitude = error;
+                onset.envelope = envelope;
+                onset.received = i_sample.rxTime;
+                channel.found = true;
+                emit(onset);
+            }
+        } else {
+            channel.stalling = false;
+        }
+    }
+}
+
+void StallDetector::emit(const ContactOnset &i_onset) {
+    double latency = i_onset.detected - i_onset.time;
+
+    mutex.lock();
+    onsets.push_back(i_onset);
+    nLatency++;
+    latencySum += latency;
+    latencyMax = (latency > latencyMax) ? latency : latencyMax;
+    mutex.unlock();
+
+    Bottle &out = eventPort.prepare();
+    out.clear();
+    out.addString("onset");
+    out.addInt(i_onset.pinch);
+    out.addInt(i_onset.source);
+    out.addDouble(i_onset.time);
+    out.addDouble(i_onset.detected);
+    out.addDouble(i_onset.amplitude);
+    eventPort.write();
+}
+/* *********************************************************************************************************************** */
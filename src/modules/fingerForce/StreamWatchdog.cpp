@@ -0,0 +1,270 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "StreamWatchdog.h"
+#include "SensorHub.h"
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::StreamWatchdog;
+using iCub::interactionForces::StreamHealth;
+using iCub::interactionForces::StreamStatus;
+using iCub::interactionForces::SensorHub;
+using iCub::interactionForces::Clock;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+
+
+StreamWatchdog::StreamWatchdog(const int aPeriod, Clock *aClock) 
+    : ClockedRateThread(aPeriod, aClock) {
+        for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+            states[i].samples = 0;
+            states[i].drops = 0;
+            states[i].lastSeq = -1;
+            states[i].lastRx = 0.0;
+            states[i].period = 0.0;
+            states[i].jitter = 0.0;
+            states[i].latency = 0.0;
+            states[i].checkSamples = 0;
+            states[i].checkDrops = 0;
+
+            health[i].status = STATUS_IDLE;
+            health[i].rate = 0.0;
+            health[i].nominalRate = 0.0;
+            health[i].jitter = 0.0;
+            health[i].latency = 0.0;
+            health[i].dropRate = 0.0;
+            health[i].samples = 0;
+            health[i].drops = 0;
+            health[i].age = 0.0;
+        }
+        lastCheck = 0.0;
+
+        stallTimeout = 0.5;
+        rateRatio = 0.5;
+        maxDropRate = 0.1;
+        maxLatency = 0.05;
+        maxJitter = 0.0;
+        filter = 0.05;
+
+        dbgTag = "StreamWatchdog: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the watchdog                                           ********************************************** */
+bool StreamWatchdog::configure(const Bottle &i_group, const string &i_portName) {
+    stallTimeout = i_group.check("stallTimeout", Value(0.5), "Time without samples after which a stream is stalled.").asDouble();
+    rateRatio = i_group.check("rateRatio", Value(0.5), "Fraction of the nominal rate below which a stream is degraded.").asDouble();
+    maxDropRate = i_group.check("maxDropRate", Value(0.1), "Fraction of lost samples above which a stream is degraded.").asDouble();
+    maxLatency = i_group.check("maxLatency", Value(0.05), "Latency above which a stream is degraded.").asDouble();
+    maxJitter = i_group.check("maxJitter", Value(0.0), "Jitter above which a stream is degraded, 0 to disable.").asDouble();
+    filter = i_group.check("filter", Value(0.05), "Jitter and latency filter coefficient.").asDouble();
+
+    if (!eventPort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+
+    return true;
+}
+
+void StreamWatchdog::interrupt() {
+    eventPort.interrupt();
+}
+
+void StreamWatchdog::close() {
+    eventPort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Per-sample statistics                                            ********************************************** */
+void StreamWatchdog::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    StreamState &state = states[i_stream];
+
+    state.mutex.lock();
+    if (state.samples > 0) {
+        // Inter-arrival period and jitter
+        double dt = i_sample.rxTime - state.lastRx;
+        if (state.samples == 1) {
+            state.period = dt;
+        }
+        state.jitter += filter * (fabs(dt - state.period) - state.jitter);
+        state.period += filter * (dt - state.period);
+
+        // Sequence gaps
+        if ((i_sample.seq >= 0) && (state.lastSeq >= 0) && (i_sample.seq > state.lastSeq + 1)) {
+            state.drops += i_sample.seq - state.lastSeq - 1;
+        }
+    }
+    if (i_sample.envTime > 0.0) {
+        state.latency += filter * ((i_sample.rxTime - i_sample.envTime) - state.latency);
+    }
+    state.lastSeq = i_sample.seq;
+    state.lastRx = i_sample.rxTime;
+    state.samples++;
+    state.mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Periodic health check                                            ********************************************** */
+bool StreamWatchdog::threadInit() {
+    lastCheck = getClock()->now();
+
+    return true;
+}
+
+void StreamWatchdog::run() {
+    double now = getClock()->now();
+    double dt = now - lastCheck;
+    lastCheck = now;
+    if (dt <= 0.0) {
+        return;
+    }
+
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        StreamState &state = states[i];
+
+        state.mutex.lock();
+        unsigned int samples = state.samples;
+        unsigned int drops = state.drops;
+        double lastRx = state.lastRx;
+        double jitter = state.jitter;
+        double latency = state.latency;
+        state.mutex.unlock();
+
+        StreamHealth h = getHealth((SensorStream) i);
+        unsigned int newSamples = samples - state.checkSamples;
+        unsigned int newDrops = drops - state.checkDrops;
+        state.checkSamples = samples;
+        state.checkDrops = drops;
+
+        h.samples = samples;
+        h.drops = drops;
+        h.jitter = jitter;
+        h.latency = latency;
+        h.rate = newSamples / dt;
+        h.dropRate = (newSamples + newDrops > 0) ? (double) newDrops / (newSamples + newDrops) : 0.0;
+        h.age = (samples > 0) ? now - lastRx : 0.0;
+
+        StreamStatus status;
+        if (samples == 0) {
+            status = STATUS_IDLE;
+        } else if (h.age > stallTimeout) {
+            status = STATUS_STALLED;
+        } else if ((h.nominalRate > 0.0) && (h.rate < rateRatio * h.nominalRate)) {
+            status = STATUS_DEGRADED;
+        } else if ((h.dropRate > maxDropRate) || (h.latency > maxLatency) || ((maxJitter > 0.0) && (h.jitter > maxJitter))) {
+            status = STATUS_DEGRADED;
+        } else {
+            status = STATUS_OK;
+            // Learn the nominal rate on the healthy windows
+            h.nominalRate = (h.nominalRate > 0.0) ? h.nominalRate + filter * (h.rate - h.nominalRate) : h.rate;
+        }
+
+        if (status != h.status) {
+            cout << dbgTag << SensorHub::getStreamName((SensorStream) i) << " is " << getStatusName(status) << ". \n";
+
+            Bottle &event = eventPort.prepare();
+            event.clear();
+            event.addString("health");
+            event.addString(SensorHub::getStreamName((SensorStream) i));
+            event.addString(getStatusName(status));
+            event.addDouble(h.rate);
+            event.addDouble(h.jitter);
+            event.addDouble(h.latency);
+            event.addDouble(h.dropRate);
+            event.addDouble(now);
+            eventPort.write();
+        }
+        h.status = status;
+
+        healthMutex.lock();
+        health[i] = h;
+        healthMutex.unlock();
+    }
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Queries                                                          ********************************************** */
+bool StreamWatchdog::isHealthy() {
+    bool healthy = true;
+
+    healthMutex.lock();
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        healthy = healthy && ((health[i].status == STATUS_IDLE) || (health[i].status == STATUS_OK));
+    }
+    healthMutex.unlock();
+
+    return healthy;
+}
+
+StreamHealth StreamWatchdog::getHealth(const SensorStream i_stream) {
+    healthMutex.lock();
+    StreamHealth h = health[i_stream];
+    healthMutex.unlock();
+
+    return h;
+}
+
+string StreamWatchdog::getReport() {
+    stringstream ss;
+    ss << std::setprecision(4);
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        StreamHealth h = getHealth((SensorStream) i);
+        ss << SensorHub::getStreamName((SensorStream) i) << " " << getStatusName(h.status)
+            << " rate " << h.rate << " nominal " << h.nominalRate
+            << " jitter " << h.jitter << " latency " << h.latency
+            << " dropRate " << h.dropRate << " drops " << h.drops << " samples " << h.samples
+            << " age " << h.age << "\n";
+    }
+
+    return ss.str();
+}
+
+const char* StreamWatchdog::getStatusName(const StreamStatus i_status) {
+    switch (i_status) {
+        case STATUS_IDLE:
+            return "idle";
+        case STATUS_OK:
+            return "ok";
+        case STATUS_DEGRADED:
+            return "degraded";
+        case STATUS_STALLED:
+            return "stalled";
+        default:
+            return "unknown";
+    }
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "Transport.h"
+
+#include <iostream>
+
+#include <yarp/os/Network.h>
+
+using std::cout;
+using std::string;
+
+using iCub::interactionForces::Transport;
+
+using yarp::os::Network;
+using yarp::os::Contact;
+
+
+/** The shared memory carrier. */
+static const char *SHMEM_CARRIER = "shmem";
+
+
+string Transport::connect(const string &i_remote, const string &i_local, const string &i_carrier, const bool i_shmem) {
+    if (i_shmem && isColocated(i_remote, i_local)) {
+        if (Network::connect(i_remote.c_str(), i_local.c_str(), SHMEM_CARRIER, true)) {
+            return SHMEM_CARRIER;
+        }
+        cout << "Transport: " << "Could not connect " << i_remote << " over shared memory, falling back to " << i_carrier << ". \n";
+    }
+
+    if (Network::connect(i_remote.c_str(), i_local.c_str(), i_carrier.c_str(), true)) {
+        return i_carrier;
+    }
+
+    return "";
+}
+
+bool Transport::isColocated(const string &i_remote, const string &i_local) {
+    Contact remote = Network::queryName(i_remote.c_str());
+    Contact local = Network::queryName(i_local.c_str());
+    if (!remote.isValid() || !local.isValid()) {
+        return false;
+    }
+
+    return remote.getHost() == local.getHost();
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "VisualFeed.h"
+#include "SensorHub.h"
+
+#include <iostream>
+#include <sstream>
+
+#include <yarp/os/Stamp.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::VisualFeed;
+using iCub::interactionForces::SensorHub;
+using iCub::interactionForces::Clock;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::sig::Vector;
+
+
+/** The number of taxels of a fingertip. */
+static const int FINGERTIP_TAXELS = 12;
+
+/** The size of each stream vector. */
+static const int STREAM_SIZES[iCub::interactionForces::N_SENSOR_STREAMS] = {192, 192, 6, 16};
+
+
+/**
+ * Read a list of stream indices.
+ * @return false if an index is out of range
+ */
+static bool readIndices(const Bottle &i_group, const string &i_key, const int &i_size, vector<int> &io_indices) {
+    Bottle *list = i_group.find(i_key.c_str()).asList();
+    if (list != NULL) {
+        io_indices.clear();
+        for (int i = 0; i < list->size(); ++i) {
+            io_indices.push_back(list->get(i).asInt());
+        }
+    }
+    for (size_t i = 0; i < io_indices.size(); ++i) {
+        if ((io_indices[i] < 0) || (io_indices[i] >= i_size)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+VisualFeed::VisualFeed(const int aPeriod, Clock *aClock) 
+    : ClockedRateThread(aPeriod, aClock) {
+        for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+            channels[i].offset = 0;
+            channels[i].filled = false;
+        }
+        nChannels = 0;
+        count = 0;
+
+        dbgTag = "VisualFeed: ";
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Configure the feed                                               ********************************************** */
+bool VisualFeed::configure(const Bottle &i_group, const string &i_portName) {
+    // Taxels of the selected fingertips, on both the raw and the compensated skin
+    vector<int> tips;
+    for (int i = 0; i < 5; ++i) {
+        tips.push_back(i);
+    }
+    if (!readIndices(i_group, "fingertips", 5, tips)) {
+        cerr << dbgTag << "Invalid fingertip index. \n";
+        return false;
+    }
+    vector<int> taxels;
+    for (size_t i = 0; i < tips.size(); ++i) {
+        for (int j = 0; j < FINGERTIP_TAXELS; ++j) {
+            taxels.push_back(tips[i] * FINGERTIP_TAXELS + j);
+        }
+    }
+    // Explicit taxel lists override the fingertips
+    if (!readIndices(i_group, "taxels", STREAM_SIZES[STREAM_SKIN_RAW], taxels)) {
+        cerr << dbgTag << "Invalid taxel index. \n";
+        return false;
+    }
+    channels[STREAM_SKIN_RAW].indices = taxels;
+    channels[STREAM_SKIN_COMP].indices = taxels;
+
+    // Force and torque axes
+    vector<int> axes;
+    for (int i = 0; i < STREAM_SIZES[STREAM_WRENCH]; ++i) {
+        axes.push_back(i);
+    }
+    if (!readIndices(i_group, "axes", STREAM_SIZES[STREAM_WRENCH], axes)) {
+        cerr << dbgTag << "Invalid wrench axis. \n";
+        return false;
+    }
+    channels[STREAM_WRENCH].indices = axes;
+
+    // Hand joints
+    vector<int> joints;
+    for (int i = 8; i < STREAM_SIZES[STREAM_JOINTS]; ++i) {
+        joints.push_back(i);
+    }
+    if (!readIndices(i_group, "joints", STREAM_SIZES[STREAM_JOINTS], joints)) {
+        cerr << dbgTag << "Invalid joint index. \n";
+        return false;
+    }
+    channels[STREAM_JOINTS].indices = joints;
+
+    // Preallocate the envelopes
+    nChannels = 0;
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        StreamChannels &stream = channels[i];
+        size_t n = stream.indices.size();
+        stream.offset = nChannels;
+        stream.lo.assign(n, 0.0);
+        stream.hi.assign(n, 0.0);
+        stream.last.assign(n, 0.0);
+        stream.filled = false;
+        nChannels += n;
+    }
+
+    if (!scopePort.open(i_portName.c_str())) {
+        cerr << dbgTag << "Could not open port " << i_portName << ". \n";
+        return false;
+    }
+    cout << dbgTag << "Publishing " << nChannels << " channels on " << i_portName << " every " << getRate() << " ms. \n";
+
+    return true;
+}
+
+void VisualFeed::interrupt() {
+    scopePort.interrupt();
+}
+
+void VisualFeed::close() {
+    scopePort.close();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Per-sample envelopes                                             ********************************************** */
+void VisualFeed::onSample(const SensorStream i_stream, const SensorSample &i_sample) {
+    StreamChannels &stream = channels[i_stream];
+
+    stream.mutex.lock();
+    for (size_t i = 0; i < stream.indices.size(); ++i) {
+        size_t index = (size_t) stream.indices[i];
+        if (index >= i_sample.size) {
+            continue;
+        }
+        double value = i_sample.data[index];
+        if (!stream.filled) {
+            stream.lo[i] = value;
+            stream.hi[i] = value;
+        } else if (value < stream.lo[i]) {
+            stream.lo[i] = value;
+        } else if (value > stream.hi[i]) {
+            stream.hi[i] = value;
+        }
+        stream.last[i] = value;
+    }
+    stream.filled = true;
+    stream.mutex.unlock();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Periodic publication                                             ********************************************** */
+void VisualFeed::run() {
+    Vector &out = scopePort.prepare();
+    out.resize(2 * nChannels);
+
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        StreamChannels &stream = channels[i];
+        size_t k = 2 * stream.offset;
+
+        stream.mutex.lock();
+        for (size_t j = 0; j < stream.indices.size(); ++j) {
+            out[k++] = stream.filled ? stream.lo[j] : stream.last[j];
+            out[k++] = stream.filled ? stream.hi[j] : stream.last[j];
+        }
+        stream.filled = false;
+        stream.mutex.unlock();
+    }
+
+    yarp::os::Stamp stamp(count++, getClock()->now());
+    scopePort.setEnvelope(stamp);
+    scopePort.write();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Queries                                                          ********************************************** */
+string VisualFeed::getLayout(void) {
+    stringstream ss;
+    for (int i = 0; i < N_SENSOR_STREAMS; ++i) {
+        const StreamChannels &stream = channels[i];
+        for (size_t j = 0; j < stream.indices.size(); ++j) {
+            size_t k = 2 * (stream.offset + j);
+            ss << k << " " << k + 1 << " " << SensorHub::getStreamName((SensorStream) i) << " " << stream.indices[j] << "\n";
+        }
+    }
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
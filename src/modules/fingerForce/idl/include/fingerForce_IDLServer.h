@@ -33,6 +33,118 @@ public:
  * @return true/false on success/failure
  */
   virtual bool pinchseq();
+/**
+ * Select the continuous depth profile.
+ * @param type the profile type (none, staircase, sine, chirp, prbs, table)
+ * @return true/false on success/failure
+ */
+  virtual bool setProfile(const std::string& type);
+/**
+ * Get the selected continuous depth profile.
+ * @return the profile type
+ */
+  virtual std::string getProfile();
+/**
+ * Run the selected depth profile as a single continuous pinch.
+ * The depth is sampled at the control rate set in the [profile] group.
+ * @return true/false on success/failure
+ */
+  virtual bool runProfile();
+/**
+ * Enable or disable compliant pinching.
+ * When enabled, the pinching joints press and hold in impedance position mode
+ * and switch back to position mode on raise.
+ * @param enable true to enable compliant pinching
+ * @return true/false on success/failure
+ */
+  virtual bool setCompliant(const bool enable);
+/**
+ * Get the health of the sensor streams.
+ * @return one line per stream with its status, rate, jitter, latency and drops
+ */
+  virtual std::string getStreamHealth();
+/**
+ * Check that no sensor stream is degraded or stalled.
+ * @return true if all the active streams are healthy
+ */
+  virtual bool isStreamHealthy();
+/**
+ * Get the transport of each input stream.
+ * @return one line per stream with its carrier: shmem for co-located producers, the network carrier otherwise,
+ * external when waiting for a connection made outside the module
+ */
+  virtual std::string getTransports();
+/**
+ * Get the layout of the port scope feed.
+ * @return one line per channel with the indices of its min and max in the scope port vector, its stream and
+ * its index in the stream
+ */
+  virtual std::string getScope();
+/**
+ * Get the statistics of the per-pinch bookkeeping pipeline.
+ * @return the completed and pending jobs, the stalls of the pinching thread and the job times
+ */
+  virtual std::string getPipelineStats();
+/**
+ * Get the latency of the control loop ticks.
+ * @return one line per loop (profile, hold, poll) with the number of ticks and the mean and worst-case latency,
+ * and the state of the control path log
+ */
+  virtual std::string getLatency();
+/**
+ * Get the contact onsets of the last pinch.
+ * @return one line per fingertip and for the nano17 with the onset time and the lag of the skin to the nano17
+ */
+  virtual std::string getContactOnsets();
+/**
+ * Get the skin to nano17 lag of the last analysed pinch.
+ * @return one line per fingertip with the cross-correlation lag and its confidence
+ */
+  virtual std::string getSkinLag();
+/**
+ * Get an experiment parameter.
+ * @param name the parameter name (nPinches, pinchIncrement, pinchDuration, pinchDelay, progressiveDepth,
+ * useThumb, finger.joint, finger.startPos, finger.pinchPos, finger.fingertips)
+ * @return the parameter value, empty if unknown
+ */
+  virtual std::string getParam(const std::string& name);
+/**
+ * Set an experiment parameter.
+ * The change is applied as a whole with the other pending changes before the next pinch.
+ * @param name the parameter name
+ * @param value the parameter value, e.g. "12", "true" or "(1 4)"
+ * @return true/false on success/failure
+ */
+  virtual bool setParam(const std::string& name, const std::string& value);
+/**
+ * Get all experiment parameters.
+ * @return one line per parameter with its name and value
+ */
+  virtual std::string getParams();
+/**
+ * Reload the [experiment] and [finger] parameters from the configuration file.
+ * The parameters are applied before the next pinch, without reconnecting the devices.
+ * @return true/false on success/failure
+ */
+  virtual bool reloadParams();
+/**
+ * Queue the runs of a campaign file, executed back to back after the runs already queued.
+ * Each run is a pinch sequence with its own parameters, segment index and results session.
+ * Manual pinching and parameter changes are refused until the campaign is complete or stopped.
+ * @param file the campaign file
+ * @return true if at least one run was queued
+ */
+  virtual bool runCampaign(const std::string& file);
+/**
+ * Get the campaign progress.
+ * @return the current run, the completed runs and pinches, the elapsed time and the estimated time left
+ */
+  virtual std::string getCampaign();
+/**
+ * Stop the campaign after the current pinch and drop the queued runs.
+ * @return false if no campaign is running
+ */
+  virtual bool stopCampaign();
 /**
  * Reset the pinch counter.
  * @return true/false on success/failure
@@ -66,6 +66,398 @@ public:
   }
 };
 
+class fingerForce_IDLServer_setProfile : public yarp::os::Portable {
+public:
+  std::string type;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("setProfile",1,1)) return false;
+    if (!writer.writeString(type)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getProfile : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getProfile",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_runProfile : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("runProfile",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_setCompliant : public yarp::os::Portable {
+public:
+  bool enable;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("setCompliant",1,1)) return false;
+    if (!writer.writeBool(enable)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getStreamHealth : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getStreamHealth",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_isStreamHealthy : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("isStreamHealthy",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getTransports : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getTransports",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getScope : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getScope",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getPipelineStats : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getPipelineStats",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getLatency : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getLatency",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getContactOnsets : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getContactOnsets",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getSkinLag : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getSkinLag",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getParam : public yarp::os::Portable {
+public:
+  std::string name;
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("getParam",1,1)) return false;
+    if (!writer.writeString(name)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_setParam : public yarp::os::Portable {
+public:
+  std::string name;
+  std::string value;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(3)) return false;
+    if (!writer.writeTag("setParam",1,1)) return false;
+    if (!writer.writeString(name)) return false;
+    if (!writer.writeString(value)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getParams : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getParams",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_reloadParams : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("reloadParams",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_runCampaign : public yarp::os::Portable {
+public:
+  std::string file;
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(2)) return false;
+    if (!writer.writeTag("runCampaign",1,1)) return false;
+    if (!writer.writeString(file)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_getCampaign : public yarp::os::Portable {
+public:
+  std::string _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("getCampaign",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readString(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_stopCampaign : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("stopCampaign",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
 class fingerForce_IDLServer_resetC : public yarp::os::Portable {
 public:
   bool _return;
@@ -75,60 +467,237 @@ public:
     if (!writer.writeTag("resetC",1,1)) return false;
     return true;
   }
-  virtual bool read(yarp::os::ConnectionReader& connection) {
-    yarp::os::idl::WireReader reader(connection);
-    if (!reader.readListReturn()) return false;
-    if (!reader.readBool(_return)) {
-      reader.fail();
-      return false;
-    }
-    return true;
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+class fingerForce_IDLServer_quit : public yarp::os::Portable {
+public:
+  bool _return;
+  virtual bool write(yarp::os::ConnectionWriter& connection) {
+    yarp::os::idl::WireWriter writer(connection);
+    if (!writer.writeListHeader(1)) return false;
+    if (!writer.writeTag("quit",1,1)) return false;
+    return true;
+  }
+  virtual bool read(yarp::os::ConnectionReader& connection) {
+    yarp::os::idl::WireReader reader(connection);
+    if (!reader.readListReturn()) return false;
+    if (!reader.readBool(_return)) {
+      reader.fail();
+      return false;
+    }
+    return true;
+  }
+};
+
+bool fingerForce_IDLServer::open() {
+  bool _return = false;
+  fingerForce_IDLServer_open helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::open()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::pinch() {
+  bool _return = false;
+  fingerForce_IDLServer_pinch helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::pinch()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::pinchseq() {
+  bool _return = false;
+  fingerForce_IDLServer_pinchseq helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::pinchseq()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::setProfile(const std::string& type) {
+  bool _return = false;
+  fingerForce_IDLServer_setProfile helper;
+  helper.type = type;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::setProfile(const std::string& type)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getProfile() {
+  std::string _return = "";
+  fingerForce_IDLServer_getProfile helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getProfile()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::runProfile() {
+  bool _return = false;
+  fingerForce_IDLServer_runProfile helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::runProfile()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::setCompliant(const bool enable) {
+  bool _return = false;
+  fingerForce_IDLServer_setCompliant helper;
+  helper.enable = enable;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::setCompliant(const bool enable)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getStreamHealth() {
+  std::string _return = "";
+  fingerForce_IDLServer_getStreamHealth helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getStreamHealth()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::isStreamHealthy() {
+  bool _return = false;
+  fingerForce_IDLServer_isStreamHealthy helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::isStreamHealthy()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getTransports() {
+  std::string _return = "";
+  fingerForce_IDLServer_getTransports helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getTransports()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getScope() {
+  std::string _return = "";
+  fingerForce_IDLServer_getScope helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getScope()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getPipelineStats() {
+  std::string _return = "";
+  fingerForce_IDLServer_getPipelineStats helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getPipelineStats()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getLatency() {
+  std::string _return = "";
+  fingerForce_IDLServer_getLatency helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getLatency()");
   }
-};
-
-class fingerForce_IDLServer_quit : public yarp::os::Portable {
-public:
-  bool _return;
-  virtual bool write(yarp::os::ConnectionWriter& connection) {
-    yarp::os::idl::WireWriter writer(connection);
-    if (!writer.writeListHeader(1)) return false;
-    if (!writer.writeTag("quit",1,1)) return false;
-    return true;
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getContactOnsets() {
+  std::string _return = "";
+  fingerForce_IDLServer_getContactOnsets helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getContactOnsets()");
   }
-  virtual bool read(yarp::os::ConnectionReader& connection) {
-    yarp::os::idl::WireReader reader(connection);
-    if (!reader.readListReturn()) return false;
-    if (!reader.readBool(_return)) {
-      reader.fail();
-      return false;
-    }
-    return true;
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getSkinLag() {
+  std::string _return = "";
+  fingerForce_IDLServer_getSkinLag helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getSkinLag()");
   }
-};
-
-bool fingerForce_IDLServer::open() {
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getParam(const std::string& name) {
+  std::string _return = "";
+  fingerForce_IDLServer_getParam helper;
+  helper.name = name;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getParam(const std::string& name)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::setParam(const std::string& name, const std::string& value) {
   bool _return = false;
-  fingerForce_IDLServer_open helper;
+  fingerForce_IDLServer_setParam helper;
+  helper.name = name;
+  helper.value = value;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::open()");
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::setParam(const std::string& name, const std::string& value)");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
 }
-bool fingerForce_IDLServer::pinch() {
+std::string fingerForce_IDLServer::getParams() {
+  std::string _return = "";
+  fingerForce_IDLServer_getParams helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getParams()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::reloadParams() {
   bool _return = false;
-  fingerForce_IDLServer_pinch helper;
+  fingerForce_IDLServer_reloadParams helper;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::pinch()");
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::reloadParams()");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
 }
-bool fingerForce_IDLServer::pinchseq() {
+bool fingerForce_IDLServer::runCampaign(const std::string& file) {
   bool _return = false;
-  fingerForce_IDLServer_pinchseq helper;
+  fingerForce_IDLServer_runCampaign helper;
+  helper.file = file;
   if (!yarp().canWrite()) {
-    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::pinchseq()");
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::runCampaign(const std::string& file)");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+std::string fingerForce_IDLServer::getCampaign() {
+  std::string _return = "";
+  fingerForce_IDLServer_getCampaign helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","std::string fingerForce_IDLServer::getCampaign()");
+  }
+  bool ok = yarp().write(helper,helper);
+  return ok?helper._return:_return;
+}
+bool fingerForce_IDLServer::stopCampaign() {
+  bool _return = false;
+  fingerForce_IDLServer_stopCampaign helper;
+  if (!yarp().canWrite()) {
+    fprintf(stderr,"Missing server method '%s'?\n","bool fingerForce_IDLServer::stopCampaign()");
   }
   bool ok = yarp().write(helper,helper);
   return ok?helper._return:_return;
@@ -192,6 +761,245 @@ bool fingerForce_IDLServer::read(yarp::os::ConnectionReader& connection) {
       reader.accept();
       return true;
     }
+    if (tag == "setProfile") {
+      std::string type;
+      if (!reader.readString(type)) {
+        reader.fail();
+        return false;
+      }
+      bool _return;
+      _return = setProfile(type);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getProfile") {
+      std::string _return;
+      _return = getProfile();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "runProfile") {
+      bool _return;
+      _return = runProfile();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "setCompliant") {
+      bool enable;
+      if (!reader.readBool(enable)) {
+        reader.fail();
+        return false;
+      }
+      bool _return;
+      _return = setCompliant(enable);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getStreamHealth") {
+      std::string _return;
+      _return = getStreamHealth();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "isStreamHealthy") {
+      bool _return;
+      _return = isStreamHealthy();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getTransports") {
+      std::string _return;
+      _return = getTransports();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getScope") {
+      std::string _return;
+      _return = getScope();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getPipelineStats") {
+      std::string _return;
+      _return = getPipelineStats();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getLatency") {
+      std::string _return;
+      _return = getLatency();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getContactOnsets") {
+      std::string _return;
+      _return = getContactOnsets();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getSkinLag") {
+      std::string _return;
+      _return = getSkinLag();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getParam") {
+      std::string name;
+      if (!reader.readString(name)) {
+        reader.fail();
+        return false;
+      }
+      std::string _return;
+      _return = getParam(name);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "setParam") {
+      std::string name;
+      std::string value;
+      if (!reader.readString(name)) {
+        reader.fail();
+        return false;
+      }
+      if (!reader.readString(value)) {
+        reader.fail();
+        return false;
+      }
+      bool _return;
+      _return = setParam(name,value);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getParams") {
+      std::string _return;
+      _return = getParams();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "reloadParams") {
+      bool _return;
+      _return = reloadParams();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "runCampaign") {
+      std::string file;
+      if (!reader.readString(file)) {
+        reader.fail();
+        return false;
+      }
+      bool _return;
+      _return = runCampaign(file);
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "getCampaign") {
+      std::string _return;
+      _return = getCampaign();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeString(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
+    if (tag == "stopCampaign") {
+      bool _return;
+      _return = stopCampaign();
+      yarp::os::idl::WireWriter writer(reader);
+      if (!writer.isNull()) {
+        if (!writer.writeListHeader(1)) return false;
+        if (!writer.writeBool(_return)) return false;
+      }
+      reader.accept();
+      return true;
+    }
     if (tag == "resetC") {
       bool _return;
       _return = resetC();
@@ -251,6 +1059,25 @@ std::vector<std::string> fingerForce_IDLServer::help(const std::string& function
     helpString.push_back("open");
     helpString.push_back("pinch");
     helpString.push_back("pinchseq");
+    helpString.push_back("setProfile");
+    helpString.push_back("getProfile");
+    helpString.push_back("runProfile");
+    helpString.push_back("setCompliant");
+    helpString.push_back("getStreamHealth");
+    helpString.push_back("isStreamHealthy");
+    helpString.push_back("getTransports");
+    helpString.push_back("getScope");
+    helpString.push_back("getPipelineStats");
+    helpString.push_back("getLatency");
+    helpString.push_back("getContactOnsets");
+    helpString.push_back("getSkinLag");
+    helpString.push_back("getParam");
+    helpString.push_back("setParam");
+    helpString.push_back("getParams");
+    helpString.push_back("reloadParams");
+    helpString.push_back("runCampaign");
+    helpString.push_back("getCampaign");
+    helpString.push_back("stopCampaign");
     helpString.push_back("resetC");
     helpString.push_back("quit");
     helpString.push_back("help");
@@ -272,6 +1099,118 @@ std::vector<std::string> fingerForce_IDLServer::help(const std::string& function
       helpString.push_back("Perform a sequence of pinch grasps. ");
       helpString.push_back("@return true/false on success/failure ");
     }
+    if (functionName=="setProfile") {
+      helpString.push_back("bool setProfile(const std::string& type) ");
+      helpString.push_back("Select the continuous depth profile. ");
+      helpString.push_back("@param type the profile type (none, staircase, sine, chirp, prbs, table) ");
+      helpString.push_back("@return true/false on success/failure ");
+    }
+    if (functionName=="getProfile") {
+      helpString.push_back("std::string getProfile() ");
+      helpString.push_back("Get the selected continuous depth profile. ");
+      helpString.push_back("@return the profile type ");
+    }
+    if (functionName=="runProfile") {
+      helpString.push_back("bool runProfile() ");
+      helpString.push_back("Run the selected depth profile as a single continuous pinch. ");
+      helpString.push_back("The depth is sampled at the control rate set in the [profile] group. ");
+      helpString.push_back("@return true/false on success/failure ");
+    }
+    if (functionName=="setCompliant") {
+      helpString.push_back("bool setCompliant(const bool enable) ");
+      helpString.push_back("Enable or disable compliant pinching. ");
+      helpString.push_back("When enabled, the pinching joints press and hold in impedance position mode ");
+      helpString.push_back("and switch back to position mode on raise. ");
+      helpString.push_back("@param enable true to enable compliant pinching ");
+      helpString.push_back("@return true/false on success/failure ");
+    }
+    if (functionName=="getStreamHealth") {
+      helpString.push_back("std::string getStreamHealth() ");
+      helpString.push_back("Get the health of the sensor streams. ");
+      helpString.push_back("@return one line per stream with its status, rate, jitter, latency and drops ");
+    }
+    if (functionName=="isStreamHealthy") {
+      helpString.push_back("bool isStreamHealthy() ");
+      helpString.push_back("Check that no sensor stream is degraded or stalled. ");
+      helpString.push_back("@return true if all the active streams are healthy ");
+    }
+    if (functionName=="getTransports") {
+      helpString.push_back("std::string getTransports() ");
+      helpString.push_back("Get the transport of each input stream. ");
+      helpString.push_back("@return one line per stream with its carrier: shmem for co-located producers, the network carrier otherwise, ");
+      helpString.push_back("external when waiting for a connection made outside the module ");
+    }
+    if (functionName=="getScope") {
+      helpString.push_back("std::string getScope() ");
+      helpString.push_back("Get the layout of the port scope feed. ");
+      helpString.push_back("@return one line per channel with the indices of its min and max in the scope port vector, its stream and ");
+      helpString.push_back("its index in the stream ");
+    }
+    if (functionName=="getPipelineStats") {
+      helpString.push_back("std::string getPipelineStats() ");
+      helpString.push_back("Get the statistics of the per-pinch bookkeeping pipeline. ");
+      helpString.push_back("@return the completed and pending jobs, the stalls of the pinching thread and the job times ");
+    }
+    if (functionName=="getLatency") {
+      helpString.push_back("std::string getLatency() ");
+      helpString.push_back("Get the latency of the control loop ticks. ");
+      helpString.push_back("@return one line per loop (profile, hold, poll) with the number of ticks and the mean and worst-case latency, ");
+      helpString.push_back("and the state of the control path log ");
+    }
+    if (functionName=="getContactOnsets") {
+      helpString.push_back("std::string getContactOnsets() ");
+      helpString.push_back("Get the contact onsets of the last pinch. ");
+      helpString.push_back("@return one line per fingertip and for the nano17 with the onset time and the lag of the skin to the nano17 ");
+    }
+    if (functionName=="getSkinLag") {
+      helpString.push_back("std::string getSkinLag() ");
+      helpString.push_back("Get the skin to nano17 lag of the last analysed pinch. ");
+      helpString.push_back("@return one line per fingertip with the cross-correlation lag and its confidence ");
+    }
+    if (functionName=="getParam") {
+      helpString.push_back("std::string getParam(const std::string& name) ");
+      helpString.push_back("Get an experiment parameter. ");
+      helpString.push_back("@param name the parameter name (nPinches, pinchIncrement, pinchDuration, pinchDelay, progressiveDepth, ");
+      helpString.push_back("useThumb, finger.joint, finger.startPos, finger.pinchPos, finger.fingertips) ");
+      helpString.push_back("@return the parameter value, empty if unknown ");
+    }
+    if (functionName=="setParam") {
+      helpString.push_back("bool setParam(const std::string& name, const std::string& value) ");
+      helpString.push_back("Set an experiment parameter. ");
+      helpString.push_back("The change is applied as a whole with the other pending changes before the next pinch. ");
+      helpString.push_back("@param name the parameter name ");
+      helpString.push_back("@param value the parameter value, e.g. \"12\", \"true\" or \"(1 4)\" ");
+      helpString.push_back("@return true/false on success/failure ");
+    }
+    if (functionName=="getParams") {
+      helpString.push_back("std::string getParams() ");
+      helpString.push_back("Get all experiment parameters. ");
+      helpString.push_back("@return one line per parameter with its name and value ");
+    }
+    if (functionName=="reloadParams") {
+      helpString.push_back("bool reloadParams() ");
+      helpString.push_back("Reload the [experiment] and [finger] parameters from the configuration file. ");
+      helpString.push_back("The parameters are applied before the next pinch, without reconnecting the devices. ");
+      helpString.push_back("@return true/false on success/failure ");
+    }
+    if (functionName=="runCampaign") {
+      helpString.push_back("bool runCampaign(const std::string& file) ");
+      helpString.push_back("Queue the runs of a campaign file, executed back to back after the runs already queued. ");
+      helpString.push_back("Each run is a pinch sequence with its own parameters, segment index and results session. ");
+      helpString.push_back("Manual pinching and parameter changes are refused until the campaign is complete or stopped. ");
+      helpString.push_back("@param file the campaign file ");
+      helpString.push_back("@return true if at least one run was queued ");
+    }
+    if (functionName=="getCampaign") {
+      helpString.push_back("std::string getCampaign() ");
+      helpString.push_back("Get the campaign progress. ");
+      helpString.push_back("@return the current run, the completed runs and pinches, the elapsed time and the estimated time left ");
+    }
+    if (functionName=="stopCampaign") {
+      helpString.push_back("bool stopCampaign() ");
+      helpString.push_back("Stop the campaign after the current pinch and drop the queued runs. ");
+      helpString.push_back("@return false if no campaign is running ");
+    }
     if (functionName=="resetC") {
       helpString.push_back("bool resetC() ");
       helpString.push_back("Reset the pinch counter. ");
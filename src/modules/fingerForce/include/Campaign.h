@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CAMPAIGN_H__
+#define __ICUB_INTERACTIONFORCES_CAMPAIGN_H__
+
+#include "ExperimentConfig.h"
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * A run of a campaign: one pinch sequence with its own parameters and home pose.
+         */
+        struct CampaignRun {
+            /** The campaign and run names, used to label the segment index and the stored results. */
+            std::string campaign;
+            std::string name;
+
+            /** The experiment parameters of the run. */
+            ExperimentParameters params;
+
+            /** The home position of the arm (7 joints) and hand (9 joints). */
+            std::vector<double> home;
+        };
+
+
+        /**
+         * Queue of campaign runs executed back to back by the module.
+         * A campaign file lists one run per line as "run <name> (parameter value) ...", where the parameters are
+         * those of setParam plus:
+         *  - (repeat N) to queue the run N times;
+         *  - (hand left|right) to restrict the run to one hand;
+         *  - (home.arm (7 values)) and (home.hand (9 values)) to change the home pose.
+         * A "defaults (parameter value) ..." line sets the parameters of the following runs and a "name <name>" line
+         * names the campaign. Lines starting with # are comments.
+         *
+         * The RPC thread loads the campaigns and reads the progress; the module thread takes the runs.
+         * Campaigns loaded while another one is running are queued after it.
+         */
+        class Campaign {
+            private:
+                yarp::os::Mutex mutex;
+                std::deque<CampaignRun> queue;
+
+                /** The parameters and home pose in use before the first campaign, restored when the queue is empty. */
+                CampaignRun base;
+
+                /** Set while runs are queued or running. */
+                bool busy;
+                bool stopping;
+
+                /** The current run. */
+                CampaignRun current;
+                bool running;
+
+                /** Progress counters since the queue was last empty. */
+                int runsTotal;
+                int runsDone;
+                int pinchesTotal;
+                int pinchesDone;
+                double started;
+
+                /** Nominal duration of the queued pinches, and nominal and measured duration of the completed ones. */
+                double nominalLeft;
+                double nominalDone;
+                double measuredDone;
+
+                std::string dbgTag;
+
+            public:
+                Campaign();
+
+                /**
+                 * Parse a campaign file and queue its runs.
+                 * @param i_file the campaign file
+                 * @param i_params the current experiment parameters, which the runs override
+                 * @param i_home the current home position
+                 * @param i_hand the hand of the module; runs for the other hand are skipped
+                 * @param i_now the current time
+                 * @return the number of queued runs, -1 on error
+                 */
+                int load(const std::string &i_file, const ExperimentParameters &i_params, const std::vector<double> &i_home,
+                        const std::string &i_hand, const double &i_now);
+
+                /**
+                 * Take the next run.
+                 * @return false if no run is queued or the campaign is stopping
+                 */
+                bool next(CampaignRun &o_run);
+
+                /**
+                 * Account for a completed pinch of the current run.
+                 * @param i_duration the measured duration of the pinch and the following rest
+                 */
+                void pinchDone(const double &i_duration);
+
+                /**
+                 * Close the current run.
+                 */
+                void runDone(void);
+
+                /**
+                 * Clear the queue once it is empty or stopped.
+                 * @param o_base the parameters and home pose to restore, and the name of the last campaign
+                 * @return true once, when the last run of the queue is done
+                 */
+                bool finish(CampaignRun &o_base);
+
+                /**
+                 * Drop the queued runs and stop the current one after its current pinch.
+                 */
+                void stop(void);
+
+                bool isStopping(void);
+                bool isBusy(void);
+
+                /**
+                 * Get the progress of the queue.
+                 * @return the current run, the run and pinch counts, the elapsed time and the estimated time left
+                 */
+                std::string getReport(const double &i_now);
+
+                /**
+                 * Get the nominal duration of a pinch and of the following rest, in seconds.
+                 */
+                static double getNominal(const ExperimentParameters &i_params);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
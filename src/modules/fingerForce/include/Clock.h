@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CLOCK_H__
+#define __ICUB_INTERACTIONFORCES_CLOCK_H__
+
+#include <string>
+#include <map>
+#include <vector>
+
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Semaphore.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The time source used by the module and its threads.
+         * All delays and timestamps go through a Clock so that the experiment can be run either in
+         * wall time or in simulated time.
+         */
+        class Clock {
+            public:
+                virtual ~Clock() {}
+
+                /**
+                 * Get the current time in seconds.
+                 */
+                virtual double now() = 0;
+
+                /**
+                 * Block the calling thread for the given amount of seconds.
+                 */
+                virtual void delay(const double &i_seconds) = 0;
+
+                /**
+                 * Register the calling thread as a participant of the clock.
+                 * Calls are reference counted, hence nested registrations are allowed.
+                 */
+                virtual void registerThread() {}
+
+                /**
+                 * Unregister the calling thread.
+                 */
+                virtual void unregisterThread() {}
+
+                /**
+                 * Create the clock matching the given type ("real" or "sim").
+                 * @return the new clock or NULL if the type is unknown
+                 */
+                static Clock* create(const std::string &i_type);
+        };
+
+
+        /**
+         * Wall time clock. This is a thin wrapper around yarp::os::Time.
+         */
+        class RealClock : public Clock {
+            public:
+                virtual double now();
+                virtual void delay(const double &i_seconds);
+        };
+
+
+        /**
+         * Simulated time clock.
+         * Time only advances when every registered thread is blocked in delay(), at which point it jumps
+         * straight to the earliest pending wake up time. Unregistered threads calling delay() are counted
+         * as participants for the duration of the call.
+         * A registered thread blocking on anything other than the clock stalls the simulation.
+         */
+        class SimulatedClock : public Clock {
+            private:
+                /**
+                 * A thread waiting on the clock.
+                 */
+                struct Sleeper {
+                    double wakeTime;
+                    yarp::os::Semaphore *sem;
+                };
+
+                /** The current simulated time. */
+                double simTime;
+
+                /** Registered threads and their registration count. */
+                std::map<long int, int> participants;
+
+                /** Unregistered threads currently blocked in delay(). */
+                int transients;
+
+                /** Threads currently blocked in delay(). */
+                std::vector<Sleeper> sleepers;
+
+                yarp::os::Mutex mutex;
+
+            public:
+                SimulatedClock(const double &i_startTime = 0.0);
+
+                virtual double now();
+                virtual void delay(const double &i_seconds);
+                virtual void registerThread();
+                virtual void unregisterThread();
+
+            private:
+                /**
+                 * Advance time if all participants are waiting. Must be called with the mutex held.
+                 */
+                void advance();
+        };
+
+
+        /**
+         * Scoped registration of the calling thread with a clock.
+         */
+        class ClockParticipant {
+            private:
+                Clock *clock;
+
+            public:
+                ClockParticipant(Clock *aClock) : clock(aClock) { if (clock) clock->registerThread(); }
+                ~ClockParticipant() { if (clock) clock->unregisterThread(); }
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
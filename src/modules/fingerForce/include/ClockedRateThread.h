@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CLOCKEDRATETHREAD_H__
+#define __ICUB_INTERACTIONFORCES_CLOCKEDRATETHREAD_H__
+
+#include "Clock.h"
+
+#include <yarp/os/Thread.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * A periodic thread whose period is measured on a Clock instead of wall time.
+         * The interface mirrors yarp::os::RateThread: subclasses implement threadInit(), run() and threadRelease().
+         */
+        class ClockedRateThread {
+            private:
+                /**
+                 * The underlying yarp thread running the periodic loop.
+                 */
+                class Runner : public yarp::os::Thread {
+                    private:
+                        ClockedRateThread &owner;
+
+                    public:
+                        Runner(ClockedRateThread &aOwner) : owner(aOwner) {}
+
+                        bool threadInit() { return owner.threadInit(); }
+                        void threadRelease() { owner.threadRelease(); }
+                        void run() { owner.loop(); }
+                };
+
+                Runner runner;
+
+                /** The thread period in milliseconds. */
+                double periodMs;
+
+                /** The clock measuring the period. */
+                Clock *clock;
+
+                /* ******* Statistics.                       ******* */
+                unsigned int iterations;
+                double estPeriod;
+                double estUsed;
+                double lastStart;
+                yarp::os::Mutex statMutex;
+
+            public:
+                ClockedRateThread(const int aPeriod, Clock *aClock);
+                virtual ~ClockedRateThread();
+
+                bool start();
+                void stop();
+                bool isRunning();
+
+                bool setRate(const int aPeriod);
+                double getRate();
+
+                /**
+                 * Get the estimated period and used time of the last cycle, in milliseconds of clock time.
+                 */
+                double getEstPeriod();
+                double getEstUsed();
+                unsigned int getIterations();
+
+            protected:
+                Clock* getClock() { return clock; }
+
+                virtual bool threadInit() { return true; }
+                virtual void threadRelease() {}
+                virtual void run() = 0;
+
+            private:
+                void loop();
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
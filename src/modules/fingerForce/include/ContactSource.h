@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CONTACTSOURCE_H__
+#define __ICUB_INTERACTIONFORCES_CONTACTSOURCE_H__
+
+#include <vector>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /** Maximum number of onsets of a pinch, over all the contact detectors. */
+        const int MAX_CONTACT_ONSETS = 16;
+
+
+        /**
+         * A contact onset.
+         */
+        struct ContactOnset {
+            /**
+             * The source of the onset: the fingertip index (0-4), OnsetDetector::SOURCE_FT or
+             * StallDetector::SOURCE_FINGER_JOINT and SOURCE_THUMB_JOINT.
+             */
+            int source;
+
+            /** The pinch the detector was armed for. */
+            int pinch;
+
+            /** The estimated onset time. */
+            double time;
+
+            /** The timestamp of the sample that triggered the detection. */
+            double detected;
+
+            /** The deviation from the baseline at detection. */
+            double amplitude;
+
+            /** True if the times are source envelope timestamps, false if receive times. */
+            bool envelope;
+
+            /**
+             * The receive time of the sample that triggered the detection, on the module clock.
+             * The onset on the module clock is received - (detected - time), whatever the time base of the source.
+             */
+            double received;
+        };
+
+
+        /**
+         * Interface of the contact detectors.
+         * A detector is armed at the start of each pinch and reports at most one onset per source until disarmed,
+         * whatever the sensor it relies on, so that the experiment runs the same with any set of detectors.
+         */
+        class ContactSource {
+            public:
+                virtual ~ContactSource() {}
+
+                /**
+                 * Look for the onsets of a new pinch.
+                 */
+                virtual void arm(const int &i_pinch) = 0;
+
+                /**
+                 * Stop looking for onsets.
+                 */
+                virtual void disarm() = 0;
+
+                /**
+                 * Get the onsets found since the last arming, without allocating.
+                 * @param o_onsets the caller-owned array to fill
+                 * @param i_size the number of entries available in the array
+                 * @return the number of onsets copied
+                 */
+                virtual int getOnsets(ContactOnset *o_onsets, const int &i_size) = 0;
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
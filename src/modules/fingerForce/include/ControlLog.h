@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CONTROLLOG_H__
+#define __ICUB_INTERACTIONFORCES_CONTROLLOG_H__
+
+#include <string>
+
+#include <yarp/os/Thread.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Console log of the control path.
+         * By default the lines are printed by the calling thread. Once started, the lines are formatted into a
+         * preallocated lock-free ring and printed by a background thread, so that logging neither allocates nor
+         * blocks the control threads on the console. Lines that do not fit in the ring are dropped and counted.
+         */
+        class ControlLog {
+            private:
+                /**
+                 * Background thread printing the queued lines.
+                 */
+                class Drainer : public yarp::os::Thread {
+                    private:
+                        ControlLog &owner;
+
+                    public:
+                        Drainer(ControlLog &aOwner) : owner(aOwner) {}
+                        void run();
+                };
+
+                /** Maximum length of a line. */
+                static const int LINE_SIZE = 256;
+
+                /**
+                 * A slot of the ring. The sequence number tells whether the slot is free or holds a line.
+                 */
+                struct Line {
+                    volatile unsigned int sequence;
+                    char text[LINE_SIZE];
+                };
+
+                Line *lines;
+                unsigned int capacity;
+
+                /** Next slot to write, shared by the producers, and next slot to print. */
+                volatile unsigned int writePos;
+                unsigned int readPos;
+
+                /** Number of dropped lines. */
+                volatile unsigned int dropped;
+
+                Drainer drainer;
+                bool deferred;
+
+                std::string dbgTag;
+
+            public:
+                ControlLog();
+                ~ControlLog();
+
+                /**
+                 * Defer the printing to the background thread.
+                 * @param i_capacity the number of lines of the ring, rounded up to a power of two
+                 * @return true/false on success/failure
+                 */
+                bool start(const int i_capacity);
+
+                /**
+                 * Print the queued lines and return to printing in the calling thread.
+                 */
+                void stop(void);
+
+                /**
+                 * Print a line, printf style. Long lines are truncated when deferred.
+                 */
+                void print(const char *i_format, ...)
+#ifdef __GNUC__
+                    __attribute__((format(printf, 2, 3)))
+#endif
+                    ;
+
+                /**
+                 * Print a multi-line text, one log line per text line.
+                 */
+                void printLines(const std::string &i_text);
+
+                bool isDeferred(void) const { return deferred; }
+                unsigned int getDropped(void);
+
+            private:
+                /**
+                 * Print the queued lines.
+                 * @return the number of lines printed
+                 */
+                int drain(void);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
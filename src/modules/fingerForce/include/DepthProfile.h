@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_DEPTHPROFILE_H__
+#define __ICUB_INTERACTIONFORCES_DEPTHPROFILE_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * A continuous pinching depth schedule.
+         * A profile maps the time elapsed since its start to a depth offset in degrees, which is added to the
+         * starting position of each pinching joint. All profiles start at zero depth.
+         */
+        class DepthProfile {
+            public:
+                virtual ~DepthProfile() {}
+
+                /**
+                 * Get the depth offset at the given time.
+                 * @param i_t the time in seconds since the start of the profile
+                 */
+                virtual double sample(const double &i_t) const = 0;
+
+                /**
+                 * Get the profile duration in seconds.
+                 */
+                virtual double getDuration() const = 0;
+
+                /**
+                 * Create the profile of the given type (staircase, sine, chirp, prbs, table) configured from
+                 * the [profile] parameter group.
+                 * @return the new profile or NULL on error
+                 */
+                static DepthProfile* create(const std::string &i_type, const yarp::os::Bottle &i_group);
+        };
+
+
+        /**
+         * Staircase going up by stepSize for nSteps steps and back down to zero, each step lasting stepDuration.
+         */
+        class StaircaseProfile : public DepthProfile {
+            private:
+                double stepSize;
+                double stepDuration;
+                int nSteps;
+
+            public:
+                StaircaseProfile(const double &aStepSize, const double &aStepDuration, const int &aNSteps);
+
+                virtual double sample(const double &i_t) const;
+                virtual double getDuration() const;
+        };
+
+
+        /**
+         * Raised cosine oscillating between zero and amplitude at the given frequency.
+         */
+        class SineProfile : public DepthProfile {
+            private:
+                double amplitude;
+                double frequency;
+                double duration;
+
+            public:
+                SineProfile(const double &aAmplitude, const double &aFrequency, const double &aDuration);
+
+                virtual double sample(const double &i_t) const;
+                virtual double getDuration() const;
+        };
+
+
+        /**
+         * Raised cosine oscillating between zero and amplitude, with the frequency swept linearly from f0 to f1.
+         */
+        class ChirpProfile : public DepthProfile {
+            private:
+                double amplitude;
+                double f0;
+                double f1;
+                double duration;
+
+            public:
+                ChirpProfile(const double &aAmplitude, const double &aF0, const double &aF1, const double &aDuration);
+
+                virtual double sample(const double &i_t) const;
+                virtual double getDuration() const;
+        };
+
+
+        /**
+         * Pseudo-random binary sequence switching between zero and amplitude.
+         * The sequence is the maximum length sequence of a 7 bit linear feedback shift register.
+         */
+        class PrbsProfile : public DepthProfile {
+            private:
+                double amplitude;
+                double bitDuration;
+                std::vector<bool> bits;
+
+            public:
+                PrbsProfile(const double &aAmplitude, const double &aBitDuration, const int &aNBits, const int &aSeed);
+
+                virtual double sample(const double &i_t) const;
+                virtual double getDuration() const;
+        };
+
+
+        /**
+         * User defined table of (time depth) points, linearly interpolated.
+         */
+        class TableProfile : public DepthProfile {
+            private:
+                std::vector<double> times;
+                std::vector<double> depths;
+
+            public:
+                TableProfile(const std::vector<double> &aTimes, const std::vector<double> &aDepths);
+
+                virtual double sample(const double &i_t) const;
+                virtual double getDuration() const;
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_EXPERIMENTCONFIG_H__
+#define __ICUB_INTERACTIONFORCES_EXPERIMENTCONFIG_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The PinchingLimb is the limb used to complete the pinching action.
+         * This is a single joint such as index distal/proximal, etc.
+         */
+        struct PinchingLimb {
+            /**
+             * The joint number.
+             */
+            int joint;
+
+            /**
+             * The joint starting position.
+             */
+            double startPos;
+
+            /**
+             * The joint pinching position.
+             */
+            double pinchPos;
+
+            /**
+             * The fingertips in contact with the object.
+             */
+            std::vector<int> fingertips;
+        };
+
+
+        /**
+         * The parameters of a pinching experiment, from the [experiment] and [finger] groups.
+         */
+        struct ExperimentParameters {
+            /** The number of pinches in the sequence. */
+            int nPinches;
+
+            /** The depth (position) increment between each pinch. */
+            int pinchIncrement;
+
+            /** The duration of each pinch in seconds. */
+            int pinchDuration;
+
+            /** The time delay between each pinch. */
+            int pinchDelay;
+
+            /** Set to true if the experiment is a progressive depth pinch experiment. */
+            bool progressiveDepth;
+
+            /** Set to true if the thumb is to be used in the pinching motion. */
+            bool useThumb;
+
+            /** The finger used for the pinching action. */
+            PinchingLimb finger;
+        };
+
+
+        /**
+         * Double-buffered experiment parameters.
+         * The RPC thread edits a staged copy of the parameters; the pinching thread fetches the staged copy
+         * into its own active snapshot between pinches. A pinch therefore always runs with one consistent set
+         * of parameters, and a change is applied as a whole.
+         */
+        class ExperimentConfig {
+            private:
+                yarp::os::Mutex mutex;
+                ExperimentParameters staged;
+                bool pending;
+
+                std::string dbgTag;
+
+            public:
+                ExperimentConfig();
+
+                /**
+                 * Read the parameters from the [experiment] and [finger] groups.
+                 * @return true/false on success/failure
+                 */
+                static bool read(const yarp::os::Bottle &i_experiment, const yarp::os::Bottle &i_finger, ExperimentParameters &o_params);
+
+                /**
+                 * Check the parameter ranges.
+                 * @return true if valid
+                 */
+                static bool validate(const ExperimentParameters &i_params);
+
+                /**
+                 * Replace all staged parameters.
+                 */
+                void stage(const ExperimentParameters &i_params);
+
+                /**
+                 * Set a single staged parameter (nPinches, pinchIncrement, pinchDuration, pinchDelay, progressiveDepth,
+                 * useThumb, finger.joint, finger.startPos, finger.pinchPos, finger.fingertips).
+                 * @param i_name the parameter name
+                 * @param i_value the parameter value; a list for finger.fingertips
+                 * @return true/false on success/failure
+                 */
+                bool set(const std::string &i_name, const yarp::os::Bottle &i_value);
+
+                /**
+                 * Set a single parameter of the given parameters, without validating them.
+                 * @return false if the parameter is unknown or its value missing
+                 */
+                static bool assign(ExperimentParameters &io_params, const std::string &i_name, const yarp::os::Bottle &i_value);
+
+                /**
+                 * Get a copy of all staged parameters.
+                 */
+                ExperimentParameters getStaged(void);
+
+                /**
+                 * Get a staged parameter.
+                 * @return the parameter value, an empty string if unknown
+                 */
+                std::string get(const std::string &i_name);
+
+                /**
+                 * Get all staged parameters, one "name value" line each.
+                 */
+                std::string toString(void);
+
+                /**
+                 * Get a snapshot of the given parameters on a single line, one "(name value)" list each.
+                 */
+                static std::string snapshot(const ExperimentParameters &i_params);
+
+                /**
+                 * Fetch the staged parameters if they changed since the last fetch.
+                 * @param o_params the active parameters, overwritten on change
+                 * @return true if the parameters changed
+                 */
+                bool fetch(ExperimentParameters &o_params);
+
+            private:
+                static std::string format(const ExperimentParameters &i_params, const std::string &i_name);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
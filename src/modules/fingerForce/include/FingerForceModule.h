@@ -75,15 +75,42 @@ This file can be edited at .... .
 
 #include "fingerForce_IDLServer.h"
 #include "GazeThread.h"
+#include "Clock.h"
+#include "SimulatedHand.h"
+#include "PoseService.h"
+#include "DepthProfile.h"
+#include "SensorHub.h"
+#include "SlipDetector.h"
+#include "PinchMonitor.h"
+#include "SegmentIndex.h"
+#include "StreamWatchdog.h"
+#include "ExperimentConfig.h"
+#include "PinchPipeline.h"
+#include "OnsetDetector.h"
+#include "OnsetReport.h"
+#include "LagMonitor.h"
+#include "SkinForceEstimator.h"
+#include "SkinCompensator.h"
+#include "StallDetector.h"
+#include "ResultStore.h"
+#include "Campaign.h"
+#include "JointCache.h"
+#include "ControlLog.h"
+#include "RealTime.h"
+#include "VisualFeed.h"
 
 #include <yarp/os/RFModule.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/Bottle.h>
 #include <yarp/os/RpcServer.h>
 #include <yarp/os/RpcClient.h>
+#include <yarp/os/Mutex.h>
 #include <yarp/dev/CartesianControl.h>
 #include <yarp/dev/IPositionControl.h>
 #include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IControlMode2.h>
+#include <yarp/dev/IImpedanceControl.h>
 #include <yarp/dev/PolyDriver.h>
 
 #include <string>
@@ -94,28 +121,6 @@ This file can be edited at .... .
 namespace iCub {
     namespace interactionForces {
 
-        /**
-         * The PinchingLimb is the limb used to complete the pinching action.
-         * This is a single joint such as index distal/proximal, etc.
-         */
-        struct PinchingLimb {
-            /**
-             * The joint number.
-             */
-            int joint;
-
-            /**
-             * The joint starting position.
-             */
-            double startPos;
-
-            /**
-             * The joint pinching position.
-             */
-            double pinchPos;
-        };
-
-
         class FingerForceModule : public yarp::os::RFModule, public fingerForce_IDLServer {
             private:
                 /* ****** Module attributes                             ****** */
@@ -131,39 +136,65 @@ namespace iCub {
                 /** Robot position to be reached when module starts. */
                 std::vector<double> homePos;
 
+                /** Per-joint home position tolerance in degrees; joints within it are not moved when homing. */
+                std::vector<double> homeTolerance;
+
+                /** Maximum age of the cached joint positions, homing motion polling period and timeout, in seconds. */
+                double homeMaxAge;
+                double homePoll;
+                double homeTimeout;
+
                 /** Module closing flag used by RPC::quit(). */
                 bool closing;
 
+                /* ****** Real-time control path                        ****** */
+                /** Set to true to run the control path with the real-time scheduling and a deferred log. */
+                bool useRealTime;
+
+                /** SCHED_FIFO priority of the control path (0 for the default scheduling) and its CPU (-1 for any). */
+                int rtPriority;
+                int rtCpu;
+
+                /** Console log of the control path. */
+                iCub::interactionForces::ControlLog controlLog;
+
+                /** Latency of the control loop ticks. */
+                iCub::interactionForces::TickLatency tickLatency;
+
+                /** Joint buffers of the control path, sized at configuration. */
+                yarp::sig::Vector controlPosition;
+                yarp::sig::Vector controlTarget;
+                yarp::sig::Vector controlState;
+                std::vector<int> movingJoints;
+
+                /** The clock used for all delays and timestamps. */
+                iCub::interactionForces::Clock *clock;
+
                 /* ****** Experiment parameters                         ****** */
                 /**
-                 * The finger used for the pinching action.
+                 * The active experiment parameters, only used by the pinching thread.
                  */
-                PinchingLimb finger;
-                
-                /**
-                 * The number of pinches in the sequence.
-                 */ 
-                int nPinches;
+                iCub::interactionForces::ExperimentParameters params;
 
                 /**
-                 * The duration of each pinch in seconds.
+                 * The staged experiment parameters, edited over RPC and applied between pinches.
                  */
-                int pinchDuration;
+                iCub::interactionForces::ExperimentConfig experimentConfig;
 
                 /**
-                 * The time delay between each pinch.
+                 * The configuration file, used to reload the experiment parameters.
                  */
-                int pinchDelay;
+                std::string configFile;
 
                 /**
-                 * The depth (position) increment between each pinch.
+                 * The continuous depth profile type (none, staircase, sine, chirp, prbs, table).
                  */
-                int pinchIncrement;
+                std::string profileType;
 
                 /**
-                 * Set to true if the experiment is a progressive depth pinch experiment.
+                 * The [profile] parameter group.
                  */
-                bool progressiveDepth;
+                yarp::os::Bottle profileGroup;
 
                 /* ******* Experiment execution                         ******* */
                 /**
@@ -172,19 +203,168 @@ namespace iCub {
                 int pinchCounter;
 
                 /**
-                 * The previous pinch depth.
+                 * The number of pinches executed since the module started, used to label the pinch summaries and segments.
                  */
-                std::vector<double> previousDepth;
+                int pinchNumber;
 
-                /** 
-                 * Set to true if the thumb is to be used in the pinching motion. 
+                /**
+                 * The previous pinch depth.
                  */
-                bool useThumb;
+                std::vector<double> previousDepth;
 
 
                 /* *******  Threads                                 ******* */
                 iCub::interactionForces::GazeThread *thGaze;
 
+                /** Set to true to track the hand with the gaze. */
+                bool useGaze;
+
+                /** Cached hand pose shared by the module threads. */
+                iCub::interactionForces::PoseService *poseService;
+
+                /** Reader of the skin, nano17 and joint streams. */
+                iCub::interactionForces::SensorHub *sensorHub;
+
+                /** Latest arm joint positions from the joint stream. */
+                iCub::interactionForces::JointCache *jointCache;
+
+                /** Online per-pinch metrics. */
+                iCub::interactionForces::PinchMonitor *pinchMonitor;
+
+                /** Sidecar index of the pinch phases, NULL if disabled. */
+                iCub::interactionForces::SegmentIndex *segmentIndex;
+
+                /** The index file and the indexed streams, used to start a new index for each campaign run. */
+                std::string indexFile;
+                std::vector<std::string> indexStreams;
+                std::vector<std::string> indexPaths;
+
+                /** Per-pinch bookkeeping run off the control path. */
+                iCub::interactionForces::PinchPipeline *pipeline;
+
+                /** Set to true to run the bookkeeping on the pipeline thread, false to run it inline. */
+                bool usePipeline;
+
+                /** The per-pinch jobs, preallocated so that the control path queues them without allocating. */
+                iCub::interactionForces::JobPool summaryJobs;
+                iCub::interactionForces::JobPool segmentJobs;
+                iCub::interactionForces::JobPool lagJobs;
+                iCub::interactionForces::JobPool onsetJobs;
+                iCub::interactionForces::JobPool flushJobs;
+                iCub::interactionForces::JobPool closeJobs;
+
+                /** Writer of the per-pinch results store, NULL if disabled. */
+                iCub::interactionForces::ResultWriter *resultWriter;
+
+                /** The session label of the stored results, and the configured label restored after a campaign. */
+                std::string resultSession;
+                std::string baseSession;
+
+                /** Health monitor of the sensor streams, NULL if disabled. */
+                iCub::interactionForces::StreamWatchdog *watchdog;
+
+                /** Decimated feed of the sensor streams for the port scopes, NULL if disabled. */
+                iCub::interactionForces::VisualFeed *visualFeed;
+
+                /** Set to true to pause pinching while a sensor stream is degraded or stalled. */
+                bool pauseOnFault;
+
+                
+                /* ****** Campaigns                                     ****** */
+                /** The queued campaign runs, executed by the module thread. */
+                iCub::interactionForces::Campaign campaign;
+
+                /** Held while the arm is driven by a sequence, a profile or a campaign run. */
+                yarp::os::Mutex motionMutex;
+
+                
+                /* ****** Slip detection                              ****** */
+                iCub::interactionForces::SlipDetector *slipDetector;
+
+                /** Set to true to monitor slip while holding a pinch. */
+                bool useSlip;
+
+                /**
+                 * Finger depth correction applied on each slip event and maximum total correction per pinch.
+                 */
+                double slipCorrection;
+                double maxSlipCorrection;
+
+
+                /* ****** Contact onsets                               ****** */
+                /** Online contact onset estimator, NULL if disabled. */
+                iCub::interactionForces::OnsetDetector *onsetDetector;
+
+                /** Encoder stall detector, NULL if disabled. */
+                iCub::interactionForces::StallDetector *stallDetector;
+
+                /** The enabled contact detectors. */
+                std::vector<iCub::interactionForces::ContactSource*> contactSources;
+
+                /** The onsets of the current pinch, collected without allocating. */
+                iCub::interactionForces::ContactOnset pinchOnsets[iCub::interactionForces::MAX_CONTACT_ONSETS];
+                int nPinchOnsets;
+
+                /** The onset report of the last pinch, built by the pipeline. */
+                iCub::interactionForces::OnsetReport onsetReport;
+
+
+                /* ****** Hold timing                                   ****** */
+                /** Set to true to start the hold at the first detected contact instead of at the end of the press motion. */
+                bool contactHold;
+
+                /** Maximum time from the start of the press to the contact and contact polling period, in seconds. */
+                double contactTimeout;
+                double contactPoll;
+
+                /** Hold timing statistics over the current sequence. */
+                int holdCount;
+                double holdErrorSum;
+                double holdErrorMax;
+                int loadedCount;
+                double loadedSum;
+                double loadedSumSq;
+
+
+                /* ****** Skin lag                                     ****** */
+                /** Online skin to nano17 lag estimator, NULL if disabled. */
+                iCub::interactionForces::LagMonitor *lagMonitor;
+
+
+                /* ****** Skin force calibration                       ****** */
+                /** Online fingertip force estimator, NULL if no calibration is loaded. */
+                iCub::interactionForces::SkinForceEstimator *skinForce;
+
+
+                /* ****** Skin drift compensation                      ****** */
+                /** Phase-aware compensation of the raw skin, NULL if disabled. */
+                iCub::interactionForces::SkinCompensator *skinCompensator;
+
+
+                /* ****** Synchronised pinching                         ****** */
+                /** Set to true to scale the pinching joint speeds so that finger and thumb arrive together. */
+                bool useSync;
+
+                /** Reference speed of the longest move, minimum speed of the others, in deg/s. */
+                double syncSpeed;
+                double syncMinSpeed;
+
+                /** Arrival polling period and timeout in seconds. */
+                double syncPoll;
+                double syncTimeout;
+
+                /** Arrival tolerance in degrees, used to time the arrivals from the joint stream. */
+                double syncTolerance;
+
+                /**
+                 * Synchronisation error statistics over the current sequence, of the press [0] and raise [1] moves.
+                 * syncPolled counts the moves timed by polling the motion done, thus quantised to the polling period.
+                 */
+                int syncCount[2];
+                double syncErrorSum[2];
+                double syncErrorMax[2];
+                int syncPolled[2];
+
                 
                 /* ****** Ports                                      ****** */
                 yarp::os::RpcServer RPCFingertipsCmd;
@@ -199,6 +379,26 @@ namespace iCub {
                 yarp::dev::PolyDriver clientPos;
                 yarp::dev::IPositionControl *iPos;
                 yarp::dev::IEncoders *iEncs;
+
+                yarp::dev::IControlMode2 *iCtrl;
+                yarp::dev::IImpedanceControl *iImp;
+
+                /* ****** Compliant pinching                            ****** */
+                /**
+                 * Set to true to press and hold in impedance position mode.
+                 */
+                bool compliantPinch;
+
+                /**
+                 * Impedance stiffness and damping of the finger and of the thumb.
+                 */
+                double fingerStiffness;
+                double fingerDamping;
+                double thumbStiffness;
+                double thumbDamping;
+
+                /** The in-process simulated hand, used in place of the control board when [plant] type is sim. */
+                iCub::interactionForces::SimulatedHand *simHand;
                 
                 /* ****** Debug Attributes                           ****** */
                 std::string dbgTag;
@@ -216,10 +416,165 @@ namespace iCub {
             private:
                 /**
                  * Put arm in experiment position.
+                 * @return false if the arm pose could not be read or the joints did not reach the position
                  */
                 bool reachArm(void);
                 bool waitMoveDone(const double &i_timeout, const double &i_delay);
+
+                /**
+                 * Open the hand to its home position, with the pinching finger at its start position.
+                 * The caller must hold motionMutex.
+                 */
+                bool openHand(void);
+
+                /**
+                 * Read the arm joint positions, from the joint stream if recent enough or else from the encoders.
+                 */
+                bool readJoints(yarp::sig::Vector &o_joints);
+
+                /**
+                 * Move the joints of the given range that are outside the home tolerance, and wait for them.
+                 * Nothing is commanded if all joints are in place.
+                 * @param i_target the target position of all joints
+                 * @param i_first the first joint of the range
+                 * @param i_last one past the last joint of the range
+                 * @return false on timeout
+                 */
+                bool moveJoints(const yarp::sig::Vector &i_target, const int i_first, const int i_last);
+
+                /**
+                 * Select in movingJoints the joints of the given range that are outside the home tolerance.
+                 * @return false if the joint positions could not be read
+                 */
+                bool selectJoints(const yarp::sig::Vector &i_target, const int i_first, const int i_last);
+
+                /**
+                 * Move the joints selected in movingJoints, and wait for them.
+                 * @return false on timeout
+                 */
+                bool commandJoints(const yarp::sig::Vector &i_target);
+
+                /**
+                 * Wait for the given joints to complete their motion.
+                 */
+                bool waitJointsDone(const std::vector<int> &i_joints, const double &i_timeout, const double &i_poll);
                 void checkUseThumb(const bool increment, yarp::sig::Vector &o_positions);
+
+                /**
+                 * Open the compliant interfaces and preset the impedance of the pinching joints.
+                 */
+                bool setupCompliance(void);
+
+                /**
+                 * Switch the pinching joints between impedance position mode and position mode.
+                 */
+                bool switchPinchMode(const bool i_compliant);
+
+                /**
+                 * Move the pinching joints so that they start and finish together, and time their arrival.
+                 * The arrivals are timed from the joint stream, or by polling the motion done if the stream is
+                 * not available.
+                 * @param i_position the target position of all joints
+                 * @param i_phase the pinch phase of the move (PHASE_PRESS or PHASE_RAISE)
+                 * @return the synchronisation error (spread of the arrival times) in seconds, negative if not measured
+                 */
+                double syncMove(const yarp::sig::Vector &i_position, const iCub::interactionForces::PinchPhase i_phase);
+
+                /**
+                 * Reset and report the synchronisation error statistics.
+                 */
+                void resetSyncStats(void);
+                void reportSyncStats(void);
+
+                /**
+                 * Hold a pinch until the given time, correcting the finger depth on slip.
+                 * @param i_start the hold start
+                 * @param i_end the hold end
+                 * @param i_depth the commanded finger depth
+                 */
+                bool hold(const double &i_start, const double &i_end, const double &i_depth);
+
+                /**
+                 * Wait for the first contact of the pinch reported by the contact detectors.
+                 * @param i_deadline the time to give up at
+                 * @param o_time the contact onset on the module clock
+                 * @return true if a contact was found
+                 */
+                bool waitContact(const double &i_deadline, double &o_time);
+
+                /**
+                 * Collect the onsets of all the contact detectors into pinchOnsets.
+                 * @return the number of onsets
+                 */
+                int collectOnsets(void);
+
+                /**
+                 * Get the earliest onset on the module clock.
+                 * @return false if there is no onset
+                 */
+                static bool getContactTime(const iCub::interactionForces::ContactOnset *i_onsets, const int &i_count, double &o_time);
+
+                /**
+                 * Block until the given time, to within a fraction of a millisecond.
+                 */
+                void delayUntil(const double &i_time);
+
+                /**
+                 * Delay a tick of a control loop and record its latency.
+                 */
+                void controlDelay(const iCub::interactionForces::ControlLoop i_loop, const double &i_delay);
+
+                /**
+                 * Start a pinch phase in the segment index, closing the previous one.
+                 * @param i_time the phase start, the current time if negative
+                 */
+                void markPhase(const int &i_pinch, const iCub::interactionForces::PinchPhase i_phase, const double &i_fingerDepth,
+                        const double &i_thumbDepth, const double i_time = -1.0);
+
+                /**
+                 * Close the current pinch phase in the segment index.
+                 * @param i_time the phase end, the current time if negative
+                 */
+                void endPhase(const double i_time = -1.0);
+
+                /**
+                 * Execute a single pinch.
+                 */
+                bool pinchOnce(void);
+
+                /**
+                 * Execute a pinch sequence with the active parameters.
+                 * @param i_campaign set to true to account for the pinches in the campaign progress and stop with the campaign
+                 */
+                bool runSequence(const bool i_campaign);
+
+                /**
+                 * Stage the parameters and home pose of a campaign run, and move to the home pose.
+                 * @return false if the arm did not reach the home pose
+                 */
+                bool setupRun(const iCub::interactionForces::CampaignRun &i_run);
+
+                /**
+                 * Execute a campaign run, with its own segment index and results session.
+                 */
+                void executeRun(const iCub::interactionForces::CampaignRun &i_run);
+
+                /**
+                 * Close the segment index and continue in a new one named after the given label.
+                 */
+                void switchIndex(const std::string &i_label);
+
+                /**
+                 * Apply the staged experiment parameters, if changed.
+                 * Called between pinches only.
+                 */
+                void applyParams(void);
+
+                /**
+                 * Wait until all sensor streams are healthy, if pausing on faults is enabled.
+                 * @return false if the module is closing or the campaign is stopped while waiting
+                 */
+                bool waitHealthy(void);
                 
                 bool connectDataDumper(void);
                 bool disconnectDataDumper(void);
@@ -228,6 +583,25 @@ namespace iCub {
                 virtual bool open(void);
                 virtual bool pinch(void);
                 virtual bool pinchseq(void);
+                virtual bool setProfile(const std::string &type);
+                virtual std::string getProfile(void);
+                virtual bool runProfile(void);
+                virtual bool setCompliant(const bool enable);
+                virtual std::string getStreamHealth(void);
+                virtual bool isStreamHealthy(void);
+                virtual std::string getTransports(void);
+                virtual std::string getScope(void);
+                virtual std::string getPipelineStats(void);
+                virtual std::string getLatency(void);
+                virtual std::string getContactOnsets(void);
+                virtual std::string getSkinLag(void);
+                virtual std::string getParam(const std::string &name);
+                virtual bool setParam(const std::string &name, const std::string &value);
+                virtual std::string getParams(void);
+                virtual bool reloadParams(void);
+                virtual bool runCampaign(const std::string &file);
+                virtual std::string getCampaign(void);
+                virtual bool stopCampaign(void);
                 virtual bool resetC(void);
                 virtual bool quit(void);
         };
@@ -23,24 +23,30 @@
 
 #include <string>
 
-#include <yarp/os/RateThread.h>
+#include "ClockedRateThread.h"
+#include "PoseService.h"
+
 #include <yarp/os/ResourceFinder.h>
+#include <yarp/sig/Vector.h>
 #include <yarp/dev/PolyDriver.h>
-#include <yarp/dev/CartesianControl.h>
 #include <yarp/dev/GazeControl.h>
 
 namespace iCub {
     namespace interactionForces {
-        class GazeThread : public yarp::os::RateThread {
+        class GazeThread : public iCub::interactionForces::ClockedRateThread {
             private:
                 /* ******* Module attributes.               ******* */
                 int period;
                 yarp::os::ResourceFinder rf;
 
-                /* ******* Cartesian controller.                ******* */
-                yarp::dev::PolyDriver clientCart;
-                yarp::dev::ICartesianControl *iCart;
-                int startup_context_id_cart;
+                /* ******* Cached hand pose.                    ******* */
+                iCub::interactionForces::PoseService *poseService;
+
+                /** The time in seconds the fixation point is predicted ahead of the latest pose. */
+                double lookAhead;
+
+                /** The fixation point offset from the hand position. */
+                yarp::sig::Vector fixationOffset;
                 
                 /* ******* Gaze controller.                     ******* */
                 yarp::dev::PolyDriver clientGaze;
@@ -53,7 +59,7 @@ namespace iCub {
                 std::string dbgTag;
 
             public:
-                GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf);
+                GazeThread(const int aPeriod, const yarp::os::ResourceFinder &aRf, iCub::interactionForces::Clock *aClock, iCub::interactionForces::PoseService *aPoseService);
                 
                 bool threadInit();     
                 void threadRelease();
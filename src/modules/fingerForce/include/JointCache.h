@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_JOINTCACHE_H__
+#define __ICUB_INTERACTIONFORCES_JOINTCACHE_H__
+
+#include "SensorListener.h"
+#include "Clock.h"
+
+#include <string>
+
+#include <yarp/os/Mutex.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Cache of the latest arm joint positions from the joint stream, so that the module can check the arm
+         * state without polling the encoders.
+         * The cache also times the arrival of a few watched joints at their targets: the time a joint enters its
+         * tolerance is interpolated between the two stream samples around the crossing.
+         */
+        class JointCache : public SensorListener {
+            public:
+                /** Maximum number of watched joints. */
+                static const int MAX_WATCHED = 2;
+
+            private:
+                Clock *clock;
+                yarp::os::Mutex mutex;
+
+                /** Latest joint positions and their receive time on the module clock. */
+                yarp::sig::Vector joints;
+                double stamp;
+
+                /** Filtered period of the joint stream in seconds. */
+                double period;
+
+                /* ******* Arrival watch.                        ******* */
+                int watched[MAX_WATCHED];
+                double targets[MAX_WATCHED];
+                double arrivals[MAX_WATCHED];
+                int nWatched;
+                double tolerance;
+                double watchStart;
+
+            public:
+                JointCache(Clock *aClock);
+
+                /**
+                 * Get the latest joint positions.
+                 * @param i_maxAge the maximum age of the positions in seconds
+                 * @return false if no positions were received within the maximum age
+                 */
+                bool getJoints(const double &i_maxAge, yarp::sig::Vector &o_joints);
+
+                /**
+                 * Get the filtered period of the joint stream, 0 if unknown.
+                 */
+                double getPeriod(void);
+
+                /**
+                 * Start timing the arrival of joints at their targets. Replaces the previous watch.
+                 * @param i_joints the joint indices
+                 * @param i_targets the joint targets
+                 * @param i_n the number of joints, at most MAX_WATCHED
+                 * @param i_tolerance the arrival tolerance
+                 */
+                void watch(const int *i_joints, const double *i_targets, const int &i_n, const double &i_tolerance);
+
+                /**
+                 * Get the arrival time of a watched joint on the module clock.
+                 * @param i_k the position of the joint in the watch
+                 * @return false if the joint has not arrived yet
+                 */
+                bool getArrival(const int &i_k, double &o_time);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_LAGESTIMATOR_H__
+#define __ICUB_INTERACTIONFORCES_LAGESTIMATOR_H__
+
+#include <vector>
+#include <cstddef>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The skin and force signals of a pinch.
+         * The force is the norm of the nano17 force, the skin is the taxel sum of each fingertip.
+         */
+        struct LagSignals {
+            std::vector<double> forceTime;
+            std::vector<double> force;
+            std::vector<double> skinTime;
+            std::vector< std::vector<double> > skin;
+
+            /** Duration of the signals kept by a bounded recording, 0 to keep them all. */
+            double span;
+
+            LagSignals() : span(0.0) {}
+
+            void clear(void);
+
+            /**
+             * Bound the recording to the given duration and preallocate the given number of samples.
+             * When a buffer is full the samples older than the duration are dropped, or every other sample if none is
+             * that old, so that adding samples never allocates.
+             */
+            void bound(const double &i_span, const size_t &i_nForce, const size_t &i_nSkin, const size_t &i_nFingertips);
+
+            /**
+             * Append a nano17 sample (Fx Fy Fz ...).
+             */
+            void addWrench(const double &i_time, const double *i_values, const size_t &i_size);
+
+            /**
+             * Append a compensated skin sample (192 taxels).
+             */
+            void addSkin(const double &i_time, const double *i_values, const size_t &i_size, const std::vector<int> &i_fingertips);
+
+            /**
+             * Append the samples of another set of signals, later in time.
+             */
+            void append(const LagSignals &i_other);
+        };
+
+
+        /**
+         * A lag estimate.
+         */
+        struct LagEstimate {
+            /** The delay of the second signal with respect to the first one, in seconds. */
+            double lag;
+
+            /** The normalised cross-correlation at the peak, in [-1, 1]. */
+            double confidence;
+
+            /** False if the signals do not overlap or are constant. */
+            bool valid;
+        };
+
+
+        /**
+         * Estimation of the time lag between two irregularly sampled signals through cross-correlation.
+         * Both signals are resampled on a common grid over the last window of their overlap, differentiated over a
+         * short span and cross-correlated with a zero padded radix-2 FFT. Differentiating removes the bias of the
+         * level changes at the window edges and sharpens the peak on the press and release edges.
+         * The lag is the position of the correlation peak within the maximum lag, refined with a parabolic fit.
+         * The transform size, the twiddle factors and all work buffers are planned once by setup(), hence an
+         * estimator must not be shared between threads.
+         */
+        class LagEstimator {
+            private:
+                double resolution;
+                double window;
+                double maxLag;
+                int span;
+
+                /** The grid length and the transform size. */
+                size_t nGrid;
+                size_t nFft;
+
+                /** The transform plan. */
+                std::vector<size_t> bitReverse;
+                std::vector<double> cosTable;
+                std::vector<double> sinTable;
+
+                /** Work buffers. */
+                std::vector<double> aRe;
+                std::vector<double> aIm;
+                std::vector<double> bRe;
+                std::vector<double> bIm;
+
+            public:
+                LagEstimator();
+
+                /**
+                 * Plan the estimator.
+                 * @param i_window the maximum analysed duration in seconds
+                 * @param i_resolution the grid period in seconds
+                 * @param i_maxLag the maximum absolute lag in seconds
+                 * @param i_smoothing the span of the differences in seconds, at least the slowest sample period
+                 * @return true/false on success/failure
+                 */
+                bool setup(const double &i_window, const double &i_resolution, const double &i_maxLag, const double &i_smoothing);
+
+                /**
+                 * Estimate the delay of signal b with respect to signal a.
+                 * @return true if the estimate is valid
+                 */
+                bool estimate(const std::vector<double> &i_timeA, const std::vector<double> &i_a,
+                        const std::vector<double> &i_timeB, const std::vector<double> &i_b, LagEstimate &o_estimate);
+
+                size_t getTransformSize(void) const { return nFft; }
+
+            private:
+                /**
+                 * Resample a signal on the grid with linear interpolation, differentiate it and remove its mean.
+                 * @return the signal energy on the grid
+                 */
+                double resample(const std::vector<double> &i_time, const std::vector<double> &i_values, const double &i_start,
+                        const size_t &i_n, std::vector<double> &o_grid);
+
+                /**
+                 * In-place radix-2 transform of the work buffers.
+                 */
+                void transform(std::vector<double> &io_re, std::vector<double> &io_im, const bool &i_inverse);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
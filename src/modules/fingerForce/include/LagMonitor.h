@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_LAGMONITOR_H__
+#define __ICUB_INTERACTIONFORCES_LAGMONITOR_H__
+
+#include "SensorListener.h"
+#include "LagEstimator.h"
+#include "PinchPipeline.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Online estimation of the skin to nano17 lag of each pinch.
+         * The skin and force signals are recorded, with their envelope timestamps, between begin() and end().
+         * The cross-correlation of each fingertip with the force is then computed by analyse(), which is meant to
+         * run on the bookkeeping pipeline. Estimates are published as ("lag" pinch fingertip lag confidence).
+         */
+        class LagMonitor : public SensorListener {
+            private:
+                std::vector<int> fingertips;
+
+                /* ******* Recording, shared with the stream threads.   ******* */
+                yarp::os::Mutex mutex;
+                LagSignals signals;
+                bool active;
+
+                /* ******* Analysis, pipeline thread only.              ******* */
+                LagEstimator estimator;
+                double minConfidence;
+                double expectedLag;
+                double tolerance;
+                yarp::os::BufferedPort<yarp::os::Bottle> lagPort;
+
+                /** The report of the last analysed pinch. */
+                yarp::os::Mutex reportMutex;
+                std::string report;
+
+                std::string dbgTag;
+
+            public:
+                LagMonitor();
+                virtual ~LagMonitor();
+
+                /**
+                 * Configure the monitor from the [lag] parameter group and open the output port.
+                 * @param i_fingertips the default fingertips, used if the group does not list any
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName, const std::vector<int> &i_fingertips);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Start recording the signals of a new pinch.
+                 */
+                void begin(void);
+
+                /**
+                 * Stop recording and get the signals.
+                 */
+                void end(LagSignals &o_signals);
+
+                /**
+                 * Estimate, report and publish the lag of each fingertip.
+                 */
+                void analyse(const int &i_pinch, const LagSignals &i_signals);
+
+                /**
+                 * Get the report of the last analysed pinch.
+                 */
+                std::string getReport(void);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+        };
+
+
+        /**
+         * Estimate the lags of a pinch on the pipeline.
+         */
+        class LagJob : public PipelineJob {
+            private:
+                LagMonitor *monitor;
+                int pinch;
+                LagSignals signals;
+
+            public:
+                LagJob() : monitor(NULL), pinch(-1) {}
+
+                void setup(LagMonitor *i_monitor, const int &i_pinch) { monitor = i_monitor; pinch = i_pinch; }
+
+                /** The signals to analyse, filled by LagMonitor::end(). */
+                LagSignals& getSignals(void) { return signals; }
+
+                virtual void execute(void) { monitor->analyse(pinch, signals); }
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
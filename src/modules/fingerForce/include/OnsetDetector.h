@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_ONSETDETECTOR_H__
+#define __ICUB_INTERACTIONFORCES_ONSETDETECTOR_H__
+
+#include "SensorListener.h"
+#include "ContactSource.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Online contact onset estimator.
+         * The detector monitors the taxel sum of each configured fingertip and the nano17 normal force. While
+         * disarmed it tracks the mean and variance of each signal; while armed the baseline is frozen and the
+         * first rise of each signal is detected either with a one-sided CUSUM or with a plain threshold on the
+         * deviation. The onset is then refined below the sample period by fitting a line to the rising samples
+         * and intersecting it with the baseline.
+         * Times are the source envelope timestamps when available, so that the skin and nano17 onsets of a pinch
+         * can be compared directly.
+         */
+        class OnsetDetector : public SensorListener, public ContactSource {
+            public:
+                /** Event source of the nano17 normal force. */
+                static const int SOURCE_FT = 5;
+
+                /** The detection methods. */
+                enum Method {
+                    METHOD_CUSUM = 0,
+                    METHOD_THRESHOLD
+                };
+
+            private:
+                /**
+                 * Detection state of a single signal, only accessed by its stream thread.
+                 */
+                struct OnsetChannel {
+                    int source;
+                    double minDelta;
+
+                    /** Baseline statistics. */
+                    double mean;
+                    double var;
+                    unsigned int nBaseline;
+
+                    /** CUSUM statistic. */
+                    double cusum;
+
+                    /** Ring of the latest samples. */
+                    std::vector<double> times;
+                    std::vector<double> values;
+                    size_t head;
+                    size_t count;
+
+                    /** The arming generation this channel was reset for. */
+                    unsigned int generation;
+                    bool found;
+                };
+
+                /* ******* Parameters.                           ******* */
+                Method method;
+                double threshold;
+                double drift;
+                double baselineRate;
+                int fitWindow;
+                int ftAxis;
+                double ftSignValue;
+                std::vector<int> fingertips;
+
+                /* ******* Channels.                             ******* */
+                std::vector<OnsetChannel> skinChannels;
+                OnsetChannel ftChannel;
+
+                /* ******* Arming and onsets.                    ******* */
+                yarp::os::Mutex mutex;
+                bool armed;
+                int pinch;
+                unsigned int generation;
+                std::vector<ContactOnset> onsets;
+                yarp::os::BufferedPort<yarp::os::Bottle> eventPort;
+                /** Serialises the events written by the skin and the nano17 threads. */
+                yarp::os::Mutex portMutex;
+
+                std::string dbgTag;
+
+            public:
+                OnsetDetector();
+                virtual ~OnsetDetector();
+
+                /**
+                 * Configure the detector from the [onset] parameter group and open the event port.
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Freeze the baselines and look for the onsets of a new pinch.
+                 */
+                virtual void arm(const int &i_pinch);
+
+                /**
+                 * Stop looking for onsets and resume tracking the baselines.
+                 */
+                virtual void disarm();
+
+                /**
+                 * Get the onsets found since the last arming.
+                 */
+                virtual int getOnsets(ContactOnset *o_onsets, const int &i_size);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+                static const char* getMethodName(const Method i_method);
+
+            private:
+                void setupChannel(OnsetChannel &o_channel, const int &i_source, const double &i_minDelta);
+
+                /**
+                 * Push a new sample in a channel and check for an onset.
+                 */
+                void process(OnsetChannel &io_channel, const double &i_time, const double &i_received, const double &i_value,
+                        const bool &i_envelope);
+
+                /**
+                 * Interpolate the onset time from the latest samples.
+                 */
+                double refine(const OnsetChannel &i_channel, const double &i_sigma) const;
+
+                void emit(const ContactOnset &i_onset);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
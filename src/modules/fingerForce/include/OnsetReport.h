@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_ONSETREPORT_H__
+#define __ICUB_INTERACTIONFORCES_ONSETREPORT_H__
+
+#include "ContactSource.h"
+#include "PinchPipeline.h"
+
+#include <string>
+
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Report of the contact onsets of the last pinch and of the skin to nano17 lags.
+         */
+        class OnsetReport {
+            private:
+                yarp::os::Mutex mutex;
+                std::string report;
+
+                std::string dbgTag;
+
+            public:
+                OnsetReport();
+
+                /**
+                 * Print and keep the report of the onsets of a pinch.
+                 */
+                void build(const ContactOnset *i_onsets, const int &i_count);
+
+                /**
+                 * Get the report of the last pinch.
+                 */
+                std::string get(void);
+        };
+
+
+        /**
+         * Report the contact onsets of a pinch on the pipeline.
+         */
+        class OnsetReportJob : public PipelineJob {
+            private:
+                OnsetReport *report;
+                ContactOnset onsets[MAX_CONTACT_ONSETS];
+                int count;
+
+            public:
+                OnsetReportJob() : report(NULL), count(0) {}
+
+                /**
+                 * @param i_report the report to update
+                 * @param i_onsets the onsets of the pinch, copied
+                 */
+                void setup(OnsetReport *i_report, const ContactOnset *i_onsets, const int &i_count);
+
+                virtual void execute(void) { report->build(onsets, count); }
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_PINCHMETRICS_H__
+#define __ICUB_INTERACTIONFORCES_PINCHMETRICS_H__
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Summary of a single pinch.
+         */
+        struct PinchSummary {
+            /** The pinch index within the sequence. */
+            int index;
+
+            /** The pinch start and end times. */
+            double start;
+            double end;
+
+            /** The maximum position of the pinching finger joint. */
+            double depth;
+
+            /** Peak and mean norm of the nano17 force. */
+            double peakForce;
+            double meanForce;
+
+            /** Peak and mean sum of the compensated taxels of the fingertips in contact. */
+            double peakSkin;
+            double meanSkin;
+
+            /** The number of samples of each stream. */
+            unsigned int nJoints;
+            unsigned int nForce;
+            unsigned int nSkin;
+        };
+
+
+        /**
+         * Accumulator of the per-pinch metrics.
+         * These are the metric definitions shared by the fingerForce module and by the offline analysis tools.
+         * Partial accumulators over disjoint sets of samples of the same pinch can be merged.
+         */
+        class PinchMetrics {
+            private:
+                int joint;
+                std::vector<int> fingertips;
+
+                PinchSummary summary;
+                double forceSum;
+                double skinSum;
+
+            public:
+                PinchMetrics();
+
+                /**
+                 * Set the pinching joint and the fingertips in contact with the object.
+                 */
+                void setup(const int &i_joint, const std::vector<int> &i_fingertips);
+
+                /**
+                 * Clear the accumulator and start a new pinch.
+                 */
+                void reset(const int &i_index, const double &i_start);
+
+                /**
+                 * Add a sample of the arm joints.
+                 */
+                void addJoints(const double *i_joints, const size_t &i_size);
+
+                /**
+                 * Add a sample of the pinching joint position.
+                 */
+                void addDepth(const double &i_position);
+
+                /**
+                 * Add a sample of the nano17 wrench and of the compensated hand skin.
+                 */
+                void addWrench(const double *i_wrench, const size_t &i_size);
+                void addSkin(const double *i_skin, const size_t &i_size);
+
+                /**
+                 * Merge the samples of another accumulator of the same pinch.
+                 */
+                void merge(const PinchMetrics &i_other);
+
+                /**
+                 * Close the pinch and compute the summary.
+                 */
+                const PinchSummary& finish(const double &i_end);
+
+                const PinchSummary& getSummary(void) const;
+
+                /**
+                 * Write the summary table header and a summary row.
+                 */
+                static void writeHeader(std::ostream &o_stream);
+                static void write(std::ostream &o_stream, const PinchSummary &i_summary);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_PINCHMONITOR_H__
+#define __ICUB_INTERACTIONFORCES_PINCHMONITOR_H__
+
+#include "SensorListener.h"
+#include "PinchMetrics.h"
+
+#include <vector>
+
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Online computation of the pinch metrics from the sensor streams.
+         * Samples are only accumulated between begin() and end().
+         */
+        class PinchMonitor : public SensorListener {
+            private:
+                yarp::os::Mutex mutex;
+                PinchMetrics metrics;
+                bool active;
+
+            public:
+                PinchMonitor(const int &i_joint, const std::vector<int> &i_fingertips);
+
+                /**
+                 * Change the pinching joint and the contact fingertips.
+                 */
+                void setup(const int &i_joint, const std::vector<int> &i_fingertips);
+
+                /**
+                 * Start accumulating the samples of a new pinch.
+                 */
+                void begin(const int &i_index, const double &i_time);
+
+                /**
+                 * Stop accumulating and get the pinch accumulators, to be finished by the caller.
+                 */
+                void end(PinchMetrics &o_metrics);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
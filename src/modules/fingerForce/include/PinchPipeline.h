@@ -0,0 +1,291 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_PINCHPIPELINE_H__
+#define __ICUB_INTERACTIONFORCES_PINCHPIPELINE_H__
+
+#include "PinchMetrics.h"
+#include "SegmentIndex.h"
+#include "ResultStore.h"
+#include "ExperimentConfig.h"
+
+#include <vector>
+#include <string>
+
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Semaphore.h>
+#include <yarp/os/Thread.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        class JobPool;
+
+
+        /**
+         * A unit of per-pinch bookkeeping run by the pipeline.
+         */
+        class PipelineJob {
+            private:
+                /** The pool the job returns to once executed, NULL if it is deleted instead. */
+                JobPool *pool;
+
+                friend class JobPool;
+
+            public:
+                PipelineJob() : pool(NULL) {}
+                virtual ~PipelineJob() {}
+                virtual void execute(void) = 0;
+
+                /**
+                 * Return the job to its pool, or delete it if it does not belong to one.
+                 */
+                void release(void);
+        };
+
+
+        /**
+         * Preallocated jobs of one type, so that the control path queues its bookkeeping without allocating.
+         * The control path takes a job, fills it and pushes it; the pipeline gives it back once executed.
+         */
+        class JobPool {
+            private:
+                yarp::os::Mutex mutex;
+                std::vector<PipelineJob*> jobs;
+                std::vector<PipelineJob*> free;
+
+                /** The number of jobs allocated because the pool was empty. */
+                unsigned int misses;
+
+            public:
+                JobPool();
+                ~JobPool();
+
+                /**
+                 * Preallocate jobs.
+                 * @param i_size the number of jobs
+                 */
+                template <class T> void fill(const int i_size) {
+                    for (int i = 0; i < i_size; ++i) {
+                        add(new T());
+                    }
+                }
+
+                /**
+                 * Take a free job. If the pool is empty a job is allocated and deleted once executed.
+                 */
+                template <class T> T* take(void) {
+                    PipelineJob *job = takeFree();
+                    return (job != NULL) ? static_cast<T*>(job) : new T();
+                }
+
+                void give(PipelineJob *i_job);
+
+                unsigned int getMisses(void);
+
+            private:
+                void add(PipelineJob *i_job);
+
+                /**
+                 * @return a free job, NULL if there is none
+                 */
+                PipelineJob* takeFree(void);
+        };
+
+
+        /**
+         * Finalise the metrics of a pinch and print the summary.
+         * If a results writer is given, the pinch is also appended to the results store. The text columns of the
+         * row are filled here, off the control path.
+         */
+        class PinchSummaryJob : public PipelineJob {
+            private:
+                PinchMetrics metrics;
+                double end;
+                ResultWriter *writer;
+                PinchResult result;
+                std::string session;
+                std::string hand;
+                ExperimentParameters params;
+
+            public:
+                PinchSummaryJob() : end(0.0), writer(NULL) {}
+
+                /**
+                 * @param i_end the end of the pinch
+                 * @param i_writer the results writer, NULL if disabled
+                 */
+                void setup(const double &i_end, ResultWriter *i_writer = NULL);
+
+                /**
+                 * Set the text columns of the row.
+                 */
+                void setContext(const std::string &i_session, const std::string &i_hand, const ExperimentParameters &i_params);
+
+                /** The metrics of the pinch, filled by PinchMonitor::end(). */
+                PinchMetrics& getMetrics(void) { return metrics; }
+
+                /** The values of the row, completed with the summary. */
+                PinchResult& getResult(void) { return result; }
+
+                virtual void execute(void);
+        };
+
+
+        /**
+         * Write the buffered pinch results to the results store.
+         */
+        class ResultFlushJob : public PipelineJob {
+            private:
+                ResultWriter *writer;
+
+            public:
+                ResultFlushJob() : writer(NULL) {}
+
+                void setWriter(ResultWriter *i_writer) { writer = i_writer; }
+
+                virtual void execute(void);
+        };
+
+
+        /**
+         * Write a closed pinch phase to the segment index.
+         */
+        class SegmentJob : public PipelineJob {
+            private:
+                SegmentIndex *index;
+                PinchSegment segment;
+
+            public:
+                SegmentJob() : index(NULL) {}
+
+                void setIndex(SegmentIndex *i_index) { index = i_index; }
+
+                /** The phase to write, filled by SegmentIndex::take(). */
+                PinchSegment& getSegment(void) { return segment; }
+
+                virtual void execute(void);
+        };
+
+
+        /**
+         * Close and delete a segment index once the rows queued before are written.
+         */
+        class IndexCloseJob : public PipelineJob {
+            private:
+                SegmentIndex *index;
+
+            public:
+                IndexCloseJob() : index(NULL) {}
+
+                void setIndex(SegmentIndex *i_index) { index = i_index; }
+
+                virtual void execute(void);
+        };
+
+
+        /**
+         * Statistics of the pipeline. Times are in seconds of wall time.
+         */
+        struct PipelineStats {
+            /** The number of completed jobs. */
+            unsigned int jobs;
+
+            /** The number of queued jobs and the maximum reached. */
+            unsigned int pending;
+            unsigned int maxPending;
+
+            /** The number of pushes that waited for a free slot, and the total waiting time. */
+            unsigned int stalls;
+            double stallTime;
+
+            /** The mean and maximum job execution time. */
+            double meanJobTime;
+            double maxJobTime;
+
+            /** The maximum time between pushing a job and completing it. */
+            double maxLatency;
+        };
+
+
+        /**
+         * Bounded queue of bookkeeping jobs executed by a worker thread.
+         * The pinching thread pushes the bookkeeping of pinch N and moves on to the rest and approach of pinch N+1
+         * while the worker finalises it. The pinching thread only waits when the queue is full; such stalls are
+         * counted in the statistics. Jobs still queued when the thread stops are executed before it exits.
+         * If the thread is not started, jobs are executed in the calling thread.
+         * The queue is a ring allocated once, and executed jobs are released to their pool.
+         */
+        class PinchPipeline : public yarp::os::Thread {
+            private:
+                struct Entry {
+                    PipelineJob *job;
+                    double pushed;
+                };
+
+                /** Ring of the queued jobs: the oldest is at head. */
+                std::vector<Entry> queue;
+                size_t head;
+                size_t count;
+                yarp::os::Mutex mutex;
+                yarp::os::Semaphore items;
+                yarp::os::Semaphore slots;
+
+                /* ******* Statistics, protected by the mutex.   ******* */
+                PipelineStats stats;
+                double jobTimeSum;
+
+                std::string dbgTag;
+
+            public:
+                /**
+                 * @param aCapacity the maximum number of queued jobs
+                 */
+                PinchPipeline(const int aCapacity);
+                virtual ~PinchPipeline();
+
+                /**
+                 * Queue a job, waiting for a free slot if the queue is full.
+                 * @param i_job the job, released once executed
+                 */
+                void push(PipelineJob *i_job);
+
+                PipelineStats getStats(void);
+
+                /**
+                 * Get the statistics as a single line.
+                 */
+                std::string getReport(void);
+
+                virtual void run(void);
+                virtual void onStop(void);
+                virtual void threadRelease(void);
+
+            private:
+                /**
+                 * Execute a job and update the statistics.
+                 */
+                void execute(const Entry &i_entry);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_POSESERVICE_H__
+#define __ICUB_INTERACTIONFORCES_POSESERVICE_H__
+
+#include "Clock.h"
+
+#include <string>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Cache of the end-effector pose streamed by the cartesian controller.
+         * The service reads the controller state port in a callback, stores the latest pose and keeps a
+         * filtered estimate of the end-effector linear velocity, so that any thread in the module can get
+         * the current or predicted pose without a blocking call to the controller.
+         */
+        class PoseService : public yarp::os::BufferedPort<yarp::sig::Vector> {
+            private:
+                Clock *clock;
+                yarp::os::Mutex mutex;
+
+                /** Latest position (x y z) and orientation (axis-angle). */
+                yarp::sig::Vector position;
+                yarp::sig::Vector orientation;
+
+                /** Filtered linear velocity in m/s. */
+                yarp::sig::Vector velocity;
+
+                /** Clock time at which the latest pose was received. */
+                double stamp;
+
+                /** Time of the latest pose used for the velocity and period: the envelope stamp if valid, else the receive time. */
+                double sourceStamp;
+
+                /** True if sourceStamp is an envelope stamp. */
+                bool sourceEnvelope;
+
+                /** Filtered period of the pose stream in seconds. */
+                double period;
+
+                /** Number of poses received. */
+                unsigned int count;
+
+                /** The carrier of the pose connection. */
+                std::string transport;
+
+                /** Velocity low-pass filter coefficient in (0, 1]. */
+                double velocityFilter;
+
+                std::string dbgTag;
+
+            public:
+                PoseService(Clock *aClock, const double &aVelocityFilter = 0.3);
+
+                /**
+                 * Open the input port and connect it to the cartesian controller state port.
+                 * @param i_localName the local port name
+                 * @param i_remoteName the cartesian controller state port
+                 * @param i_carrier the network carrier
+                 * @param i_shmem set to true to connect a co-located controller over shared memory
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_localName, const std::string &i_remoteName, const std::string &i_carrier = "udp",
+                        const bool i_shmem = false);
+
+                /**
+                 * Get the carrier of the pose connection, external if not connected by the service.
+                 */
+                std::string getTransport(void) const { return transport; }
+
+                /**
+                 * Get the latest pose.
+                 * @param o_position the end-effector position
+                 * @param o_orientation the end-effector orientation
+                 * @param o_stamp the clock time at which the pose was received (can be NULL)
+                 * @return false if no pose was received yet
+                 */
+                bool getPose(yarp::sig::Vector &o_position, yarp::sig::Vector &o_orientation, double *o_stamp = NULL);
+
+                /**
+                 * Get the estimated end-effector linear velocity.
+                 * @return false if no estimate is available yet
+                 */
+                bool getVelocity(yarp::sig::Vector &o_velocity);
+
+                /**
+                 * Predict the end-effector position the given time into the future, extrapolating from the latest
+                 * pose with the estimated velocity. The age of the latest pose is taken into account.
+                 * @return false if no pose was received yet, or if the latest pose is older than a few stream periods
+                 */
+                bool predictPosition(const double &i_lookAhead, yarp::sig::Vector &o_position);
+
+                /**
+                 * Pose callback.
+                 */
+                virtual void onRead(yarp::sig::Vector &i_pose);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
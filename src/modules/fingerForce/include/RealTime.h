@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_REALTIME_H__
+#define __ICUB_INTERACTIONFORCES_REALTIME_H__
+
+#include <string>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The timed loops of the control path.
+         */
+        enum ControlLoop {
+            /** The setpoint ticks of a continuous depth profile. */
+            LOOP_PROFILE = 0,
+            /** The hold ticks, including the final wait for the hold end. */
+            LOOP_HOLD,
+            /** The motion and contact polling ticks. */
+            LOOP_POLL,
+            N_CONTROL_LOOPS
+        };
+
+
+        /**
+         * Real-time setup of the process and of the control threads (Linux).
+         */
+        class RealTime {
+            public:
+                /**
+                 * Lock the current and future pages of the process in memory.
+                 * @return true/false on success/failure
+                 */
+                static bool lockMemory(void);
+
+                /**
+                 * Set the scheduling of the calling thread.
+                 * @param i_priority the SCHED_FIFO priority, 0 for the default scheduling
+                 * @param i_cpu the CPU to run on, -1 for any
+                 * @return true/false on success/failure
+                 */
+                static bool setScheduling(const int i_priority, const int i_cpu);
+        };
+
+
+        /**
+         * Scoped real-time scheduling of the calling thread.
+         * The previous scheduling and CPU affinity are restored when the scope ends.
+         */
+        class RealTimeScope {
+            private:
+                bool active;
+                int policy;
+                struct sched_param param;
+                cpu_set_t cpus;
+
+            public:
+                /**
+                 * @param i_enable set to false to leave the scheduling unchanged
+                 */
+                RealTimeScope(const bool i_enable, const int i_priority, const int i_cpu);
+                ~RealTimeScope();
+        };
+
+
+        /**
+         * Worst-case latency of the ticks of the control loops.
+         * The latency of a tick is the time between its scheduled start and its actual start.
+         */
+        class TickLatency {
+            private:
+                yarp::os::Mutex mutex;
+                unsigned int count[N_CONTROL_LOOPS];
+                double sum[N_CONTROL_LOOPS];
+                double max[N_CONTROL_LOOPS];
+
+            public:
+                TickLatency();
+
+                /**
+                 * Record a tick.
+                 * @param i_scheduled the scheduled start of the tick
+                 * @param i_actual the actual start of the tick
+                 */
+                void add(const ControlLoop i_loop, const double &i_scheduled, const double &i_actual);
+
+                void reset(void);
+
+                /**
+                 * Get the latency statistics.
+                 * @return one line per loop with the number of ticks and the mean and maximum latency
+                 */
+                std::string getReport(void);
+
+                static const char* getLoopName(const ControlLoop i_loop);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,351 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_RESULTSTORE_H__
+#define __ICUB_INTERACTIONFORCES_RESULTSTORE_H__
+
+#include "PinchMetrics.h"
+
+#include <cstdio>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The columns of the results store.
+         * The text columns are dictionary encoded and precede the numeric ones.
+         */
+        enum ResultColumn {
+            RESULT_SESSION = 0,
+            RESULT_HAND,
+            RESULT_FINGER,
+            RESULT_CONFIG,
+            RESULT_STAMP,
+            RESULT_DAY,
+            RESULT_PINCH,
+            RESULT_DEPTH,
+            RESULT_REACHED,
+            RESULT_DURATION,
+            RESULT_CONTACT,
+            RESULT_LOADED,
+            RESULT_HOLD,
+            RESULT_PEAKFORCE,
+            RESULT_MEANFORCE,
+            RESULT_PEAKSKIN,
+            RESULT_MEANSKIN,
+            N_RESULT_COLUMNS
+        };
+
+        /** The number of text columns. */
+        const int N_RESULT_TEXT = RESULT_STAMP;
+
+
+        /**
+         * The result of a single pinch, one row of the store.
+         */
+        struct PinchResult {
+            /**
+             * The text columns: the session label, the hand (left, right), the finger (index, middle, ...) and the
+             * snapshot of the experiment parameters.
+             */
+            std::string text[N_RESULT_TEXT];
+
+            /**
+             * The numeric columns, by column; the entries of the text columns are unused.
+             * The stamp is the wall time of the pinch in seconds since the epoch and the day its local date (YYYYMMDD).
+             * The depth is the commanded finger depth, NaN if not known, and the reached depth the maximum
+             * position of the pinching joint.
+             * The contact is the time from the start of the press to the first contact onset, the loaded duration
+             * the time from the contact to the end of the hold, both NaN if no contact was detected, and the hold
+             * the measured hold duration.
+             */
+            double value[N_RESULT_COLUMNS];
+
+            PinchResult();
+
+            /**
+             * Reset the values to NaN, keeping the text columns.
+             */
+            void clear(void);
+
+            /**
+             * Set the stamp and the day.
+             */
+            void setStamp(const double &i_stamp);
+
+            /**
+             * Set the pinch metrics from a pinch summary.
+             */
+            void setSummary(const PinchSummary &i_summary);
+        };
+
+
+        /**
+         * Selection of rows: accepted values of the text columns and accepted ranges of the numeric columns.
+         * Rows with a NaN value never satisfy a range.
+         */
+        struct ResultFilter {
+            /** The accepted values of each text column, empty to accept all. */
+            std::vector<std::string> values[N_RESULT_TEXT];
+
+            /** The accepted range [min, max] of each numeric column, -HUGE_VAL/HUGE_VAL if open. */
+            double min[N_RESULT_COLUMNS];
+            double max[N_RESULT_COLUMNS];
+
+            ResultFilter();
+
+            /**
+             * Check whether a numeric column is restricted.
+             */
+            bool isRange(const int &i_column) const;
+        };
+
+
+        /**
+         * Reader of a segment of the results store.
+         * A segment is an immutable file holding a block of rows column by column. The header keeps the
+         * minimum and maximum of each numeric column, so that whole segments are skipped by a range. The hand
+         * and finger columns are indexed by posting lists (the rows holding each value), the depth and stamp
+         * columns by their rows sorted by value. Columns and indexes are only read when a query needs them.
+         */
+        class ResultSegment {
+            private:
+                /** Location of a section in the file. */
+                struct Section {
+                    uint64_t offset;
+                    uint64_t size;
+                };
+
+                FILE *file;
+                std::string fileName;
+                uint32_t nRows;
+
+                double zoneMin[N_RESULT_COLUMNS];
+                double zoneMax[N_RESULT_COLUMNS];
+                Section columnSection[N_RESULT_COLUMNS];
+                Section indexSection[N_RESULT_COLUMNS];
+                Section dictionarySection[N_RESULT_COLUMNS];
+
+                /** False for the columns added after the segment was written, read as NaN. */
+                bool present[N_RESULT_COLUMNS];
+
+                /** The loaded dictionaries, codes and values. */
+                bool hasDictionary[N_RESULT_TEXT];
+                std::vector<std::string> dictionary[N_RESULT_TEXT];
+                std::vector<uint32_t> codes[N_RESULT_TEXT];
+                std::vector<double> values[N_RESULT_COLUMNS];
+                bool loaded[N_RESULT_COLUMNS];
+
+                std::vector<unsigned char> buffer;
+
+                std::string dbgTag;
+
+                bool read(const uint64_t &i_offset, const uint64_t &i_size);
+                bool loadDictionary(const int &i_column);
+
+                /**
+                 * Get the codes of the accepted values of a text column.
+                 */
+                bool findCodes(const int &i_column, const std::vector<std::string> &i_values, std::vector<uint32_t> &o_codes);
+
+                /**
+                 * Read the rows of a posting list index holding any of the given codes, in ascending order.
+                 * @param o_rows the rows, NULL to only count them
+                 */
+                bool readPostings(const int &i_column, const std::vector<uint32_t> &i_codes, std::vector<uint32_t> *o_rows,
+                        uint32_t &o_count);
+
+                /**
+                 * Read the rows of a sorted index within a range, in ascending order.
+                 * The range bounds are found by a binary search in the file.
+                 * @param o_rows the rows, NULL to only count them
+                 */
+                bool readRange(const int &i_column, const double &i_min, const double &i_max, std::vector<uint32_t> *o_rows,
+                        uint32_t &o_count);
+
+            public:
+                ResultSegment();
+                ~ResultSegment();
+
+                /**
+                 * Open a segment and read its header.
+                 * Segments of format version 1, written before the contact, loaded and hold columns were added,
+                 * are read with these columns set to NaN.
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_file);
+                void close(void);
+
+                /**
+                 * Select the rows satisfying a filter, using the zone maps and the most selective index.
+                 * @param i_filter the filter
+                 * @param o_rows the selected rows, in ascending order
+                 * @return true/false on success/failure
+                 */
+                bool select(const ResultFilter &i_filter, std::vector<uint32_t> &o_rows);
+
+                /**
+                 * Load a column, if not already loaded.
+                 * @return true/false on success/failure
+                 */
+                bool load(const int &i_column);
+
+                /**
+                 * Load all columns and rebuild a row.
+                 */
+                bool getRow(const uint32_t &i_row, PinchResult &o_result);
+
+                uint32_t getRows(void) const { return nRows; }
+                const std::string& getFile(void) const { return fileName; }
+
+                /**
+                 * Access the loaded columns.
+                 */
+                const std::vector<std::string>& getDictionary(const int &i_column) const { return dictionary[i_column]; }
+                const std::vector<uint32_t>& getCodes(const int &i_column) const { return codes[i_column]; }
+                const std::vector<double>& getValues(const int &i_column) const { return values[i_column]; }
+
+                /**
+                 * Write a segment.
+                 * The segment is written to a temporary file and renamed, so readers never see a partial segment.
+                 * @return true/false on success/failure
+                 */
+                static bool write(const std::string &i_file, const std::vector<PinchResult> &i_rows);
+        };
+
+
+        /**
+         * Append-only writer of the results store.
+         * Rows are buffered and written as a new segment when the buffer is full or on flush(). Each writer
+         * names its segments after its prefix, its start time and its process, so that the module and the
+         * analysis tools can write to the same store.
+         */
+        class ResultWriter {
+            private:
+                std::string directory;
+                std::string prefix;
+                unsigned int blockRows;
+                time_t start;
+                unsigned int sequence;
+                std::vector<PinchResult> rows;
+
+                std::string dbgTag;
+
+            public:
+                ResultWriter();
+                ~ResultWriter();
+
+                /**
+                 * Open the store, creating its directory if needed.
+                 * @param i_directory the store directory
+                 * @param i_prefix the segment name prefix
+                 * @param i_blockRows the maximum number of buffered rows
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_directory, const std::string &i_prefix, const unsigned int &i_blockRows);
+
+                void append(const PinchResult &i_result);
+
+                /**
+                 * Write the buffered rows as a new segment.
+                 * @return true/false on success/failure
+                 */
+                bool flush(void);
+
+                bool close(void);
+        };
+
+
+        /**
+         * Consumer of the rows selected from the results store.
+         */
+        class ResultHandler {
+            public:
+                virtual ~ResultHandler() {}
+
+                /**
+                 * Consume the selected rows of a segment.
+                 * @return false to stop the query
+                 */
+                virtual bool onRows(ResultSegment &i_segment, const std::vector<uint32_t> &i_rows) = 0;
+        };
+
+
+        /**
+         * Reader of the results store: a directory of segments.
+         */
+        class ResultStore {
+            private:
+                std::string directory;
+                std::vector<std::string> files;
+
+                std::string dbgTag;
+
+            public:
+                ResultStore();
+
+                /**
+                 * List the segments of a store.
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_directory);
+
+                /**
+                 * Select the rows satisfying a filter from every segment.
+                 * @param i_filter the filter
+                 * @param i_handler the consumer of the rows
+                 * @param o_rows the total number of rows in the store
+                 * @return false if a segment could not be read; segments removed by a concurrent compaction are skipped
+                 */
+                bool select(const ResultFilter &i_filter, ResultHandler *i_handler, uint64_t &o_rows);
+
+                /**
+                 * Merge the segments smaller than the given size into segments of up to that size.
+                 * The merged segments are written before the originals are removed, so no row is ever lost; a
+                 * query running meanwhile may count the merged rows twice.
+                 * @return true/false on success/failure
+                 */
+                bool compact(const unsigned int &i_rows);
+
+                const std::vector<std::string>& getSegments(void) const { return files; }
+
+                /**
+                 * Get the name of the finger moved by a hand joint.
+                 */
+                static std::string getFingerName(const int &i_joint);
+
+                static const char* getColumnName(const int &i_column);
+
+                /**
+                 * Get a column by name.
+                 * @return the column, N_RESULT_COLUMNS if unknown
+                 */
+                static int getColumn(const std::string &i_name);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
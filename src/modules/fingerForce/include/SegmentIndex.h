@@ -0,0 +1,196 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SEGMENTINDEX_H__
+#define __ICUB_INTERACTIONFORCES_SEGMENTINDEX_H__
+
+#include "Clock.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The phases of a pinch.
+         */
+        enum PinchPhase {
+            PHASE_PRESS = 0,
+            PHASE_HOLD,
+            PHASE_RAISE,
+            PHASE_REST,
+            N_PINCH_PHASES
+        };
+
+
+        /**
+         * A phase of a pinch in the recorded streams.
+         */
+        struct PinchSegment {
+            /** The pinch index. */
+            int pinch;
+
+            /** The pinch phase. */
+            PinchPhase phase;
+
+            /** The phase start and end times. */
+            double start;
+            double end;
+
+            /** The commanded finger and thumb depths. */
+            double fingerDepth;
+            double thumbDepth;
+
+            /**
+             * The size of each stream file at or before the start of the phase, -1 if not available.
+             * All samples from the phase start onwards are stored past this offset.
+             */
+            std::vector<int64_t> offsets;
+        };
+
+
+        /**
+         * Sidecar index of the pinches of a recording.
+         * The index is a text file with one row per pinch phase: "pinch phase start end fingerDepth thumbDepth"
+         * followed by one file offset per stream. The header line lists the stream names.
+         * The module writes the index while running; the analysis tools load it to seek directly to a pinch.
+         * The stream file sizes are sampled when the index is created and after each row is written, so never
+         * at a phase boundary. A phase is given the last sizes sampled before it started; streams without a
+         * sample are written as -1 and searched on the timestamps by the readers.
+         */
+        class SegmentIndex {
+            private:
+                /**
+                 * The stream file sizes at a given time.
+                 */
+                struct SizeSample {
+                    double time;
+                    std::vector<int64_t> sizes;
+                };
+
+                std::vector<std::string> streams;
+                std::vector<std::string> paths;
+                std::vector<PinchSegment> segments;
+
+                /** Writer state. */
+                std::ofstream file;
+                PinchSegment current;
+                bool writing;
+                Clock *clock;
+
+                /** The sampled file sizes, oldest first. */
+                std::vector<SizeSample> samples;
+
+                /** True while the segments are sorted by pinch and phase, and by start time: the lookups bisect only then. */
+                bool pinchOrdered;
+                bool timeOrdered;
+
+                /**
+                 * Update the order flags with the segment at the given position.
+                 */
+                void checkOrder(const size_t &i_k);
+
+                std::string dbgTag;
+
+            public:
+                SegmentIndex();
+                ~SegmentIndex();
+
+                /**
+                 * Create an index file.
+                 * @param i_file the index file
+                 * @param i_streams the stream names
+                 * @param i_paths the stream files, used to record the offsets
+                 * @param i_clock the clock of the phase times, used to date the file sizes
+                 * @return true/false on success/failure
+                 */
+                bool create(const std::string &i_file, const std::vector<std::string> &i_streams, const std::vector<std::string> &i_paths,
+                        Clock *i_clock);
+
+                /**
+                 * Start a new phase, closing the current one.
+                 */
+                void begin(const int &i_pinch, const PinchPhase i_phase, const double &i_time, const double &i_fingerDepth,
+                        const double &i_thumbDepth);
+
+                /**
+                 * Close the current phase.
+                 */
+                void end(const double &i_time);
+
+                /**
+                 * Close the current phase without writing it.
+                 * Together with write() this lets the phase boundaries be taken on the control path and the
+                 * rows be written by another thread.
+                 * @return false if no phase is open
+                 */
+                bool take(const double &i_time, PinchSegment &o_segment);
+
+                /**
+                 * Write a closed phase with the offsets sampled before it started, then sample the file sizes.
+                 */
+                void write(const PinchSegment &i_segment);
+
+                void close(void);
+
+                /**
+                 * Load an index file. The segments are sorted by pinch and phase.
+                 * @return true/false on success/failure
+                 */
+                bool load(const std::string &i_file);
+
+                /**
+                 * Find a phase of a pinch in O(log n), O(n) if the segments are out of order.
+                 * @return the segment, NULL if not found
+                 */
+                const PinchSegment* find(const int &i_pinch, const PinchPhase i_phase) const;
+
+                /**
+                 * Find the phase containing the given time in O(log n), O(n) if the phases are not in time order.
+                 * @return the segment, NULL if not found
+                 */
+                const PinchSegment* findTime(const double &i_time) const;
+
+                /**
+                 * Get the position of a stream in the offsets.
+                 * @return the stream position, -1 if not indexed
+                 */
+                int getStream(const std::string &i_name) const;
+
+                const std::vector<PinchSegment>& getSegments(void) const { return segments; }
+
+                static const char* getPhaseName(const PinchPhase i_phase);
+                static PinchPhase getPhase(const std::string &i_name);
+
+            private:
+                /**
+                 * Record the current size of the stream files.
+                 */
+                void sample(void);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
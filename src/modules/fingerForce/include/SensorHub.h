@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SENSORHUB_H__
+#define __ICUB_INTERACTIONFORCES_SENSORHUB_H__
+
+#include "Clock.h"
+#include "ClockedRateThread.h"
+#include "SensorListener.h"
+#include "SimulatedHand.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Reader of the skin, wrench and joint streams.
+         * The hub owns one input port per stream and forwards every sample, in the port callback thread, to
+         * the registered listeners. With the simulated plant the samples are generated in-process instead.
+         */
+        class SensorHub {
+            private:
+                /**
+                 * Input port of a single stream.
+                 */
+                class StreamPort : public yarp::os::BufferedPort<yarp::sig::Vector> {
+                    private:
+                        SensorHub *hub;
+                        SensorStream stream;
+
+                    public:
+                        StreamPort() : hub(NULL), stream(STREAM_SKIN_RAW) {}
+                        void setup(SensorHub *aHub, const SensorStream aStream) { hub = aHub; stream = aStream; }
+                        virtual void onRead(yarp::sig::Vector &i_data);
+                };
+
+                /**
+                 * Periodic generation of the sensor streams from the simulated plant.
+                 */
+                class SimulatedFeed : public ClockedRateThread {
+                    private:
+                        SensorHub &hub;
+                        SimulatedHand *hand;
+                        yarp::sig::Vector raw;
+                        yarp::sig::Vector comp;
+                        yarp::sig::Vector wrench;
+                        yarp::sig::Vector joints;
+                        int seq;
+
+                    public:
+                        SimulatedFeed(const int aPeriod, Clock *aClock, SensorHub &aHub, SimulatedHand *aHand);
+                        virtual void run();
+                };
+
+                Clock *clock;
+                std::vector<SensorListener*> listeners;
+
+                StreamPort ports[N_SENSOR_STREAMS];
+                SimulatedFeed *feed;
+
+                /** The remote port of each stream. */
+                std::string remoteNames[N_SENSOR_STREAMS];
+                /** The local port of each stream. */
+                std::string localNames[N_SENSOR_STREAMS];
+                /** Set to true for the streams produced within the module, see inject(). */
+                bool internal[N_SENSOR_STREAMS];
+                /** The transport of each stream. */
+                std::string transports[N_SENSOR_STREAMS];
+
+                std::string dbgTag;
+
+            public:
+                SensorHub(Clock *aClock);
+                ~SensorHub();
+
+                /**
+                 * Register a listener. Listeners must be added before opening the hub.
+                 */
+                void addListener(SensorListener *i_listener);
+
+                /**
+                 * Open the stream ports and connect them to the robot and nano17 ports.
+                 * @param i_portNameRoot the module port name prefix
+                 * @param i_robotName the robot name
+                 * @param i_whichArm the arm (left|right)
+                 * @param i_carrier the network carrier
+                 * @param i_shmem set to true to connect the co-located producers over shared memory
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_portNameRoot, const std::string &i_robotName, const std::string &i_whichArm,
+                        const std::string &i_carrier = "udp", const bool i_shmem = false);
+
+                /**
+                 * Generate the streams from the simulated plant instead of reading the ports.
+                 * @param i_hand the simulated plant
+                 * @param i_period the sampling period in ms
+                 * @return true/false on success/failure
+                 */
+                bool openSimulated(SimulatedHand *i_hand, const int i_period);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Forward a sample to all listeners. Samples of the internal streams are dropped.
+                 */
+                void dispatch(const SensorStream i_stream, const yarp::sig::Vector &i_data, const yarp::os::Stamp &i_envelope);
+
+                /**
+                 * Produce a stream within the module, in place of its port. Must be called before opening the hub.
+                 */
+                void setInternal(const SensorStream i_stream);
+
+                /**
+                 * Forward a sample of an internal stream to all listeners, in the calling thread.
+                 */
+                void inject(const SensorStream i_stream, const yarp::sig::Vector &i_data, const yarp::os::Stamp &i_envelope);
+
+                /**
+                 * Get the transport of each stream.
+                 * @return one line per stream with its producer and carrier
+                 */
+                std::string getTransports(void);
+
+                /**
+                 * Get the name of a stream.
+                 */
+                static const char* getStreamName(const SensorStream i_stream);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SENSORLISTENER_H__
+#define __ICUB_INTERACTIONFORCES_SENSORLISTENER_H__
+
+#include <cstddef>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The sensor streams read by the module.
+         */
+        enum SensorStream {
+            /** Raw hand skin, 192 taxels. */
+            STREAM_SKIN_RAW = 0,
+            /** Compensated hand skin, 192 taxels. */
+            STREAM_SKIN_COMP,
+            /** nano17 wrench (Fx Fy Fz Tx Ty Tz). */
+            STREAM_WRENCH,
+            /** Arm joint positions. */
+            STREAM_JOINTS,
+            N_SENSOR_STREAMS
+        };
+
+
+        /**
+         * A single sample of a sensor stream.
+         * The data pointer is only valid for the duration of the callback.
+         */
+        struct SensorSample {
+            /** The sample values. */
+            const double *data;
+
+            /** The number of values. */
+            size_t size;
+
+            /** The envelope sequence number, -1 if not available. */
+            int seq;
+
+            /** The envelope timestamp set by the producer, 0 if not available. */
+            double envTime;
+
+            /** The receive time on the module clock. */
+            double rxTime;
+        };
+
+
+        /**
+         * Interface of the components processing the sensor streams.
+         * Samples of different streams are delivered on different threads, hence listeners consuming more than
+         * one stream must take care of their own synchronisation. Samples of the same stream are delivered in order.
+         */
+        class SensorListener {
+            public:
+                virtual ~SensorListener() {}
+
+                /**
+                 * Process a new sample.
+                 * @param i_stream the stream the sample belongs to
+                 * @param i_sample the sample
+                 */
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample) = 0;
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
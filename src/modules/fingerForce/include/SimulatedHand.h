@@ -0,0 +1,263 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SIMULATEDHAND_H__
+#define __ICUB_INTERACTIONFORCES_SIMULATEDHAND_H__
+
+#include "Clock.h"
+
+#include <vector>
+#include <string>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/sig/Vector.h>
+#include <yarp/dev/IPositionControl.h>
+#include <yarp/dev/IEncoders.h>
+#include <yarp/dev/IControlMode2.h>
+#include <yarp/dev/IImpedanceControl.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * A digit which can come in contact with the pinched object.
+         */
+        struct ContactDigit {
+            /** The joint moving the digit towards the object. */
+            int joint;
+
+            /** The joint position at which the fingertip touches the object. */
+            double contactPos;
+
+            /** The fingertip index in the hand skin (0 index, 1 middle, 2 ring, 3 little, 4 thumb). */
+            int fingertip;
+
+            /** The current normal force in N. */
+            double force;
+        };
+
+
+        /**
+         * In-process simulation of the arm control board, used in place of the remote_controlboard device.
+         *
+         * Each joint follows the commanded position through a rate limiter (the reference speed) and a
+         * first-order lag. Joints listed as contact digits are stopped by a spring-like object: the achieved
+         * position is the equilibrium between the joint servo stiffness and the object stiffness, and the
+         * resulting force drives synthetic fingertip taxels and the object wrench.
+         * Joints in impedance position mode use their impedance stiffness against the object, and their lag is
+         * slowed down by damping / stiffness.
+         * The plant is integrated lazily on the module clock whenever it is queried.
+         */
+        class SimulatedHand : public yarp::dev::IPositionControl, public yarp::dev::IEncoders,
+                              public yarp::dev::IControlMode2, public yarp::dev::IImpedanceControl {
+            public:
+                /** The number of taxels in the hand skin. */
+                static const int N_TAXELS = 192;
+
+                /** The number of taxels in each fingertip. */
+                static const int N_FINGERTIP_TAXELS = 12;
+
+            private:
+                Clock *clock;
+                yarp::os::Mutex mutex;
+
+                /* ******* Joint dynamics.                       ******* */
+                int nJoints;
+                /** Integration step in seconds. */
+                double dt;
+                /** Maximum joint speed in deg/s. */
+                std::vector<double> maxSpeed;
+                /** First-order lag time constant in seconds. */
+                std::vector<double> tau;
+                /** Per-step lag filter coefficient, precomputed from tau and dt. */
+                std::vector<double> lagAlpha;
+                /** Joint servo stiffness in N/deg, used against the object stiffness. */
+                double jointStiffness;
+                /** Position tolerance for motion done. */
+                double tolerance;
+
+                /* ******* Control modes.                        ******* */
+                std::vector<int> controlMode;
+                std::vector<double> impStiffness;
+                std::vector<double> impDamping;
+                std::vector<double> impOffset;
+                /** Per-step lag filter coefficient in impedance mode. */
+                std::vector<double> impAlpha;
+
+                /* ******* Joint state.                          ******* */
+                std::vector<double> target;
+                std::vector<double> reference;
+                std::vector<double> position;
+                std::vector<double> velocity;
+                std::vector<double> acceleration;
+                std::vector<double> refSpeed;
+                std::vector<double> refAccel;
+                double lastUpdate;
+                bool settled;
+
+                /* ******* Contact model.                        ******* */
+                std::vector<ContactDigit> digits;
+                /** The contact digit moved by each joint, -1 if none. */
+                std::vector<int> jointDigit;
+                /** Object stiffness in N/deg. */
+                double objectStiffness;
+                /** Taxel response per N of normal force. */
+                double taxelGain;
+                /** Raw taxel value when nothing is touching the skin. */
+                double taxelBaseline;
+                /** Ratio between tangential and normal force. */
+                double tangentialRatio;
+                /** Spatial taxel response within a fingertip. */
+                std::vector<double> taxelWeights;
+
+                /* ******* Noise.                                ******* */
+                double encNoise;
+                double skinNoise;
+                double ftNoise;
+                unsigned long long rngState;
+                bool hasSpareGauss;
+                double spareGauss;
+
+                std::string dbgTag;
+
+            public:
+                SimulatedHand(Clock *aClock);
+                virtual ~SimulatedHand();
+
+                /**
+                 * Configure the plant from the [plant] parameter group.
+                 * @param i_group the configuration group
+                 * @param i_initPos the initial joint positions
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::vector<double> &i_initPos);
+
+                /**
+                 * Get the synthetic hand skin.
+                 * @param o_raw the raw taxel values
+                 * @param o_comp the compensated taxel values
+                 */
+                void getSkin(yarp::sig::Vector &o_raw, yarp::sig::Vector &o_comp);
+
+                /**
+                 * Get the synthetic object wrench (Fx Fy Fz Tx Ty Tz).
+                 */
+                void getWrench(yarp::sig::Vector &o_wrench);
+
+                /**
+                 * Get the normal force at each contact digit.
+                 */
+                void getContactForces(std::vector<double> &o_forces);
+
+                /* ******* IPositionControl.                     ******* */
+                virtual bool getAxes(int *ax);
+                virtual bool setPositionMode();
+                virtual bool positionMove(int j, double ref);
+                virtual bool positionMove(const double *refs);
+                virtual bool relativeMove(int j, double delta);
+                virtual bool relativeMove(const double *deltas);
+                virtual bool checkMotionDone(int j, bool *flag);
+                virtual bool checkMotionDone(bool *flag);
+                virtual bool setRefSpeed(int j, double sp);
+                virtual bool setRefSpeeds(const double *spds);
+                virtual bool setRefAcceleration(int j, double acc);
+                virtual bool setRefAccelerations(const double *accs);
+                virtual bool getRefSpeed(int j, double *ref);
+                virtual bool getRefSpeeds(double *spds);
+                virtual bool getRefAcceleration(int j, double *acc);
+                virtual bool getRefAccelerations(double *accs);
+                virtual bool stop(int j);
+                virtual bool stop();
+
+                /* ******* IEncoders.                            ******* */
+                virtual bool resetEncoder(int j);
+                virtual bool resetEncoders();
+                virtual bool setEncoder(int j, double val);
+                virtual bool setEncoders(const double *vals);
+                virtual bool getEncoder(int j, double *v);
+                virtual bool getEncoders(double *encs);
+                virtual bool getEncoderSpeed(int j, double *sp);
+                virtual bool getEncoderSpeeds(double *spds);
+                virtual bool getEncoderAcceleration(int j, double *spds);
+                virtual bool getEncoderAccelerations(double *accs);
+
+                /* ******* IControlMode2.                        ******* */
+                virtual bool setPositionMode(int j);
+                virtual bool setVelocityMode(int j);
+                virtual bool setTorqueMode(int j);
+                virtual bool setImpedancePositionMode(int j);
+                virtual bool setImpedanceVelocityMode(int j);
+                virtual bool setOpenLoopMode(int j);
+                virtual bool getControlMode(int j, int *mode);
+                virtual bool getControlModes(int *modes);
+                virtual bool getControlModes(const int n_joint, const int *joints, int *modes);
+                virtual bool setControlMode(const int j, const int mode);
+                virtual bool setControlModes(const int n_joint, const int *joints, int *modes);
+                virtual bool setControlModes(int *modes);
+
+                /* ******* IImpedanceControl.                    ******* */
+                virtual bool getImpedance(int j, double *stiffness, double *damping);
+                virtual bool setImpedance(int j, double stiffness, double damping);
+                virtual bool setImpedanceOffset(int j, double offset);
+                virtual bool getImpedanceOffset(int j, double *offset);
+                virtual bool getCurrentImpedanceLimit(int j, double *min_stiff, double *max_stiff, double *min_damp, double *max_damp);
+
+            private:
+                /**
+                 * Set the control mode of a joint. Only position and impedance position are supported.
+                 * Must be called with the mutex held.
+                 */
+                bool applyControlMode(const int &i_joint, const int &i_mode);
+
+                /**
+                 * Integrate the plant up to the current clock time. Must be called with the mutex held.
+                 */
+                void update();
+
+                /**
+                 * Integrate a single step of the given length.
+                 */
+                void step(const double &i_dt);
+
+                /**
+                 * Check whether a joint has reached its target. Must be called with the mutex held.
+                 */
+                bool jointDone(const int &i_joint) const;
+
+                /**
+                 * Get the equilibrium position of a joint given its reference. Contact joints stop against the object.
+                 */
+                double equilibrium(const int &i_joint, const double &i_reference) const;
+
+                /**
+                 * Draw a sample from the standard normal distribution.
+                 */
+                double gauss();
+
+                /**
+                 * Read a per-joint parameter given either as a scalar or as a list of nJoints values.
+                 */
+                bool readJointParam(const yarp::os::Bottle &i_group, const std::string &i_key, const double &i_default, std::vector<double> &o_values);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SKINCOMPENSATOR_H__
+#define __ICUB_INTERACTIONFORCES_SKINCOMPENSATOR_H__
+
+#include "SensorListener.h"
+#include "SensorHub.h"
+#include "SegmentIndex.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Drift compensation of the raw hand skin, synchronised with the pinch phases.
+         * The baseline of each taxel is an exponential average of the raw skin, updated only while the fingers are
+         * known to be free: at rest between the pinches, once the skin has settled, and before the first pinch.
+         * The compensated skin, baseline minus raw clipped at zero as in the skinManager, is published on its
+         * own port and, if enabled, replaces the skinManager compensated stream for the module listeners.
+         */
+        class SkinCompensator : public SensorListener {
+            private:
+                SensorHub *hub;
+
+                /** The baseline adaptation rate per sample. */
+                double rate;
+
+                /** The time after the start of a rest phase before the baseline adapts. */
+                double settle;
+
+                /** Set to true to replace the skinManager compensated stream. */
+                bool replace;
+
+                /* ******* Phase, set by the pinching thread.           ******* */
+                yarp::os::Mutex mutex;
+                bool learning;
+                double learnFrom;
+
+                /* ******* Stream thread state.                         ******* */
+                std::vector<double> baseline;
+                bool initialised;
+                unsigned int updates;
+                yarp::sig::Vector comp;
+                yarp::os::BufferedPort<yarp::sig::Vector> compPort;
+
+                std::string dbgTag;
+
+            public:
+                SkinCompensator(SensorHub *aHub);
+                virtual ~SkinCompensator();
+
+                /**
+                 * Configure the compensator from the [compensation] parameter group and open the output port.
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Set the current pinch phase. The baseline adapts only during the rest phases.
+                 * @param i_phase the phase
+                 * @param i_time the phase start on the module clock
+                 */
+                void setPhase(const PinchPhase i_phase, const double &i_time);
+
+                /**
+                 * Get the number of baseline updates so far.
+                 */
+                unsigned int getUpdates(void);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+            private:
+                /**
+                 * Update the baseline and compensate a raw sample. Written as plain loops over contiguous arrays
+                 * so that the compiler vectorises them.
+                 */
+                static void compensate(const double *i_raw, double *io_baseline, double *o_comp, const int &i_n,
+                        const double &i_rate, const bool &i_learn);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
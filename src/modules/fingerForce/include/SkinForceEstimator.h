@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SKINFORCEESTIMATOR_H__
+#define __ICUB_INTERACTIONFORCES_SKINFORCEESTIMATOR_H__
+
+#include "SensorListener.h"
+#include "SkinForceModel.h"
+
+#include <string>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Online estimation of the fingertip forces from the compensated skin with the calibrated models.
+         * Each skin sample is published as (stamp fingertip force fingertip force ...), for the calibrated fingertips.
+         */
+        class SkinForceEstimator : public SensorListener {
+            private:
+                SkinForceModel model;
+                yarp::os::BufferedPort<yarp::os::Bottle> forcePort;
+
+                std::string dbgTag;
+
+            public:
+                SkinForceEstimator();
+                virtual ~SkinForceEstimator();
+
+                /**
+                 * Load the models and open the output port.
+                 * @param i_file the model file written by calibrationFit
+                 * @return true/false on success/failure
+                 */
+                bool configure(const std::string &i_file, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                const SkinForceModel& getModel(void) const { return model; }
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
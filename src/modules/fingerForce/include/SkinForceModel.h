@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SKINFORCEMODEL_H__
+#define __ICUB_INTERACTIONFORCES_SKINFORCEMODEL_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The skin to force model of a fingertip.
+         */
+        struct FingertipModel {
+            /** The fingertip index. */
+            int fingertip;
+
+            /** The feature weights, see SkinForceModel::features(). */
+            std::vector<double> weights;
+
+            /** The regularisation selected by cross-validation. */
+            double lambda;
+
+            /** The number of fitted samples. */
+            int samples;
+
+            /** The training and cross-validated root mean square errors in N. */
+            double rmse;
+            double cvRmse;
+        };
+
+
+        /**
+         * Per-fingertip linear model of the pinching force from the compensated skin.
+         * The features of a fingertip are a bias, its 12 taxels and the squared taxel sum, which accounts for the
+         * saturation of the taxel response at high forces.
+         * The models are fitted offline by the calibrationFit tool and stored as a configuration file with one
+         * [fingertip_<i>] group per fingertip, loaded by the module at startup.
+         */
+        class SkinForceModel {
+            public:
+                /** The number of features. */
+                static const int N_FEATURES = 14;
+
+            private:
+                std::vector<FingertipModel> models;
+
+                std::string dbgTag;
+
+            public:
+                SkinForceModel();
+
+                /**
+                 * Load the models from a file.
+                 * @return true/false on success/failure
+                 */
+                bool load(const std::string &i_file);
+
+                /**
+                 * Save the models to a file.
+                 * @return true/false on success/failure
+                 */
+                bool save(const std::string &i_file) const;
+
+                void setModels(const std::vector<FingertipModel> &i_models) { models = i_models; }
+                const std::vector<FingertipModel>& getModels(void) const { return models; }
+
+                /**
+                 * Get the model of a fingertip.
+                 * @return the model, NULL if the fingertip is not calibrated
+                 */
+                const FingertipModel* find(const int &i_fingertip) const;
+
+                /**
+                 * Estimate the force on a fingertip from a compensated skin sample (192 taxels).
+                 * @return false if the fingertip is not calibrated or the sample is too short
+                 */
+                bool predict(const int &i_fingertip, const double *i_skin, const size_t &i_size, double &o_force) const;
+
+                /**
+                 * Compute the features of a fingertip.
+                 * @param i_taxels the 12 taxels of the fingertip
+                 * @param o_features the N_FEATURES features
+                 */
+                static void features(const double *i_taxels, double *o_features);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SLIPDETECTOR_H__
+#define __ICUB_INTERACTIONFORCES_SLIPDETECTOR_H__
+
+#include "SensorListener.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * A detected slip.
+         */
+        struct SlipEvent {
+            /** The source of the event: the fingertip index (0-4) or SlipDetector::SOURCE_FT. */
+            int source;
+
+            /** The sample timestamp (envelope time if available, else receive time). */
+            double stamp;
+
+            /** The windowed energy that triggered the event. */
+            double energy;
+
+            /** The baseline energy at the time of the event. */
+            double baseline;
+        };
+
+
+        /**
+         * Streaming slip and micro-vibration detector.
+         * For each monitored fingertip the detector computes the energy of the first difference of the
+         * compensated taxels, and for the nano17 the energy of the first difference of the tangential axes
+         * (Fx, Fy). Each energy is summed over a sliding window and compared with a slowly adapting baseline.
+         * While armed, a window energy above threshold times the baseline emits a timestamped slip event.
+         * The baselines are re-seeded from the current windows when the detector is armed, and keep adapting at a
+         * lower rate while above threshold, so that a step change in the contact load does not latch the detector.
+         * All buffers are allocated at configuration time.
+         */
+        class SlipDetector : public SensorListener {
+            public:
+                /** Event source of the nano17 tangential channel. */
+                static const int SOURCE_FT = 5;
+
+            private:
+                /**
+                 * Sliding window energy of a single channel.
+                 */
+                struct EnergyChannel {
+                    std::vector<double> window;
+                    size_t head;
+                    size_t count;
+                    double sum;
+                    double baseline;
+                    double lastEvent;
+                    /** The arming count at which the baseline was last re-seeded. */
+                    unsigned int seeded;
+                };
+
+                /* ******* Parameters.                           ******* */
+                int windowSize;
+                double skinThreshold;
+                double ftThreshold;
+                double skinMinEnergy;
+                double ftMinEnergy;
+                double baselineRate;
+                double latchedRate;
+                double refractory;
+                std::vector<int> fingertips;
+
+                /* ******* Skin state, skin thread only.         ******* */
+                std::vector<double> prevTaxels;
+                bool hasPrevSkin;
+                std::vector<EnergyChannel> skinChannels;
+
+                /* ******* Wrench state, wrench thread only.     ******* */
+                double prevFx;
+                double prevFy;
+                bool hasPrevFt;
+                EnergyChannel ftChannel;
+
+                /* ******* Events.                               ******* */
+                yarp::os::Mutex mutex;
+                bool armed;
+                /** Number of times the detector was armed. */
+                unsigned int armings;
+                int pendingEvents;
+                unsigned int totalEvents;
+                SlipEvent lastSlip;
+                yarp::os::BufferedPort<yarp::os::Bottle> eventPort;
+                /** Serialises the events written by the skin and the nano17 threads. */
+                yarp::os::Mutex portMutex;
+
+                std::string dbgTag;
+
+            public:
+                SlipDetector();
+                virtual ~SlipDetector();
+
+                /**
+                 * Configure the detector from the [slip] parameter group and open the event port.
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Arm or disarm the detector. Events are only emitted while armed. Arming re-seeds the baselines.
+                 */
+                void setArmed(const bool i_armed);
+
+                /**
+                 * Get and clear the number of events emitted since the last call.
+                 */
+                int takeEvents();
+
+                /**
+                 * Get the total number of events and the latest event.
+                 * @return false if no event was emitted yet
+                 */
+                bool getLastEvent(SlipEvent &o_event, unsigned int &o_total);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+            private:
+                void resetChannel(EnergyChannel &io_channel);
+
+                /**
+                 * Push a new energy sample in a channel and check for a slip.
+                 */
+                void processEnergy(EnergyChannel &io_channel, const double &i_energy, const double &i_threshold,
+                        const double &i_minEnergy, const int &i_source, const double &i_stamp);
+
+                void emit(const SlipEvent &i_event);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,194 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_STALLDETECTOR_H__
+#define __ICUB_INTERACTIONFORCES_STALLDETECTOR_H__
+
+#include "SensorListener.h"
+#include "ContactSource.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * First order adaptive window differentiator.
+         * The derivative is the slope between the latest sample and the oldest one of the longest window, up to
+         * the maximum, whose intermediate samples all lie within the noise bound of that line. Long windows filter
+         * the noise at constant speed, short windows follow the speed changes with little delay.
+         */
+        class AdaptiveDerivative {
+            private:
+                size_t maxWindow;
+                double noise;
+
+                /** Ring of the latest samples. */
+                std::vector<double> times;
+                std::vector<double> values;
+                size_t head;
+                size_t count;
+
+            public:
+                AdaptiveDerivative();
+
+                /**
+                 * Set up the differentiator.
+                 * @param i_maxWindow the maximum window in samples
+                 * @param i_noise the noise bound of the differentiated signal
+                 */
+                void setup(const size_t &i_maxWindow, const double &i_noise);
+
+                void reset(void);
+
+                /**
+                 * Add a sample and estimate the derivative.
+                 * @param o_window the window used, in samples
+                 * @return false until two samples are available
+                 */
+                bool update(const double &i_time, const double &i_value, double &o_derivative, size_t &o_window);
+        };
+
+
+        /**
+         * Contact detection from the encoders of the pinching joints.
+         * The velocity and acceleration of the finger joint and of the thumb (joint 9) are estimated with adaptive
+         * window differentiators. A joint commanded towards a target stalls when its speed stays below the stall
+         * velocity for the stall time while still away from the target, once it has moved or the start timeout has
+         * elapsed. The onset is the time of the peak deceleration before the stall, or the stall start.
+         * The detection latency is thus bounded by the stall time plus the differentiator delay, and is measured
+         * for each onset.
+         */
+        class StallDetector : public SensorListener, public ContactSource {
+            public:
+                /** Event sources of the pinching joints. */
+                static const int SOURCE_FINGER_JOINT = 6;
+                static const int SOURCE_THUMB_JOINT = 7;
+
+            private:
+                /**
+                 * Detection state of a single joint, only accessed by the joint stream thread.
+                 */
+                struct JointChannel {
+                    int source;
+                    int joint;
+
+                    AdaptiveDerivative velocityFilter;
+                    AdaptiveDerivative accelerationFilter;
+                    double velocity;
+                    double acceleration;
+
+                    /** The command this channel was reset for. */
+                    unsigned int command;
+                    double start;
+                    bool moved;
+                    bool stalling;
+                    double stallStart;
+                    double stallStartRx;
+                    double impact;
+                    double peakDeceleration;
+                    bool found;
+                };
+
+                /* ******* Parameters.                           ******* */
+                double stallVelocity;
+                double moveVelocity;
+                double stallTime;
+                double minError;
+                double startTimeout;
+                int maxWindow;
+
+                /* ******* Channels.                             ******* */
+                std::vector<JointChannel> channels;
+
+                /* ******* Commands and onsets.                  ******* */
+                yarp::os::Mutex mutex;
+                bool armed;
+                int pinch;
+                /** The joint of each channel, applied by the stream thread. */
+                std::vector<int> joints;
+                std::vector<bool> commanded;
+                std::vector<double> targets;
+                std::vector<double> commandTimes;
+                std::vector<unsigned int> commands;
+                std::vector<ContactOnset> onsets;
+
+                /** Detection latency statistics. */
+                unsigned int nLatency;
+                double latencySum;
+                double latencyMax;
+
+                yarp::os::BufferedPort<yarp::os::Bottle> eventPort;
+
+                std::string dbgTag;
+
+            public:
+                StallDetector();
+                virtual ~StallDetector();
+
+                /**
+                 * Configure the detector from the [stall] parameter group and open the event port.
+                 * @param i_fingerJoint the pinching finger joint
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName, const int &i_fingerJoint);
+
+                void interrupt();
+                void close();
+
+                /**
+                 * Change the pinching finger joint.
+                 */
+                void setup(const int &i_fingerJoint);
+
+                /**
+                 * Notify a position command of a joint. Only commanded joints can stall.
+                 * @param i_joint the joint index, ignored if not monitored
+                 * @param i_target the commanded position
+                 * @param i_time the command time on the module clock
+                 */
+                void command(const int &i_joint, const double &i_target, const double &i_time);
+
+                virtual void arm(const int &i_pinch);
+                virtual void disarm();
+                virtual int getOnsets(ContactOnset *o_onsets, const int &i_size);
+
+                /**
+                 * Get the detection latency statistics.
+                 */
+                std::string getReport(void);
+
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+            private:
+                void setupChannel(JointChannel &o_channel, const int &i_source, const int &i_joint);
+
+                void emit(const ContactOnset &i_onset);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
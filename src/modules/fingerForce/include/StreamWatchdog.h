@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_STREAMWATCHDOG_H__
+#define __ICUB_INTERACTIONFORCES_STREAMWATCHDOG_H__
+
+#include "Clock.h"
+#include "ClockedRateThread.h"
+#include "SensorListener.h"
+
+#include <string>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * The health of a sensor stream.
+         */
+        enum StreamStatus {
+            /** No sample received yet. */
+            STATUS_IDLE = 0,
+            STATUS_OK,
+            /** Low rate, sequence gaps or high latency. */
+            STATUS_DEGRADED,
+            /** No sample within the stall timeout. */
+            STATUS_STALLED
+        };
+
+
+        /**
+         * Health statistics of a sensor stream.
+         */
+        struct StreamHealth {
+            StreamStatus status;
+
+            /** Arrival rate over the last check period and its nominal value, in Hz. */
+            double rate;
+            double nominalRate;
+
+            /** Filtered inter-arrival jitter (mean absolute deviation from the period), in s. */
+            double jitter;
+
+            /** Filtered envelope to receive latency, in s. Zero if the producer sets no envelope. */
+            double latency;
+
+            /** Fraction of samples lost over the last check period, from the sequence gaps. */
+            double dropRate;
+
+            /** Total number of samples received and lost. */
+            unsigned int samples;
+            unsigned int drops;
+
+            /** Time since the latest sample, in s. */
+            double age;
+        };
+
+
+        /**
+         * Health monitor of the sensor streams.
+         * Every sample updates, in its stream thread, a handful of counters and filters under a per-stream lock.
+         * The watchdog thread periodically turns them into a status, publishes the status changes and keeps a
+         * snapshot for the queries.
+         */
+        class StreamWatchdog : public ClockedRateThread, public SensorListener {
+            private:
+                /**
+                 * State of a single stream.
+                 */
+                struct StreamState {
+                    yarp::os::Mutex mutex;
+
+                    /* ******* Updated on every sample.              ******* */
+                    unsigned int samples;
+                    unsigned int drops;
+                    int lastSeq;
+                    double lastRx;
+                    double period;
+                    double jitter;
+                    double latency;
+
+                    /* ******* Watchdog thread only.                 ******* */
+                    unsigned int checkSamples;
+                    unsigned int checkDrops;
+                };
+
+                StreamState states[N_SENSOR_STREAMS];
+
+                /** Snapshot of the stream health, guarded by healthMutex. */
+                StreamHealth health[N_SENSOR_STREAMS];
+                yarp::os::Mutex healthMutex;
+
+                double lastCheck;
+
+                /* ******* Parameters.                           ******* */
+                double stallTimeout;
+                double rateRatio;
+                double maxDropRate;
+                double maxLatency;
+                double maxJitter;
+                double filter;
+
+                yarp::os::BufferedPort<yarp::os::Bottle> eventPort;
+
+                std::string dbgTag;
+
+            public:
+                StreamWatchdog(const int aPeriod, Clock *aClock);
+
+                /**
+                 * Configure the watchdog from the [watchdog] parameter group and open the event port.
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                virtual bool threadInit();
+                virtual void run();
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+                /**
+                 * Check that no stream is degraded or stalled. Streams which never delivered a sample are ignored.
+                 */
+                bool isHealthy();
+
+                /**
+                 * Get the health of a stream.
+                 */
+                StreamHealth getHealth(const SensorStream i_stream);
+
+                /**
+                 * Get a report of all streams, one line per stream.
+                 */
+                std::string getReport();
+
+                static const char* getStatusName(const StreamStatus i_status);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_TRANSPORT_H__
+#define __ICUB_INTERACTIONFORCES_TRANSPORT_H__
+
+#include <string>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Connection of the module input ports to their producers.
+         * A producer on the same host as the module is connected over shared memory, which avoids the network
+         * stack and its copies; other producers, or co-located ones for which shared memory fails, are connected
+         * with the network carrier.
+         */
+        class Transport {
+            public:
+                /**
+                 * Connect a producer to a local input port.
+                 * @param i_remote the producer port
+                 * @param i_local the local input port
+                 * @param i_carrier the network carrier (udp, tcp, mcast)
+                 * @param i_shmem set to true to use shared memory with co-located producers
+                 * @return the carrier of the connection, empty if not connected
+                 */
+                static std::string connect(const std::string &i_remote, const std::string &i_local, const std::string &i_carrier,
+                        const bool i_shmem);
+
+                /**
+                 * Check whether two ports are registered on the same host.
+                 */
+                static bool isColocated(const std::string &i_remote, const std::string &i_local);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_VISUALFEED_H__
+#define __ICUB_INTERACTIONFORCES_VISUALFEED_H__
+
+#include "Clock.h"
+#include "ClockedRateThread.h"
+#include "SensorListener.h"
+
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Decimated feed of the sensor streams for the port scopes.
+         * Every sample widens, in its stream thread, the min/max envelope of the selected channels. At each
+         * display period the feed thread publishes the envelopes as a single vector, (min max) per channel, and
+         * starts new ones. A display column thus keeps the peaks of all the samples it covers, at the cost of a
+         * single port at the display rate in place of one full vector subscription per plot.
+         * Channels without samples in a period repeat their latest value.
+         */
+        class VisualFeed : public ClockedRateThread, public SensorListener {
+            private:
+                /**
+                 * Envelopes of the selected channels of a single stream.
+                 */
+                struct StreamChannels {
+                    yarp::os::Mutex mutex;
+
+                    /** The selected indices of the stream vector. */
+                    std::vector<int> indices;
+
+                    /** Offset of the first channel in the published vector, in channels. */
+                    size_t offset;
+
+                    /* ******* Updated on every sample.              ******* */
+                    std::vector<double> lo;
+                    std::vector<double> hi;
+                    std::vector<double> last;
+                    bool filled;
+                };
+
+                StreamChannels channels[N_SENSOR_STREAMS];
+                size_t nChannels;
+
+                yarp::os::BufferedPort<yarp::sig::Vector> scopePort;
+                int count;
+
+                std::string dbgTag;
+
+            public:
+                VisualFeed(const int aPeriod, Clock *aClock);
+
+                /**
+                 * Configure the feed from the [scope] parameter group and open the output port.
+                 * @return true/false on success/failure
+                 */
+                bool configure(const yarp::os::Bottle &i_group, const std::string &i_portName);
+
+                void interrupt();
+                void close();
+
+                virtual void run();
+                virtual void onSample(const SensorStream i_stream, const SensorSample &i_sample);
+
+                /**
+                 * Get the layout of the published vector.
+                 * @return one line per channel with the indices of its min and max, its stream and its stream index
+                 */
+                std::string getLayout(void);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "Clock.h"
+#include "TestCheck.h"
+
+#include <cstdlib>
+
+#include <yarp/os/Thread.h>
+#include <yarp/os/Time.h>
+
+using iCub::interactionForces::SimulatedClock;
+using iCub::interactionForces::ClockParticipant;
+
+
+/**
+ * A registered thread stepping the simulated clock until told to stop.
+ */
+class Stepper : public yarp::os::Thread {
+    private:
+        SimulatedClock &clock;
+
+    public:
+        volatile bool registered;
+        volatile bool done;
+
+        Stepper(SimulatedClock &aClock) : clock(aClock), registered(false), done(false) {}
+
+        void run() {
+            ClockParticipant participant(&clock);
+            registered = true;
+            while (!done) {
+                clock.delay(0.01);
+            }
+        }
+};
+
+
+/**
+ * Wait in wall time for the simulated time to pass the given time.
+ * @return false if the simulated time froze
+ */
+static bool waitSimTime(SimulatedClock &i_clock, const double &i_time) {
+    double deadline = yarp::os::Time::now() + 2.0;
+    while (i_clock.now() < i_time) {
+        if (yarp::os::Time::now() > deadline) {
+            return false;
+        }
+        yarp::os::Time::delay(0.001);
+    }
+
+    return true;
+}
+
+
+/**
+ * A registered participant alone advances the time at its own pace.
+ */
+static void testParticipant(void) {
+    SimulatedClock clock(10.0);
+    Stepper stepper(clock);
+    stepper.start();
+
+    CHECK(waitSimTime(clock, 11.0));
+    stepper.done = true;
+    stepper.stop();
+}
+
+
+/**
+ * A one-shot delay of an unregistered thread while a participant keeps stepping: the transient sleeper
+ * wakes up on time and the participant is not left waiting for it afterwards.
+ */
+static void testTransient(void) {
+    SimulatedClock clock;
+    Stepper *stepper = new Stepper(clock);
+    stepper->start();
+    while (!stepper->registered) {
+        yarp::os::Time::delay(0.001);
+    }
+
+    double start = clock.now();
+    clock.delay(0.005);
+    CHECK(clock.now() >= start + 0.005);
+
+    bool running = waitSimTime(clock, clock.now() + 0.5);
+    CHECK(running);
+    if (!running) {
+        // The stepper is blocked on the frozen clock and cannot be joined
+        std::cerr << "The simulated time froze after a transient delay. \n";
+        std::exit(1);
+    }
+    stepper->done = true;
+    stepper->stop();
+    delete stepper;
+}
+
+
+/**
+ * Without participants the delays of unregistered threads complete immediately.
+ */
+static void testUnregistered(void) {
+    SimulatedClock clock(1.0);
+    double wall = yarp::os::Time::now();
+    clock.delay(100.0);
+    CHECK_CLOSE(clock.now(), 101.0, 1e-9);
+    CHECK(yarp::os::Time::now() - wall < 1.0);
+}
+
+
+int main(void) {
+    testUnregistered();
+    testParticipant();
+    testTransient();
+
+    return TEST_RESULT;
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "ControlLog.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::ControlLog;
+
+
+#define N_PRODUCERS 4
+#define N_LINES 5000
+
+
+/**
+ * A thread printing its numbered lines.
+ */
+class Producer : public yarp::os::Thread {
+    private:
+        ControlLog &log;
+        int id;
+
+    public:
+        Producer(ControlLog &aLog, const int &aId) : log(aLog), id(aId) {}
+
+        void run() {
+            for (int k = 0; k < N_LINES; ++k) {
+                log.print("producer %d line %d\n", id, k);
+            }
+        }
+};
+
+
+/**
+ * Run the producers on a deferred log and capture the console output.
+ */
+static string produce(ControlLog &io_log, const int &i_capacity) {
+    stringstream captured;
+    std::streambuf *console = std::cout.rdbuf(captured.rdbuf());
+
+    CHECK(io_log.start(i_capacity));
+    CHECK(io_log.isDeferred());
+    vector<Producer*> producers;
+    for (int i = 0; i < N_PRODUCERS; ++i) {
+        producers.push_back(new Producer(io_log, i));
+    }
+    for (int i = 0; i < N_PRODUCERS; ++i) {
+        producers[i]->start();
+    }
+    for (int i = 0; i < N_PRODUCERS; ++i) {
+        producers[i]->stop();
+        delete producers[i];
+    }
+    io_log.stop();
+
+    std::cout.rdbuf(console);
+    return captured.str();
+}
+
+/**
+ * Check the captured lines: each is whole and the lines of each producer come in order.
+ * @return the number of lines
+ */
+static int checkLines(const string &i_text) {
+    stringstream lines(i_text);
+    string line;
+    vector<int> last(N_PRODUCERS, -1);
+    int count = 0;
+    while (std::getline(lines, line)) {
+        int id = -1;
+        int k = -1;
+        bool whole = (sscanf(line.c_str(), "producer %d line %d", &id, &k) == 2) && (id >= 0) && (id < N_PRODUCERS);
+        CHECK(whole);
+        if (!whole) {
+            return -1;
+        }
+        CHECK(k > last[id]);
+        last[id] = k;
+        count++;
+    }
+
+    return count;
+}
+
+
+/**
+ * With room for every line, the lines of concurrent producers are all printed, each producer's in order.
+ */
+static void testOrder(void) {
+    ControlLog log;
+    string text = produce(log, N_PRODUCERS * N_LINES);
+    CHECK(log.getDropped() == 0);
+    CHECK(checkLines(text) == N_PRODUCERS * N_LINES);
+}
+
+
+/**
+ * A small ring drops and counts the lines it has no room for, and keeps the order of the others.
+ */
+static void testWrap(void) {
+    ControlLog log;
+    string text = produce(log, 16);
+    int printed = checkLines(text);
+    CHECK(printed > 0);
+    CHECK(printed + (int) log.getDropped() == N_PRODUCERS * N_LINES);
+}
+
+
+/**
+ * Until started, and once stopped, the lines are printed by the caller; multi-line texts are split.
+ */
+static void testDirect(void) {
+    stringstream captured;
+    std::streambuf *console = std::cout.rdbuf(captured.rdbuf());
+    ControlLog log;
+    log.print("value %d\n", 42);
+    log.printLines("first\nsecond");
+    std::cout.rdbuf(console);
+
+    CHECK(!log.isDeferred());
+    CHECK(captured.str() == "value 42\nfirst\nsecond\n");
+}
+
+
+int main(void) {
+    testDirect();
+    testOrder();
+    testWrap();
+
+    return TEST_RESULT;
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "CalibrationFit.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <vector>
+
+using std::vector;
+
+using iCub::interactionForces::FitStats;
+
+
+#define N_FEATURES 4
+
+/** The weights of the synthetic model, bias first. */
+static const double WEIGHTS[N_FEATURES] = {0.75, 2.0, -1.5, 0.25};
+
+
+/**
+ * The features of a sample, with a deterministic spread: the constant 1 first.
+ */
+static void features(const int &i_k, double *o_x) {
+    o_x[0] = 1.0;
+    o_x[1] = sin(0.37 * i_k) * 3.0 + 10.0;
+    o_x[2] = cos(0.11 * i_k) * 0.5;
+    o_x[3] = (i_k % 17) - 8.0;
+}
+
+static double model(const double *i_x) {
+    double y = 0.0;
+    for (int i = 0; i < N_FEATURES; ++i) {
+        y += WEIGHTS[i] * i_x[i];
+    }
+
+    return y;
+}
+
+
+/**
+ * Without regularisation an exact linear model is recovered, with no error.
+ */
+static void testExact(void) {
+    FitStats stats(N_FEATURES);
+    double x[N_FEATURES];
+    for (int k = 0; k < 500; ++k) {
+        features(k, x);
+        stats.add(x, model(x));
+    }
+    CHECK(stats.getSamples() == 500.0);
+
+    vector<double> weights;
+    CHECK(stats.solve(0.0, weights));
+    CHECK(weights.size() == N_FEATURES);
+    for (int i = 0; (i < N_FEATURES) && (i < (int) weights.size()); ++i) {
+        CHECK_CLOSE(weights[i], WEIGHTS[i], 1e-6);
+    }
+    CHECK(stats.getError(weights) < 1e-6);
+}
+
+
+/**
+ * Merged partial statistics solve as the whole set, and the error of a model is its sum of squared residuals.
+ */
+static void testMerge(void) {
+    FitStats whole(N_FEATURES), first(N_FEATURES), second(N_FEATURES);
+    double x[N_FEATURES];
+    double sse = 0.0;
+    vector<double> offset(WEIGHTS, WEIGHTS + N_FEATURES);
+    offset[0] += 0.5;
+    for (int k = 0; k < 300; ++k) {
+        features(k, x);
+        // A residual of zero mean, uncorrelated enough with the features
+        double y = model(x) + (((k % 2) == 0) ? 0.1 : -0.1);
+        whole.add(x, y);
+        ((k < 120) ? first : second).add(x, y);
+        sse += (y - model(x) - 0.5) * (y - model(x) - 0.5);
+    }
+    first.merge(second);
+    CHECK(first.getSamples() == whole.getSamples());
+
+    vector<double> a, b;
+    CHECK(whole.solve(0.01, a));
+    CHECK(first.solve(0.01, b));
+    for (int i = 0; i < N_FEATURES; ++i) {
+        CHECK_CLOSE(a[i], b[i], 1e-9);
+    }
+    CHECK_CLOSE(whole.getError(offset), sse, 1e-6 * sse);
+}
+
+
+/**
+ * Regularisation shrinks the standardised weights, a constant feature gets no weight and too few samples
+ * give no fit.
+ */
+static void testDegenerate(void) {
+    FitStats stats(N_FEATURES);
+    double x[N_FEATURES];
+    vector<double> weights;
+    features(0, x);
+    stats.add(x, model(x));
+    CHECK(!stats.solve(0.0, weights));
+
+    stats.reset(N_FEATURES);
+    for (int k = 0; k < 200; ++k) {
+        features(k, x);
+        x[2] = 3.0;
+        stats.add(x, model(x));
+    }
+    CHECK(stats.solve(0.0, weights));
+    CHECK(weights[2] == 0.0);
+    CHECK_CLOSE(weights[1], WEIGHTS[1], 1e-6);
+    CHECK_CLOSE(weights[3], WEIGHTS[3], 1e-6);
+
+    vector<double> ridge;
+    CHECK(stats.solve(1.0, ridge));
+    CHECK(fabs(ridge[1]) < fabs(weights[1]));
+    CHECK(fabs(ridge[3]) < fabs(weights[3]));
+}
+
+
+int main(void) {
+    testExact();
+    testMerge();
+    testDegenerate();
+
+    return TEST_RESULT;
+}
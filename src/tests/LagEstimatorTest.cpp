@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "LagEstimator.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <vector>
+
+using std::vector;
+
+using iCub::interactionForces::LagEstimator;
+using iCub::interactionForces::LagEstimate;
+using iCub::interactionForces::LagSignals;
+
+
+/**
+ * A pinch-like signal: smooth presses of different heights and widths.
+ */
+static double pinches(const double &i_time) {
+    const double centre[] = {0.6, 1.5, 2.3, 3.4};
+    const double width[] = {0.08, 0.15, 0.05, 0.1};
+    const double height[] = {1.0, 2.5, 0.7, 1.8};
+    double value = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        double x = (i_time - centre[i]) / width[i];
+        value += height[i] * exp(-0.5 * x * x);
+    }
+
+    return value;
+}
+
+/**
+ * Sample the signal delayed by the given lag at the given rate, scaled and offset, with a timing jitter.
+ */
+static void sample(const double &i_lag, const double &i_rate, const double &i_scale, const double &i_offset,
+        vector<double> &o_time, vector<double> &o_values) {
+    o_time.clear();
+    o_values.clear();
+    for (int k = 0; k * (1.0 / i_rate) <= 4.0; ++k) {
+        double t = k / i_rate + 0.2e-3 * ((k * 7) % 5) / 4.0;
+        o_time.push_back(t);
+        o_values.push_back(i_offset + i_scale * pinches(t - i_lag));
+    }
+}
+
+
+/**
+ * The lag of a known shifted signal is recovered to a fraction of the grid period, for delays and leads.
+ */
+static void testShift(void) {
+    LagEstimator estimator;
+    CHECK(estimator.setup(4.0, 0.001, 0.2, 0.02));
+
+    const double lags[] = {0.0, 0.0234, 0.1, -0.047};
+    for (int i = 0; i < 4; ++i) {
+        vector<double> forceTime, force, skinTime, skin;
+        sample(0.0, 1000.0, 1.0, 0.0, forceTime, force);
+        sample(lags[i], 100.0, 40.0, 300.0, skinTime, skin);
+
+        LagEstimate estimate;
+        CHECK(estimator.estimate(forceTime, force, skinTime, skin, estimate));
+        CHECK(estimate.valid);
+        CHECK_CLOSE(estimate.lag, lags[i], 0.001);
+        CHECK(estimate.confidence > 0.9);
+    }
+}
+
+
+/**
+ * Signals which do not overlap or are constant give no estimate.
+ */
+static void testInvalid(void) {
+    LagEstimator estimator;
+    CHECK(estimator.setup(4.0, 0.001, 0.2, 0.02));
+
+    vector<double> forceTime, force, skinTime, skin;
+    sample(0.0, 1000.0, 1.0, 0.0, forceTime, force);
+    skinTime.push_back(10.0);
+    skinTime.push_back(11.0);
+    skin.assign(2, 1.0);
+    LagEstimate estimate;
+    CHECK(!estimator.estimate(forceTime, force, skinTime, skin, estimate));
+    CHECK(!estimate.valid);
+
+    sample(0.0, 100.0, 0.0, 5.0, skinTime, skin);
+    CHECK(!estimator.estimate(forceTime, force, skinTime, skin, estimate));
+    CHECK(!estimate.valid);
+}
+
+
+/**
+ * Bounded signals keep the last span of a long recording at a fixed capacity, and give the same estimate.
+ */
+static void testBounded(void) {
+    vector<double> forceTime, force, skinTime, skin;
+    sample(0.0, 1000.0, 1.0, 0.0, forceTime, force);
+    sample(0.03, 100.0, 1.0, 0.0, skinTime, skin);
+
+    LagSignals bounded;
+    vector<int> fingertips(1, 0);
+    bounded.bound(2.5, 2000, 200, fingertips.size());
+    vector<double> taxels(192, 0.0);
+    for (size_t k = 0; k < forceTime.size(); ++k) {
+        double wrench[3] = {0.0, force[k], 0.0};
+        bounded.addWrench(forceTime[k], wrench, 3);
+    }
+    for (size_t k = 0; k < skinTime.size(); ++k) {
+        taxels[0] = skin[k];
+        bounded.addSkin(skinTime[k], &taxels[0], taxels.size(), fingertips);
+    }
+    CHECK(bounded.forceTime.capacity() == 2000);
+    CHECK(bounded.skinTime.capacity() == 200);
+    CHECK(bounded.forceTime.size() == bounded.force.size());
+    CHECK(bounded.skinTime.size() == bounded.skin[0].size());
+    CHECK(bounded.forceTime.back() == forceTime.back());
+    CHECK(bounded.forceTime.back() - bounded.forceTime.front() >= 2.5);
+
+    LagEstimator estimator;
+    CHECK(estimator.setup(2.0, 0.001, 0.2, 0.02));
+    LagEstimate estimate;
+    CHECK(estimator.estimate(bounded.forceTime, bounded.force, bounded.skinTime, bounded.skin[0], estimate));
+    CHECK_CLOSE(estimate.lag, 0.03, 0.001);
+}
+
+
+int main(void) {
+    testShift();
+    testInvalid();
+    testBounded();
+
+    return TEST_RESULT;
+}
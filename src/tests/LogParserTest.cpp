@@ -0,0 +1,200 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "LogParser.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using std::vector;
+
+using iCub::interactionForces::LogParser;
+using iCub::interactionForces::LogRowHandler;
+
+
+/** The log written by the tests, in the working directory. */
+static const char *LOG = "logParserTest.log";
+
+/** The number of rows of the test log. */
+#define N_ROWS 5000
+
+
+/**
+ * Collector of the parsed rows.
+ */
+class Collector : public LogRowHandler {
+    public:
+        vector<double> times;
+        vector< vector<double> > rows;
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            times.push_back(i_time);
+            rows.push_back(vector<double>(i_values, i_values + i_size));
+        }
+};
+
+
+/**
+ * Write a dataDumper log of N_ROWS rows "seq stamp (k -k/8 k*1e-3)" at 1 kHz.
+ */
+static bool writeLog(void) {
+    FILE *file = fopen(LOG, "w");
+    if (file == NULL) {
+        return false;
+    }
+    for (int k = 0; k < N_ROWS; ++k) {
+        fprintf(file, "%d %.6f (%d %.3f %g)\n", k, 1000.0 + 0.001 * k, k, -k / 8.0, k * 1e-3);
+    }
+    fclose(file);
+
+    return true;
+}
+
+static void checkRow(const Collector &i_collector, const size_t &i_i, const int &i_k) {
+    CHECK_CLOSE(i_collector.times[i_i], 1000.0 + 0.001 * i_k, 1e-9);
+    CHECK(i_collector.rows[i_i].size() == 3);
+    if (i_collector.rows[i_i].size() == 3) {
+        CHECK(i_collector.rows[i_i][0] == i_k);
+        CHECK(i_collector.rows[i_i][1] == -i_k / 8.0);
+        CHECK_CLOSE(i_collector.rows[i_i][2], i_k * 1e-3, 1e-12);
+    }
+}
+
+
+/**
+ * Numbers are parsed as strtod does, tokens which are not numbers are skipped.
+ */
+static void testNumbers(void) {
+    const char *numbers[] = {"0", "0.5", "-1.25e3", "+7", "1e-3", "0.1", "3.14159265358979", "-0.000123", "6.02E23", "1400000000.123456"};
+    for (size_t i = 0; i < sizeof(numbers) / sizeof(numbers[0]); ++i) {
+        const char *p = numbers[i];
+        double value = 0.0;
+        CHECK(LogParser::parseNumber(p, numbers[i] + strlen(numbers[i]), value));
+        CHECK(value == strtod(numbers[i], NULL));
+        CHECK(p == numbers[i] + strlen(numbers[i]));
+    }
+
+    const char *line = " (12\tabc -4.5) nan 2e2";
+    const char *end = line + strlen(line);
+    const char *p = line;
+    double value = 0.0;
+    CHECK(LogParser::parseNumber(p, end, value) && (value == 12.0));
+    CHECK(LogParser::parseNumber(p, end, value) && (value == -4.5));
+    CHECK(LogParser::parseNumber(p, end, value) && (value == 200.0));
+    CHECK(!LogParser::parseNumber(p, end, value));
+}
+
+
+/**
+ * The last timestamp is the row time, lists are flattened and lines without the stamps are rejected.
+ */
+static void testLine(void) {
+    vector<double> row(2);
+    double time = 0.0;
+
+    const char *line = "12 1400000000.25 1400000000.5 (1 2 3) (4.5 -6)";
+    LogParser twoStamps(2);
+    CHECK(twoStamps.parseLine(line, line + strlen(line), row, time) == 5);
+    CHECK(time == 1400000000.5);
+    CHECK((row[0] == 1.0) && (row[2] == 3.0) && (row[3] == 4.5) && (row[4] == -6.0));
+
+    LogParser oneStamp(1);
+    CHECK(oneStamp.parseLine(line, line + strlen(line), row, time) == 6);
+    CHECK(time == 1400000000.25);
+    CHECK(row[0] == 1400000000.5);
+
+    const char *invalid = "12";
+    CHECK(oneStamp.parseLine(invalid, invalid + strlen(invalid), row, time) == -1);
+    CHECK(oneStamp.parseLine(invalid, invalid, row, time) == -1);
+}
+
+
+/**
+ * Parsed in chunks, every row is delivered once and in file order, whatever the chunk and block sizes.
+ */
+static void testChunks(void) {
+    const int nChunks[] = {1, 3, 8};
+    const size_t blockSizes[] = {4 << 20, 64, 7};
+    for (int c = 0; c < 3; ++c) {
+        LogParser parser(1, blockSizes[c]);
+        vector<Collector> collectors(nChunks[c]);
+        vector<LogRowHandler*> handlers;
+        for (size_t i = 0; i < collectors.size(); ++i) {
+            handlers.push_back(&collectors[i]);
+        }
+        double bytes = 0.0;
+        CHECK(parser.parse(LOG, handlers, bytes));
+        CHECK(bytes > 0.0);
+
+        int k = 0;
+        for (size_t i = 0; i < collectors.size(); ++i) {
+            for (size_t j = 0; (j < collectors[i].rows.size()) && (k < N_ROWS); ++j, ++k) {
+                checkRow(collectors[i], j, k);
+            }
+        }
+        CHECK(k == N_ROWS);
+    }
+}
+
+
+/**
+ * A range returns exactly its rows, from a recorded offset or by bisection.
+ */
+static void testRange(void) {
+    LogParser parser(1);
+    const int64_t offsets[] = {-1, 0};
+    for (int o = 0; o < 2; ++o) {
+        Collector collector;
+        double bytes = 0.0;
+        CHECK(parser.parseRange(LOG, offsets[o], 1003.0, 1003.4995, &collector, bytes));
+        CHECK(collector.rows.size() == 500);
+        for (size_t i = 0; i < collector.rows.size(); ++i) {
+            checkRow(collector, i, 3000 + (int) i);
+        }
+    }
+
+    // The bisection skips most of the file
+    Collector collector;
+    double bytes = 0.0;
+    CHECK(parser.parseRange(LOG, -1, 1004.9, 1005.0, &collector, bytes));
+    CHECK(collector.rows.size() == 100);
+    FILE *file = fopen(LOG, "rb");
+    fseek(file, 0, SEEK_END);
+    CHECK(bytes < 0.5 * ftell(file));
+    fclose(file);
+}
+
+
+int main(void) {
+    if (!writeLog()) {
+        std::cerr << "Could not write " << LOG << ". \n";
+        return 1;
+    }
+    testNumbers();
+    testLine();
+    testChunks();
+    testRange();
+    remove(LOG);
+
+    return TEST_RESULT;
+}
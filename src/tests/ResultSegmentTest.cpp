@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "ResultStore.h"
+#include "TestCheck.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::stringstream;
+using std::vector;
+
+using iCub::interactionForces::PinchResult;
+using iCub::interactionForces::ResultFilter;
+using iCub::interactionForces::ResultSegment;
+using iCub::interactionForces::N_RESULT_TEXT;
+using iCub::interactionForces::N_RESULT_COLUMNS;
+using iCub::interactionForces::RESULT_SESSION;
+using iCub::interactionForces::RESULT_HAND;
+using iCub::interactionForces::RESULT_FINGER;
+using iCub::interactionForces::RESULT_CONFIG;
+using iCub::interactionForces::RESULT_STAMP;
+using iCub::interactionForces::RESULT_DEPTH;
+using iCub::interactionForces::RESULT_CONTACT;
+using iCub::interactionForces::RESULT_PEAKFORCE;
+
+
+/** The segment written by the tests, in the working directory. */
+static const char *SEGMENT = "resultSegmentTest.seg";
+
+#define N_ROWS 1000
+
+
+/** NaN test, portable to C++98. */
+static bool isNaN(const double &i_value) {
+    return i_value != i_value;
+}
+
+
+/**
+ * The synthetic results: a few sessions, hands and fingers, depths with unknown values.
+ */
+static void makeRows(vector<PinchResult> &o_rows) {
+    const char *hands[2] = {"left", "right"};
+    const char *fingers[3] = {"index", "middle", "thumb"};
+    o_rows.resize(N_ROWS);
+    for (int i = 0; i < N_ROWS; ++i) {
+        PinchResult &row = o_rows[i];
+        stringstream session, config;
+        session << "s" << i / 250;
+        config << "(nPinches 10) (x " << i % 5 << ")";
+        row.text[RESULT_SESSION] = session.str();
+        row.text[RESULT_HAND] = hands[(i / 7) % 2];
+        row.text[RESULT_FINGER] = fingers[(i / 3) % 3];
+        row.text[RESULT_CONFIG] = config.str();
+        row.setStamp(1400000000.0 + 60.0 * i);
+        for (int c = RESULT_STAMP + 2; c < N_RESULT_COLUMNS; ++c) {
+            row.value[c] = 0.5 * ((i * (c + 3)) % 41);
+        }
+        row.value[RESULT_DEPTH] = ((i % 13) == 0) ? std::numeric_limits<double>::quiet_NaN() : (double) (i % 30);
+        row.value[RESULT_CONTACT] = ((i % 4) == 0) ? std::numeric_limits<double>::quiet_NaN() : 0.01 * i;
+    }
+}
+
+/**
+ * The rows satisfying a filter, by brute force.
+ */
+static void reference(const vector<PinchResult> &i_rows, const ResultFilter &i_filter, vector<uint32_t> &o_rows) {
+    o_rows.clear();
+    for (uint32_t i = 0; i < i_rows.size(); ++i) {
+        bool accepted = true;
+        for (int c = 0; c < N_RESULT_TEXT; ++c) {
+            const vector<string> &values = i_filter.values[c];
+            if (!values.empty() && (std::find(values.begin(), values.end(), i_rows[i].text[c]) == values.end())) {
+                accepted = false;
+            }
+        }
+        for (int c = N_RESULT_TEXT; c < N_RESULT_COLUMNS; ++c) {
+            double v = i_rows[i].value[c];
+            if (i_filter.isRange(c) && !((v >= i_filter.min[c]) && (v <= i_filter.max[c]))) {
+                accepted = false;
+            }
+        }
+        if (accepted) {
+            o_rows.push_back(i);
+        }
+    }
+}
+
+static void checkSelect(ResultSegment &io_segment, const vector<PinchResult> &i_rows, const ResultFilter &i_filter) {
+    vector<uint32_t> selected, expected;
+    CHECK(io_segment.select(i_filter, selected));
+    reference(i_rows, i_filter, expected);
+    CHECK(selected == expected);
+}
+
+
+/**
+ * Every row written is read back, the unknown values included.
+ */
+static void testRoundTrip(void) {
+    vector<PinchResult> rows;
+    makeRows(rows);
+    CHECK(ResultSegment::write(SEGMENT, rows));
+
+    ResultSegment segment;
+    CHECK(segment.open(SEGMENT));
+    CHECK(segment.getRows() == N_ROWS);
+    for (uint32_t i = 0; i < N_ROWS; ++i) {
+        PinchResult row;
+        CHECK(segment.getRow(i, row));
+        for (int c = 0; c < N_RESULT_TEXT; ++c) {
+            CHECK(row.text[c] == rows[i].text[c]);
+        }
+        for (int c = N_RESULT_TEXT; c < N_RESULT_COLUMNS; ++c) {
+            CHECK((row.value[c] == rows[i].value[c]) || (isNaN(row.value[c]) && isNaN(rows[i].value[c])));
+        }
+    }
+    PinchResult row;
+    CHECK(!segment.getRow(N_ROWS, row));
+    segment.close();
+}
+
+
+/**
+ * A selection returns the rows a full scan would, in ascending order, through the indexes and zone maps.
+ */
+static void testSelect(void) {
+    vector<PinchResult> rows;
+    makeRows(rows);
+    CHECK(ResultSegment::write(SEGMENT, rows));
+    ResultSegment segment;
+    CHECK(segment.open(SEGMENT));
+
+    ResultFilter all;
+    checkSelect(segment, rows, all);
+
+    ResultFilter byText;
+    byText.values[RESULT_HAND].push_back("left");
+    byText.values[RESULT_FINGER].push_back("index");
+    byText.values[RESULT_FINGER].push_back("thumb");
+    checkSelect(segment, rows, byText);
+
+    ResultFilter byDepth;
+    byDepth.min[RESULT_DEPTH] = 10.0;
+    byDepth.max[RESULT_DEPTH] = 20.0;
+    checkSelect(segment, rows, byDepth);
+
+    ResultFilter combined = byText;
+    combined.min[RESULT_DEPTH] = 10.0;
+    combined.max[RESULT_DEPTH] = 20.0;
+    combined.min[RESULT_STAMP] = 1400000000.0 + 60.0 * 200;
+    combined.max[RESULT_STAMP] = 1400000000.0 + 60.0 * 700;
+    combined.min[RESULT_PEAKFORCE] = 2.0;
+    combined.values[RESULT_SESSION].push_back("s1");
+    combined.values[RESULT_SESSION].push_back("s2");
+    checkSelect(segment, rows, combined);
+
+    // Unknown values are outside every range
+    ResultFilter byContact;
+    byContact.max[RESULT_CONTACT] = 3.0;
+    checkSelect(segment, rows, byContact);
+
+    // Excluded by the zone map and by the dictionary
+    vector<uint32_t> selected;
+    ResultFilter outside;
+    outside.min[RESULT_DEPTH] = 1000.0;
+    CHECK(segment.select(outside, selected));
+    CHECK(selected.empty());
+    ResultFilter unknown;
+    unknown.values[RESULT_HAND].push_back("both");
+    CHECK(segment.select(unknown, selected));
+    CHECK(selected.empty());
+    segment.close();
+}
+
+
+int main(void) {
+    testRoundTrip();
+    testSelect();
+    remove(SEGMENT);
+
+    return TEST_RESULT;
+}
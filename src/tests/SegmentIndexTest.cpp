@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SegmentIndex.h"
+#include "Clock.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::SegmentIndex;
+using iCub::interactionForces::PinchSegment;
+using iCub::interactionForces::PinchPhase;
+using iCub::interactionForces::SimulatedClock;
+
+
+/** The files written by the tests, in the working directory. */
+static const char *INDEX = "segmentIndexTest.idx";
+static const char *STREAMS[2] = {"segmentIndexTestA.log", "segmentIndexTestB.log"};
+
+#define N_PINCHES 3
+
+
+/**
+ * Append the given number of bytes to a stream file.
+ */
+static void appendBytes(const char *i_file, const int &i_bytes) {
+    std::ofstream out(i_file, std::ios::out | std::ios::app | std::ios::binary);
+    out << string(i_bytes, 'x');
+}
+
+
+/**
+ * Phases written while the streams grow are found again, with the stream sizes at their start.
+ */
+static void testWriteLoad(void) {
+    vector<string> names, paths;
+    names.push_back("a");
+    names.push_back("b");
+    for (int i = 0; i < 2; ++i) {
+        paths.push_back(STREAMS[i]);
+        std::ofstream(STREAMS[i], std::ios::out | std::ios::trunc);
+    }
+
+    SimulatedClock clock(100.0);
+    SegmentIndex writer;
+    CHECK(writer.create(INDEX, names, paths, &clock));
+    vector<int64_t> sizes(2, 0);
+    vector<PinchSegment> expected;
+    for (int p = 0; p < N_PINCHES; ++p) {
+        for (int h = iCub::interactionForces::PHASE_PRESS; h < iCub::interactionForces::N_PINCH_PHASES; ++h) {
+            PinchSegment segment;
+            segment.pinch = p;
+            segment.phase = (PinchPhase) h;
+            segment.start = clock.now();
+            segment.fingerDepth = 10.0 + p;
+            segment.thumbDepth = 5.0 + 0.5 * p;
+            segment.offsets = sizes;
+            writer.begin(p, segment.phase, segment.start, segment.fingerDepth, segment.thumbDepth);
+
+            // The samples of the phase
+            appendBytes(STREAMS[0], 100 + h);
+            appendBytes(STREAMS[1], 10 * (p + 1));
+            sizes[0] += 100 + h;
+            sizes[1] += 10 * (p + 1);
+            clock.delay(0.5 + 0.25 * h);
+            segment.end = clock.now();
+            expected.push_back(segment);
+        }
+    }
+    writer.end(clock.now());
+    writer.close();
+
+    SegmentIndex index;
+    CHECK(index.load(INDEX));
+    CHECK(index.getSegments().size() == expected.size());
+    CHECK(index.getStream("b") == 1);
+    CHECK(index.getStream("c") == -1);
+    for (size_t k = 0; k < expected.size(); ++k) {
+        const PinchSegment *segment = index.find(expected[k].pinch, expected[k].phase);
+        CHECK(segment != NULL);
+        if (segment == NULL) {
+            continue;
+        }
+        CHECK_CLOSE(segment->start, expected[k].start, 1e-6);
+        CHECK_CLOSE(segment->end, expected[k].end, 1e-6);
+        CHECK_CLOSE(segment->fingerDepth, expected[k].fingerDepth, 1e-6);
+        CHECK_CLOSE(segment->thumbDepth, expected[k].thumbDepth, 1e-6);
+        CHECK(segment->offsets == expected[k].offsets);
+
+        CHECK(index.findTime(0.5 * (expected[k].start + expected[k].end)) == segment);
+    }
+    CHECK(index.find(N_PINCHES, iCub::interactionForces::PHASE_PRESS) == NULL);
+    CHECK(index.findTime(99.0) == NULL);
+    CHECK(index.findTime(expected.back().end + 1.0) == NULL);
+
+    for (int i = 0; i < 2; ++i) {
+        remove(STREAMS[i]);
+    }
+}
+
+
+/**
+ * An index written out of order, with a gap between phases, is still searched correctly.
+ */
+static void testOutOfOrder(void) {
+    {
+        std::ofstream out(INDEX);
+        out << "# pinch phase start end fingerDepth thumbDepth a\n"
+            << "2 press 5.0 6.0 1 1 40\n"
+            << "1 hold 2.0 3.0 1 1 20\n"
+            << "1 press 1.0 2.0 1 1 10\n"
+            << "3 press 4.0 4.5 1 1 30\n";
+    }
+
+    SegmentIndex index;
+    CHECK(index.load(INDEX));
+    const vector<PinchSegment> &segments = index.getSegments();
+    CHECK(segments.size() == 4);
+    for (size_t k = 1; k < segments.size(); ++k) {
+        CHECK((segments[k - 1].pinch < segments[k].pinch)
+                || ((segments[k - 1].pinch == segments[k].pinch) && (segments[k - 1].phase < segments[k].phase)));
+    }
+
+    const PinchSegment *segment = index.find(2, iCub::interactionForces::PHASE_PRESS);
+    CHECK((segment != NULL) && (segment->offsets.size() == 1) && (segment->offsets[0] == 40));
+    segment = index.find(1, iCub::interactionForces::PHASE_HOLD);
+    CHECK((segment != NULL) && (segment->start == 2.0));
+    CHECK(index.find(1, iCub::interactionForces::PHASE_RAISE) == NULL);
+
+    segment = index.findTime(5.5);
+    CHECK((segment != NULL) && (segment->pinch == 2));
+    segment = index.findTime(4.2);
+    CHECK((segment != NULL) && (segment->pinch == 3));
+    segment = index.findTime(1.5);
+    CHECK((segment != NULL) && (segment->pinch == 1) && (segment->phase == iCub::interactionForces::PHASE_PRESS));
+    CHECK(index.findTime(3.5) == NULL);
+    CHECK(index.findTime(7.0) == NULL);
+}
+
+
+/**
+ * Phase names round trip and invalid rows are rejected.
+ */
+static void testPhases(void) {
+    for (int h = iCub::interactionForces::PHASE_PRESS; h < iCub::interactionForces::N_PINCH_PHASES; ++h) {
+        CHECK(SegmentIndex::getPhase(SegmentIndex::getPhaseName((PinchPhase) h)) == h);
+    }
+    CHECK(SegmentIndex::getPhase("squeeze") == iCub::interactionForces::N_PINCH_PHASES);
+
+    {
+        std::ofstream out(INDEX);
+        out << "# pinch phase start end fingerDepth thumbDepth\n"
+            << "1 squeeze 1.0 2.0 1 1\n";
+    }
+    SegmentIndex index;
+    CHECK(!index.load(INDEX));
+}
+
+
+int main(void) {
+    testWriteLoad();
+    testOutOfOrder();
+    testPhases();
+    remove(INDEX);
+
+    return TEST_RESULT;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SkinArchive.h"
+#include "TestCheck.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using std::vector;
+
+using iCub::interactionForces::LogRowHandler;
+using iCub::interactionForces::SkinArchiveWriter;
+using iCub::interactionForces::SkinArchiveReader;
+
+
+/** The archive written by the tests, in the working directory. */
+static const char *ARCHIVE = "skinArchiveTest.ska";
+
+#define N_TAXELS 192
+
+
+/**
+ * Collector of the decoded samples.
+ */
+class Collector : public LogRowHandler {
+    public:
+        vector<double> times;
+        vector< vector<double> > rows;
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            times.push_back(i_time);
+            rows.push_back(vector<double>(i_values, i_values + i_size));
+        }
+};
+
+
+/**
+ * A skin-like sample: most taxels unchanged, a few pressed and released, with jumps across the whole range.
+ */
+static void makeSample(const int &i_k, vector<double> &o_taxels) {
+    o_taxels.assign(N_TAXELS, 0.0);
+    for (int i = 0; i < N_TAXELS; ++i) {
+        if ((i / 12) == ((i_k / 20) % 16)) {
+            o_taxels[i] = (i_k * 7 + i * 13) % 256;
+        } else if ((i % 31) == 0) {
+            o_taxels[i] = ((i_k % 2) == 0) ? 0.0 : 255.0;
+        } else {
+            o_taxels[i] = 240.0;
+        }
+    }
+}
+
+static double sampleTime(const int &i_k) {
+    return 1400000000.0 + 0.01 * i_k + 1e-6 * (i_k % 3);
+}
+
+
+/**
+ * Every sample written is read back, quantised taxels and microsecond timestamps included.
+ */
+static void testRoundTrip(void) {
+    const int nSamples = 523;
+    SkinArchiveWriter writer;
+    CHECK(writer.open(ARCHIVE, N_TAXELS, 50));
+    vector<double> taxels;
+    for (int k = 0; k < nSamples; ++k) {
+        makeSample(k, taxels);
+        writer.onRow(sampleTime(k), &taxels[0], taxels.size());
+    }
+    CHECK(writer.close());
+
+    SkinArchiveReader reader;
+    CHECK(reader.open(ARCHIVE));
+    CHECK(reader.getTaxels() == N_TAXELS);
+    CHECK(reader.getIndex().size() == 11);
+
+    Collector collector;
+    CHECK(reader.read(0.0, 1e10, &collector));
+    CHECK(collector.rows.size() == (size_t) nSamples);
+    for (size_t k = 0; (k < collector.rows.size()) && (k < (size_t) nSamples); ++k) {
+        CHECK_CLOSE(collector.times[k], sampleTime(k), 1e-6);
+        makeSample(k, taxels);
+        CHECK(collector.rows[k] == taxels);
+    }
+    reader.close();
+}
+
+
+/**
+ * Taxels are rounded and clamped to [0, 255], missing taxels are zero.
+ */
+static void testQuantisation(void) {
+    SkinArchiveWriter writer;
+    CHECK(writer.open(ARCHIVE, 4, 10));
+    double values[3] = {-3.2, 300.0, 12.6};
+    writer.onRow(1.0, values, 3);
+    CHECK(writer.close());
+
+    SkinArchiveReader reader;
+    CHECK(reader.open(ARCHIVE));
+    Collector collector;
+    CHECK(reader.read(0.0, 2.0, &collector));
+    CHECK(collector.rows.size() == 1);
+    if (collector.rows.size() == 1) {
+        CHECK(collector.rows[0].size() == 4);
+        CHECK(collector.rows[0][0] == 0.0);
+        CHECK(collector.rows[0][1] == 255.0);
+        CHECK(collector.rows[0][2] == 13.0);
+        CHECK(collector.rows[0][3] == 0.0);
+    }
+    reader.close();
+}
+
+
+/**
+ * A time range returns exactly the samples within it, across block boundaries.
+ */
+static void testRange(void) {
+    const int nSamples = 200;
+    SkinArchiveWriter writer;
+    CHECK(writer.open(ARCHIVE, N_TAXELS, 16));
+    vector<double> taxels;
+    for (int k = 0; k < nSamples; ++k) {
+        makeSample(k, taxels);
+        writer.onRow(0.01 * k, &taxels[0], taxels.size());
+    }
+    CHECK(writer.close());
+
+    SkinArchiveReader reader;
+    CHECK(reader.open(ARCHIVE));
+    Collector collector;
+    CHECK(reader.read(0.305, 0.995, &collector));
+    CHECK(collector.rows.size() == 69);
+    if (!collector.rows.empty()) {
+        CHECK_CLOSE(collector.times.front(), 0.31, 1e-6);
+        CHECK_CLOSE(collector.times.back(), 0.99, 1e-6);
+        makeSample(31, taxels);
+        CHECK(collector.rows.front() == taxels);
+    }
+    reader.close();
+}
+
+
+int main(void) {
+    testRoundTrip();
+    testQuantisation();
+    testRange();
+    remove(ARCHIVE);
+
+    return TEST_RESULT;
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_TESTCHECK_H__
+#define __ICUB_INTERACTIONFORCES_TESTCHECK_H__
+
+#include <iostream>
+#include <cmath>
+
+/**
+ * Minimal checks for the unit tests. A failed check is reported and counted, the test goes on;
+ * main() returns TEST_RESULT so that ctest sees the failure.
+ */
+static int testFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #cond << "\n"; \
+            testFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_CLOSE(value, expected, tolerance) \
+    do { \
+        double v_ = (value); \
+        double e_ = (expected); \
+        if (!(std::fabs(v_ - e_) <= (tolerance))) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #value << " = " << v_ \
+                << ", expected " << e_ << " +/- " << (tolerance) << "\n"; \
+            testFailures++; \
+        } \
+    } while (0)
+
+#define TEST_RESULT ((testFailures == 0) ? 0 : 1)
+
+#endif
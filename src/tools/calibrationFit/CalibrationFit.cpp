@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "CalibrationFit.h"
+
+#include <cmath>
+
+using std::vector;
+
+using iCub::interactionForces::FitStats;
+
+
+FitStats::FitStats(const int &i_features) {
+    reset(i_features);
+}
+
+void FitStats::reset(const int &i_features) {
+    nFeatures = i_features;
+    n = 0.0;
+    xtx.assign(nFeatures * nFeatures, 0.0);
+    xty.assign(nFeatures, 0.0);
+    yty = 0.0;
+}
+
+void FitStats::add(const double *i_x, const double &i_y) {
+    // Upper triangle only, mirrored when solving
+    for (int i = 0; i < nFeatures; ++i) {
+        double *row = &xtx[i * nFeatures];
+        for (int j = i; j < nFeatures; ++j) {
+            row[j] += i_x[i] * i_x[j];
+        }
+        xty[i] += i_x[i] * i_y;
+    }
+    yty += i_y * i_y;
+    n += 1.0;
+}
+
+void FitStats::merge(const FitStats &i_other) {
+    if (i_other.nFeatures != nFeatures) {
+        return;
+    }
+    for (size_t i = 0; i < xtx.size(); ++i) {
+        xtx[i] += i_other.xtx[i];
+    }
+    for (size_t i = 0; i < xty.size(); ++i) {
+        xty[i] += i_other.xty[i];
+    }
+    yty += i_other.yty;
+    n += i_other.n;
+}
+
+bool FitStats::solve(const double &i_lambda, vector<double> &o_weights) const {
+    int m = nFeatures - 1;
+    o_weights.assign(nFeatures, 0.0);
+    if ((m < 0) || (n < 2.0)) {
+        return false;
+    }
+
+    // Means and deviations of the features, the first one being the bias
+    vector<double> mean(m), scale(m);
+    double yMean = xty[0] / n;
+    for (int i = 0; i < m; ++i) {
+        mean[i] = xtx[i + 1] / n;
+        double var = xtx[(i + 1) * nFeatures + i + 1] / n - mean[i] * mean[i];
+        scale[i] = (var > 1e-12) ? sqrt(var) : 0.0;
+    }
+
+    // Standardised covariance system with the regularisation on the diagonal
+    vector<double> a(m * m, 0.0), b(m, 0.0);
+    for (int i = 0; i < m; ++i) {
+        if (scale[i] == 0.0) {
+            a[i * m + i] = 1.0;
+            continue;
+        }
+        for (int j = i; j < m; ++j) {
+            if (scale[j] == 0.0) {
+                continue;
+            }
+            double c = (xtx[(i + 1) * nFeatures + j + 1] / n - mean[i] * mean[j]) / (scale[i] * scale[j]);
+            a[i * m + j] = c;
+            a[j * m + i] = c;
+        }
+        a[i * m + i] += i_lambda;
+        b[i] = (xty[i + 1] / n - mean[i] * yMean) / scale[i];
+    }
+
+    // Cholesky factorisation, a small pivot marks collinear features
+    for (int j = 0; j < m; ++j) {
+        double d = a[j * m + j];
+        for (int k = 0; k < j; ++k) {
+            d -= a[j * m + k] * a[j * m + k];
+        }
+        d = (d > 1e-12) ? sqrt(d) : 1e-6;
+        a[j * m + j] = d;
+        for (int i = j + 1; i < m; ++i) {
+            double s = a[i * m + j];
+            for (int k = 0; k < j; ++k) {
+                s -= a[i * m + k] * a[j * m + k];
+            }
+            a[i * m + j] = s / d;
+        }
+    }
+    for (int i = 0; i < m; ++i) {
+        double s = b[i];
+        for (int k = 0; k < i; ++k) {
+            s -= a[i * m + k] * b[k];
+        }
+        b[i] = s / a[i * m + i];
+    }
+    for (int i = m - 1; i >= 0; --i) {
+        double s = b[i];
+        for (int k = i + 1; k < m; ++k) {
+            s -= a[k * m + i] * b[k];
+        }
+        b[i] = s / a[i * m + i];
+    }
+
+    // Back to the original features
+    o_weights[0] = yMean;
+    for (int i = 0; i < m; ++i) {
+        if (scale[i] > 0.0) {
+            o_weights[i + 1] = b[i] / scale[i];
+            o_weights[0] -= o_weights[i + 1] * mean[i];
+        }
+    }
+
+    return true;
+}
+
+double FitStats::getError(const vector<double> &i_weights) const {
+    if ((int) i_weights.size() != nFeatures) {
+        return 0.0;
+    }
+
+    // w'X'Xw - 2 w'X'y + y'y
+    double quad = 0.0;
+    double lin = 0.0;
+    for (int i = 0; i < nFeatures; ++i) {
+        quad += i_weights[i] * i_weights[i] * xtx[i * nFeatures + i];
+        for (int j = i + 1; j < nFeatures; ++j) {
+            quad += 2.0 * i_weights[i] * i_weights[j] * xtx[i * nFeatures + j];
+        }
+        lin += i_weights[i] * xty[i];
+    }
+    double sse = quad - 2.0 * lin + yty;
+
+    return (sse > 0.0) ? sse : 0.0;
+}
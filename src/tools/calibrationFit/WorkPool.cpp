@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "WorkPool.h"
+
+#include <sstream>
+
+using std::string;
+using std::stringstream;
+
+using iCub::interactionForces::WorkPool;
+using iCub::interactionForces::WorkTask;
+
+
+WorkPool::WorkPool(const int &i_threads) : available(0), idle(0) {
+    pending = 0;
+    waiting = false;
+    stopping = false;
+    next = 0;
+    dbgTag = "WorkPool: ";
+
+    int n = (i_threads > 0) ? i_threads : 1;
+    for (int i = 0; i < n; ++i) {
+        queues.push_back(new TaskQueue());
+    }
+    for (int i = 0; i < n; ++i) {
+        workers.push_back(new Worker(*this, i));
+        workers.back()->start();
+    }
+}
+
+WorkPool::~WorkPool() {
+    wait();
+
+    stateMutex.lock();
+    stopping = true;
+    stateMutex.unlock();
+    for (size_t i = 0; i < workers.size(); ++i) {
+        available.post();
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->stop();
+        delete workers[i];
+    }
+    for (size_t i = 0; i < queues.size(); ++i) {
+        delete queues[i];
+    }
+}
+
+/* *********************************************************************************************************************** */
+/* ******* Task submission                                                  ********************************************** */
+void WorkPool::submit(WorkTask *i_task, const int &i_worker) {
+    stateMutex.lock();
+    pending++;
+    int k = i_worker;
+    if ((k < 0) || (k >= (int) queues.size())) {
+        k = (int) (next++ % queues.size());
+    }
+    stateMutex.unlock();
+
+    queues[k]->mutex.lock();
+    queues[k]->tasks.push_back(i_task);
+    queues[k]->mutex.unlock();
+    available.post();
+}
+
+void WorkPool::wait(void) {
+    stateMutex.lock();
+    if (pending == 0) {
+        stateMutex.unlock();
+        return;
+    }
+    waiting = true;
+    stateMutex.unlock();
+
+    idle.wait();
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Workers                                                          ********************************************** */
+void WorkPool::work(const int &i_worker) {
+    while (true) {
+        available.wait();
+
+        // A task is queued somewhere unless the pool is stopping
+        WorkTask *task = take(i_worker);
+        while (task == NULL) {
+            stateMutex.lock();
+            bool stop = stopping;
+            stateMutex.unlock();
+            if (stop) {
+                return;
+            }
+            yarp::os::Thread::yield();
+            task = take(i_worker);
+        }
+
+        task->run(*this, i_worker);
+        delete task;
+
+        stateMutex.lock();
+        pending--;
+        if ((pending == 0) && waiting) {
+            waiting = false;
+            idle.post();
+        }
+        stateMutex.unlock();
+    }
+}
+
+WorkTask* WorkPool::take(const int &i_worker) {
+    // Own tasks, newest first
+    TaskQueue *own = queues[i_worker];
+    own->mutex.lock();
+    if (!own->tasks.empty()) {
+        WorkTask *task = own->tasks.back();
+        own->tasks.pop_back();
+        own->executed++;
+        own->mutex.unlock();
+        return task;
+    }
+    own->mutex.unlock();
+
+    // Steal the oldest task of the next busy worker
+    for (size_t i = 1; i < queues.size(); ++i) {
+        TaskQueue *victim = queues[(i_worker + i) % queues.size()];
+        victim->mutex.lock();
+        if (!victim->tasks.empty()) {
+            WorkTask *task = victim->tasks.front();
+            victim->tasks.pop_front();
+            victim->mutex.unlock();
+
+            own->mutex.lock();
+            own->executed++;
+            own->stolen++;
+            own->mutex.unlock();
+            return task;
+        }
+        victim->mutex.unlock();
+    }
+
+    return NULL;
+}
+
+string WorkPool::getReport(void) {
+    stringstream ss;
+    for (size_t i = 0; i < queues.size(); ++i) {
+        queues[i]->mutex.lock();
+        ss << (i > 0 ? ", " : "") << "worker " << i << ": " << queues[i]->executed << " tasks (" << queues[i]->stolen << " stolen)";
+        queues[i]->mutex.unlock();
+    }
+
+    return ss.str();
+}
+/* *********************************************************************************************************************** */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_CALIBRATIONFIT_H__
+#define __ICUB_INTERACTIONFORCES_CALIBRATIONFIT_H__
+
+#include <vector>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Sufficient statistics of a least squares fit: the normal equations of a set of samples.
+         * Statistics of disjoint sample sets are merged by summation, hence the samples are accumulated once,
+         * in parallel shards, and every cross-validation fold is fitted and scored from the merged statistics.
+         */
+        class FitStats {
+            private:
+                int nFeatures;
+                double n;
+                std::vector<double> xtx;
+                std::vector<double> xty;
+                double yty;
+
+            public:
+                FitStats(const int &i_features = 0);
+
+                void reset(const int &i_features);
+
+                /**
+                 * Add a sample.
+                 * @param i_x the features, the first one being the constant 1
+                 * @param i_y the target
+                 */
+                void add(const double *i_x, const double &i_y);
+
+                /**
+                 * Add the samples of other statistics.
+                 */
+                void merge(const FitStats &i_other);
+
+                double getSamples(void) const { return n; }
+
+                /**
+                 * Fit a ridge regression. The features are standardised and the bias is not regularised.
+                 * Features without variance get a zero weight.
+                 * @param i_lambda the regularisation, relative to the number of samples
+                 * @param o_weights the feature weights
+                 * @return false if there are not enough samples
+                 */
+                bool solve(const double &i_lambda, std::vector<double> &o_weights) const;
+
+                /**
+                 * Get the sum of the squared errors of a model on these samples.
+                 */
+                double getError(const std::vector<double> &i_weights) const;
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
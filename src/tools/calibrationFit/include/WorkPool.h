@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_WORKPOOL_H__
+#define __ICUB_INTERACTIONFORCES_WORKPOOL_H__
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Thread.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Semaphore.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        class WorkPool;
+
+        /**
+         * A unit of work of the pool.
+         */
+        class WorkTask {
+            public:
+                virtual ~WorkTask() {}
+
+                /**
+                 * Run the task. The task may submit further tasks to the pool.
+                 * @param io_pool the pool running the task
+                 * @param i_worker the worker running the task
+                 */
+                virtual void run(WorkPool &io_pool, const int &i_worker) = 0;
+        };
+
+
+        /**
+         * Work-stealing thread pool.
+         * Each worker owns a deque of tasks: it runs its own tasks newest first and, when it has none, steals the
+         * oldest task of another worker. Tasks submitted by a running task go to the deque of its worker, so that
+         * the subtasks of a large task stay local unless another worker runs out of work.
+         * A semaphore counts the queued tasks: a worker passing it is guaranteed to find a task in some deque.
+         * Tasks are deleted by the pool once run.
+         */
+        class WorkPool {
+            private:
+                /**
+                 * A pool thread.
+                 */
+                class Worker : public yarp::os::Thread {
+                    private:
+                        WorkPool &pool;
+                        int id;
+
+                    public:
+                        Worker(WorkPool &aPool, const int &aId) : pool(aPool), id(aId) {}
+                        virtual void run() { pool.work(id); }
+                };
+
+                /**
+                 * The task deque of a worker.
+                 */
+                struct TaskQueue {
+                    yarp::os::Mutex mutex;
+                    std::deque<WorkTask*> tasks;
+
+                    /** The tasks run by the worker and those it stole. */
+                    unsigned int executed;
+                    unsigned int stolen;
+
+                    TaskQueue() : executed(0), stolen(0) {}
+                };
+
+                std::vector<Worker*> workers;
+                std::vector<TaskQueue*> queues;
+
+                /** Counts the queued tasks, plus one wake up per worker when stopping. */
+                yarp::os::Semaphore available;
+
+                /** The submitted and not yet completed tasks. */
+                yarp::os::Mutex stateMutex;
+                unsigned int pending;
+                bool waiting;
+                bool stopping;
+                yarp::os::Semaphore idle;
+
+                /** The round robin position of the tasks submitted from outside the pool. */
+                unsigned int next;
+
+                std::string dbgTag;
+
+            public:
+                /**
+                 * Start the workers.
+                 * @param i_threads the number of workers
+                 */
+                WorkPool(const int &i_threads);
+
+                /**
+                 * Stop the workers. Pending tasks are run first.
+                 */
+                ~WorkPool();
+
+                /**
+                 * Submit a task, owned by the pool from now on.
+                 * @param i_task the task
+                 * @param i_worker the submitting worker, -1 from outside the pool
+                 */
+                void submit(WorkTask *i_task, const int &i_worker = -1);
+
+                /**
+                 * Wait until all submitted tasks, and the tasks they submitted, are complete.
+                 */
+                void wait(void);
+
+                int getThreads(void) const { return (int) workers.size(); }
+
+                /**
+                 * Get the number of tasks run and stolen by each worker.
+                 */
+                std::string getReport(void);
+
+            private:
+                /**
+                 * The worker loop.
+                 */
+                void work(const int &i_worker);
+
+                /**
+                 * Take a task from the own deque or steal one from another worker.
+                 * @return the task, NULL if all deques are empty
+                 */
+                WorkTask* take(const int &i_worker);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
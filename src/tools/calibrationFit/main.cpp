@@ -0,0 +1,488 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+/**
+ * \defgroup calibrationFit calibrationFit
+ * Batch fitting of the skin to force models of the fingertips over many recorded sessions.
+ * Each session is a dataDumper directory with the compensated skin and the nano17 logs. The sessions are loaded in
+ * parallel, split in blocks of skin samples, and the normal equations of each fingertip and block are accumulated
+ * on a work-stealing thread pool. The blocks are grouped in folds, by session when there are enough sessions, and
+ * a ridge regression is cross-validated for each fingertip, fold and regularisation, again on the pool. The
+ * regularisation with the lowest cross-validated error is refitted on all the samples and the models are written
+ * in the format loaded by the fingerForce module through its [calibration] group.
+ * The sessions of the two hands are fitted by separate runs, with the configuration file of each hand.
+ *
+ * Parameters:
+ *  --from, --context   the fingerForce configuration providing the fingertips in the [finger] group
+ *  --sessions          the list of session directories, e.g. (/var/usr/fg/data/pinch/right /var/usr/fg/data/pinch2/right)
+ *  --sessionList       a file with one session directory per line, added to --sessions
+ *  --fingertips        override the fingertips to calibrate
+ *  --skinLog, --ftLog  the log files within a session, default skin/comp/data.log and nano17/data.log
+ *  --stamps            the number of timestamp columns in the logs (2 with --txTime --rxTime)
+ *  --threads           the number of pool threads, default the number of cores
+ *  --folds             the number of cross-validation folds
+ *  --lambdas           the regularisations to cross-validate
+ *  --blockRows         the number of skin samples per accumulation task
+ *  --minSkin           the minimum taxel sum of a fingertip for its samples to be fitted
+ *  --maxGap            the maximum nano17 sample gap interpolated at the skin timestamps
+ *  --out               the model file
+ */
+
+
+#include "WorkPool.h"
+#include "CalibrationFit.h"
+#include "LogParser.h"
+#include "SkinForceModel.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+
+#include <unistd.h>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/Mutex.h>
+#include <yarp/os/Time.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::WorkPool;
+using iCub::interactionForces::WorkTask;
+using iCub::interactionForces::FitStats;
+using iCub::interactionForces::LogParser;
+using iCub::interactionForces::LogRowHandler;
+using iCub::interactionForces::SkinForceModel;
+using iCub::interactionForces::FingertipModel;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Mutex;
+using yarp::os::Time;
+
+
+#define SKIN_TAXELS 192
+#define FINGERTIP_TAXELS 12
+
+
+/**
+ * The fitting settings shared by all tasks.
+ */
+struct FitSettings {
+    vector<int> fingertips;
+    string skinLog;
+    string ftLog;
+    int nStamps;
+    int blockRows;
+    double minSkin;
+    double maxGap;
+};
+
+
+/**
+ * A recorded session: its samples while loaded, then the statistics of each fingertip and block.
+ */
+struct Session {
+    string dir;
+    bool ok;
+
+    /** The nano17 force norm. */
+    vector<double> forceTime;
+    vector<double> force;
+
+    /** The taxels of the calibrated fingertips, one row of 12 per fingertip for each skin sample. */
+    vector<double> skinTime;
+    vector<double> taxels;
+
+    /** The statistics of each fingertip and block. */
+    vector< vector<FitStats> > stats;
+
+    /** The accumulation tasks still running, the samples are released by the last one. */
+    Mutex mutex;
+    int remaining;
+
+    Session() : ok(false), remaining(0) {}
+};
+
+
+/**
+ * Collect the nano17 force norm.
+ */
+class ForceHandler : public LogRowHandler {
+    public:
+        Session &session;
+
+        ForceHandler(Session &aSession) : session(aSession) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            if (i_size >= 3) {
+                session.forceTime.push_back(i_time);
+                session.force.push_back(sqrt(i_values[0] * i_values[0] + i_values[1] * i_values[1] + i_values[2] * i_values[2]));
+            }
+        }
+};
+
+
+/**
+ * Collect the taxels of the calibrated fingertips.
+ */
+class SkinHandler : public LogRowHandler {
+    public:
+        Session &session;
+        const vector<int> &fingertips;
+
+        SkinHandler(Session &aSession, const vector<int> &aFingertips) : session(aSession), fingertips(aFingertips) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            if (i_size >= SKIN_TAXELS) {
+                session.skinTime.push_back(i_time);
+                for (size_t k = 0; k < fingertips.size(); ++k) {
+                    const double *x = i_values + fingertips[k] * FINGERTIP_TAXELS;
+                    session.taxels.insert(session.taxels.end(), x, x + FINGERTIP_TAXELS);
+                }
+            }
+        }
+};
+
+
+/**
+ * Accumulate the statistics of a fingertip over a block of skin samples of a session.
+ */
+class AccumulateTask : public WorkTask {
+    private:
+        Session &session;
+        const FitSettings &settings;
+        size_t fingertip;
+        size_t block;
+
+    public:
+        AccumulateTask(Session &aSession, const FitSettings &aSettings, const size_t &aFingertip, const size_t &aBlock)
+            : session(aSession), settings(aSettings), fingertip(aFingertip), block(aBlock) {}
+
+        virtual void run(WorkPool &io_pool, const int &i_worker) {
+            FitStats &stats = session.stats[fingertip][block];
+            const size_t nTips = settings.fingertips.size();
+            const size_t begin = block * settings.blockRows;
+            const size_t end = std::min(begin + settings.blockRows, session.skinTime.size());
+            const vector<double> &ft = session.forceTime;
+
+            double x[SkinForceModel::N_FEATURES];
+            vector<double>::const_iterator it = std::lower_bound(ft.begin(), ft.end(), session.skinTime[begin]);
+            for (size_t r = begin; r < end; ++r) {
+                // The nano17 samples around the skin sample, both logs being ordered
+                double t = session.skinTime[r];
+                while ((it != ft.end()) && (*it < t)) {
+                    ++it;
+                }
+                if ((it == ft.begin()) || (it == ft.end())) {
+                    continue;
+                }
+                size_t j = it - ft.begin();
+                double dt = ft[j] - ft[j - 1];
+                if (dt > settings.maxGap) {
+                    continue;
+                }
+                double a = (dt > 0.0) ? (t - ft[j - 1]) / dt : 1.0;
+                double force = session.force[j - 1] + a * (session.force[j] - session.force[j - 1]);
+
+                const double *taxels = &session.taxels[(r * nTips + fingertip) * FINGERTIP_TAXELS];
+                double sum = 0.0;
+                for (int i = 0; i < FINGERTIP_TAXELS; ++i) {
+                    sum += taxels[i];
+                }
+                if (sum < settings.minSkin) {
+                    continue;
+                }
+                SkinForceModel::features(taxels, x);
+                stats.add(x, force);
+            }
+
+            session.mutex.lock();
+            bool last = (--session.remaining == 0);
+            session.mutex.unlock();
+            if (last) {
+                vector<double>().swap(session.forceTime);
+                vector<double>().swap(session.force);
+                vector<double>().swap(session.skinTime);
+                vector<double>().swap(session.taxels);
+            }
+        }
+};
+
+
+/**
+ * Load a session and split its accumulation in blocks.
+ */
+class LoadTask : public WorkTask {
+    private:
+        Session &session;
+        const FitSettings &settings;
+
+    public:
+        LoadTask(Session &aSession, const FitSettings &aSettings) : session(aSession), settings(aSettings) {}
+
+        virtual void run(WorkPool &io_pool, const int &i_worker) {
+            // The pool provides the parallelism, each log is parsed as a single chunk
+            LogParser parser(settings.nStamps);
+            double bytes;
+            ForceHandler forceHandler(session);
+            SkinHandler skinHandler(session, settings.fingertips);
+            if (!parser.parse(session.dir + "/" + settings.ftLog, vector<LogRowHandler*>(1, &forceHandler), bytes)
+                    || !parser.parse(session.dir + "/" + settings.skinLog, vector<LogRowHandler*>(1, &skinHandler), bytes)) {
+                return;
+            }
+            session.ok = true;
+
+            size_t nBlocks = (session.skinTime.size() + settings.blockRows - 1) / settings.blockRows;
+            session.stats.assign(settings.fingertips.size(), vector<FitStats>(nBlocks, FitStats(SkinForceModel::N_FEATURES)));
+            session.remaining = (int) (nBlocks * settings.fingertips.size());
+
+            // The blocks stay on this worker unless the others run out of work
+            for (size_t k = 0; k < settings.fingertips.size(); ++k) {
+                for (size_t b = 0; b < nBlocks; ++b) {
+                    io_pool.submit(new AccumulateTask(session, settings, k, b), i_worker);
+                }
+            }
+        }
+};
+
+
+/**
+ * Fit a fingertip on all folds but one, for each regularisation, and score the left out fold.
+ */
+class FoldTask : public WorkTask {
+    private:
+        const vector<FitStats> &folds;
+        size_t fold;
+        const vector<double> &lambdas;
+        double *errors;
+
+    public:
+        FoldTask(const vector<FitStats> &aFolds, const size_t &aFold, const vector<double> &aLambdas, double *aErrors)
+            : folds(aFolds), fold(aFold), lambdas(aLambdas), errors(aErrors) {}
+
+        virtual void run(WorkPool &io_pool, const int &i_worker) {
+            FitStats train(SkinForceModel::N_FEATURES);
+            for (size_t f = 0; f < folds.size(); ++f) {
+                if (f != fold) {
+                    train.merge(folds[f]);
+                }
+            }
+
+            vector<double> weights;
+            for (size_t l = 0; l < lambdas.size(); ++l) {
+                errors[l] = train.solve(lambdas[l], weights) ? folds[fold].getError(weights) : -1.0;
+            }
+        }
+};
+
+
+int main(int argc, char *argv[]) {
+    string dbgTag = "calibrationFit: ";
+
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.setDefaultConfigFile("confFingertipsRight.ini");
+    rf.setDefaultContext("fingerForce");
+    rf.configure("ICUB_ROOT", argc, argv);
+
+    // Fingertips, as in the module
+    FitSettings settings;
+    Bottle *tips = rf.check("fingertips") ? rf.find("fingertips").asList() : rf.findGroup("finger").find("fingertips").asList();
+    if (tips != NULL) {
+        for (int i = 0; i < tips->size(); ++i) {
+            settings.fingertips.push_back(tips->get(i).asInt());
+        }
+    } else {
+        for (int i = 0; i < 5; ++i) {
+            settings.fingertips.push_back(i);
+        }
+    }
+    for (size_t k = 0; k < settings.fingertips.size(); ++k) {
+        if ((settings.fingertips[k] < 0) || (settings.fingertips[k] > 4)) {
+            cerr << dbgTag << "Invalid fingertip index " << settings.fingertips[k] << ". \n";
+            return 1;
+        }
+    }
+
+    // Tool options
+    settings.skinLog = rf.check("skinLog", Value("skin/comp/data.log"), "The compensated skin log of a session.").asString().c_str();
+    settings.ftLog = rf.check("ftLog", Value("nano17/data.log"), "The nano17 log of a session.").asString().c_str();
+    settings.nStamps = rf.check("stamps", Value(1), "The number of timestamp columns.").asInt();
+    settings.blockRows = rf.check("blockRows", Value(5000), "The number of skin samples per accumulation task.").asInt();
+    settings.minSkin = rf.check("minSkin", Value(1.0), "The minimum taxel sum of a fitted sample.").asDouble();
+    settings.maxGap = rf.check("maxGap", Value(0.05), "The maximum interpolated nano17 gap.").asDouble();
+    int nThreads = rf.check("threads", Value((int) sysconf(_SC_NPROCESSORS_ONLN)), "The number of pool threads.").asInt();
+    int nFolds = rf.check("folds", Value(5), "The number of cross-validation folds.").asInt();
+    string outFile = rf.check("out", Value("skinForce.ini"), "The model file.").asString().c_str();
+    vector<double> lambdas;
+    Bottle *lambdaList = rf.find("lambdas").asList();
+    if (lambdaList != NULL) {
+        for (int i = 0; i < lambdaList->size(); ++i) {
+            lambdas.push_back(lambdaList->get(i).asDouble());
+        }
+    } else {
+        for (double l = 1e-4; l < 2.0; l *= 10.0) {
+            lambdas.push_back(l);
+        }
+    }
+    if ((settings.blockRows <= 0) || (nFolds < 2) || lambdas.empty()) {
+        cerr << dbgTag << "Invalid block size, number of folds or regularisations. \n";
+        return 1;
+    }
+
+    // Sessions
+    vector<string> dirs;
+    Bottle *sessionList = rf.find("sessions").asList();
+    if (sessionList != NULL) {
+        for (int i = 0; i < sessionList->size(); ++i) {
+            dirs.push_back(sessionList->get(i).asString().c_str());
+        }
+    }
+    if (rf.check("sessionList")) {
+        std::ifstream list(rf.find("sessionList").asString().c_str());
+        string line;
+        while (std::getline(list, line)) {
+            if (!line.empty() && (line[0] != '#')) {
+                dirs.push_back(line);
+            }
+        }
+    }
+    if (dirs.empty()) {
+        cerr << dbgTag << "Usage: calibrationFit --sessions (<dir> ...) | --sessionList <file> [--out <file>] \n";
+        return 1;
+    }
+
+
+    /* ******* Accumulation.                                        ******* */
+    double start = Time::now();
+    vector<Session*> sessions;
+    WorkPool pool(nThreads);
+    for (size_t s = 0; s < dirs.size(); ++s) {
+        sessions.push_back(new Session());
+        sessions.back()->dir = dirs[s];
+        pool.submit(new LoadTask(*sessions.back(), settings));
+    }
+    pool.wait();
+    double accumulated = Time::now();
+    cerr << dbgTag << "Accumulated " << sessions.size() << " sessions in " << accumulated - start << " s on "
+        << pool.getThreads() << " threads (" << pool.getReport() << "). \n";
+
+
+    /* ******* Folds.                                               ******* */
+    // Whole sessions per fold when possible, blocks of time otherwise
+    int nSessions = 0;
+    for (size_t s = 0; s < sessions.size(); ++s) {
+        if (sessions[s]->ok) {
+            nSessions++;
+        } else {
+            cerr << dbgTag << "Skipping session " << sessions[s]->dir << ". \n";
+        }
+    }
+    bool bySession = (nSessions >= nFolds);
+    const size_t nTips = settings.fingertips.size();
+    vector< vector<FitStats> > folds(nTips, vector<FitStats>(nFolds, FitStats(SkinForceModel::N_FEATURES)));
+    int sessionFold = 0;
+    for (size_t s = 0; s < sessions.size(); ++s) {
+        if (sessions[s]->ok) {
+            for (size_t k = 0; k < nTips; ++k) {
+                for (size_t b = 0; b < sessions[s]->stats[k].size(); ++b) {
+                    folds[k][bySession ? sessionFold : (int) (b % nFolds)].merge(sessions[s]->stats[k][b]);
+                }
+            }
+            sessionFold = (sessionFold + 1) % nFolds;
+        }
+        delete sessions[s];
+        sessions[s] = NULL;
+    }
+
+
+    /* ******* Cross-validation.                                    ******* */
+    vector<double> errors(nTips * nFolds * lambdas.size(), 0.0);
+    for (size_t k = 0; k < nTips; ++k) {
+        for (int f = 0; f < nFolds; ++f) {
+            pool.submit(new FoldTask(folds[k], f, lambdas, &errors[(k * nFolds + f) * lambdas.size()]));
+        }
+    }
+    pool.wait();
+
+    cout << std::setprecision(4);
+    cout << "# fingertip lambda cvRmse\n";
+    vector<FingertipModel> models;
+    for (size_t k = 0; k < nTips; ++k) {
+        FitStats all(SkinForceModel::N_FEATURES);
+        for (int f = 0; f < nFolds; ++f) {
+            all.merge(folds[k][f]);
+        }
+        if (all.getSamples() < SkinForceModel::N_FEATURES) {
+            cerr << dbgTag << "Not enough samples for fingertip " << settings.fingertips[k] << ". \n";
+            continue;
+        }
+
+        // Lowest total error over the folds
+        int best = -1;
+        double bestError = 0.0;
+        for (size_t l = 0; l < lambdas.size(); ++l) {
+            double sse = 0.0;
+            for (int f = 0; f < nFolds; ++f) {
+                double e = errors[(k * nFolds + f) * lambdas.size() + l];
+                sse += (e >= 0.0) ? e : 1e300;
+            }
+            cout << settings.fingertips[k] << " " << lambdas[l] << " " << sqrt(sse / all.getSamples()) << "\n";
+            if ((best < 0) || (sse < bestError)) {
+                best = (int) l;
+                bestError = sse;
+            }
+        }
+
+        FingertipModel model;
+        model.fingertip = settings.fingertips[k];
+        model.lambda = lambdas[best];
+        all.solve(model.lambda, model.weights);
+        model.samples = (int) all.getSamples();
+        model.rmse = sqrt(all.getError(model.weights) / all.getSamples());
+        model.cvRmse = sqrt(bestError / all.getSamples());
+        models.push_back(model);
+
+        cerr << dbgTag << "Fingertip " << model.fingertip << ": " << model.samples << " samples, lambda " << model.lambda
+            << ", error " << model.rmse << " N, cross-validated " << model.cvRmse << " N. \n";
+    }
+    cerr << dbgTag << "Fitted " << models.size() << " fingertips in " << Time::now() - start << " s, "
+        << (bySession ? "folds by session" : "folds by block") << ". \n";
+
+    SkinForceModel model;
+    model.setModels(models);
+    if (models.empty() || !model.save(outFile)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "LogParser.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <iostream>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::LogParser;
+using iCub::interactionForces::LogRowHandler;
+
+
+/** Exact powers of ten. */
+static const double POW10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Maximum number of significant digits accumulated in the mantissa. */
+#define MAX_DIGITS 17
+
+
+/* *********************************************************************************************************************** */
+/* ******* Chunk reader                                                     ********************************************** */
+LogParser::ChunkReader::ChunkReader(const LogParser &aParser, const string &aFileName, const off_t &aBegin, const off_t &aEnd,
+        LogRowHandler *aHandler)
+    : parser(aParser), fileName(aFileName), begin(aBegin), end(aEnd), handler(aHandler) {
+        buffer.resize(parser.blockSize);
+        row.resize(1024);
+        bytes = 0;
+        ok = false;
+}
+
+void LogParser::ChunkReader::run() {
+    FILE *file = fopen(fileName.c_str(), "rb");
+    if (file == NULL) {
+        return;
+    }
+
+    // Start one character early to find out whether the first line belongs to this chunk
+    off_t offset = (begin > 0) ? begin - 1 : 0;
+    if (fseeko(file, offset, SEEK_SET) != 0) {
+        fclose(file);
+        return;
+    }
+    bool skipLine = (begin > 0);
+
+    double time = 0.0;
+    size_t carry = 0;
+    bool done = false;
+    while (!done) {
+        // Lines longer than the buffer
+        if (carry == buffer.size()) {
+            buffer.resize(2 * buffer.size());
+        }
+
+        size_t n = fread(&buffer[carry], 1, buffer.size() - carry, file);
+        bytes += n;
+        bool eof = (n < buffer.size() - carry);
+        char *first = &buffer[0];
+        const char *last = first + carry + n;
+        const char *p = first;
+
+        // Skip the line owned by the previous chunk
+        if (skipLine) {
+            const char *nl = (const char *) memchr(p, '\n', last - p);
+            if (nl == NULL) {
+                offset += last - first;
+                carry = 0;
+                if (eof) {
+                    break;
+                }
+                continue;
+            }
+            p = nl + 1;
+            skipLine = false;
+        }
+
+        while (p < last) {
+            // Lines starting past the chunk end belong to the next chunk
+            if (offset + (p - first) >= end) {
+                done = true;
+                break;
+            }
+
+            const char *nl = (const char *) memchr(p, '\n', last - p);
+            if (nl == NULL) {
+                if (!eof) {
+                    break;
+                }
+                nl = last;
+            }
+
+            int size = parser.parseLine(p, nl, row, time);
+            if (size >= 0) {
+                handler->onRow(time, &row[0], size);
+                if (handler->done()) {
+                    done = true;
+                    break;
+                }
+            }
+            p = nl + 1;
+        }
+
+        if (done || eof) {
+            break;
+        }
+
+        // Move the partial line to the front of the buffer
+        carry = last - p;
+        memmove(first, p, carry);
+        offset += p - first;
+    }
+
+    ok = (ferror(file) == 0);
+    fclose(file);
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Log parser                                                       ********************************************** */
+LogParser::LogParser(const int &i_nStamps, const size_t &i_blockSize) 
+    : nStamps(i_nStamps), blockSize(i_blockSize) {
+        dbgTag = "LogParser: ";
+}
+
+bool LogParser::parse(const string &i_file, const vector<LogRowHandler*> &i_handlers, double &o_bytes) {
+    // Get the file size
+    FILE *file = fopen(i_file.c_str(), "rb");
+    if (file == NULL) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return false;
+    }
+    fseeko(file, 0, SEEK_END);
+    off_t size = ftello(file);
+    fclose(file);
+    o_bytes = (double) size;
+
+    // Split the file in chunks and parse them in parallel
+    off_t nChunks = (off_t) i_handlers.size();
+    vector<ChunkReader*> readers;
+    for (off_t i = 0; i < nChunks; ++i) {
+        readers.push_back(new ChunkReader(*this, i_file, (size * i) / nChunks, (size * (i + 1)) / nChunks, i_handlers[i]));
+    }
+    for (size_t i = 0; i < readers.size(); ++i) {
+        readers[i]->start();
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < readers.size(); ++i) {
+        readers[i]->stop();
+        ok = ok && readers[i]->success();
+        delete readers[i];
+    }
+
+    if (!ok) {
+        cerr << dbgTag << "Error while reading " << i_file << ". \n";
+    }
+
+    return ok;
+}
+
+/**
+ * Forward the rows within a time range.
+ */
+class RangeHandler : public LogRowHandler {
+    private:
+        LogRowHandler *handler;
+        double from;
+        double to;
+        bool past;
+
+    public:
+        RangeHandler(LogRowHandler *aHandler, const double &aFrom, const double &aTo)
+            : handler(aHandler), from(aFrom), to(aTo), past(false) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            if (i_time > to) {
+                past = true;
+            } else if (i_time >= from) {
+                handler->onRow(i_time, i_values, i_size);
+            }
+        }
+
+        virtual bool done(void) const { return past; }
+};
+
+bool LogParser::parseRange(const string &i_file, const int64_t &i_offset, const double &i_from, const double &i_to,
+        LogRowHandler *i_handler, double &o_bytes) {
+    FILE *file = fopen(i_file.c_str(), "rb");
+    if (file == NULL) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return false;
+    }
+    fseeko(file, 0, SEEK_END);
+    off_t size = ftello(file);
+
+    // Offsets not recorded in the index are searched on the timestamps
+    off_t offset = (off_t) i_offset;
+    if ((offset < 0) || (offset > size)) {
+        offset = seekTime(file, size, i_from);
+    }
+    fclose(file);
+
+    // The chunk reader starts at the first complete line at or after the offset
+    RangeHandler range(i_handler, i_from, i_to);
+    ChunkReader reader(*this, i_file, offset, size, &range);
+    reader.run();
+    o_bytes = (double) reader.getBytes();
+
+    if (!reader.success()) {
+        cerr << dbgTag << "Error while reading " << i_file << ". \n";
+    }
+
+    return reader.success();
+}
+
+off_t LogParser::seekTime(FILE *i_file, const off_t &i_size, const double &i_time) const {
+    vector<char> buffer(1 << 16);
+    vector<double> row(1024);
+    double time;
+
+    off_t low = 0;
+    off_t high = i_size;
+    while (high - low > (off_t) buffer.size()) {
+        off_t mid = low + (high - low) / 2;
+        fseeko(i_file, mid, SEEK_SET);
+        size_t n = fread(&buffer[0], 1, buffer.size(), i_file);
+
+        // First complete line after the midpoint
+        const char *first = &buffer[0];
+        const char *p = (const char *) memchr(first, '\n', n);
+        const char *nl = (p != NULL) ? (const char *) memchr(p + 1, '\n', first + n - p - 1) : NULL;
+        if ((nl != NULL) && (parseLine(p + 1, nl, row, time) >= 0) && (time < i_time)) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+int LogParser::parseLine(const char *i_begin, const char *i_end, vector<double> &io_row, double &o_time) const {
+    const char *p = i_begin;
+    double value;
+
+    // Sequence number
+    if (!parseNumber(p, i_end, value)) {
+        return -1;
+    }
+    // Timestamps
+    for (int i = 0; i < nStamps; ++i) {
+        if (!parseNumber(p, i_end, o_time)) {
+            return -1;
+        }
+    }
+    // Data
+    size_t n = 0;
+    while (parseNumber(p, i_end, value)) {
+        if (n == io_row.size()) {
+            io_row.resize(2 * n);
+        }
+        io_row[n++] = value;
+    }
+
+    return (int) n;
+}
+
+bool LogParser::parseNumber(const char *&io_pos, const char *i_end, double &o_value) {
+    const char *p = io_pos;
+    while (p < i_end) {
+        // Skip separators and list delimiters
+        while ((p < i_end) && ((*p == ' ') || (*p == '\t') || (*p == '\r') || (*p == '(') || (*p == ')'))) {
+            ++p;
+        }
+        if (p >= i_end) {
+            break;
+        }
+
+        bool negative = false;
+        if ((*p == '-') || (*p == '+')) {
+            negative = (*p == '-');
+            ++p;
+        }
+
+        // Mantissa
+        double mantissa = 0.0;
+        int digits = 0;
+        int exponent = 0;
+        bool valid = false;
+        while ((p < i_end) && (*p >= '0') && (*p <= '9')) {
+            if (digits < MAX_DIGITS) {
+                mantissa = 10.0 * mantissa + (*p - '0');
+                digits += (mantissa > 0.0);
+            } else {
+                exponent++;
+            }
+            valid = true;
+            ++p;
+        }
+        if ((p < i_end) && (*p == '.')) {
+            ++p;
+            while ((p < i_end) && (*p >= '0') && (*p <= '9')) {
+                if (digits < MAX_DIGITS) {
+                    mantissa = 10.0 * mantissa + (*p - '0');
+                    digits += (mantissa > 0.0);
+                    exponent--;
+                }
+                valid = true;
+                ++p;
+            }
+        }
+
+        // Exponent
+        if (valid && (p < i_end) && ((*p == 'e') || (*p == 'E'))) {
+            ++p;
+            bool negativeExp = false;
+            if ((p < i_end) && ((*p == '-') || (*p == '+'))) {
+                negativeExp = (*p == '-');
+                ++p;
+            }
+            int e = 0;
+            while ((p < i_end) && (*p >= '0') && (*p <= '9')) {
+                if (e < 10000) {
+                    e = 10 * e + (*p - '0');
+                }
+                ++p;
+            }
+            exponent += negativeExp ? -e : e;
+        }
+
+        // Tokens which are not numbers are skipped
+        if (!valid || ((p < i_end) && (*p != ' ') && (*p != '\t') && (*p != '\r') && (*p != '(') && (*p != ')'))) {
+            while ((p < i_end) && (*p != ' ') && (*p != '\t')) {
+                ++p;
+            }
+            continue;
+        }
+
+        if (exponent == 0) {
+            o_value = mantissa;
+        } else if ((exponent > 0) && (exponent <= 22)) {
+            o_value = mantissa * POW10[exponent];
+        } else if ((exponent < 0) && (exponent >= -22)) {
+            o_value = mantissa / POW10[-exponent];
+        } else {
+            o_value = mantissa * pow(10.0, exponent);
+        }
+        if (negative) {
+            o_value = -o_value;
+        }
+
+        io_pos = p;
+        return true;
+    }
+
+    io_pos = p;
+    return false;
+}
+/* *********************************************************************************************************************** */
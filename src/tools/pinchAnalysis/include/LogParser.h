@@ -0,0 +1,155 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_LOGPARSER_H__
+#define __ICUB_INTERACTIONFORCES_LOGPARSER_H__
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <yarp/os/Thread.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Consumer of the rows of a dataDumper log.
+         */
+        class LogRowHandler {
+            public:
+                virtual ~LogRowHandler() {}
+
+                /**
+                 * Process a row.
+                 * @param i_time the row timestamp
+                 * @param i_values the row data, only valid for the duration of the call
+                 * @param i_size the number of values
+                 */
+                virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) = 0;
+
+                /**
+                 * Stop the parsing of the current chunk.
+                 */
+                virtual bool done(void) const { return false; }
+        };
+
+
+        /**
+         * Parallel parser of the data.log files written by dataDumper.
+         * Each line is "seq stamp [stamp] value value ...". The file is split in as many chunks as handlers, each
+         * chunk is parsed in its own thread and its rows are delivered, in file order, to its own handler.
+         * A chunk owns the lines that start within it. Numbers are parsed in place, without allocations.
+         */
+        class LogParser {
+            private:
+                /**
+                 * Parser of a single chunk of the log.
+                 */
+                class ChunkReader : public yarp::os::Thread {
+                    private:
+                        const LogParser &parser;
+                        std::string fileName;
+                        off_t begin;
+                        off_t end;
+                        LogRowHandler *handler;
+                        std::vector<char> buffer;
+                        std::vector<double> row;
+                        off_t bytes;
+                        bool ok;
+
+                    public:
+                        ChunkReader(const LogParser &aParser, const std::string &aFileName, const off_t &aBegin, const off_t &aEnd,
+                                LogRowHandler *aHandler);
+                        virtual void run();
+                        bool success(void) const { return ok; }
+                        off_t getBytes(void) const { return bytes; }
+                };
+
+                /** The number of timestamp columns after the sequence number. The last one is used. */
+                int nStamps;
+
+                /** The read block size in bytes. */
+                size_t blockSize;
+
+                std::string dbgTag;
+
+            public:
+                LogParser(const int &i_nStamps, const size_t &i_blockSize = 4 << 20);
+
+                /**
+                 * Parse a log file.
+                 * @param i_file the log file
+                 * @param i_handlers the handlers, one per chunk
+                 * @param o_bytes the file size in bytes
+                 * @return true/false on success/failure
+                 */
+                bool parse(const std::string &i_file, const std::vector<LogRowHandler*> &i_handlers, double &o_bytes);
+
+                /**
+                 * Parse the rows within a time range, reading the file from a known offset.
+                 * @param i_file the log file
+                 * @param i_offset an offset preceding all rows of the range, -1 to search it by bisection
+                 * @param i_from the range start
+                 * @param i_to the range end
+                 * @param i_handler the row handler
+                 * @param o_bytes the number of bytes read
+                 * @return true/false on success/failure
+                 */
+                bool parseRange(const std::string &i_file, const int64_t &i_offset, const double &i_from, const double &i_to,
+                        LogRowHandler *i_handler, double &o_bytes);
+
+                /**
+                 * Find by bisection an offset preceding all rows at or after the given time, assuming ordered timestamps.
+                 * @param i_file the open log file
+                 * @param i_size the file size
+                 * @param i_time the time
+                 * @return the offset
+                 */
+                off_t seekTime(FILE *i_file, const off_t &i_size, const double &i_time) const;
+
+                /**
+                 * Parse a single line.
+                 * @param i_begin the first character of the line
+                 * @param i_end one past the last character of the line
+                 * @param io_row the row buffer
+                 * @param o_time the row timestamp
+                 * @return the number of values, -1 if the line is not a valid row
+                 */
+                int parseLine(const char *i_begin, const char *i_end, std::vector<double> &io_row, double &o_time) const;
+
+                /**
+                 * Parse the next number of a line, skipping separators and list delimiters.
+                 * @param io_pos the parsing position, moved past the number
+                 * @param i_end the end of the line
+                 * @param o_value the parsed number
+                 * @return false at the end of the line
+                 */
+                static bool parseNumber(const char *&io_pos, const char *i_end, double &o_value);
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
@@ -0,0 +1,474 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+/**
+ * \defgroup pinchAnalysis pinchAnalysis
+ * Offline analysis of the pinching experiments.
+ * The tool reads the dataDumper logs of the arm joints, of the compensated skin and of the nano17, segments
+ * the pinches on the position of the pinching joint and writes one summary row per pinch, using the same metric
+ * definitions as the fingerForce module. The logs are parsed in parallel.
+ *
+ * Parameters:
+ *  --from, --context   the fingerForce configuration providing the [finger] group
+ *  --dataDir           the dataDumper directory of the arm, e.g. /var/usr/fg/data/pinch/right
+ *  --posLog, --skinLog, --ftLog    override the log files
+ *  --threads           the number of parser threads
+ *  --stamps            the number of timestamp columns in the logs (2 with --txTime --rxTime)
+ *  --threshold         the joint displacement from startPos marking a pinch
+ *  --index             the pinch segment index written by the module, used in place of the joint threshold
+ *  --pinch             with --index, analyse a single pinch by seeking directly to it in the logs
+ *  --lag               also estimate the skin to nano17 lag of each pinch, using the [lag] group
+ *  --store             also append the pinches to the results store in this directory
+ *  --session           the session label of the stored pinches, default the dataDir
+ *  --hand              the hand of the stored pinches, default the whichArm of the configuration
+ *  --out               the output file, default standard output
+ */
+
+
+#include "LogParser.h"
+#include "PinchMetrics.h"
+#include "SegmentIndex.h"
+#include "LagEstimator.h"
+#include "ExperimentConfig.h"
+#include "ResultStore.h"
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+
+#include <unistd.h>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/Time.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::LogParser;
+using iCub::interactionForces::LogRowHandler;
+using iCub::interactionForces::PinchMetrics;
+using iCub::interactionForces::PinchSummary;
+using iCub::interactionForces::SegmentIndex;
+using iCub::interactionForces::PinchSegment;
+using iCub::interactionForces::PHASE_PRESS;
+using iCub::interactionForces::PHASE_RAISE;
+using iCub::interactionForces::PHASE_REST;
+using iCub::interactionForces::LagSignals;
+using iCub::interactionForces::LagEstimator;
+using iCub::interactionForces::LagEstimate;
+using iCub::interactionForces::ExperimentConfig;
+using iCub::interactionForces::ExperimentParameters;
+using iCub::interactionForces::ResultWriter;
+using iCub::interactionForces::ResultStore;
+using iCub::interactionForces::PinchResult;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+/**
+ * The time span of the pinches.
+ */
+struct Segments {
+    vector<double> start;
+    vector<double> end;
+
+    /**
+     * Find the pinch containing the given time.
+     * @return the pinch index, -1 if none
+     */
+    int find(const double &i_time) const {
+        vector<double>::const_iterator it = std::upper_bound(start.begin(), start.end(), i_time);
+        if (it == start.begin()) {
+            return -1;
+        }
+        int k = (int) (it - start.begin()) - 1;
+        return (i_time <= end[k]) ? k : -1;
+    }
+};
+
+
+/**
+ * The part of the logs to parse: the whole files in parallel, or a single time range from a known offset.
+ */
+struct LogRange {
+    bool ranged;
+    double from;
+    double to;
+};
+
+
+/**
+ * Parse a log according to the range.
+ */
+bool parseLog(LogParser &io_parser, const string &i_file, const int64_t &i_offset, const LogRange &i_range,
+        const vector<LogRowHandler*> &i_handlers, double &o_bytes) {
+    if (i_range.ranged) {
+        return io_parser.parseRange(i_file, i_offset, i_range.from, i_range.to, i_handlers[0], o_bytes);
+    }
+
+    return io_parser.parse(i_file, i_handlers, o_bytes);
+}
+
+
+/**
+ * Collect the position of the pinching joint.
+ */
+class JointHandler : public LogRowHandler {
+    public:
+        int joint;
+        vector<double> time;
+        vector<double> position;
+
+        JointHandler(const int &aJoint) : joint(aJoint) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            if ((joint >= 0) && ((size_t) joint < i_size)) {
+                time.push_back(i_time);
+                position.push_back(i_values[joint]);
+            }
+        }
+};
+
+
+/**
+ * Accumulate the sensor samples of each pinch.
+ */
+class SensorHandler : public LogRowHandler {
+    public:
+        const Segments &segments;
+        bool isSkin;
+        vector<PinchMetrics> metrics;
+
+        /** The lag signals of each pinch, empty if the lag is not estimated. */
+        const vector<int> &fingertips;
+        vector<LagSignals> signals;
+
+        SensorHandler(const Segments &aSegments, const bool &aIsSkin, const vector<PinchMetrics> &aMetrics,
+                const vector<int> &aFingertips, const size_t &aLagPinches)
+            : segments(aSegments), isSkin(aIsSkin), metrics(aMetrics), fingertips(aFingertips), signals(aLagPinches) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            int k = segments.find(i_time);
+            if (k >= 0) {
+                if (isSkin) {
+                    metrics[k].addSkin(i_values, i_size);
+                } else {
+                    metrics[k].addWrench(i_values, i_size);
+                }
+                if (!signals.empty()) {
+                    if (isSkin) {
+                        signals[k].addSkin(i_time, i_values, i_size, fingertips);
+                    } else {
+                        signals[k].addWrench(i_time, i_values, i_size);
+                    }
+                }
+            }
+        }
+};
+
+
+/**
+ * Parse a sensor log and merge its samples into the pinch metrics and, if not empty, into the lag signals.
+ */
+bool parseSensorLog(LogParser &io_parser, const string &i_file, const int64_t &i_offset, const LogRange &i_range,
+        const int &i_threads, const Segments &i_segments, const bool &i_isSkin, vector<PinchMetrics> &io_metrics,
+        const vector<int> &i_fingertips, vector<LagSignals> &io_signals, double &o_bytes) {
+    // Empty accumulators for each chunk
+    vector<PinchMetrics> empty(io_metrics);
+    for (size_t k = 0; k < empty.size(); ++k) {
+        empty[k].reset(io_metrics[k].getSummary().index, io_metrics[k].getSummary().start);
+    }
+
+    vector<SensorHandler*> handlers;
+    vector<LogRowHandler*> rowHandlers;
+    for (int i = 0; i < i_threads; ++i) {
+        handlers.push_back(new SensorHandler(i_segments, i_isSkin, empty, i_fingertips, io_signals.size()));
+        rowHandlers.push_back(handlers.back());
+    }
+
+    // The chunks are handled in file order, hence the signals are appended in time order
+    bool ok = parseLog(io_parser, i_file, i_offset, i_range, rowHandlers, o_bytes);
+    for (size_t i = 0; i < handlers.size(); ++i) {
+        for (size_t k = 0; k < io_metrics.size(); ++k) {
+            io_metrics[k].merge(handlers[i]->metrics[k]);
+        }
+        for (size_t k = 0; k < io_signals.size(); ++k) {
+            io_signals[k].append(handlers[i]->signals[k]);
+        }
+        delete handlers[i];
+    }
+
+    return ok;
+}
+
+
+int main(int argc, char *argv[]) {
+    string dbgTag = "pinchAnalysis: ";
+
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.setDefaultConfigFile("confFingertipsRight.ini");
+    rf.setDefaultContext("fingerForce");
+    rf.configure("ICUB_ROOT", argc, argv);
+
+    // Pinching joint definition, as in the module
+    Bottle &fingerGroup = rf.findGroup("finger");
+    int joint = fingerGroup.check("joint", Value(11)).asInt();
+    double startPos = fingerGroup.check("startPos", Value(0.0)).asDouble();
+    vector<int> fingertips;
+    Bottle *tips = fingerGroup.find("fingertips").asList();
+    if (tips != NULL) {
+        for (int i = 0; i < tips->size(); ++i) {
+            fingertips.push_back(tips->get(i).asInt());
+        }
+    } else {
+        for (int i = 0; i < 5; ++i) {
+            fingertips.push_back(i);
+        }
+    }
+
+    // Tool options
+    string dataDir = rf.check("dataDir", Value("."), "The dataDumper directory of the arm.").asString().c_str();
+    string posLog = rf.check("posLog", Value((dataDir + "/pos/data.log").c_str()), "The arm joints log.").asString().c_str();
+    string skinLog = rf.check("skinLog", Value((dataDir + "/skin/comp/data.log").c_str()), "The compensated skin log.").asString().c_str();
+    string ftLog = rf.check("ftLog", Value((dataDir + "/nano17/data.log").c_str()), "The nano17 log.").asString().c_str();
+    int nThreads = rf.check("threads", Value((int) sysconf(_SC_NPROCESSORS_ONLN)), "The number of parser threads.").asInt();
+    int nStamps = rf.check("stamps", Value(1), "The number of timestamp columns.").asInt();
+    double threshold = rf.check("threshold", Value(1.0), "The joint displacement marking a pinch.").asDouble();
+    string outFile = rf.check("out", Value(""), "The output file.").asString().c_str();
+    string indexFile = rf.check("index", Value(""), "The pinch segment index.").asString().c_str();
+    int pinch = rf.check("pinch", Value(-1), "The pinch to analyse.").asInt();
+    bool estimateLag = rf.check("lag");
+    string storeDir = rf.check("store", Value(""), "The results store directory.").asString().c_str();
+    string session = rf.check("session", Value(dataDir.c_str()), "The session label of the stored pinches.").asString().c_str();
+    string hand = rf.check("hand", rf.check("whichArm", Value("right")), "The hand of the stored pinches.").asString().c_str();
+    if (nThreads < 1) {
+        nThreads = 1;
+    }
+
+    LogParser parser(nStamps);
+    double totalBytes = 0.0;
+    double bytes = 0.0;
+    double start = Time::now();
+
+
+    /* ******* Indexed pinches.                                     ******* */
+    // A pinch spans from the start of the press to the end of the raise
+    Segments segments;
+    vector<PinchMetrics> metrics;
+    LogRange range;
+    range.ranged = false;
+    int64_t posOffset = -1;
+    int64_t skinOffset = -1;
+    int64_t ftOffset = -1;
+    SegmentIndex index;
+    if (!indexFile.empty()) {
+        if (!index.load(indexFile)) {
+            return 1;
+        }
+
+        if (pinch >= 0) {
+            // Seek directly to the pinch
+            const PinchSegment *press = index.find(pinch, PHASE_PRESS);
+            const PinchSegment *raise = index.find(pinch, PHASE_RAISE);
+            if ((press == NULL) || (raise == NULL)) {
+                cerr << dbgTag << "Pinch " << pinch << " is not in the index. \n";
+                return 1;
+            }
+            range.ranged = true;
+            range.from = press->start;
+            range.to = raise->end;
+            posOffset = (index.getStream("pos") >= 0) ? press->offsets[index.getStream("pos")] : -1;
+            skinOffset = (index.getStream("skin_comp") >= 0) ? press->offsets[index.getStream("skin_comp")] : -1;
+            ftOffset = (index.getStream("nano17") >= 0) ? press->offsets[index.getStream("nano17")] : -1;
+            nThreads = 1;
+
+            metrics.push_back(PinchMetrics());
+            metrics.back().setup(joint, fingertips);
+            metrics.back().reset(pinch, range.from);
+            segments.start.push_back(range.from);
+            segments.end.push_back(range.to);
+        } else {
+            const vector<PinchSegment> &all = index.getSegments();
+            for (size_t i = 0; i < all.size(); ++i) {
+                if (all[i].phase == PHASE_REST) {
+                    continue;
+                }
+                if (metrics.empty() || (metrics.back().getSummary().index != all[i].pinch)) {
+                    metrics.push_back(PinchMetrics());
+                    metrics.back().setup(joint, fingertips);
+                    metrics.back().reset(all[i].pinch, all[i].start);
+                    segments.start.push_back(all[i].start);
+                    segments.end.push_back(all[i].end);
+                } else {
+                    segments.end.back() = all[i].end;
+                }
+            }
+        }
+    }
+
+
+    /* ******* Pinch segmentation.                                  ******* */
+    vector<JointHandler*> jointHandlers;
+    vector<LogRowHandler*> rowHandlers;
+    for (int i = 0; i < nThreads; ++i) {
+        jointHandlers.push_back(new JointHandler(joint));
+        rowHandlers.push_back(jointHandlers.back());
+    }
+    if (!parseLog(parser, posLog, posOffset, range, rowHandlers, bytes)) {
+        return 1;
+    }
+    totalBytes += bytes;
+
+    bool pinching = false;
+    for (size_t i = 0; i < jointHandlers.size(); ++i) {
+        const vector<double> &t = jointHandlers[i]->time;
+        const vector<double> &q = jointHandlers[i]->position;
+        for (size_t j = 0; j < t.size(); ++j) {
+            if (!indexFile.empty()) {
+                int k = segments.find(t[j]);
+                if (k >= 0) {
+                    metrics[k].addDepth(q[j]);
+                }
+                continue;
+            }
+
+            bool active = (q[j] - startPos > threshold);
+            if (active && !pinching) {
+                metrics.push_back(PinchMetrics());
+                metrics.back().setup(joint, fingertips);
+                metrics.back().reset((int) metrics.size() - 1, t[j]);
+                segments.start.push_back(t[j]);
+                segments.end.push_back(t[j]);
+            }
+            if (active) {
+                metrics.back().addDepth(q[j]);
+                segments.end.back() = t[j];
+            }
+            pinching = active;
+        }
+        delete jointHandlers[i];
+    }
+    cerr << dbgTag << "Found " << segments.start.size() << " pinches. \n";
+
+
+    /* ******* Sensor logs.                                         ******* */
+    vector<LagSignals> signals(estimateLag ? metrics.size() : 0);
+    for (size_t k = 0; k < signals.size(); ++k) {
+        signals[k].skin.resize(fingertips.size());
+    }
+    if (parseSensorLog(parser, skinLog, skinOffset, range, nThreads, segments, true, metrics, fingertips, signals, bytes)) {
+        totalBytes += bytes;
+    }
+    if (parseSensorLog(parser, ftLog, ftOffset, range, nThreads, segments, false, metrics, fingertips, signals, bytes)) {
+        totalBytes += bytes;
+    }
+
+    double elapsed = Time::now() - start;
+    cerr << dbgTag << "Parsed " << totalBytes / 1e6 << " MB in " << elapsed << " s ("
+        << totalBytes / 1e9 / elapsed << " GB/s) with " << nThreads << " threads. \n";
+
+
+    /* ******* Summary table.                                       ******* */
+    std::ofstream file;
+    if (!outFile.empty()) {
+        file.open(outFile.c_str());
+        if (!file.is_open()) {
+            cerr << dbgTag << "Could not open " << outFile << ". \n";
+            return 1;
+        }
+    }
+    std::ostream &out = outFile.empty() ? cout : file;
+
+    PinchMetrics::writeHeader(out);
+    for (size_t k = 0; k < metrics.size(); ++k) {
+        PinchMetrics::write(out, metrics[k].finish(segments.end[k]));
+    }
+
+
+    /* ******* Skin lag table.                                      ******* */
+    if (estimateLag) {
+        // Same estimator settings as the module
+        Bottle &lagGroup = rf.findGroup("lag");
+        LagEstimator estimator;
+        if (!estimator.setup(lagGroup.check("window", Value(10.0)).asDouble(), lagGroup.check("resolution", Value(0.001)).asDouble(),
+                    lagGroup.check("maxLag", Value(0.2)).asDouble(), lagGroup.check("smoothing", Value(0.05)).asDouble())) {
+            cerr << dbgTag << "Invalid [lag] parameters. \n";
+            return 1;
+        }
+
+        out << "# pinch fingertip lag confidence\n";
+        for (size_t k = 0; k < signals.size(); ++k) {
+            for (size_t f = 0; f < fingertips.size(); ++f) {
+                LagEstimate estimate;
+                if (estimator.estimate(signals[k].forceTime, signals[k].force, signals[k].skinTime, signals[k].skin[f], estimate)) {
+                    out << metrics[k].getSummary().index << " " << fingertips[f] << " " << estimate.lag << " " << estimate.confidence << "\n";
+                }
+            }
+        }
+    }
+
+
+    /* ******* Results store.                                       ******* */
+    if (!storeDir.empty()) {
+        ExperimentParameters experiment;
+        if (!ExperimentConfig::read(rf.findGroup("experiment"), fingerGroup, experiment)) {
+            cerr << dbgTag << "Invalid experiment parameters. \n";
+            return 1;
+        }
+
+        PinchResult result;
+        result.text[iCub::interactionForces::RESULT_SESSION] = session;
+        result.text[iCub::interactionForces::RESULT_HAND] = hand;
+        result.text[iCub::interactionForces::RESULT_FINGER] = ResultStore::getFingerName(joint);
+        result.text[iCub::interactionForces::RESULT_CONFIG] = ExperimentConfig::snapshot(experiment);
+
+        ResultWriter writer;
+        if (!writer.open(storeDir, "pinchAnalysis", (unsigned int) metrics.size() + 1)) {
+            return 1;
+        }
+        for (size_t k = 0; k < metrics.size(); ++k) {
+            result.setSummary(metrics[k].getSummary());
+            result.setStamp(segments.start[k]);
+            // The commanded depth is only known from the index
+            const PinchSegment *press = indexFile.empty() ? NULL : index.find(metrics[k].getSummary().index, PHASE_PRESS);
+            result.value[iCub::interactionForces::RESULT_DEPTH] = (press != NULL) ? press->fingerDepth : std::numeric_limits<double>::quiet_NaN();
+            writer.append(result);
+        }
+        if (!writer.close()) {
+            return 1;
+        }
+        cerr << dbgTag << "Stored " << metrics.size() << " pinches of session " << session << " in " << storeDir << ". \n";
+    }
+
+    return 0;
+}
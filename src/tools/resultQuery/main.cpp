@@ -0,0 +1,452 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+/**
+ * \defgroup resultQuery resultQuery
+ * Queries of the pinch results store written by the fingerForce module and by the pinchAnalysis tool.
+ * The tool selects the pinches matching the filters and aggregates their metrics (count, mean, standard deviation,
+ * minimum and maximum) per group, or lists them. The filters on the hand, finger, depth and date use the indexes of
+ * the store, so only the matching rows and the needed columns are read.
+ *
+ * Parameters:
+ *  --store             the results store directory, default /var/usr/fg/data/results
+ *  --session, --hand, --finger     the accepted values, a single value or a list, e.g. --hand left --finger (index middle)
+ *  --minDepth, --maxDepth          the range of the commanded finger depth
+ *  --from, --to        the range of dates, as YYYYMMDD
+ *  --range             other ranges, as a list of (column min max), e.g. ((peakForce 0.5 5.0))
+ *  --groupBy           the grouping columns, e.g. (hand depth), default none
+ *  --metrics           the aggregated columns, default all metrics
+ *  --rows              list up to this number of matching pinches instead of aggregating
+ *  --compact           merge the segments smaller than this number of rows and exit
+ */
+
+
+#include "ResultStore.h"
+
+#include <cmath>
+#include <ctime>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <algorithm>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/Time.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+using std::map;
+
+using iCub::interactionForces::ResultStore;
+using iCub::interactionForces::ResultSegment;
+using iCub::interactionForces::ResultFilter;
+using iCub::interactionForces::ResultHandler;
+using iCub::interactionForces::N_RESULT_TEXT;
+using iCub::interactionForces::N_RESULT_COLUMNS;
+
+using yarp::os::Bottle;
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+/**
+ * Read a list of names from a single value or a list.
+ */
+static vector<string> getNames(const Value &i_value) {
+    vector<string> names;
+    if (i_value.isList()) {
+        for (int i = 0; i < i_value.asList()->size(); ++i) {
+            names.push_back(i_value.asList()->get(i).toString().c_str());
+        }
+    } else if (!i_value.isNull()) {
+        names.push_back(i_value.toString().c_str());
+    }
+    return names;
+}
+
+/**
+ * Convert a local date (YYYYMMDD) to seconds since the epoch.
+ */
+static double getStamp(const int &i_day) {
+    struct tm date;
+    memset(&date, 0, sizeof(date));
+    date.tm_year = i_day / 10000 - 1900;
+    date.tm_mon = (i_day / 100) % 100 - 1;
+    date.tm_mday = i_day % 100;
+    date.tm_isdst = -1;
+    return (double) mktime(&date);
+}
+
+
+/**
+ * Statistics of a metric over a group.
+ */
+struct MetricStats {
+    unsigned long n;
+    double sum;
+    double sumSq;
+    double min;
+    double max;
+
+    MetricStats() : n(0), sum(0.0), sumSq(0.0), min(HUGE_VAL), max(-HUGE_VAL) {}
+
+    void add(const double &i_value) {
+        if (i_value != i_value) {
+            return;
+        }
+        n++;
+        sum += i_value;
+        sumSq += i_value * i_value;
+        min = std::min(min, i_value);
+        max = std::max(max, i_value);
+    }
+};
+
+
+/**
+ * A group of pinches: the values of the grouping columns and the statistics of the metrics.
+ */
+struct Group {
+    vector<string> text;
+    vector<double> value;
+    unsigned long count;
+    vector<MetricStats> stats;
+};
+
+
+/**
+ * Order of the groups, by text or by value in each grouping column.
+ */
+struct LessGroup {
+    const vector<int> &columns;
+
+    LessGroup(const vector<int> &aColumns) : columns(aColumns) {}
+
+    bool operator()(const Group *i_a, const Group *i_b) const {
+        for (size_t c = 0; c < columns.size(); ++c) {
+            if (columns[c] < N_RESULT_TEXT) {
+                int order = i_a->text[c].compare(i_b->text[c]);
+                if (order != 0) {
+                    return order < 0;
+                }
+            } else if (i_a->value[c] != i_b->value[c]) {
+                return i_a->value[c] < i_b->value[c];
+            }
+        }
+        return false;
+    }
+};
+
+
+/**
+ * Aggregation of the metrics per group.
+ */
+class Aggregator : public ResultHandler {
+    private:
+        vector<int> groupBy;
+        vector<int> metrics;
+
+        /** The groups by their encoded key. */
+        map<string, Group*> groups;
+
+    public:
+        unsigned long selected;
+
+        Aggregator(const vector<int> &aGroupBy, const vector<int> &aMetrics) : groupBy(aGroupBy), metrics(aMetrics), selected(0) {}
+
+        ~Aggregator() {
+            for (map<string, Group*>::iterator it = groups.begin(); it != groups.end(); ++it) {
+                delete it->second;
+            }
+        }
+
+        virtual bool onRows(ResultSegment &i_segment, const vector<uint32_t> &i_rows) {
+            for (size_t c = 0; c < groupBy.size(); ++c) {
+                if (!i_segment.load(groupBy[c])) {
+                    return false;
+                }
+            }
+            for (size_t m = 0; m < metrics.size(); ++m) {
+                if (!i_segment.load(metrics[m])) {
+                    return false;
+                }
+            }
+
+            // The key of a row is made of the codes and values of the segment, mapped once to a global group
+            map<vector<double>, Group*> local;
+            vector<double> key(groupBy.size());
+            for (size_t r = 0; r < i_rows.size(); ++r) {
+                uint32_t row = i_rows[r];
+                for (size_t c = 0; c < groupBy.size(); ++c) {
+                    key[c] = (groupBy[c] < N_RESULT_TEXT) ? i_segment.getCodes(groupBy[c])[row] : i_segment.getValues(groupBy[c])[row];
+                }
+                map<vector<double>, Group*>::iterator it = local.find(key);
+                if (it == local.end()) {
+                    it = local.insert(std::make_pair(key, getGroup(i_segment, row))).first;
+                }
+                Group *group = it->second;
+                group->count++;
+                for (size_t m = 0; m < metrics.size(); ++m) {
+                    group->stats[m].add(i_segment.getValues(metrics[m])[row]);
+                }
+            }
+            selected += i_rows.size();
+
+            return true;
+        }
+
+        void write(std::ostream &o_stream) {
+            o_stream << "#";
+            for (size_t c = 0; c < groupBy.size(); ++c) {
+                o_stream << " " << ResultStore::getColumnName(groupBy[c]);
+            }
+            o_stream << " count";
+            for (size_t m = 0; m < metrics.size(); ++m) {
+                const char *name = ResultStore::getColumnName(metrics[m]);
+                o_stream << " " << name << ".mean " << name << ".std " << name << ".min " << name << ".max";
+            }
+            o_stream << "\n";
+
+            vector<Group*> sorted;
+            for (map<string, Group*>::iterator it = groups.begin(); it != groups.end(); ++it) {
+                sorted.push_back(it->second);
+            }
+            std::sort(sorted.begin(), sorted.end(), LessGroup(groupBy));
+
+            for (size_t g = 0; g < sorted.size(); ++g) {
+                const Group &group = *sorted[g];
+                for (size_t c = 0; c < groupBy.size(); ++c) {
+                    if (groupBy[c] < N_RESULT_TEXT) {
+                        o_stream << "\"" << group.text[c] << "\" ";
+                    } else {
+                        o_stream << std::setprecision(10) << group.value[c] << " ";
+                    }
+                }
+                o_stream << group.count << std::setprecision(6);
+                for (size_t m = 0; m < metrics.size(); ++m) {
+                    const MetricStats &stats = group.stats[m];
+                    if (stats.n == 0) {
+                        o_stream << " nan nan nan nan";
+                        continue;
+                    }
+                    double mean = stats.sum / stats.n;
+                    double var = (stats.n > 1) ? std::max(stats.sumSq - stats.n * mean * mean, 0.0) / (stats.n - 1) : 0.0;
+                    o_stream << " " << mean << " " << sqrt(var) << " " << stats.min << " " << stats.max;
+                }
+                o_stream << "\n";
+            }
+        }
+
+    private:
+        /**
+         * Find or create the group of a row.
+         */
+        Group* getGroup(ResultSegment &i_segment, const uint32_t &i_row) {
+            std::ostringstream encoded;
+            encoded << std::setprecision(17);
+            vector<string> text(groupBy.size());
+            vector<double> value(groupBy.size(), 0.0);
+            for (size_t c = 0; c < groupBy.size(); ++c) {
+                if (groupBy[c] < N_RESULT_TEXT) {
+                    text[c] = i_segment.getDictionary(groupBy[c])[i_segment.getCodes(groupBy[c])[i_row]];
+                    encoded << text[c].size() << ":" << text[c];
+                } else {
+                    value[c] = i_segment.getValues(groupBy[c])[i_row];
+                    encoded << value[c];
+                }
+                encoded << "|";
+            }
+
+            Group *&group = groups[encoded.str()];
+            if (group == NULL) {
+                group = new Group();
+                group->text = text;
+                group->value = value;
+                group->count = 0;
+                group->stats.resize(metrics.size());
+            }
+            return group;
+        }
+};
+
+
+/**
+ * Listing of the selected pinches.
+ */
+class Lister : public ResultHandler {
+    private:
+        std::ostream &out;
+        unsigned long limit;
+
+    public:
+        unsigned long selected;
+
+        Lister(std::ostream &aOut, const unsigned long &aLimit) : out(aOut), limit(aLimit), selected(0) {
+            out << "#";
+            for (int c = 0; c < N_RESULT_COLUMNS; ++c) {
+                out << " " << ResultStore::getColumnName(c);
+            }
+            out << "\n";
+        }
+
+        virtual bool onRows(ResultSegment &i_segment, const vector<uint32_t> &i_rows) {
+            iCub::interactionForces::PinchResult result;
+            for (size_t r = 0; (r < i_rows.size()) && (selected < limit); ++r, ++selected) {
+                if (!i_segment.getRow(i_rows[r], result)) {
+                    return false;
+                }
+                for (int c = 0; c < N_RESULT_COLUMNS; ++c) {
+                    if (c < N_RESULT_TEXT) {
+                        out << (c > 0 ? " " : "") << "\"" << result.text[c] << "\"";
+                    } else {
+                        out << " " << std::setprecision((c == iCub::interactionForces::RESULT_STAMP) ? 16 : 10) << result.value[c];
+                    }
+                }
+                out << "\n";
+            }
+
+            return selected < limit;
+        }
+};
+
+
+int main(int argc, char *argv[]) {
+    string dbgTag = "resultQuery: ";
+
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.configure("ICUB_ROOT", argc, argv);
+
+    string storeDir = rf.check("store", Value("/var/usr/fg/data/results"), "The results store directory.").asString().c_str();
+    ResultStore store;
+    if (!store.open(storeDir)) {
+        return 1;
+    }
+    double start = Time::now();
+
+
+    /* ******* Compaction.                                          ******* */
+    if (rf.check("compact")) {
+        int rows = rf.find("compact").asInt();
+        if (rows <= 0) {
+            rows = 1000000;
+        }
+        size_t before = store.getSegments().size();
+        if (!store.compact((unsigned int) rows)) {
+            return 1;
+        }
+        cerr << dbgTag << "Compacted " << before << " segments into " << store.getSegments().size() << " in "
+            << Time::now() - start << " s. \n";
+        return 0;
+    }
+
+
+    /* ******* Filters.                                             ******* */
+    ResultFilter filter;
+    filter.values[iCub::interactionForces::RESULT_SESSION] = getNames(rf.find("session"));
+    filter.values[iCub::interactionForces::RESULT_HAND] = getNames(rf.find("hand"));
+    filter.values[iCub::interactionForces::RESULT_FINGER] = getNames(rf.find("finger"));
+    if (rf.check("minDepth")) {
+        filter.min[iCub::interactionForces::RESULT_DEPTH] = rf.find("minDepth").asDouble();
+    }
+    if (rf.check("maxDepth")) {
+        filter.max[iCub::interactionForces::RESULT_DEPTH] = rf.find("maxDepth").asDouble();
+    }
+    // Whole days, the end date included
+    if (rf.check("from")) {
+        filter.min[iCub::interactionForces::RESULT_STAMP] = getStamp(rf.find("from").asInt());
+    }
+    if (rf.check("to")) {
+        filter.max[iCub::interactionForces::RESULT_STAMP] = getStamp(rf.find("to").asInt()) + 86400.0 - 1e-6;
+    }
+    Bottle *ranges = rf.find("range").asList();
+    if (ranges != NULL) {
+        for (int i = 0; i < ranges->size(); ++i) {
+            Bottle *range = ranges->get(i).asList();
+            int column = (range != NULL) ? ResultStore::getColumn(range->get(0).asString().c_str()) : N_RESULT_COLUMNS;
+            if ((range == NULL) || (range->size() != 3) || (column < N_RESULT_TEXT) || (column >= N_RESULT_COLUMNS)) {
+                cerr << dbgTag << "Invalid range, expected (column min max) of a numeric column. \n";
+                return 1;
+            }
+            filter.min[column] = range->get(1).asDouble();
+            filter.max[column] = range->get(2).asDouble();
+        }
+    }
+
+
+    /* ******* Query.                                               ******* */
+    uint64_t total = 0;
+    unsigned long selected = 0;
+    if (rf.check("rows")) {
+        Lister lister(cout, (unsigned long) std::max(rf.find("rows").asInt(), 0));
+        if (!store.select(filter, &lister, total)) {
+            return 1;
+        }
+        selected = lister.selected;
+    } else {
+        vector<int> groupBy;
+        vector<string> names = getNames(rf.find("groupBy"));
+        for (size_t i = 0; i < names.size(); ++i) {
+            groupBy.push_back(ResultStore::getColumn(names[i]));
+            if (groupBy.back() == N_RESULT_COLUMNS) {
+                cerr << dbgTag << "Unknown column " << names[i] << ". \n";
+                return 1;
+            }
+        }
+
+        vector<int> metrics;
+        names = getNames(rf.find("metrics"));
+        if (names.empty()) {
+            for (int c = iCub::interactionForces::RESULT_REACHED; c < N_RESULT_COLUMNS; ++c) {
+                metrics.push_back(c);
+            }
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            metrics.push_back(ResultStore::getColumn(names[i]));
+            if ((metrics.back() < N_RESULT_TEXT) || (metrics.back() == N_RESULT_COLUMNS)) {
+                cerr << dbgTag << "Unknown numeric column " << names[i] << ". \n";
+                return 1;
+            }
+        }
+
+        Aggregator aggregator(groupBy, metrics);
+        if (!store.select(filter, &aggregator, total)) {
+            return 1;
+        }
+        aggregator.write(cout);
+        selected = aggregator.selected;
+    }
+
+    cerr << dbgTag << "Selected " << selected << " of " << total << " pinches from " << store.getSegments().size() << " segments in "
+        << Time::now() - start << " s. \n";
+
+    return 0;
+}
@@ -0,0 +1,431 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#include "SkinArchive.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+#include <stdint.h>
+
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::SkinArchiveWriter;
+using iCub::interactionForces::SkinArchiveReader;
+using iCub::interactionForces::SkinArchiveBlock;
+using iCub::interactionForces::LogRowHandler;
+
+
+/** File signature and format version. */
+static const char MAGIC[4] = {'S', 'K', 'A', 'R'};
+#define VERSION 1
+
+/** Size of the file header, of an index entry and of the footer. */
+#define HEADER_SIZE 16
+#define ENTRY_SIZE 32
+#define FOOTER_SIZE 16
+
+
+/* *********************************************************************************************************************** */
+/* ******* Little endian serialisation                                      ********************************************** */
+static void putU32(unsigned char *o_buf, const uint32_t i_value) {
+    for (int i = 0; i < 4; ++i) {
+        o_buf[i] = (unsigned char) (i_value >> (8 * i));
+    }
+}
+
+static void putU64(unsigned char *o_buf, const uint64_t i_value) {
+    for (int i = 0; i < 8; ++i) {
+        o_buf[i] = (unsigned char) (i_value >> (8 * i));
+    }
+}
+
+static void putF64(unsigned char *o_buf, const double i_value) {
+    uint64_t bits;
+    memcpy(&bits, &i_value, sizeof(bits));
+    putU64(o_buf, bits);
+}
+
+static uint32_t getU32(const unsigned char *i_buf) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= ((uint32_t) i_buf[i]) << (8 * i);
+    }
+    return value;
+}
+
+static uint64_t getU64(const unsigned char *i_buf) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= ((uint64_t) i_buf[i]) << (8 * i);
+    }
+    return value;
+}
+
+static double getF64(const unsigned char *i_buf) {
+    uint64_t bits = getU64(i_buf);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/** Append a zigzag encoded variable length integer. */
+static void putVarint(vector<unsigned char> &o_buf, const int64_t i_value) {
+    uint64_t v = ((uint64_t) i_value << 1) ^ (uint64_t) (i_value >> 63);
+    while (v >= 0x80) {
+        o_buf.push_back((unsigned char) (v | 0x80));
+        v >>= 7;
+    }
+    o_buf.push_back((unsigned char) v);
+}
+
+/** Read a zigzag encoded variable length integer. */
+static bool getVarint(const unsigned char *&io_pos, const unsigned char *i_end, int64_t &o_value) {
+    uint64_t v = 0;
+    int shift = 0;
+    while (io_pos < i_end) {
+        unsigned char b = *io_pos++;
+        v |= ((uint64_t) (b & 0x7F)) << shift;
+        if (!(b & 0x80)) {
+            o_value = (int64_t) (v >> 1) ^ -((int64_t) (v & 1));
+            return true;
+        }
+        shift += 7;
+        if (shift > 63) {
+            return false;
+        }
+    }
+    return false;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Writer                                                           ********************************************** */
+SkinArchiveWriter::SkinArchiveWriter() {
+    file = NULL;
+    nTaxels = 0;
+    blockSamples = 0;
+    blockInfo.nSamples = 0;
+    lastMicros = 0.0;
+    rawBytes = 0.0;
+    ok = false;
+    dbgTag = "SkinArchiveWriter: ";
+}
+
+SkinArchiveWriter::~SkinArchiveWriter() {
+    close();
+}
+
+bool SkinArchiveWriter::open(const string &i_file, const unsigned int &i_nTaxels, const unsigned int &i_blockSamples) {
+    if ((i_nTaxels == 0) || (i_blockSamples == 0)) {
+        cerr << dbgTag << "Invalid archive geometry. \n";
+        return false;
+    }
+
+    file = fopen(i_file.c_str(), "wb");
+    if (file == NULL) {
+        cerr << dbgTag << "Could not create " << i_file << ". \n";
+        return false;
+    }
+    fileName = i_file;
+    nTaxels = i_nTaxels;
+    blockSamples = i_blockSamples;
+
+    previous.assign(nTaxels, 0);
+    current.assign(nTaxels, 0);
+    block.clear();
+    block.reserve(blockSamples * (nTaxels + 4));
+    blockInfo.nSamples = 0;
+    index.clear();
+    rawBytes = 0.0;
+
+    unsigned char header[HEADER_SIZE];
+    memcpy(header, MAGIC, 4);
+    putU32(header + 4, VERSION);
+    putU32(header + 8, nTaxels);
+    putU32(header + 12, blockSamples);
+    ok = (fwrite(header, 1, HEADER_SIZE, file) == HEADER_SIZE);
+
+    return ok;
+}
+
+void SkinArchiveWriter::onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+    if (file == NULL) {
+        return;
+    }
+
+    // Quantise to the native taxel range
+    size_t n = std::min((size_t) nTaxels, i_size);
+    for (size_t i = 0; i < n; ++i) {
+        double v = floor(i_values[i] + 0.5);
+        current[i] = (unsigned char) ((v < 0.0) ? 0.0 : ((v > 255.0) ? 255.0 : v));
+    }
+    for (size_t i = n; i < nTaxels; ++i) {
+        current[i] = 0;
+    }
+
+    // Blocks start from a zero reference so that they can be decoded independently
+    if (blockInfo.nSamples == 0) {
+        blockInfo.start = i_time;
+        lastMicros = 0.0;
+        std::fill(previous.begin(), previous.end(), 0);
+    }
+
+    // Timestamp, in microseconds from the block start
+    double micros = floor((i_time - blockInfo.start) * 1e6 + 0.5);
+    putVarint(block, (int64_t) (micros - lastMicros));
+    lastMicros = micros;
+    blockInfo.end = blockInfo.start + micros * 1e-6;
+
+    // Taxel differences, with runs of unchanged taxels collapsed to (0, length)
+    unsigned int run = 0;
+    for (unsigned int i = 0; i < nTaxels; ++i) {
+        signed char d = (signed char) (unsigned char) (current[i] - previous[i]);
+        unsigned char z = (unsigned char) ((d << 1) ^ (d >> 7));
+        if (z == 0) {
+            if (++run == 255) {
+                block.push_back(0);
+                block.push_back((unsigned char) run);
+                run = 0;
+            }
+        } else {
+            if (run > 0) {
+                block.push_back(0);
+                block.push_back((unsigned char) run);
+                run = 0;
+            }
+            block.push_back(z);
+        }
+    }
+    if (run > 0) {
+        block.push_back(0);
+        block.push_back((unsigned char) run);
+    }
+    previous.swap(current);
+
+    rawBytes += nTaxels * sizeof(double);
+    if (++blockInfo.nSamples == blockSamples) {
+        flushBlock();
+    }
+}
+
+void SkinArchiveWriter::flushBlock(void) {
+    if (blockInfo.nSamples == 0) {
+        return;
+    }
+
+    blockInfo.offset = ftello(file);
+    blockInfo.size = (unsigned int) block.size();
+    if (fwrite(&block[0], 1, block.size(), file) != block.size()) {
+        ok = false;
+    }
+    index.push_back(blockInfo);
+
+    block.clear();
+    blockInfo.nSamples = 0;
+}
+
+bool SkinArchiveWriter::close(void) {
+    if (file == NULL) {
+        return false;
+    }
+
+    flushBlock();
+
+    // Block index
+    off_t indexOffset = ftello(file);
+    unsigned char entry[ENTRY_SIZE];
+    for (size_t i = 0; i < index.size(); ++i) {
+        putU64(entry, (uint64_t) index[i].offset);
+        putU32(entry + 8, index[i].size);
+        putU32(entry + 12, index[i].nSamples);
+        putF64(entry + 16, index[i].start);
+        putF64(entry + 24, index[i].end);
+        if (fwrite(entry, 1, ENTRY_SIZE, file) != ENTRY_SIZE) {
+            ok = false;
+        }
+    }
+
+    unsigned char footer[FOOTER_SIZE];
+    putU64(footer, (uint64_t) indexOffset);
+    putU32(footer + 8, (uint32_t) index.size());
+    memcpy(footer + 12, MAGIC, 4);
+    if (fwrite(footer, 1, FOOTER_SIZE, file) != FOOTER_SIZE) {
+        ok = false;
+    }
+
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    file = NULL;
+
+    if (!ok) {
+        cerr << dbgTag << "Error while writing " << fileName << ". \n";
+    }
+
+    return ok;
+}
+/* *********************************************************************************************************************** */
+
+
+/* *********************************************************************************************************************** */
+/* ******* Reader                                                           ********************************************** */
+SkinArchiveReader::SkinArchiveReader() {
+    file = NULL;
+    nTaxels = 0;
+    blockSamples = 0;
+    dbgTag = "SkinArchiveReader: ";
+}
+
+SkinArchiveReader::~SkinArchiveReader() {
+    close();
+}
+
+bool SkinArchiveReader::open(const string &i_file) {
+    file = fopen(i_file.c_str(), "rb");
+    if (file == NULL) {
+        cerr << dbgTag << "Could not open " << i_file << ". \n";
+        return false;
+    }
+
+    // Header
+    unsigned char header[HEADER_SIZE];
+    if ((fread(header, 1, HEADER_SIZE, file) != HEADER_SIZE) || (memcmp(header, MAGIC, 4) != 0)
+            || (getU32(header + 4) != VERSION)) {
+        cerr << dbgTag << i_file << " is not a skin archive. \n";
+        close();
+        return false;
+    }
+    nTaxels = getU32(header + 8);
+    blockSamples = getU32(header + 12);
+
+    // Footer
+    unsigned char footer[FOOTER_SIZE];
+    if ((fseeko(file, -FOOTER_SIZE, SEEK_END) != 0) || (fread(footer, 1, FOOTER_SIZE, file) != FOOTER_SIZE)
+            || (memcmp(footer + 12, MAGIC, 4) != 0)) {
+        cerr << dbgTag << i_file << " is truncated. \n";
+        close();
+        return false;
+    }
+    off_t indexOffset = (off_t) getU64(footer);
+    unsigned int nBlocks = getU32(footer + 8);
+
+    // Block index
+    index.resize(nBlocks);
+    fseeko(file, indexOffset, SEEK_SET);
+    unsigned char entry[ENTRY_SIZE];
+    for (unsigned int i = 0; i < nBlocks; ++i) {
+        if (fread(entry, 1, ENTRY_SIZE, file) != ENTRY_SIZE) {
+            cerr << dbgTag << "Could not read the block index. \n";
+            close();
+            return false;
+        }
+        index[i].offset = (off_t) getU64(entry);
+        index[i].size = getU32(entry + 8);
+        index[i].nSamples = getU32(entry + 12);
+        index[i].start = getF64(entry + 16);
+        index[i].end = getF64(entry + 24);
+    }
+
+    taxels.resize(nTaxels);
+    row.resize(nTaxels);
+
+    return true;
+}
+
+void SkinArchiveReader::close(void) {
+    if (file != NULL) {
+        fclose(file);
+        file = NULL;
+    }
+}
+
+bool SkinArchiveReader::read(const double &i_from, const double &i_to, LogRowHandler *i_handler) {
+    if (file == NULL) {
+        return false;
+    }
+
+    for (size_t i = 0; i < index.size(); ++i) {
+        if ((index[i].end >= i_from) && (index[i].start <= i_to)) {
+            if (!decodeBlock(index[i], i_from, i_to, i_handler)) {
+                cerr << dbgTag << "Corrupted block at offset " << index[i].offset << ". \n";
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool SkinArchiveReader::decodeBlock(const SkinArchiveBlock &i_block, const double &i_from, const double &i_to, LogRowHandler *i_handler) {
+    block.resize(i_block.size);
+    if ((i_block.size == 0) || (fseeko(file, i_block.offset, SEEK_SET) != 0)
+            || (fread(&block[0], 1, i_block.size, file) != i_block.size)) {
+        return false;
+    }
+
+    const unsigned char *p = &block[0];
+    const unsigned char *end = p + block.size();
+    std::fill(taxels.begin(), taxels.end(), 0);
+    int64_t micros = 0;
+    for (unsigned int s = 0; s < i_block.nSamples; ++s) {
+        int64_t dt;
+        if (!getVarint(p, end, dt)) {
+            return false;
+        }
+        micros += dt;
+
+        unsigned int i = 0;
+        while (i < nTaxels) {
+            if (p >= end) {
+                return false;
+            }
+            unsigned char z = *p++;
+            if (z == 0) {
+                if (p >= end) {
+                    return false;
+                }
+                i += *p++;
+            } else {
+                taxels[i] += (unsigned char) ((z >> 1) ^ -(z & 1));
+                i++;
+            }
+        }
+        if (i != nTaxels) {
+            return false;
+        }
+
+        double time = i_block.start + micros * 1e-6;
+        if ((time >= i_from) && (time <= i_to)) {
+            for (unsigned int k = 0; k < nTaxels; ++k) {
+                row[k] = taxels[k];
+            }
+            i_handler->onRow(time, &row[0], nTaxels);
+        }
+    }
+
+    return true;
+}
+/* *********************************************************************************************************************** */
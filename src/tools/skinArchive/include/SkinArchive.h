@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+#ifndef __ICUB_INTERACTIONFORCES_SKINARCHIVE_H__
+#define __ICUB_INTERACTIONFORCES_SKINARCHIVE_H__
+
+#include "LogParser.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace iCub {
+    namespace interactionForces {
+
+        /**
+         * Index entry of an archive block.
+         */
+        struct SkinArchiveBlock {
+            /** The block offset in the file. */
+            off_t offset;
+
+            /** The encoded block size in bytes. */
+            unsigned int size;
+
+            /** The number of samples in the block. */
+            unsigned int nSamples;
+
+            /** The time of the first and of the last sample. */
+            double start;
+            double end;
+        };
+
+
+        /**
+         * Writer of compressed skin archives.
+         * Taxels are quantised to their native 8 bit range and each sample is stored as the per-taxel difference
+         * from the previous one, with runs of unchanged taxels collapsed. Timestamps are stored as microsecond
+         * differences. Samples are grouped in independently decodable blocks, indexed at the end of the file
+         * by time, so that any time range can be read back without decoding the whole archive.
+         */
+        class SkinArchiveWriter : public LogRowHandler {
+            private:
+                FILE *file;
+                std::string fileName;
+                unsigned int nTaxels;
+                unsigned int blockSamples;
+
+                /** The quantised taxels of the previous and of the current sample. */
+                std::vector<unsigned char> previous;
+                std::vector<unsigned char> current;
+
+                /** The encoded samples of the current block. */
+                std::vector<unsigned char> block;
+                SkinArchiveBlock blockInfo;
+                /** The time of the previous sample, in microseconds from the block start. */
+                double lastMicros;
+
+                std::vector<SkinArchiveBlock> index;
+                double rawBytes;
+                bool ok;
+
+                std::string dbgTag;
+
+                void flushBlock(void);
+
+            public:
+                SkinArchiveWriter();
+                virtual ~SkinArchiveWriter();
+
+                /**
+                 * Create an archive.
+                 * @param i_file the archive file
+                 * @param i_nTaxels the number of taxels per sample
+                 * @param i_blockSamples the number of samples per block
+                 * @return true/false on success/failure
+                 */
+                bool open(const std::string &i_file, const unsigned int &i_nTaxels, const unsigned int &i_blockSamples);
+
+                /**
+                 * Write the pending block and the index and close the archive.
+                 * @return true/false on success/failure
+                 */
+                bool close(void);
+
+                /**
+                 * Append a sample. Extra values are ignored, missing taxels are zero.
+                 */
+                virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size);
+
+                /**
+                 * Get the size of the samples written, as doubles.
+                 */
+                double getRawBytes(void) const { return rawBytes; }
+        };
+
+
+        /**
+         * Reader of compressed skin archives.
+         */
+        class SkinArchiveReader {
+            private:
+                FILE *file;
+                unsigned int nTaxels;
+                unsigned int blockSamples;
+                std::vector<SkinArchiveBlock> index;
+
+                std::vector<unsigned char> block;
+                std::vector<unsigned char> taxels;
+                std::vector<double> row;
+
+                std::string dbgTag;
+
+                bool decodeBlock(const SkinArchiveBlock &i_block, const double &i_from, const double &i_to, LogRowHandler *i_handler);
+
+            public:
+                SkinArchiveReader();
+                ~SkinArchiveReader();
+
+                bool open(const std::string &i_file);
+                void close(void);
+
+                /**
+                 * Decode the samples within a time range. Only the blocks overlapping the range are decoded.
+                 * @param i_from the range start
+                 * @param i_to the range end
+                 * @param i_handler the consumer of the samples
+                 * @return true/false on success/failure
+                 */
+                bool read(const double &i_from, const double &i_to, LogRowHandler *i_handler);
+
+                unsigned int getTaxels(void) const { return nTaxels; }
+                const std::vector<SkinArchiveBlock>& getIndex(void) const { return index; }
+        };
+    } //namespace interactionForces
+} //namespace iCub
+
+#endif
+
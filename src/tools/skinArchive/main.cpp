@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2014 Francesco Giovannini, iCub Facility - Istituto Italiano di Tecnologia
+ * Authors: Francesco Giovannini
+ * email:   francesco.giovannini@iit.it
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+
+
+/**
+ * \defgroup skinArchive skinArchive
+ * Compressed archival of the skin dataDumper logs.
+ *
+ * Usage:
+ *  skinArchive --pack <data.log> --out <archive> [--taxels 192] [--blockSamples 1000] [--stamps 1]
+ *  skinArchive --unpack <archive> [--from <time>] [--to <time>] [--out <data.log>]
+ *  skinArchive --info <archive>
+ *
+ * Unpacked logs use the dataDumper layout "seq stamp values", with the sequence numbers renumbered from 0.
+ */
+
+
+#include "SkinArchive.h"
+#include "LogParser.h"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/Value.h>
+#include <yarp/os/Time.h>
+
+using std::cout;
+using std::cerr;
+using std::string;
+using std::vector;
+
+using iCub::interactionForces::LogParser;
+using iCub::interactionForces::LogRowHandler;
+using iCub::interactionForces::SkinArchiveWriter;
+using iCub::interactionForces::SkinArchiveReader;
+using iCub::interactionForces::SkinArchiveBlock;
+
+using yarp::os::Value;
+using yarp::os::Time;
+
+
+/**
+ * Write the decoded samples as a dataDumper log.
+ */
+class TextWriter : public LogRowHandler {
+    private:
+        FILE *file;
+        int seq;
+
+    public:
+        TextWriter(FILE *aFile) : file(aFile), seq(0) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            fprintf(file, "%d %.6f", seq++, i_time);
+            for (size_t i = 0; i < i_size; ++i) {
+                fprintf(file, " %d", (int) i_values[i]);
+            }
+            fputc('\n', file);
+        }
+
+        int getSamples(void) const { return seq; }
+};
+
+
+/**
+ * Count the decoded samples.
+ */
+class CountHandler : public LogRowHandler {
+    public:
+        int samples;
+
+        CountHandler() : samples(0) {}
+
+        virtual void onRow(const double &i_time, const double *i_values, const size_t &i_size) {
+            samples++;
+        }
+};
+
+
+int main(int argc, char *argv[]) {
+    string dbgTag = "skinArchive: ";
+
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.setVerbose(false);
+    rf.configure("ICUB_ROOT", argc, argv);
+
+    if (rf.check("pack")) {
+        /* ******* Compress a log.                                      ******* */
+        string logFile = rf.find("pack").asString().c_str();
+        string outFile = rf.check("out", Value((logFile + ".ska").c_str()), "The archive file.").asString().c_str();
+        int nTaxels = rf.check("taxels", Value(192), "The number of taxels.").asInt();
+        int blockSamples = rf.check("blockSamples", Value(1000), "The number of samples per block.").asInt();
+        int nStamps = rf.check("stamps", Value(1), "The number of timestamp columns.").asInt();
+
+        SkinArchiveWriter writer;
+        if ((nTaxels <= 0) || (blockSamples <= 0) || !writer.open(outFile, nTaxels, blockSamples)) {
+            return 1;
+        }
+
+        // The blocks are written in file order, hence the log is parsed as a single chunk
+        LogParser parser(nStamps);
+        vector<LogRowHandler*> handlers(1, &writer);
+        double logBytes = 0.0;
+        double start = Time::now();
+        if (!parser.parse(logFile, handlers, logBytes) || !writer.close()) {
+            return 1;
+        }
+        double elapsed = Time::now() - start;
+
+        // The archive size includes the block index and the footer
+        struct stat info;
+        if (stat(outFile.c_str(), &info) != 0) {
+            cerr << dbgTag << "Could not read the size of " << outFile << ". \n";
+            return 1;
+        }
+        double archiveBytes = (double) info.st_size;
+        cout << dbgTag << "Packed " << logBytes / 1e6 << " MB of text (" << writer.getRawBytes() / 1e6 << " MB as doubles) into "
+            << archiveBytes / 1e6 << " MB, ratio " << logBytes / archiveBytes << ", in " << elapsed << " s. \n";
+    } else if (rf.check("unpack")) {
+        /* ******* Decompress a time range.                             ******* */
+        string archiveFile = rf.find("unpack").asString().c_str();
+        double from = rf.check("from", Value(-1e300), "The range start.").asDouble();
+        double to = rf.check("to", Value(1e300), "The range end.").asDouble();
+        string outFile = rf.check("out", Value(""), "The output log.").asString().c_str();
+
+        SkinArchiveReader reader;
+        if (!reader.open(archiveFile)) {
+            return 1;
+        }
+
+        FILE *file = outFile.empty() ? stdout : fopen(outFile.c_str(), "w");
+        if (file == NULL) {
+            cerr << dbgTag << "Could not create " << outFile << ". \n";
+            return 1;
+        }
+        TextWriter writer(file);
+        double start = Time::now();
+        bool ok = reader.read(from, to, &writer);
+        if (file != stdout) {
+            fclose(file);
+        }
+        cerr << dbgTag << "Unpacked " << writer.getSamples() << " samples in " << Time::now() - start << " s. \n";
+        if (!ok) {
+            return 1;
+        }
+    } else if (rf.check("info")) {
+        /* ******* Describe an archive.                                 ******* */
+        SkinArchiveReader reader;
+        if (!reader.open(rf.find("info").asString().c_str())) {
+            return 1;
+        }
+        const vector<SkinArchiveBlock> &index = reader.getIndex();
+        unsigned int samples = 0;
+        for (size_t i = 0; i < index.size(); ++i) {
+            samples += index[i].nSamples;
+        }
+        cout << "taxels " << reader.getTaxels() << "\n";
+        cout << "blocks " << index.size() << "\n";
+        cout << "samples " << samples << "\n";
+        if (!index.empty()) {
+            cout.precision(16);
+            cout << "start " << index.front().start << "\n";
+            cout << "end " << index.back().end << "\n";
+        }
+
+        // Decoding speed
+        CountHandler counter;
+        double start = Time::now();
+        reader.read(-1e300, 1e300, &counter);
+        cout.precision(6);
+        cout << "decodeTime " << Time::now() - start << "\n";
+    } else {
+        cerr << dbgTag << "Usage: skinArchive --pack <data.log> [--out <archive>] | --unpack <archive> [--from t] [--to t] [--out <data.log>] | --info <archive> \n";
+        return 1;
+    }
+
+    return 0;
+}